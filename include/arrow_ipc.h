@@ -0,0 +1,98 @@
+#ifndef STATISTICALDATAPROCESSOR_ARROW_IPC_H
+#define STATISTICALDATAPROCESSOR_ARROW_IPC_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "dataframe.h"
+
+/**
+ * @file arrow_ipc.h
+ * @brief Export and import of DataFrames in the Apache Arrow IPC format.
+ *
+ * The Arrow columnar IPC format (metadata version 5) is implemented here
+ * directly, without the Arrow libraries: the FlatBuffers metadata is encoded
+ * and decoded by hand. A frame is written as its schema, one dictionary batch
+ * per TYPE_CATEGORY column and a single record batch. Column types map to
+ * Arrow types as follows:
+ * - TYPE_NUMERIC: Float64,
+ * - TYPE_INT64: Int64,
+ * - TYPE_DATE: Date32 (days),
+ * - TYPE_TIMESTAMP: Timestamp (nanoseconds, "UTC"),
+ * - TYPE_STRING: Utf8 (LargeUtf8 beyond 2 GiB of text),
+ * - TYPE_CATEGORY: dictionary-encoded Utf8 with Int32 indices.
+ *
+ * Missing values become nulls in validity bitmaps. Float64, Int64 and
+ * timestamp columns share the in-memory representation of DataCell: columnar
+ * frames write them straight from their arrays, and reading copies each one
+ * with a single memcpy per record batch. A single-batch file opened with
+ * dataframe_load_arrow is used in place instead when its buffers are 64-byte
+ * aligned (files written here always are). String data is copied once per
+ * cell in either direction, dates and category codes are narrowed or widened
+ * to their Arrow widths.
+ *
+ * Reading accepts both formats, any number of record batches and, besides the
+ * types above, signed and unsigned integers of every width (as TYPE_INT64),
+ * Float32 and Bool (as TYPE_NUMERIC), Date64, timestamps of every unit,
+ * LargeUtf8 and dictionaries with any integer index type. Imported frames are
+ * columnar.
+ */
+
+/**
+ * @brief The two framings of Arrow IPC data.
+ */
+typedef enum {
+    ARROW_IPC_STREAM, /*!< A sequence of messages ended by an end-of-stream marker (pipes). */
+    ARROW_IPC_FILE    /*!< The stream between "ARROW1" magic bytes, plus a random-access footer. */
+} ArrowIpcFormat;
+
+/**
+ * @brief Writes a DataFrame as Arrow IPC data to an open stream.
+ *
+ * The stream format needs no seeking, so file may be a pipe or stdout.
+ *
+ * @param df Pointer to the DataFrame (either layout).
+ * @param file The destination, opened in binary mode.
+ * @param format The framing to write.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_WRITE_FAILED or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_write_arrow(const DataFrame *df, FILE *file, ArrowIpcFormat format);
+
+/**
+ * @brief Writes a DataFrame to an Arrow IPC file, replacing any previous one.
+ * @param df Pointer to the DataFrame (either layout).
+ * @param path The path of the file.
+ * @param format The framing to write (conventionally .arrow files use ARROW_IPC_FILE).
+ * @return As dataframe_write_arrow.
+ */
+DataframeErrorCode dataframe_save_arrow(const DataFrame *df,
+                                        const char *path,
+                                        ArrowIpcFormat format);
+
+/**
+ * @brief Builds a DataFrame from Arrow IPC data in memory (either format).
+ *
+ * All values are copied, so the buffer may be released afterwards.
+ *
+ * @param data The IPC data.
+ * @param size The number of bytes at data.
+ * @param out_df Receives the columnar DataFrame on success.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT for malformed data,
+ * DATAFRAME_ERR_UNSUPPORTED_FORMAT for nested types, compressed bodies or big-endian data,
+ * DATAFRAME_ERR_EMPTY_FILE if the schema has no fields, or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_read_arrow(const void *data, size_t size, DataFrame **out_df);
+
+/**
+ * @brief Loads an Arrow IPC file or stream (pipes and FIFOs included).
+ *
+ * The input is memory-mapped copy-on-write and owned by the frame (see
+ * dataframe_adopt_mapping), so in-place columns can be modified freely.
+ *
+ * @param path The path of the input.
+ * @param out_df Receives the columnar DataFrame on success.
+ * @return As dataframe_read_arrow, or DATAFRAME_ERR_FILE_NOT_FOUND.
+ */
+DataframeErrorCode dataframe_load_arrow(const char *path, DataFrame **out_df);
+
+#endif // STATISTICALDATAPROCESSOR_ARROW_IPC_H
@@ -0,0 +1,101 @@
+#ifndef STATISTICALDATAPROCESSOR_COMPRESSED_INPUT_H
+#define STATISTICALDATAPROCESSOR_COMPRESSED_INPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @file compressed_input.h
+ * @brief Pipelined decompression of gzip and zstd streams.
+ *
+ * Compressed input is recognized from its magic bytes rather than the file
+ * name. A background thread reads the compressed file and decodes it into a
+ * small ring of blocks while the caller consumes earlier blocks, so
+ * decompression overlaps with whatever the caller does with the data
+ * (typically tokenizing CSV records) and no temporary file is needed.
+ *
+ * Each format is only available when its library was found at build time
+ * (HAVE_ZLIB for gzip, HAVE_ZSTD for zstd); compression_supported reports it.
+ */
+
+/**
+ * @brief Compression formats recognized by compression_detect.
+ */
+typedef enum {
+    COMPRESSION_NONE = 0, /*!< Plain, uncompressed data. */
+    COMPRESSION_GZIP,     /*!< gzip (RFC 1952), including concatenated members. */
+    COMPRESSION_ZSTD      /*!< Zstandard frames, including concatenated frames. */
+} CompressionFormat;
+
+/**
+ * @brief Error codes related to compressed input.
+ */
+typedef enum {
+    COMPRESSED_INPUT_SUCCESS = 0,          /*!< The operation succeeded. */
+    COMPRESSED_INPUT_ERR_UNSUPPORTED,      /*!< The format was not enabled at build time. */
+    COMPRESSED_INPUT_ERR_ALLOCATION_FAILED, /*!< Buffers or decoder state could not be allocated. */
+    COMPRESSED_INPUT_ERR_READ_FAILED,      /*!< Reading the compressed file failed. */
+    COMPRESSED_INPUT_ERR_CORRUPT           /*!< The data is malformed or truncated. */
+} CompressedInputErrorCode;
+
+/**
+ * @brief Opaque state of a decompressing reader.
+ */
+typedef struct CompressedInput CompressedInput;
+
+/**
+ * @brief Identifies the compression format from the first bytes of a file.
+ * @param data The first bytes of the file.
+ * @param size The number of bytes available at data (four are enough).
+ * @return The detected format, or COMPRESSION_NONE.
+ */
+CompressionFormat compression_detect(const void *data, size_t size);
+
+/**
+ * @brief Reports whether a format can be decoded by this build.
+ * @param format The compression format.
+ * @return true if compressed_input_open accepts the format.
+ */
+bool compression_supported(CompressionFormat format);
+
+/**
+ * @brief Starts decompressing a file on a background thread.
+ *
+ * The file stays owned by the caller and must stay open until
+ * compressed_input_close returns. Bytes already read from it (for example to
+ * detect the format) are passed as a prefix and decoded first. If no thread
+ * can be created, decoding happens on the calling thread inside
+ * compressed_input_read instead.
+ *
+ * @param file The compressed stream, positioned right after the prefix.
+ * @param format The format of the stream (not COMPRESSION_NONE).
+ * @param prefix Bytes of the stream that were already read, or NULL.
+ * @param prefix_size The number of bytes in prefix.
+ * @param out_input Receives the reader.
+ * @return COMPRESSED_INPUT_SUCCESS, or an appropriate CompressedInputErrorCode.
+ */
+CompressedInputErrorCode compressed_input_open(FILE *file,
+                                               CompressionFormat format,
+                                               const void *prefix,
+                                               size_t prefix_size,
+                                               CompressedInput **out_input);
+
+/**
+ * @brief Copies the next decompressed bytes into a buffer, waiting for the decoder if needed.
+ * @param input The reader.
+ * @param buffer The destination.
+ * @param capacity The size of buffer.
+ * @param out_size Receives the number of bytes copied; 0 means the end of the data.
+ * @return COMPRESSED_INPUT_SUCCESS, or the error that stopped decoding.
+ */
+CompressedInputErrorCode
+compressed_input_read(CompressedInput *input, void *buffer, size_t capacity, size_t *out_size);
+
+/**
+ * @brief Stops the background thread and frees the reader. The file is not closed.
+ * @param input The reader (NULL is ignored).
+ */
+void compressed_input_close(CompressedInput *input);
+
+#endif // STATISTICALDATAPROCESSOR_COMPRESSED_INPUT_H
@@ -0,0 +1,71 @@
+#ifndef STATISTICALDATAPROCESSOR_CSV_CACHE_H
+#define STATISTICALDATAPROCESSOR_CSV_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "csv_reader.h"
+#include "dataframe.h"
+
+/**
+ * @file csv_cache.h
+ * @brief Binary sidecar files that let a parsed CSV file be reloaded without tokenizing it.
+ *
+ * After a CSV file has been parsed, its columns can be written next to it
+ * (as "<path>" CSV_CACHE_SUFFIX) in the binary format of dataframe_binary.h.
+ * The sidecar is tagged with a key built from the source's size and
+ * modification time and from every read option that influences the result,
+ * so a changed file or different options simply miss the cache. A hit
+ * memory-maps the sidecar: fixed-width and category columns are used in
+ * place and paged in by the OS on first access, and only string cells need
+ * their pointers resolved.
+ */
+
+/**
+ * @brief Suffix appended to the source path to name its sidecar.
+ */
+#define CSV_CACHE_SUFFIX ".sdpcache"
+
+/**
+ * @brief Computes the key that ties a sidecar to the current state of its source file.
+ *
+ * Options that only affect how the file is read (threads, memory mapping,
+ * capacity hints, layout) are not part of the key.
+ *
+ * @param path The path of the CSV file.
+ * @param options The options the file is parsed with.
+ * @param out_key Receives the key.
+ * @return true on success, false if the source file cannot be inspected.
+ */
+bool csv_cache_key(const char *path, const CsvReadOptions *options, uint64_t *out_key);
+
+/**
+ * @brief Loads a DataFrame from the sidecar of a CSV file.
+ *
+ * With the columnar layout the frame uses the mapped columns directly; with
+ * the row layout the cells are copied out of the mapping (string cells still
+ * point into it). Either way the frame owns the mapping.
+ *
+ * @param path The path of the CSV file (not of the sidecar).
+ * @param key The key from csv_cache_key.
+ * @param layout The storage layout of the resulting DataFrame.
+ * @param out_df Receives the DataFrame on success.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_FILE_NOT_FOUND if there is no sidecar,
+ * DATAFRAME_ERR_INVALID_FORMAT if it is stale, corrupt or of another version, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode
+csv_cache_load(const char *path, uint64_t key, DataFrameLayout layout, DataFrame **out_df);
+
+/**
+ * @brief Writes the sidecar of a CSV file, replacing any previous one.
+ *
+ * @param path The path of the CSV file (not of the sidecar).
+ * @param key The key from csv_cache_key, computed before the file was parsed.
+ * @param df The DataFrame parsed from the file.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_WRITE_FAILED if the sidecar cannot be written, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode csv_cache_store(const char *path, uint64_t key, const DataFrame *df);
+
+#endif // STATISTICALDATAPROCESSOR_CSV_CACHE_H
@@ -2,6 +2,7 @@
 #define STATISTICALDATAPROCESSOR_CSV_READER_H
 
 #include "dataframe.h"
+#include "dataframe_filter.h"
 #include <stdbool.h>
 
 /**
@@ -12,11 +13,126 @@
  * from CSV files, automatically detecting column counts and basic data types.
  */
 
+/**
+ * @brief What to do with a record whose field count differs from the header's.
+ */
+typedef enum {
+    CSV_BAD_ROWS_ERROR = 0, /*!< Abort the load with DATAFRAME_ERR_COLUMN_MISMATCH (default). */
+    CSV_BAD_ROWS_SKIP,      /*!< Leave the record out and log it. */
+    CSV_BAD_ROWS_PAD        /*!< Pad missing fields, drop extra ones, keep the row and log it. */
+} CsvBadRowPolicy;
+
+/**
+ * @brief Options controlling how a CSV file is loaded.
+ *
+ * Always start from csv_default_read_options() so that fields added in the
+ * future receive sensible defaults.
+ *
+ * Column projection: when usecols (or usecols_indices) is set, only the listed
+ * columns are kept, in file order. The other fields are still delimited but are
+ * never trimmed, copied or converted. Names are matched against the header, or
+ * against the generated "col_N" names when there is none. The arrays must stay
+ * valid for the duration of the read (for a CsvStream, until it is closed).
+ *
+ * Type inference: each column's type is chosen from the first inference_rows
+ * data rows, ignoring missing values (empty fields, "NA", "N/A", "null",
+ * "NULL", "None"). A column is numeric if every sampled value is a number,
+ * TYPE_INT64, TYPE_DATE or TYPE_TIMESTAMP if enabled and every value fits,
+ * and text otherwise. With infer_dates, YYYY-MM-DD columns become day counts
+ * and columns with times (YYYY-MM-DDTHH:MM:SS[.fff]) nanosecond timestamps.
+ * Values after the sample that do not fit the column type are stored as
+ * missing (NAN or DATAFRAME_NULL_INT64).
+ *
+ * Dictionary encoding: with dictionary_encode set, every column inferred as
+ * text becomes TYPE_CATEGORY. Each cell then holds an int32 code and every
+ * distinct value is stored once, in a per-column dictionary filled through a
+ * hash table while parsing. This suits low-cardinality columns such as
+ * tickers or currencies. The codes of a CsvStream stay stable across batches.
+ *
+ * Malformed records: a record with more or fewer fields than the header
+ * fails the load by default. With bad_rows set to CSV_BAD_ROWS_SKIP or
+ * CSV_BAD_ROWS_PAD the load continues instead, and the line number, byte
+ * offset and field count of each such record are appended to the result's
+ * bad_rows log (up to bad_row_log_limit entries; the total is always kept).
+ * Padded fields are missing values. For a CsvStream, each batch logs the bad
+ * records met while reading it.
+ *
+ * Row filtering: with filter set, only the records that satisfy the predicate
+ * become rows (see dataframe_filter.h). Each record is checked right after it
+ * is split, on the raw text of the compared fields, and a rejected record's
+ * fields are never converted or copied. The compared columns must be among
+ * the kept columns, or the load fails with DATAFRAME_ERR_COLUMN_NOT_FOUND. The
+ * constants are parsed once the column types are inferred; the inference
+ * sample is taken from all records, before filtering. The predicate must stay
+ * valid for the duration of the read (for a CsvStream, until it is closed).
+ *
+ * Caching: with use_cache set, a file that was already parsed with the same
+ * result-affecting options and has not changed since is loaded from its
+ * binary sidecar instead of being tokenized again; otherwise the parsed
+ * result is written to the sidecar for the next load. Failing to write the
+ * sidecar does not fail the load.
+ */
+typedef struct {
+    bool has_header;          /*!< Whether the first line contains column names. */
+    const char *delim;        /*!< Delimiter string (only the first character is used). */
+    size_t row_capacity_hint; /*!< Expected number of data rows; 0 lets the row table grow. */
+    bool memory_map;          /*!< Tokenize through a read-only file mapping instead of reads. */
+    int num_threads;          /*!< Parsing threads: 1 = serial, 0 = all hardware threads. */
+    const char *const *usecols; /*!< Names of the columns to keep, or NULL to keep all. */
+    const int *usecols_indices; /*!< Zero-based indices of the columns to keep (if no names). */
+    size_t usecols_count;       /*!< Number of entries in usecols or usecols_indices. */
+    DataFrameLayout layout;     /*!< Storage layout of the resulting DataFrame (rows by default). */
+    bool dictionary_encode;     /*!< Store text columns as dictionary-encoded TYPE_CATEGORY. */
+    size_t inference_rows;      /*!< Number of data rows sampled to infer column types. */
+    bool infer_integers;        /*!< Store integer-only columns as TYPE_INT64 instead of double. */
+    bool infer_dates;           /*!< Store ISO-8601 dates/timestamps as TYPE_DATE/TIMESTAMP. */
+    CsvBadRowPolicy bad_rows;   /*!< Handling of records with the wrong number of fields. */
+    size_t bad_row_log_limit;   /*!< Maximum number of bad records logged in the result. */
+    bool use_cache;             /*!< Reuse or write a binary sidecar of the result (csv_cache.h). */
+    const FilterPredicate *filter; /*!< Records to keep, or NULL to keep all. */
+} CsvReadOptions;
+
+/**
+ * @brief Returns the default CSV options: header row, comma delimiter, buffered reads.
+ * @return A fully initialized CsvReadOptions structure.
+ */
+CsvReadOptions csv_default_read_options(void);
+
+/**
+ * @brief Reads a CSV file into a DataFrame according to the supplied options.
+ *
+ * The input is read exactly once: records are tokenized block by block and
+ * appended to a DataFrame whose row storage grows geometrically (or is sized
+ * up front from row_capacity_hint). Quoted fields may contain the delimiter
+ * or newlines. Column types are inferred from a sample of the first data rows.
+ *
+ * With num_threads other than 1 the file is memory-mapped, split into byte
+ * ranges that are parsed concurrently (each range resynchronizing on a record
+ * boundary, including splits inside quoted fields), and the results are
+ * stitched together in the original row order.
+ *
+ * gzip and zstd files are recognized from their first bytes and decompressed
+ * on a background thread while the main thread tokenizes the decoded blocks.
+ * Compressed input is always parsed sequentially, whatever num_threads and
+ * memory_map say. A format this build has no decoder for fails with
+ * DATAFRAME_ERR_UNSUPPORTED_FORMAT.
+ *
+ * @param path The file path to the CSV file to be read.
+ * @param options The loading options.
+ * @param out_df Pointer to a DataFrame pointer where the newly created DataFrame will be stored.
+ * @return DATAFRAME_SUCCESS on success, or an appropriate DataframeErrorCode on failure.
+ */
+DataframeErrorCode
+read_csv_with_options(const char *path, const CsvReadOptions *options, DataFrame **out_df);
+
 /**
  * @brief Reads a CSV file and populates a dynamically allocated DataFrame.
- * * This function handles dynamic row and column counting, extracts headers
- * (or generates default ones), and attempts to infer whether a column is
- * numeric or string-based by inspecting the first row of data.
+ * * This function reads the file in a single pass, extracts headers
+ * (or generates default ones), and infers whether each column is numeric or
+ * string-based from a sample of the first inference_rows data rows (100, as
+ * set by csv_default_read_options). To sample a different number of rows, or
+ * to also infer TYPE_INT64, TYPE_DATE and TYPE_TIMESTAMP columns, use
+ * read_csv_with_options with inference_rows, infer_integers and infer_dates.
  *
  * @param path The file path to the CSV file to be read.
  * @param has_header A boolean flag indicating whether the first line contains column names.
@@ -26,4 +142,66 @@
  */
 DataframeErrorCode read_csv(const char *path, bool has_header, const char *delim, DataFrame **out_df);
 
+/**
+ * @brief Reads a CSV file through a read-only memory mapping in a single pass.
+ *
+ * The file is mapped once and tokenized directly out of the mapping; rows are
+ * appended to a growing DataFrame, so the input is never read twice. Quoted
+ * fields may contain the delimiter or newlines. If the input cannot be mapped
+ * (for example a pipe), it is read sequentially into memory instead. Header,
+ * type inference and missing-value handling match read_csv.
+ *
+ * @param path The file path to the CSV file to be read.
+ * @param has_header A boolean flag indicating whether the first line contains column names.
+ * @param delim The delimiter string used in the CSV (only the first character is used).
+ * @param out_df Pointer to a DataFrame pointer where the newly created DataFrame will be stored.
+ * @return DATAFRAME_SUCCESS on success, or an appropriate DataframeErrorCode on failure.
+ */
+DataframeErrorCode
+read_csv_mmap(const char *path, bool has_header, const char *delim, DataFrame **out_df);
+
+/**
+ * @brief An open CSV file consumed as a sequence of fixed-size DataFrame batches.
+ *
+ * Peak memory is bounded by the batch size rather than the file size, so
+ * files larger than RAM can be processed incrementally.
+ */
+typedef struct CsvStream CsvStream;
+
+/**
+ * @brief Opens a CSV file for batch-wise reading.
+ *
+ * Batches are always parsed sequentially on the calling thread; num_threads
+ * and memory_map are ignored. Compressed input is decoded as in
+ * read_csv_with_options, the decompressor running ahead of the batches.
+ *
+ * @param path The file path to the CSV file to be read.
+ * @param options The loading options.
+ * @param out_stream Pointer receiving the newly opened stream.
+ * @return DATAFRAME_SUCCESS on success, or an appropriate DataframeErrorCode on failure.
+ */
+DataframeErrorCode
+csv_stream_open(const char *path, const CsvReadOptions *options, CsvStream **out_stream);
+
+/**
+ * @brief Reads up to max_rows further data rows from the stream.
+ *
+ * The returned batch is owned by the stream and its buffers are recycled by the
+ * next call, so it (and any strings obtained from it) is only valid until then.
+ * All batches share the column names and the types inferred from the sample
+ * of the first data rows.
+ *
+ * @param stream The open stream.
+ * @param max_rows The maximum number of rows per batch (must be positive).
+ * @param out_batch Receives the batch, or NULL once the file is exhausted.
+ * @return DATAFRAME_SUCCESS on success, or an appropriate DataframeErrorCode on failure.
+ */
+DataframeErrorCode csv_stream_next_batch(CsvStream *stream, size_t max_rows, DataFrame **out_batch);
+
+/**
+ * @brief Closes the stream and frees its file handle and batch buffers.
+ * @param stream The stream to close (NULL is ignored).
+ */
+void csv_stream_close(CsvStream *stream);
+
 #endif // STATISTICALDATAPROCESSOR_CSV_READER_H
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef STATISTICALDATAPROCESSOR_CSV_SCANNER_H
+#define STATISTICALDATAPROCESSOR_CSV_SCANNER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file csv_scanner.h
+ * @brief Vectorized structural scanning of CSV text.
+ *
+ * The scanner locates every field delimiter and record-terminating newline that
+ * lies outside double quotes, producing a field-boundary index for the
+ * tokenizer. Input is classified 64 bytes at a time: SIMD compares (AVX2 or
+ * SSE2, chosen at runtime) build bitmasks of quotes, delimiters and newlines,
+ * and a prefix-XOR over the quote mask turns quote positions into an
+ * "inside quotes" mask without a per-byte branch. A portable scalar scanner is
+ * used on other architectures.
+ */
+
+/**
+ * @brief Instruction set used by csv_scan_structurals on this machine.
+ */
+typedef enum {
+    CSV_SCAN_SCALAR = 0, /*!< Portable byte-at-a-time loop. */
+    CSV_SCAN_SSE2,       /*!< 16-byte SSE2 compares. */
+    CSV_SCAN_AVX2        /*!< 32-byte AVX2 compares. */
+} CsvScanBackend;
+
+/**
+ * @brief Finds delimiters and newlines outside quoted sections.
+ *
+ * Every double quote toggles the quoted state, matching the tokenizer's quote
+ * handling. The state is carried in and out through in_quotes, so a long input
+ * may be scanned in consecutive pieces.
+ *
+ * @param data The text to scan.
+ * @param length The number of bytes to scan (must not exceed UINT32_MAX).
+ * @param delim The field delimiter character.
+ * @param in_quotes Quote state at the start of data; updated to the state after the last byte.
+ * @param out_positions Receives the offsets (relative to data) of structural characters, in
+ * increasing order. Must have room for length entries.
+ * @return The number of offsets written to out_positions.
+ */
+size_t csv_scan_structurals(const char *data,
+                            size_t length,
+                            char delim,
+                            bool *in_quotes,
+                            uint32_t *out_positions);
+
+/**
+ * @brief Portable reference implementation of csv_scan_structurals.
+ *
+ * Produces exactly the same output as the vectorized paths and is used
+ * directly when no SIMD backend is available.
+ *
+ * @param data The text to scan.
+ * @param length The number of bytes to scan (must not exceed UINT32_MAX).
+ * @param delim The field delimiter character.
+ * @param in_quotes Quote state at the start of data; updated to the state after the last byte.
+ * @param out_positions Receives the offsets of structural characters. Room for length entries.
+ * @return The number of offsets written to out_positions.
+ */
+size_t csv_scan_structurals_scalar(const char *data,
+                                   size_t length,
+                                   char delim,
+                                   bool *in_quotes,
+                                   uint32_t *out_positions);
+
+/**
+ * @brief Reports which backend csv_scan_structurals dispatches to.
+ * @return The selected CsvScanBackend.
+ */
+CsvScanBackend csv_scan_backend(void);
+
+#endif // STATISTICALDATAPROCESSOR_CSV_SCANNER_H
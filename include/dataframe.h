@@ -1,7 +1,12 @@
 #ifndef STATISTICALDATAPROCESSOR_DATAFRAME_H
 #define STATISTICALDATAPROCESSOR_DATAFRAME_H
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
+#include "file_mapping.h"
+#include "memory_utils.h"
+#include "string_dictionary.h"
 #include "typedefs.h"
 
 /**
@@ -21,7 +26,12 @@ typedef enum {
     DATAFRAME_ERR_FILE_NOT_FOUND,    /*!< Specified file could not be opened. */
     DATAFRAME_ERR_EMPTY_FILE,        /*!< The file is empty or contains no readable data. */
     DATAFRAME_ERR_ALLOCATION_FAILED, /*!< Memory allocation failed during creation or parsing. */
-    DATAFRAME_ERR_COLUMN_MISMATCH    /*!< Inconsistent number of columns detected in rows. */
+    DATAFRAME_ERR_COLUMN_MISMATCH,   /*!< Inconsistent number of columns detected in rows. */
+    DATAFRAME_ERR_READ_FAILED,       /*!< An I/O error occurred while reading the input. */
+    DATAFRAME_ERR_COLUMN_NOT_FOUND,  /*!< A requested column name or index does not exist. */
+    DATAFRAME_ERR_UNSUPPORTED_FORMAT, /*!< The input uses a compression or feature not supported. */
+    DATAFRAME_ERR_INVALID_FORMAT,     /*!< A binary file is corrupt, stale or of another version. */
+    DATAFRAME_ERR_WRITE_FAILED        /*!< An I/O error occurred while writing a file. */
 } DataframeErrorCode;
 
 /**
@@ -29,26 +39,133 @@ typedef enum {
  */
 typedef enum {
     TYPE_NUMERIC, /*!< Column contains numeric values (represented as doubles). */
-    TYPE_STRING   /*!< Column contains string values (represented as char pointers). */
+    TYPE_STRING,   /*!< Column contains string values (represented as char pointers). */
+    TYPE_CATEGORY, /*!< Column contains dictionary-encoded strings (int32 codes). */
+    TYPE_INT64,    /*!< Column contains exact 64-bit integers. */
+    TYPE_DATE,     /*!< Column contains calendar dates as int64 days since 1970-01-01. */
+    TYPE_TIMESTAMP /*!< Column contains int64 nanoseconds since 1970-01-01T00:00:00 UTC. */
 } DataType;
 
 /**
  * @brief A single cell in a DataFrame, capable of holding either a number or a string.
  */
 typedef union {
-    double v_num; /*!< Numeric value representation. */
-    char *v_str;  /*!< Dynamically allocated string value representation. */
+    double v_num;   /*!< Numeric value representation. */
+    char *v_str;    /*!< String value, owned by the DataFrame's string arena. */
+    int32_t v_code; /*!< Code of a TYPE_CATEGORY value in the column's dictionary. */
+    int64_t v_int;  /*!< Value of a TYPE_INT64, TYPE_DATE or TYPE_TIMESTAMP cell. */
 } DataCell;
 
+/**
+ * @brief Marks a missing value in int64-backed cells (numeric cells use NAN).
+ */
+#define DATAFRAME_NULL_INT64 INT64_MIN
+
+/**
+ * @brief Physical arrangement of the cells of a DataFrame.
+ */
+typedef enum {
+    DATAFRAME_LAYOUT_ROWS,   /*!< One cell array per row, accessed as data[row][col]. */
+    DATAFRAME_LAYOUT_COLUMNS /*!< One contiguous cell array per column, as col_data[col][row]. */
+} DataFrameLayout;
+
+/**
+ * @brief Location of an input record that did not fit the frame's columns.
+ */
+typedef struct {
+    uint64_t line;   /*!< 1-based line number at which the record starts. */
+    uint64_t offset; /*!< Byte offset of the record's start in the (decompressed) input. */
+    uint32_t fields; /*!< Number of fields the record actually had. */
+} DataFrameBadRow;
+
+/**
+ * @brief Log of the malformed records skipped or repaired while loading a frame.
+ *
+ * Only the first entries up to a caller-chosen limit are kept, so a badly
+ * broken file cannot make the log grow with the input; total still counts
+ * every bad record.
+ */
+typedef struct {
+    DataFrameBadRow *entries; /*!< Logged records, in input order. */
+    size_t count;             /*!< Number of entries logged. */
+    size_t capacity;          /*!< Number of entries allocated. */
+    size_t total;             /*!< Number of bad records seen, including unlogged ones. */
+} DataFrameBadRowLog;
+
+/**
+ * @brief Validity bitmap of one column: which rows hold a value rather than a missing one.
+ *
+ * Bit r % 64 of bits[r / 64] belongs to row r and is set when the row holds a
+ * value, which for bytes on little-endian machines is the Arrow layout. Bits
+ * of row slots at or past the frame's rows are always set.
+ */
+typedef struct {
+    uint64_t *bits;    /*!< Bitmap covering every row slot, or NULL while no value is missing. */
+    size_t null_count; /*!< Number of rows whose bit is clear. */
+} DataFrameValidity;
+
+/**
+ * @brief Strings of a mapped TYPE_STRING column whose cells hold offsets rather than pointers.
+ *
+ * A frame opened from a binary file (see dataframe_binary.h) keeps the stored
+ * heap offsets of its string cells, so opening touches no cell. Reads through
+ * dataframe_get_cell turn an offset into a pointer into data; negative and
+ * out-of-range offsets read as NULL. The first write to the column, or any
+ * row added to the frame, turns all its offsets into pointers in place.
+ */
+typedef struct {
+    const char *data; /*!< The null-terminated strings, or NULL once cells hold pointers. */
+    size_t size;      /*!< Number of bytes in data; the last one is a terminator. */
+} DataFrameStringHeap;
+
 /**
  * @brief Structure representing tabular data with named columns and typed data.
+ *
+ * Cells are stored either row by row (data, the default) or column by column
+ * (col_data). In the columnar layout every column is a single cache-line
+ * aligned array, so a numeric column is directly usable as a double array
+ * (see dataframe_numeric_column). The accessors dataframe_get_cell and
+ * dataframe_set_cell work with both layouts.
+ *
+ * String cells are not allocated individually: they live in the frame's
+ * string arena (see dataframe_store_string) and are released all at once by
+ * free_dataframe. TYPE_CATEGORY columns store a code per cell instead, and
+ * each distinct value once in the column's dictionary.
+ *
+ * A frame may also own a file mapping (see dataframe_adopt_mapping): its
+ * columns, validity bitmaps and strings can then live directly in a
+ * memory-mapped file. String cells of such columns may be offsets until
+ * first written (see DataFrameStringHeap), so they are read through
+ * dataframe_get_cell rather than from col_data.
+ *
+ * Missing values are marked by sentinels (NAN, DATAFRAME_NULL_INT64, NULL
+ * strings, negative category codes). Frames with validity tracking (see
+ * dataframe_enable_validity), which includes every frame built by the readers,
+ * additionally keep a validity bitmap per column. The bitmap is then what
+ * decides: a NAN cell whose bit is set is a genuine NaN value, not a missing one.
+ *
+ * Frames are reference counted so that views (see dataframe_view.h) can
+ * share their storage: free_dataframe drops one reference and the frame is
+ * released with the last one.
  */
 typedef struct {
-    char **columns;      /*!< Array of dynamically allocated column names. */
-    DataType *col_types; /*!< Array of data types corresponding to each column. */
-    DataCell **data;     /*!< 2D array of cells storing the actual data [row][col]. */
-    int rows;            /*!< Number of rows in the DataFrame. */
-    int cols;            /*!< Number of columns in the DataFrame. */
+    char **columns;         /*!< Array of dynamically allocated column names. */
+    DataType *col_types;    /*!< Array of data types corresponding to each column. */
+    DataCell **data;        /*!< Row layout: cells stored as [row][col] (NULL when columnar). */
+    int rows;               /*!< Number of rows in the DataFrame. */
+    int cols;               /*!< Number of columns in the DataFrame. */
+    int row_capacity;       /*!< Number of row slots available before storage must grow. */
+    MemoryArena strings;    /*!< Arena owning every string cell of the frame. */
+    DataFrameLayout layout; /*!< Which of data or col_data holds the cells. */
+    DataCell **col_data;    /*!< Columnar layout: cells stored as [col][row] (NULL for rows). */
+    StringDictionary **dictionaries;   /*!< Per-column dictionaries of TYPE_CATEGORY columns. */
+    DataFrameBadRowLog bad_rows;       /*!< Malformed input records tolerated while loading. */
+    FileMapping *mapping;              /*!< Copy-on-write mapping owned by the frame, or NULL. */
+    DataFrameValidity *validity;       /*!< Per-column validity, or NULL if only sentinels count. */
+    volatile long references;          /*!< Holders of the frame (see dataframe_retain). */
+    StringDictionary *name_index;      /*!< Column names by code (see dataframe_index_columns). */
+    int *name_index_cols;              /*!< First column carrying each name of name_index. */
+    DataFrameStringHeap *string_heaps; /*!< Per-column deferred string heaps, or NULL. */
 } DataFrame;
 
 /**
@@ -60,7 +177,365 @@ typedef struct {
 DataFrame *create_dataframe(size_t rows, size_t cols);
 
 /**
- * @brief Safely deallocates a DataFrame and all its inner dynamically allocated contents.
+ * @brief Allocates an empty DataFrame (zero rows) that can be filled with dataframe_append_row.
+ *
+ * Only the row pointer table is reserved up front; the cell arrays of each row
+ * are allocated as rows are appended.
+ *
+ * @param row_capacity The number of row slots to reserve (0 selects a small default).
+ * @param cols The number of columns to allocate.
+ * @return A pointer to the newly allocated DataFrame, or NULL if allocation fails.
+ */
+DataFrame *create_dataframe_with_capacity(size_t row_capacity, size_t cols);
+
+/**
+ * @brief Allocates an empty DataFrame (zero rows) with the requested storage layout.
+ *
+ * In the columnar layout each column is one zero-initialized, cache-line
+ * aligned array of row_capacity cells that grows geometrically as rows are
+ * added.
+ *
+ * @param row_capacity The number of row slots to reserve (0 selects a small default).
+ * @param cols The number of columns to allocate.
+ * @param layout The storage layout of the cells.
+ * @return A pointer to the newly allocated DataFrame, or NULL if allocation fails.
+ */
+DataFrame *create_dataframe_with_layout(size_t row_capacity, size_t cols, DataFrameLayout layout);
+
+/**
+ * @brief Appends a new zero-initialized row to a row-layout DataFrame.
+ *
+ * The row pointer table grows geometrically, so appending N rows costs
+ * amortized O(1) per row.
+ *
+ * @param df Pointer to the DataFrame to extend.
+ * @return A pointer to the cells of the new row, or NULL if allocation fails or the
+ * DataFrame uses the columnar layout (use dataframe_push_row instead).
+ */
+DataCell *dataframe_append_row(DataFrame *df);
+
+/**
+ * @brief Appends a new zero-initialized row to a DataFrame of any layout.
+ * @param df Pointer to the DataFrame to extend.
+ * @return The index of the new row, or -1 if allocation fails.
+ */
+int dataframe_push_row(DataFrame *df);
+
+/**
+ * @brief Checks whether a column type stores its cells in DataCell.v_int.
+ * @param type The column type.
+ * @return true for TYPE_INT64, TYPE_DATE and TYPE_TIMESTAMP.
+ */
+bool dataframe_type_is_int64(DataType type);
+
+/**
+ * @brief Checks whether a cell holds a missing value.
+ * @param df Pointer to the DataFrame.
+ * @param row The zero-based row index (must be below rows).
+ * @param col The zero-based column index (must be below cols).
+ * @return With validity tracking, whether the row's validity bit is clear. Otherwise true for
+ * NAN numbers, DATAFRAME_NULL_INT64, NULL strings and negative category codes.
+ */
+bool dataframe_cell_is_null(const DataFrame *df, int row, int col);
+
+/**
+ * @brief Starts tracking missing values in validity bitmaps.
+ *
+ * The bitmaps are derived from the sentinels of the existing rows; columns
+ * without missing values get no bitmap. Calling it again has no effect.
+ *
+ * @param df Pointer to the DataFrame.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED (the frame is left unchanged).
+ */
+DataframeErrorCode dataframe_enable_validity(DataFrame *df);
+
+/**
+ * @brief Marks a cell as holding a value or as missing.
+ *
+ * Marking a cell missing also stores its type's sentinel, so code that only
+ * looks at cells sees it as missing too. Marking it valid only sets its bit;
+ * the value is written with dataframe_set_cell. Without validity tracking only
+ * the sentinel is written.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param row The zero-based row index (must be below rows).
+ * @param col The zero-based column index (must be below cols).
+ * @param valid Whether the cell holds a value.
+ * @return true on success, false for invalid arguments or if the bitmap could not be allocated.
+ */
+bool dataframe_set_valid(DataFrame *df, int row, int col, bool valid);
+
+/**
+ * @brief Sets the validity of a run of rows from a byte bitmap in the Arrow layout.
+ *
+ * Validity tracking is enabled first if needed. Cells are not modified, so
+ * rows marked missing should already hold their type's sentinel.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param col The zero-based column index.
+ * @param first_row The first row to set.
+ * @param bitmap Bit i % 8 of byte i / 8 is set if row first_row + i holds a value.
+ * @param count The number of rows to set.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND if the column or the rows do not
+ * exist, or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_set_validity_bitmap(DataFrame *df,
+                                                 int col,
+                                                 int first_row,
+                                                 const uint8_t *bitmap,
+                                                 size_t count);
+
+/**
+ * @brief Returns the validity bitmap of a column for the bitmap-aware statistics kernels.
+ *
+ * Bit r % 64 of word r / 64 is set when row r holds a value. NULL is returned
+ * when no value of the column is missing, which selects the kernels' all-valid
+ * path; it is also returned for frames without validity tracking, whose
+ * missing values are only marked by sentinels. The bitmap stays valid until
+ * rows are added to or removed from the frame.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param col The zero-based column index.
+ * @param out_null_count Receives the number of missing values (may be NULL).
+ * @return The bitmap, or NULL as described above or if the column does not exist.
+ */
+const uint64_t *dataframe_column_validity(const DataFrame *df, int col, size_t *out_null_count);
+
+/**
+ * @brief Returns the values of an int64-backed column (integers, dates, timestamps) as an array.
+ *
+ * The same rules as for dataframe_numeric_column apply; missing values are
+ * DATAFRAME_NULL_INT64.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param col The zero-based column index.
+ * @return The column's values, or NULL if the frame is row-oriented, the column has another
+ * type or the index is out of range.
+ */
+const int64_t *dataframe_int64_column(const DataFrame *df, int col);
+
+/**
+ * @brief Reads one cell, independently of the storage layout.
+ * @param df Pointer to the DataFrame.
+ * @param row The zero-based row index (must be below rows).
+ * @param col The zero-based column index (must be below cols).
+ * @return The cell; v_num or v_str is meaningful depending on the column type.
+ */
+DataCell dataframe_get_cell(const DataFrame *df, int row, int col);
+
+/**
+ * @brief Writes one cell, independently of the storage layout.
+ *
+ * String values are stored as given; use dataframe_store_string to place a
+ * copy in the frame's arena first.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param row The zero-based row index (must be below rows).
+ * @param col The zero-based column index (must be below cols).
+ * @param value The value to store.
+ */
+void dataframe_set_cell(DataFrame *df, int row, int col, DataCell value);
+
+/**
+ * @brief Returns the values of a numeric column as a contiguous array, without copying.
+ *
+ * Only available in the columnar layout. The array is aligned to
+ * CACHE_LINE_SIZE, holds rows elements (missing values are NAN) and stays
+ * valid until rows are added to or removed from the frame.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param col The zero-based column index.
+ * @return The column's values, or NULL if the frame is row-oriented, the column is not
+ * numeric or the index is out of range.
+ */
+const double *dataframe_numeric_column(const DataFrame *df, int col);
+
+/**
+ * @brief Removes all rows while keeping their storage for reuse.
+ *
+ * Row and column arrays stay allocated and are recycled by subsequent appends,
+ * so a frame can serve as a fixed-size batch buffer. The string arena is
+ * reset, so string cells of cleared rows become invalid immediately. The
+ * bad-row log is emptied as well.
+ *
+ * @param df Pointer to the DataFrame to clear.
+ */
+void dataframe_clear_rows(DataFrame *df);
+
+/**
+ * @brief Counts a malformed input record and logs its location while the log has room.
+ * @param df Pointer to the DataFrame the record was loaded into.
+ * @param entry The location of the record.
+ * @param max_logged The maximum number of entries the log may hold.
+ * @return true on success, false if the log could not be grown.
+ */
+bool dataframe_log_bad_row(DataFrame *df, const DataFrameBadRow *entry, size_t max_logged);
+
+/**
+ * @brief Transfers ownership of a copy-on-write file mapping to the frame.
+ *
+ * Column arrays of a columnar frame and string cells may then point into the
+ * mapping instead of heap memory. Mapped columns can be modified in place
+ * (the OS copies touched pages privately) and are copied to the heap the
+ * first time the frame grows. The mapping is closed by free_dataframe.
+ *
+ * @param df Pointer to the DataFrame, which must not own a mapping yet.
+ * @param mapping A heap-allocated mapping opened with file_mapping_open_copy_on_write.
+ */
+void dataframe_adopt_mapping(DataFrame *df, FileMapping *mapping);
+
+/**
+ * @brief Ensures the DataFrame can hold at least row_capacity rows without growing again.
+ * @param df Pointer to the DataFrame.
+ * @param row_capacity The minimum number of row slots required.
+ * @return 1 on success, 0 if the allocation failed (the DataFrame is left unchanged).
+ */
+int dataframe_reserve_rows(DataFrame *df, size_t row_capacity);
+
+/**
+ * @brief Moves every row of src to the end of dst without copying cell data.
+ *
+ * Both frames must have the same number of columns and matching column types.
+ * Ownership of the rows passes to dst, which also adopts src's string arena,
+ * and src is left with zero rows. Row-layout rows change hands as pointers;
+ * columnar frames copy their column slices. Codes of TYPE_CATEGORY columns are
+ * translated into dst's dictionaries.
+ *
+ * @param dst The DataFrame receiving the rows.
+ * @param src The DataFrame whose rows are moved.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_MISMATCH if the shapes differ, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED if dst cannot grow.
+ */
+DataframeErrorCode dataframe_move_rows(DataFrame *dst, DataFrame *src);
+
+/**
+ * @brief Reorders the rows of a DataFrame so that row r becomes the former row order[r].
+ *
+ * Row-layout frames only reorder their row pointers. Columnar frames gather
+ * each column into a fresh array in one pass, split across threads, and reuse
+ * the array it replaces for the next column. Validity bits follow their rows.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param order A permutation of 0 .. rows - 1.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED (the frame is left unchanged).
+ */
+DataframeErrorCode dataframe_permute_rows(DataFrame *df, const int *order);
+
+/**
+ * @brief Fills columns of a columnar DataFrame with selected rows of another frame's columns.
+ *
+ * Column dst_col + i of dst receives in its row r the cell of src's column
+ * src_cols[i] at row rows[r]; a negative rows[r] gives a missing cell. Each
+ * column is gathered in one pass split across threads, which lets joins and
+ * filters build their results column by column instead of cell by cell. The
+ * copied columns take their source types, strings are copied into dst's arena
+ * and category codes are translated into dst's dictionaries. dst grows to
+ * count rows if it has fewer.
+ *
+ * @param dst The columnar DataFrame receiving the cells.
+ * @param dst_col The first column of dst to fill.
+ * @param src The DataFrame providing the cells (either layout).
+ * @param src_cols The columns of src to copy.
+ * @param col_count The number of columns to copy.
+ * @param rows The row of src for each row of dst (negative for a missing row).
+ * @param count The number of rows to fill.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_UNSUPPORTED_FORMAT if dst is not columnar,
+ * DATAFRAME_ERR_COLUMN_NOT_FOUND for an invalid column or row, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED (the columns filled so far keep their data).
+ */
+DataframeErrorCode dataframe_gather_rows(DataFrame *dst,
+                                         int dst_col,
+                                         const DataFrame *src,
+                                         const int *src_cols,
+                                         int col_count,
+                                         const int *rows,
+                                         size_t count);
+
+/**
+ * @brief Copies a string into the DataFrame's string arena.
+ *
+ * The copy stays valid until the frame is freed or its rows are cleared, and
+ * must not be passed to free().
+ *
+ * @param df Pointer to the DataFrame that will own the string.
+ * @param str The characters to copy (need not be null-terminated).
+ * @param len The number of characters to copy.
+ * @return The null-terminated copy, or NULL if allocation fails.
+ */
+char *dataframe_store_string(DataFrame *df, const char *str, size_t len);
+
+/**
+ * @brief Returns the dictionary code of a string in a TYPE_CATEGORY column, adding it if new.
+ *
+ * The column's dictionary is created on first use.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param col The zero-based column index.
+ * @param str The characters of the string (need not be null-terminated).
+ * @param len The number of characters.
+ * @return The code to store in the cell's v_code, or -1 on allocation failure or invalid column.
+ */
+int32_t dataframe_intern_string(DataFrame *df, int col, const char *str, size_t len);
+
+/**
+ * @brief Returns the text of a TYPE_STRING or TYPE_CATEGORY cell.
+ * @param df Pointer to the DataFrame.
+ * @param row The zero-based row index (must be below rows).
+ * @param col The zero-based column index (must be below cols).
+ * @return The cell's string, or NULL for numeric columns and missing values.
+ */
+const char *dataframe_get_string(const DataFrame *df, int row, int col);
+
+/**
+ * @brief Converts a TYPE_STRING column to a dictionary-encoded TYPE_CATEGORY column.
+ * @param df Pointer to the DataFrame.
+ * @param col The zero-based column index.
+ * @return DATAFRAME_SUCCESS (also if the column is already encoded),
+ * DATAFRAME_ERR_COLUMN_NOT_FOUND for an invalid or non-text column, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_dictionary_encode(DataFrame *df, int col);
+
+/**
+ * @brief Builds the hash index used by dataframe_col_index from the current column names.
+ *
+ * The readers index the frames they create. Frames whose names are assigned
+ * by hand should be indexed once the names are set, and again after any
+ * name changes, since the index is not updated automatically.
+ *
+ * @param df Pointer to the DataFrame.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED (the previous index is kept).
+ */
+DataframeErrorCode dataframe_index_columns(DataFrame *df);
+
+/**
+ * @brief Finds a column by name.
+ *
+ * Indexed frames answer in constant time; others are scanned column by column.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param name The column name.
+ * @return The zero-based index of the first column with that name, or -1 if there is none.
+ */
+int dataframe_col_index(const DataFrame *df, const char *name);
+
+/**
+ * @brief Adds a reference to a DataFrame, keeping it alive until a matching free_dataframe.
+ *
+ * References may be taken and dropped from any thread; the frame's contents
+ * are not synchronized.
+ *
+ * @param df Pointer to the DataFrame (NULL is ignored).
+ * @return df.
+ */
+DataFrame *dataframe_retain(DataFrame *df);
+
+/**
+ * @brief Drops a reference to a DataFrame, deallocating it and all its contents with the last one.
+ *
+ * A new frame holds one reference, so without dataframe_retain this frees it
+ * immediately.
+ *
  * @param df Pointer to the DataFrame to be freed.
  */
 void free_dataframe(DataFrame *df);
@@ -0,0 +1,149 @@
+#ifndef STATISTICALDATAPROCESSOR_DATAFRAME_BINARY_H
+#define STATISTICALDATAPROCESSOR_DATAFRAME_BINARY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "dataframe.h"
+
+/**
+ * @file dataframe_binary.h
+ * @brief A versioned columnar file format for DataFrames that is opened by memory-mapping.
+ *
+ * A file consists of:
+ * - a DataFrameBinaryHeader,
+ * - one DataFrameBinaryColumn per column (the schema),
+ * - the null-terminated column names,
+ * - the bad-row log of the frame (DataFrameBinaryBadRow entries),
+ * - for every column: its cells (64-byte aligned, one 8-byte DataCell per
+ *   row), an optional validity bitmap and a string heap.
+ *
+ * Numbers are stored in the writer's native byte order, which the header
+ * records; files from machines of another byte order are rejected. Cells and
+ * validity bitmaps use their in-memory representation, so a columnar frame
+ * uses them in place: opening a file costs O(columns) and the OS pages
+ * column data in on first access. TYPE_STRING cells hold heap offsets, which
+ * the frame keeps and dataframe_get_cell turns into pointers on access (see
+ * DataFrameStringHeap).
+ *
+ * Validity bitmaps are 64-byte aligned arrays of uint64 words with bit r % 64
+ * of word r / 64 set for a valid row r; the bits past the last row are set.
+ * They are only written for columns that contain missing values. In the
+ * cells themselves missing values keep their usual representation (NAN,
+ * DATAFRAME_NULL_INT64, NULL strings).
+ */
+
+/**
+ * @brief Version written by dataframe_save_binary; files of other versions are rejected.
+ */
+#define DATAFRAME_BINARY_VERSION 2
+
+/**
+ * @brief Alignment of every column's cells and validity bitmap within the file.
+ */
+#define DATAFRAME_BINARY_ALIGNMENT 64
+
+/**
+ * @brief Stored in place of the heap offset of a NULL TYPE_STRING cell.
+ */
+#define DATAFRAME_BINARY_NULL_STRING (-1)
+
+/**
+ * @brief Fixed-size header at the start of a file.
+ */
+typedef struct {
+    char magic[8];           /*!< The characters "SDPFRAME". */
+    uint32_t version;        /*!< DATAFRAME_BINARY_VERSION. */
+    uint32_t byte_order;     /*!< 0x01020304 in the writer's byte order. */
+    uint64_t tag;            /*!< Caller-defined value, e.g. identifying the source data. */
+    uint64_t file_size;      /*!< Size of the whole file, to detect truncation. */
+    uint64_t rows;           /*!< Number of rows. */
+    uint64_t cols;           /*!< Number of columns (the schema follows the header). */
+    uint64_t bad_row_count;  /*!< Number of logged bad rows. */
+    uint64_t bad_row_total;  /*!< Number of bad rows seen while loading the frame. */
+    uint64_t bad_row_offset; /*!< File offset of the DataFrameBinaryBadRow entries. */
+} DataFrameBinaryHeader;
+
+/**
+ * @brief Schema entry describing one column and where its sections are stored.
+ */
+typedef struct {
+    uint32_t type;             /*!< DataType of the column. */
+    uint32_t name_length;      /*!< Length of the column name (it is null-terminated). */
+    uint64_t name_offset;      /*!< File offset of the column name. */
+    uint64_t data_offset;      /*!< File offset of rows DataCell values. */
+    uint64_t validity_offset;  /*!< File offset of the validity bitmap (0 if null_count is 0). */
+    uint64_t null_count;       /*!< Number of missing values in the column. */
+    uint64_t heap_offset;      /*!< File offset of the column's null-terminated strings. */
+    uint64_t heap_size;        /*!< Number of bytes of strings. */
+    uint64_t dictionary_count; /*!< Number of dictionary values in the heap (TYPE_CATEGORY). */
+} DataFrameBinaryColumn;
+
+/**
+ * @brief Stored form of a DataFrameBadRow.
+ */
+typedef struct {
+    uint64_t line;     /*!< 1-based line number. */
+    uint64_t offset;   /*!< Byte offset in the input. */
+    uint32_t fields;   /*!< Number of fields of the record. */
+    uint32_t reserved; /*!< Always zero. */
+} DataFrameBinaryBadRow;
+
+/**
+ * @brief Options controlling how a binary DataFrame file is opened.
+ */
+typedef struct {
+    DataFrameLayout layout; /*!< Columnar maps columns in place; rows copies cells out. */
+    bool check_tag;         /*!< Reject files whose tag differs from tag. */
+    uint64_t tag;           /*!< Tag required when check_tag is set. */
+} DataFrameBinaryOpenOptions;
+
+/**
+ * @brief Writes a DataFrame to a binary file, replacing any previous one.
+ *
+ * The file is written under a temporary name and renamed into place, so
+ * readers never map a half-written file.
+ *
+ * @param df Pointer to the DataFrame (either layout).
+ * @param path The path of the file.
+ * @param tag A caller-defined value stored in the header.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_WRITE_FAILED or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_save_binary(const DataFrame *df, const char *path, uint64_t tag);
+
+/**
+ * @brief Returns the default options for dataframe_open_mmap_with_options.
+ * @return Columnar layout without a tag check.
+ */
+DataFrameBinaryOpenOptions dataframe_binary_default_open_options(void);
+
+/**
+ * @brief Opens a binary DataFrame file written by dataframe_save_binary.
+ *
+ * The resulting frame is columnar and owns the file's copy-on-write mapping
+ * (see dataframe_adopt_mapping); it can be modified and grown like any
+ * other frame without changing the file.
+ *
+ * @param path The path of the file.
+ * @param out_df Receives the DataFrame on success.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_FILE_NOT_FOUND, DATAFRAME_ERR_INVALID_FORMAT if the
+ * file is corrupt or of another version, or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_open_mmap(const char *path, DataFrame **out_df);
+
+/**
+ * @brief Opens a binary DataFrame file with explicit options.
+ *
+ * With the row layout, cells are copied out of the mapping, which costs
+ * O(rows); string cells become pointers into the mapping.
+ *
+ * @param path The path of the file.
+ * @param options The open options.
+ * @param out_df Receives the DataFrame on success.
+ * @return As dataframe_open_mmap; a tag mismatch is reported as DATAFRAME_ERR_INVALID_FORMAT.
+ */
+DataframeErrorCode dataframe_open_mmap_with_options(const char *path,
+                                                    const DataFrameBinaryOpenOptions *options,
+                                                    DataFrame **out_df);
+
+#endif // STATISTICALDATAPROCESSOR_DATAFRAME_BINARY_H
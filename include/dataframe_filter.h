@@ -0,0 +1,211 @@
+#ifndef STATISTICALDATAPROCESSOR_DATAFRAME_FILTER_H
+#define STATISTICALDATAPROCESSOR_DATAFRAME_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dataframe.h"
+
+/**
+ * @file dataframe_filter.h
+ * @brief Row selection by comparison predicates such as "Price > 150 AND Volume >= 1000".
+ *
+ * A predicate is a conjunction of conditions, each comparing one column with a
+ * constant. It is compiled against a frame's schema once, which resolves the
+ * column names and parses every constant as its column's type, and is then
+ * evaluated a column at a time: each condition produces one bit per row,
+ * 64 rows to a word, and the words of the conditions are ANDed together. Words
+ * that no row survives are skipped by the later conditions. Contiguous numeric
+ * and int64-backed columns are compared with SSE2 or AVX2 instructions where
+ * the processor has them.
+ *
+ * The surviving rows are returned as a selection vector of row indices, or
+ * gathered into a new frame. The CSV reader accepts the same predicates (see
+ * CsvReadOptions.filter) and checks each record before its fields are stored.
+ *
+ * A missing value satisfies no condition, not even "!=".
+ */
+
+/**
+ * @brief The comparison of a filter condition.
+ */
+typedef enum {
+    FILTER_LESS,          /*!< column < value */
+    FILTER_LESS_EQUAL,    /*!< column <= value */
+    FILTER_GREATER,       /*!< column > value */
+    FILTER_GREATER_EQUAL, /*!< column >= value */
+    FILTER_EQUAL,         /*!< column == value */
+    FILTER_NOT_EQUAL      /*!< column != value */
+} FilterOperator;
+
+/**
+ * @brief One comparison of a column with a constant.
+ *
+ * The constant is given as text and parsed as the column's type when the
+ * predicate is compiled: a number for numeric columns, an integer or number
+ * for TYPE_INT64, an ISO-8601 date or timestamp for TYPE_DATE and
+ * TYPE_TIMESTAMP. String and category columns are compared byte-wise.
+ */
+typedef struct {
+    const char *column; /*!< Name of the column compared. */
+    FilterOperator op;  /*!< The comparison. */
+    const char *value;  /*!< The constant, as text. */
+} FilterCondition;
+
+/**
+ * @brief A conjunction of filter conditions.
+ */
+typedef struct {
+    const FilterCondition *conditions; /*!< The conditions every selected row satisfies. */
+    size_t count;                      /*!< Number of conditions (0 selects every row). */
+    char *storage;                     /*!< Text owned by a parsed predicate, else NULL. */
+} FilterPredicate;
+
+/**
+ * @brief A filter condition compiled against the schema of a frame.
+ */
+typedef struct {
+    int col;                     /*!< The column compared. */
+    FilterOperator op;           /*!< The comparison. */
+    DataType type;               /*!< The column's type. */
+    bool exact_integer;          /*!< Whether an int64-backed column is compared as integers. */
+    int64_t integer;             /*!< The constant of int64-backed columns, if exact_integer. */
+    double number;               /*!< The constant of numeric and inexact int64 comparisons. */
+    const char *text;            /*!< The constant of text columns (borrowed from the predicate). */
+    size_t text_length;          /*!< Length of text. */
+    const uint8_t *code_matches; /*!< Result for each category code known when compiled. */
+    int32_t code_count;          /*!< Number of entries in code_matches. */
+} FilterTerm;
+
+/**
+ * @brief Parses a predicate such as "Price > 150 AND Volume >= 1000".
+ *
+ * Conditions are joined by AND (in any case) or &&. Each is a column name,
+ * one of the operators < <= > >= == = != <>, and a constant. Names and
+ * constants containing spaces or operator characters may be enclosed in
+ * single quotes, double quotes or backquotes.
+ *
+ * @param expression The predicate text.
+ * @param out_predicate Receives the predicate, to be released with dataframe_predicate_free.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT for malformed text, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_predicate_parse(const char *expression,
+                                             FilterPredicate *out_predicate);
+
+/**
+ * @brief Releases a predicate returned by dataframe_predicate_parse.
+ *
+ * Predicates built by hand (storage NULL) are left alone.
+ *
+ * @param predicate The predicate, reset to no conditions.
+ */
+void dataframe_predicate_free(FilterPredicate *predicate);
+
+/**
+ * @brief Resolves the columns and parses the constants of a predicate for one frame.
+ *
+ * The terms borrow the predicate's text, which must outlive them. Category
+ * constants are compared with every value of the column's dictionary once;
+ * values added to the dictionary later are compared when they are met.
+ *
+ * @param df The DataFrame whose schema the predicate is compiled against.
+ * @param predicate The predicate.
+ * @param out_terms Receives predicate->count terms (to be freed with free; NULL for none).
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND for an unknown column,
+ * DATAFRAME_ERR_INVALID_FORMAT for a constant that does not parse as its column's type or an
+ * invalid operator, or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_predicate_compile(const DataFrame *df,
+                                               const FilterPredicate *predicate,
+                                               FilterTerm **out_terms);
+
+/**
+ * @brief Checks whether a raw text field satisfies a term.
+ *
+ * The field is read the way the CSV reader stores it in a column of the
+ * term's type, so a record can be rejected before any of its fields is
+ * stored. A field that would be stored as missing satisfies nothing.
+ *
+ * @param term The compiled term.
+ * @param begin Pointer to the first character of the field.
+ * @param end Pointer one past the last character of the field.
+ * @return true if the field satisfies the term.
+ */
+bool dataframe_filter_matches_field(const FilterTerm *term, const char *begin, const char *end);
+
+/**
+ * @brief Evaluates compiled terms over a range of rows into a bitmap.
+ *
+ * Bit i % 64 of out_mask[i / 64] is set when row first_row + i satisfies every
+ * term; the bits past row_count in the last word are cleared.
+ *
+ * @param df The DataFrame the terms were compiled against.
+ * @param terms The terms.
+ * @param term_count The number of terms (0 selects every row).
+ * @param first_row The first row evaluated.
+ * @param row_count The number of rows evaluated (first_row + row_count must not exceed rows).
+ * @param out_mask Receives (row_count + 63) / 64 words.
+ */
+void dataframe_filter_range(const DataFrame *df,
+                            const FilterTerm *terms,
+                            size_t term_count,
+                            size_t first_row,
+                            size_t row_count,
+                            uint64_t *out_mask);
+
+/**
+ * @brief Clears the bits of a bitmap whose rows fail any of the terms.
+ *
+ * Works like dataframe_filter_range but narrows an existing bitmap, so rows
+ * already rejected by earlier conditions are not evaluated again.
+ *
+ * @param df The DataFrame the terms were compiled against.
+ * @param terms The terms.
+ * @param term_count The number of terms.
+ * @param first_row The row of bit 0.
+ * @param row_count The number of rows covered by mask (first_row + row_count must not exceed
+ * rows).
+ * @param mask The (row_count + 63) / 64 words narrowed in place.
+ */
+void dataframe_filter_and_range(const DataFrame *df,
+                                const FilterTerm *terms,
+                                size_t term_count,
+                                size_t first_row,
+                                size_t row_count,
+                                uint64_t *mask);
+
+/**
+ * @brief Lists the rows of a frame that satisfy a predicate.
+ * @param df The DataFrame.
+ * @param predicate The predicate.
+ * @param num_threads The maximum number of threads (0 selects the hardware thread count).
+ * @param out_rows Receives the selected rows in ascending order (to be freed with free).
+ * @param out_count Receives the number of selected rows.
+ * @return The same codes as dataframe_predicate_compile.
+ */
+DataframeErrorCode dataframe_filter_rows(const DataFrame *df,
+                                         const FilterPredicate *predicate,
+                                         int num_threads,
+                                         int **out_rows,
+                                         size_t *out_count);
+
+/**
+ * @brief Copies the rows of a frame that satisfy a predicate into a new frame.
+ *
+ * The result is a columnar frame with validity tracking holding every column
+ * of df, with the selected rows in their original order.
+ *
+ * @param df The DataFrame.
+ * @param predicate The predicate.
+ * @param num_threads The maximum number of threads (0 selects the hardware thread count).
+ * @param out_df Receives the result, to be freed with free_dataframe.
+ * @return The same codes as dataframe_predicate_compile.
+ */
+DataframeErrorCode dataframe_filter(const DataFrame *df,
+                                    const FilterPredicate *predicate,
+                                    int num_threads,
+                                    DataFrame **out_df);
+
+#endif // STATISTICALDATAPROCESSOR_DATAFRAME_FILTER_H
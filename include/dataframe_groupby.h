@@ -0,0 +1,78 @@
+#ifndef STATISTICALDATAPROCESSOR_DATAFRAME_GROUPBY_H
+#define STATISTICALDATAPROCESSOR_DATAFRAME_GROUPBY_H
+
+#include "dataframe.h"
+
+/**
+ * @file dataframe_groupby.h
+ * @brief Hash-based group-by aggregation over DataFrame rows.
+ *
+ * Rows are grouped by the values of one or more key columns through an
+ * open-addressing hash table. Each group keeps, per aggregated column, a
+ * Welford accumulator (see RunningStatistics) together with its sum, minimum
+ * and maximum. The rows are split into ranges aggregated by separate threads
+ * into partial tables, which are then merged; the Chan et al. update of
+ * running_statistics_merge makes the merged means and variances match a
+ * single pass.
+ */
+
+/**
+ * @brief Aggregations available for a column.
+ */
+typedef enum {
+    GROUPBY_COUNT,    /*!< Number of non-missing values (TYPE_INT64 result). */
+    GROUPBY_SUM,      /*!< Sum of the values. */
+    GROUPBY_MEAN,     /*!< Arithmetic mean of the values. */
+    GROUPBY_VARIANCE, /*!< Sample variance of the values (missing for fewer than two). */
+    GROUPBY_MIN,      /*!< Smallest value. */
+    GROUPBY_MAX       /*!< Largest value. */
+} GroupByAggregation;
+
+/**
+ * @brief One output column of a group-by: an aggregation of an input column.
+ */
+typedef struct {
+    int col;                        /*!< The zero-based input column to aggregate. */
+    GroupByAggregation aggregation; /*!< The aggregation to compute. */
+    const char *name;               /*!< Output column name, or NULL for "<column>_<suffix>". */
+} GroupByAggregate;
+
+/**
+ * @brief Returns the suffix naming an aggregate column that has no name of its own.
+ * @param aggregation The aggregation.
+ * @return The suffix, e.g. "mean" for the column "Price_mean".
+ */
+const char *dataframe_groupby_suffix(GroupByAggregation aggregation);
+
+/**
+ * @brief Groups the rows of a DataFrame by key columns and aggregates other columns per group.
+ *
+ * The result is a new columnar frame with one row per distinct key
+ * combination, in order of first appearance. It holds the key columns (same
+ * names and types) followed by one column per aggregate. Rows with a missing
+ * key value form their own group, whose key cell is missing.
+ *
+ * Missing values of aggregated columns are skipped. GROUPBY_COUNT accepts any
+ * column; the other aggregations need TYPE_NUMERIC or int64-backed columns
+ * (integers are accumulated as doubles) and give TYPE_NUMERIC results, missing
+ * when a group has no value to aggregate.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param keys The zero-based key columns.
+ * @param key_count The number of key columns (at least 1).
+ * @param aggregates The output aggregates.
+ * @param aggregate_count The number of aggregates (may be 0).
+ * @param num_threads The maximum number of threads (0 selects the hardware thread count).
+ * @param out_df Receives the result, to be freed with free_dataframe.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND for an invalid column or an
+ * aggregation its type does not support, or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_groupby_agg(const DataFrame *df,
+                                         const int *keys,
+                                         int key_count,
+                                         const GroupByAggregate *aggregates,
+                                         int aggregate_count,
+                                         int num_threads,
+                                         DataFrame **out_df);
+
+#endif // STATISTICALDATAPROCESSOR_DATAFRAME_GROUPBY_H
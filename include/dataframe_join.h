@@ -0,0 +1,161 @@
+#ifndef STATISTICALDATAPROCESSOR_DATAFRAME_JOIN_H
+#define STATISTICALDATAPROCESSOR_DATAFRAME_JOIN_H
+
+#include <stddef.h>
+
+#include "dataframe.h"
+
+/**
+ * @file dataframe_join.h
+ * @brief Hash joins and as-of joins between two DataFrames.
+ *
+ * Both joins index the right frame by its key columns: the rows are hashed in
+ * parallel, the distinct keys are inserted into open-addressing tables that
+ * each thread owns a hash partition of, and the rows of every key are then
+ * listed contiguously in row order. The left rows are matched against the
+ * index in parallel.
+ *
+ * The matches are returned as pairs of row indices; the frame-building
+ * variants then copy each output column in one gather pass (see
+ * dataframe_gather_rows).
+ *
+ * Keys match by value: numeric keys with numeric keys (0.0 equals -0.0),
+ * int64-backed keys (integers, dates, timestamps) with int64-backed keys, and
+ * string or category keys with string or category keys by their text. A row
+ * with a missing or NaN key value matches nothing.
+ */
+
+/**
+ * @brief Which left rows a hash join keeps.
+ */
+typedef enum {
+    DATAFRAME_JOIN_INNER, /*!< Only left rows with at least one matching right row. */
+    DATAFRAME_JOIN_LEFT   /*!< Every left row; unmatched ones are paired with no right row. */
+} DataFrameJoinType;
+
+/**
+ * @brief Matches the rows of two DataFrames with equal key values.
+ *
+ * The pairs are ordered by left row, and the right rows of one left row in
+ * ascending order. With DATAFRAME_JOIN_LEFT an unmatched left row appears once,
+ * paired with right row -1.
+ *
+ * @param left The left DataFrame.
+ * @param left_keys The key columns of left.
+ * @param right The right DataFrame, which is indexed.
+ * @param right_keys The key columns of right, matched with left_keys in order.
+ * @param key_count The number of key columns (at least 1).
+ * @param type The join type.
+ * @param num_threads The maximum number of threads (0 selects the hardware thread count).
+ * @param out_left_rows Receives the left row of each pair (to be freed with free).
+ * @param out_right_rows Receives the right row of each pair (to be freed with free).
+ * @param out_count Receives the number of pairs.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND for an invalid key column,
+ * DATAFRAME_ERR_COLUMN_MISMATCH for keys of incompatible types, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_hash_join_indices(const DataFrame *left,
+                                               const int *left_keys,
+                                               const DataFrame *right,
+                                               const int *right_keys,
+                                               int key_count,
+                                               DataFrameJoinType type,
+                                               int num_threads,
+                                               int **out_left_rows,
+                                               int **out_right_rows,
+                                               size_t *out_count);
+
+/**
+ * @brief Joins two DataFrames on equal key values into a new frame.
+ *
+ * The result is a columnar frame with validity tracking holding one row per
+ * pair of dataframe_hash_join_indices: every left column, then every right
+ * column except the keys. Right columns whose name is taken by a left column
+ * get the suffix "_right". The right cells of unmatched left rows are missing.
+ *
+ * @param left The left DataFrame.
+ * @param left_keys The key columns of left.
+ * @param right The right DataFrame.
+ * @param right_keys The key columns of right.
+ * @param key_count The number of key columns (at least 1).
+ * @param type The join type.
+ * @param num_threads The maximum number of threads (0 selects the hardware thread count).
+ * @param out_df Receives the result, to be freed with free_dataframe.
+ * @return The same codes as dataframe_hash_join_indices.
+ */
+DataframeErrorCode dataframe_hash_join(const DataFrame *left,
+                                       const int *left_keys,
+                                       const DataFrame *right,
+                                       const int *right_keys,
+                                       int key_count,
+                                       DataFrameJoinType type,
+                                       int num_threads,
+                                       DataFrame **out_df);
+
+/**
+ * @brief Finds for each left row the last right row whose time is not later than its own.
+ *
+ * For left row r, out_right_rows[r] is the right row with the greatest time
+ * at or before the left row's time, among the right rows whose by columns
+ * match the left row's (all right rows when by_count is 0). Ties go to the
+ * later row. It is -1 when there is no such row or the left time is missing.
+ * Right rows with a missing time are ignored.
+ *
+ * Within each by group the right rows must be in ascending order of time, e.g.
+ * sorted by time or by the by columns and then time (see dataframe_sort). The
+ * left rows may be in any order; each is looked up with a binary search.
+ *
+ * @param left The left DataFrame.
+ * @param left_on The time column of left (numeric or int64-backed, e.g. TYPE_DATE).
+ * @param right The right DataFrame.
+ * @param right_on The time column of right, of the same kind as left_on.
+ * @param left_by The exact-match columns of left (may be NULL if by_count is 0).
+ * @param right_by The exact-match columns of right, matched with left_by in order.
+ * @param by_count The number of exact-match columns (may be 0).
+ * @param num_threads The maximum number of threads (0 selects the hardware thread count).
+ * @param out_right_rows Receives left->rows entries.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND for an invalid column,
+ * DATAFRAME_ERR_COLUMN_MISMATCH for columns of incompatible types,
+ * DATAFRAME_ERR_INVALID_FORMAT if the right times are out of order, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_asof_join_indices(const DataFrame *left,
+                                               int left_on,
+                                               const DataFrame *right,
+                                               int right_on,
+                                               const int *left_by,
+                                               const int *right_by,
+                                               int by_count,
+                                               int num_threads,
+                                               int *out_right_rows);
+
+/**
+ * @brief Joins each left row with the last right row at or before its time into a new frame.
+ *
+ * The result is a columnar frame with validity tracking holding every left
+ * row in order: every left column, then every right column except the time
+ * and by columns, named as in dataframe_hash_join. The right cells of left
+ * rows without a match are missing.
+ *
+ * @param left The left DataFrame.
+ * @param left_on The time column of left.
+ * @param right The right DataFrame.
+ * @param right_on The time column of right.
+ * @param left_by The exact-match columns of left (may be NULL if by_count is 0).
+ * @param right_by The exact-match columns of right.
+ * @param by_count The number of exact-match columns (may be 0).
+ * @param num_threads The maximum number of threads (0 selects the hardware thread count).
+ * @param out_df Receives the result, to be freed with free_dataframe.
+ * @return The same codes as dataframe_asof_join_indices.
+ */
+DataframeErrorCode dataframe_asof_join(const DataFrame *left,
+                                       int left_on,
+                                       const DataFrame *right,
+                                       int right_on,
+                                       const int *left_by,
+                                       const int *right_by,
+                                       int by_count,
+                                       int num_threads,
+                                       DataFrame **out_df);
+
+#endif // STATISTICALDATAPROCESSOR_DATAFRAME_JOIN_H
@@ -0,0 +1,199 @@
+#ifndef STATISTICALDATAPROCESSOR_DATAFRAME_QUERY_H
+#define STATISTICALDATAPROCESSOR_DATAFRAME_QUERY_H
+
+#include <stddef.h>
+
+#include "csv_reader.h"
+#include "dataframe.h"
+#include "dataframe_filter.h"
+#include "dataframe_groupby.h"
+
+/**
+ * @file dataframe_query.h
+ * @brief Lazy query plans over a DataFrame or a CSV file, executed in fused morsels.
+ *
+ * A query records a scan followed by any number of steps (filters, moving
+ * averages, trading signals) and only runs when a terminal operation asks for
+ * its result. Execution then walks the scanned rows in morsels of
+ * QUERY_MORSEL_ROWS rows, small enough for a morsel's columns to stay in the
+ * cache, and passes each morsel through every step before reading the next:
+ * filters narrow a bitmap of the rows still alive, and computed columns are
+ * written to buffers of one morsel's length that the following steps read.
+ * No step materializes a column of the scan's full length; only the final
+ * result does. Moving averages and signals carry their window state from one
+ * morsel to the next, so they see the surviving rows as one series and give
+ * the same values as calculate_sma_masked, calculate_ema_masked and
+ * generate_trading_signals over the filtered column. This makes execution
+ * sequential.
+ *
+ * A CSV scan reads the file through a CsvStream, one morsel per batch, and
+ * the conditions of filters recorded before the first computed column that
+ * compare file columns are checked by the reader itself (see
+ * CsvReadOptions.filter), so rejected records are never converted.
+ *
+ * Steps are validated when they are recorded: column names must exist in the
+ * scan or be computed by an earlier step. Names and constants of filter
+ * conditions are compared as by dataframe_filter.h; a computed value that is
+ * NaN is missing.
+ */
+
+/**
+ * @brief Number of rows each step processes at a time (a multiple of 64).
+ */
+#define QUERY_MORSEL_ROWS 4096
+
+/**
+ * @brief A recorded query plan (see dataframe_query_scan).
+ */
+typedef struct DataFrameQuery DataFrameQuery;
+
+/**
+ * @brief One output column of dataframe_query_aggregate: an aggregation of a column.
+ */
+typedef struct {
+    const char *column;             /*!< Name of the scanned or computed column to aggregate. */
+    GroupByAggregation aggregation; /*!< The aggregation to compute. */
+    const char *name;               /*!< Output column name, or NULL for "<column>_<suffix>". */
+} QueryAggregate;
+
+/**
+ * @brief Starts a query over the rows of a DataFrame.
+ *
+ * The query keeps a reference to df (see dataframe_retain), which must not
+ * change while the query exists.
+ *
+ * @param df The DataFrame to scan (either layout).
+ * @param out_query Receives the query, to be freed with dataframe_query_free.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_query_scan(DataFrame *df, DataFrameQuery **out_query);
+
+/**
+ * @brief Starts a query over the rows of a CSV file.
+ *
+ * The file is opened once to learn its columns and types, and read again by
+ * every execution. The options, and the arrays and predicate they point to,
+ * must stay valid until the query is freed; num_threads and memory_map are
+ * ignored as by csv_stream_open.
+ *
+ * @param path The file path to the CSV file to be read.
+ * @param options The loading options.
+ * @param out_query Receives the query, to be freed with dataframe_query_free.
+ * @return DATAFRAME_SUCCESS, the codes of csv_stream_open, or DATAFRAME_ERR_EMPTY_FILE if the
+ * file holds no row.
+ */
+DataframeErrorCode dataframe_query_scan_csv(const char *path,
+                                            const CsvReadOptions *options,
+                                            DataFrameQuery **out_query);
+
+/**
+ * @brief Appends a filter: only rows satisfying the predicate reach the later steps.
+ *
+ * The conditions may compare scanned columns and columns computed by earlier
+ * steps. The predicate's text must stay valid until the query is freed.
+ *
+ * @param query The query.
+ * @param predicate The predicate.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND for an unknown column, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED. Constants are parsed when the query executes.
+ */
+DataframeErrorCode dataframe_query_filter(DataFrameQuery *query, const FilterPredicate *predicate);
+
+/**
+ * @brief Appends a computed column holding the Simple Moving Average of a column.
+ * @param query The query.
+ * @param column The averaged column: TYPE_NUMERIC, int64-backed, or computed.
+ * @param period The number of rows averaged (at least 1).
+ * @param name The name of the new TYPE_NUMERIC column, or NULL for "<column>_sma<period>".
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND for an unknown or non-numeric
+ * column, DATAFRAME_ERR_COLUMN_MISMATCH if the name is taken, DATAFRAME_ERR_INVALID_FORMAT for
+ * an invalid period, or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_query_sma(DataFrameQuery *query,
+                                       const char *column,
+                                       int period,
+                                       const char *name);
+
+/**
+ * @brief Appends a computed column holding the Exponential Moving Average of a column.
+ * @param query The query.
+ * @param column The averaged column: TYPE_NUMERIC, int64-backed, or computed.
+ * @param period The smoothing period (at least 1).
+ * @param name The name of the new TYPE_NUMERIC column, or NULL for "<column>_ema<period>".
+ * @return The same codes as dataframe_query_sma.
+ */
+DataframeErrorCode dataframe_query_ema(DataFrameQuery *query,
+                                       const char *column,
+                                       int period,
+                                       const char *name);
+
+/**
+ * @brief Appends a computed column holding the crossover signals of a price and its average.
+ *
+ * The new TYPE_CATEGORY column holds "BUY", "SELL" or "HOLD" for each row as
+ * generate_trading_signals assigns them.
+ *
+ * @param query The query.
+ * @param price_column The price column: TYPE_NUMERIC, int64-backed, or computed.
+ * @param average_column The moving average column, usually computed by an earlier step.
+ * @param name The name of the new column, or NULL for "signal".
+ * @return The same codes as dataframe_query_sma.
+ */
+DataframeErrorCode dataframe_query_signals(DataFrameQuery *query,
+                                           const char *price_column,
+                                           const char *average_column,
+                                           const char *name);
+
+/**
+ * @brief Restricts the columns returned by dataframe_query_collect.
+ *
+ * By default every scanned column is returned, followed by the computed ones.
+ * Columns that are not selected are never copied.
+ *
+ * @param query The query.
+ * @param columns The names of the columns to return, in output order.
+ * @param count The number of names (at least 1).
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND for an unknown column, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_query_select(DataFrameQuery *query, const char **columns, int count);
+
+/**
+ * @brief Executes the query and returns the surviving rows.
+ *
+ * The result is a columnar frame with validity tracking, holding the
+ * selected columns of the rows that passed every filter, in scan order.
+ *
+ * @param query The query.
+ * @param out_df Receives the result, to be freed with free_dataframe.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT for a filter constant that does not
+ * parse as its column's type, the read errors of a CSV scan, or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_query_collect(DataFrameQuery *query, DataFrame **out_df);
+
+/**
+ * @brief Executes the query and aggregates the surviving rows into a single row.
+ *
+ * Missing values are skipped. GROUPBY_COUNT accepts any column; the other
+ * aggregations need numeric columns and are missing when no value was
+ * aggregated, as for dataframe_groupby_agg.
+ *
+ * @param query The query.
+ * @param aggregates The output aggregates.
+ * @param aggregate_count The number of aggregates (at least 1).
+ * @param out_df Receives a columnar one-row frame with one column per aggregate.
+ * @return The codes of dataframe_query_collect, or DATAFRAME_ERR_COLUMN_NOT_FOUND for an
+ * unknown column or an aggregation its type does not support.
+ */
+DataframeErrorCode dataframe_query_aggregate(DataFrameQuery *query,
+                                             const QueryAggregate *aggregates,
+                                             int aggregate_count,
+                                             DataFrame **out_df);
+
+/**
+ * @brief Releases a query, its reference to the scanned frame and its open files.
+ * @param query The query to free (NULL is ignored).
+ */
+void dataframe_query_free(DataFrameQuery *query);
+
+#endif // STATISTICALDATAPROCESSOR_DATAFRAME_QUERY_H
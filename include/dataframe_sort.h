@@ -0,0 +1,51 @@
+#ifndef STATISTICALDATAPROCESSOR_DATAFRAME_SORT_H
+#define STATISTICALDATAPROCESSOR_DATAFRAME_SORT_H
+
+#include <stdbool.h>
+
+#include "dataframe.h"
+
+/**
+ * @file dataframe_sort.h
+ * @brief Multi-threaded ordering of DataFrame rows by one or more key columns.
+ *
+ * The sort first computes a permutation of the rows. Keys are processed from
+ * the last to the first, each with a stable sort, so earlier keys take
+ * precedence and rows with equal keys keep their relative order. Numeric,
+ * int64, date and timestamp keys are encoded as order-preserving 64-bit
+ * integers and sorted with a parallel LSD radix sort that skips the bytes all
+ * keys share; category keys are radix sorted by the rank of their value, and
+ * string keys use a parallel merge sort. Missing values sort last in either
+ * direction. The permutation is then applied column by column in a single
+ * gather pass (see dataframe_permute_rows).
+ */
+
+/**
+ * @brief Computes the order that sorts the rows of a DataFrame, without modifying it.
+ * @param df Pointer to the DataFrame.
+ * @param keys The zero-based key columns, most significant first.
+ * @param ascending The direction of each key (NULL sorts every key ascending).
+ * @param key_count The number of keys (at least 1).
+ * @param out_order Receives rows entries: the former row of each sorted row.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND for an invalid key, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+DataframeErrorCode dataframe_sort_order(const DataFrame *df,
+                                        const int *keys,
+                                        const bool *ascending,
+                                        int key_count,
+                                        int *out_order);
+
+/**
+ * @brief Sorts the rows of a DataFrame in place by one or more key columns.
+ * @param df Pointer to the DataFrame.
+ * @param keys The zero-based key columns, most significant first.
+ * @param ascending The direction of each key (NULL sorts every key ascending).
+ * @param key_count The number of keys (at least 1).
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND for an invalid key, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED (the frame is left unchanged).
+ */
+DataframeErrorCode
+dataframe_sort(DataFrame *df, const int *keys, const bool *ascending, int key_count);
+
+#endif // STATISTICALDATAPROCESSOR_DATAFRAME_SORT_H
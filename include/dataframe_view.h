@@ -0,0 +1,198 @@
+#ifndef STATISTICALDATAPROCESSOR_DATAFRAME_VIEW_H
+#define STATISTICALDATAPROCESSOR_DATAFRAME_VIEW_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dataframe.h"
+
+/**
+ * @file dataframe_view.h
+ * @brief Zero-copy views selecting rows and columns of a DataFrame.
+ *
+ * A view describes a subset of a parent frame: an evenly spaced run of its
+ * rows (a contiguous range, or every step-th row) and any list of its columns,
+ * possibly reordered. Creating a view copies no cells. It holds a reference to
+ * the parent (see dataframe_retain), so the parent stays alive as long as any
+ * of its views, even after its owner called free_dataframe. Views of views
+ * are flattened onto the same parent, so an access never goes through more
+ * than one level of indirection, and slicing costs O(1) whatever the size of
+ * the frame.
+ *
+ * Views always read the parent's current cells. Appending rows to the parent
+ * is safe; removing or moving its rows (dataframe_clear_rows,
+ * dataframe_move_rows) while views exist leaves their rows out of range.
+ */
+
+/**
+ * @brief A selection of rows and columns of a parent DataFrame.
+ */
+typedef struct {
+    DataFrame *frame; /*!< The parent frame, kept alive by the view's reference. */
+    int first_row;    /*!< Parent row of the view's first row. */
+    int row_step;     /*!< Distance in parent rows between consecutive view rows (at least 1). */
+    int rows;         /*!< Number of rows in the view. */
+    int cols;         /*!< Number of columns in the view. */
+    int *col_map;     /*!< Parent column of each view column, or NULL for all of them in order. */
+} DataFrameView;
+
+/**
+ * @brief Creates a view of every row and column of a frame.
+ * @param df Pointer to the parent DataFrame, which receives a reference.
+ * @return The view, or NULL if df is NULL or allocation fails.
+ */
+DataFrameView *dataframe_view_create(DataFrame *df);
+
+/**
+ * @brief Creates a view of an evenly spaced run of rows of another view.
+ *
+ * The view's rows are first_row, first_row + step, ... of view; their count
+ * must fit inside view.
+ *
+ * @param view The view to slice.
+ * @param first_row The view row that becomes the new view's first row.
+ * @param rows The number of rows of the new view (may be 0).
+ * @param step The distance between consecutive selected rows (1 for a contiguous range).
+ * @return The view, or NULL for an out-of-range selection or if allocation fails.
+ */
+DataFrameView *
+dataframe_view_slice(const DataFrameView *view, int first_row, int rows, int step);
+
+/**
+ * @brief Creates a view of some columns of another view, in the given order.
+ * @param view The view to select from.
+ * @param cols The zero-based column indices within view.
+ * @param count The number of columns to select (at least 1).
+ * @return The view, or NULL for an invalid index or if allocation fails.
+ */
+DataFrameView *dataframe_view_select(const DataFrameView *view, const int *cols, int count);
+
+/**
+ * @brief Creates a view of the named columns of another view, in the given order.
+ *
+ * Names are resolved with dataframe_col_index on the parent frame, so a name
+ * shared by several parent columns refers to the first of them.
+ *
+ * @param view The view to select from.
+ * @param names The column names.
+ * @param count The number of columns to select (at least 1).
+ * @return The view, or NULL if a name is not found or allocation fails.
+ */
+DataFrameView *
+dataframe_view_select_names(const DataFrameView *view, const char *const *names, int count);
+
+/**
+ * @brief Frees a view and drops its reference to the parent frame.
+ * @param view The view (NULL is ignored).
+ */
+void dataframe_view_free(DataFrameView *view);
+
+/**
+ * @brief Returns the parent column behind a view column.
+ * @param view The view.
+ * @param col The zero-based view column index (must be below cols).
+ * @return The zero-based column index in view->frame.
+ */
+int dataframe_view_parent_col(const DataFrameView *view, int col);
+
+/**
+ * @brief Returns the parent row behind a view row.
+ * @param view The view.
+ * @param row The zero-based view row index (must be below rows).
+ * @return The zero-based row index in view->frame.
+ */
+int dataframe_view_parent_row(const DataFrameView *view, int row);
+
+/**
+ * @brief Reads one cell of a view.
+ * @param view The view.
+ * @param row The zero-based view row index (must be below rows).
+ * @param col The zero-based view column index (must be below cols).
+ * @return The parent's cell.
+ */
+DataCell dataframe_view_get_cell(const DataFrameView *view, int row, int col);
+
+/**
+ * @brief Checks whether a cell of a view holds a missing value (see dataframe_cell_is_null).
+ * @param view The view.
+ * @param row The zero-based view row index (must be below rows).
+ * @param col The zero-based view column index (must be below cols).
+ * @return true if the parent's cell is missing.
+ */
+bool dataframe_view_cell_is_null(const DataFrameView *view, int row, int col);
+
+/**
+ * @brief Returns the text of a TYPE_STRING or TYPE_CATEGORY cell of a view.
+ * @param view The view.
+ * @param row The zero-based view row index (must be below rows).
+ * @param col The zero-based view column index (must be below cols).
+ * @return The cell's string, or NULL for other columns and missing values.
+ */
+const char *dataframe_view_get_string(const DataFrameView *view, int row, int col);
+
+/**
+ * @brief Returns the cells of a view column in place, for strided access.
+ *
+ * Cell i of the view column is cells[i * view->row_step]. Only available
+ * when the parent is columnar; the pointer stays valid until rows are added
+ * to or removed from the parent.
+ *
+ * @param view The view.
+ * @param col The zero-based view column index.
+ * @return The column's first cell, or NULL for a row-layout parent, an empty view, an
+ * invalid index or a string column whose cells still hold heap offsets (see
+ * DataFrameStringHeap).
+ */
+const DataCell *dataframe_view_column(const DataFrameView *view, int col);
+
+/**
+ * @brief Returns a view column as a contiguous double array, without copying.
+ *
+ * Available for numeric columns of columnar parents when the view's rows are
+ * contiguous (row_step 1), so a slice can be handed directly to the
+ * statistics kernels.
+ *
+ * @param view The view.
+ * @param col The zero-based view column index.
+ * @return rows values, or NULL if the column cannot be exposed that way.
+ */
+const double *dataframe_view_numeric_column(const DataFrameView *view, int col);
+
+/**
+ * @brief Returns an int64-backed view column (integers, dates, timestamps) as an array.
+ *
+ * The same rules as for dataframe_view_numeric_column apply.
+ *
+ * @param view The view.
+ * @param col The zero-based view column index.
+ * @return rows values, or NULL if the column cannot be exposed that way.
+ */
+const int64_t *dataframe_view_int64_column(const DataFrameView *view, int col);
+
+/**
+ * @brief Returns the validity of a view column for the bitmap-aware statistics kernels.
+ *
+ * The bitmap is NULL when no row of the view is missing, which selects the
+ * kernels' all-valid path. When the view starts on a 64-row boundary of a
+ * contiguous range, the parent's bitmap is returned in place; otherwise the
+ * bits are gathered into scratch, which may only be NULL if the column is
+ * known to hold no missing value. Missing values are found as described for
+ * dataframe_cell_is_null, so frames without validity tracking work too.
+ *
+ * @param view The view.
+ * @param col The zero-based view column index.
+ * @param scratch Space for (rows + 63) / 64 words.
+ * @param out_bits Receives the bitmap (bit i % 64 of word i / 64 is set if view row i holds a
+ * value), or NULL.
+ * @param out_null_count Receives the number of missing values (may be NULL).
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND for an invalid column, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED if the bits must be gathered and scratch is NULL.
+ */
+DataframeErrorCode dataframe_view_column_validity(const DataFrameView *view,
+                                                  int col,
+                                                  uint64_t *scratch,
+                                                  const uint64_t **out_bits,
+                                                  size_t *out_null_count);
+
+#endif // STATISTICALDATAPROCESSOR_DATAFRAME_VIEW_H
@@ -0,0 +1,59 @@
+#ifndef STATISTICALDATAPROCESSOR_DATE_PARSER_H
+#define STATISTICALDATAPROCESSOR_DATE_PARSER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file date_parser.h
+ * @brief Conversion between ISO-8601 dates, timestamps and epoch-based integers.
+ *
+ * Dates are represented as the number of days since 1970-01-01 (negative
+ * before it) in the proleptic Gregorian calendar, timestamps as nanoseconds
+ * since 1970-01-01T00:00:00 UTC, so both can be stored as plain int64 values,
+ * compared and subtracted directly. The fixed-width parts of a field are
+ * validated eight bytes at a time instead of character by character.
+ */
+
+/**
+ * @brief Parses a field that consists exactly of an ISO-8601 date (YYYY-MM-DD).
+ * @param begin Pointer to the first character of the field.
+ * @param end Pointer one past the last character of the field.
+ * @param out_days Receives the number of days since 1970-01-01.
+ * @return true if the whole field is a valid calendar date, false otherwise.
+ */
+bool parse_date_span(const char *begin, const char *end, int64_t *out_days);
+
+/**
+ * @brief Parses a field that consists exactly of an ISO-8601 date or date and time.
+ *
+ * Accepts YYYY-MM-DD (midnight) and YYYY-MM-DDTHH:MM:SS, with 'T' or a space
+ * between date and time, an optional fraction of one to nine digits and an
+ * optional trailing 'Z'. Times are taken as UTC; other zone offsets are rejected.
+ *
+ * @param begin Pointer to the first character of the field.
+ * @param end Pointer one past the last character of the field.
+ * @param out_nanos Receives the number of nanoseconds since 1970-01-01T00:00:00.
+ * @return true if the whole field is a valid timestamp within the int64 range.
+ */
+bool parse_timestamp_span(const char *begin, const char *end, int64_t *out_nanos);
+
+/**
+ * @brief Converts a calendar date to days since 1970-01-01.
+ * @param year The year (e.g. 2024).
+ * @param month The month, 1 to 12.
+ * @param day The day of the month, 1 to 31.
+ * @return The day count. The date itself is not validated.
+ */
+int64_t date_from_civil(int64_t year, int month, int day);
+
+/**
+ * @brief Converts days since 1970-01-01 back to a calendar date.
+ * @param days The day count.
+ * @param out_year Receives the year.
+ * @param out_month Receives the month, 1 to 12.
+ * @param out_day Receives the day of the month, 1 to 31.
+ */
+void date_to_civil(int64_t days, int64_t *out_year, int *out_month, int *out_day);
+
+#endif // STATISTICALDATAPROCESSOR_DATE_PARSER_H
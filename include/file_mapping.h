@@ -0,0 +1,75 @@
+#ifndef STATISTICALDATAPROCESSOR_FILE_MAPPING_H
+#define STATISTICALDATAPROCESSOR_FILE_MAPPING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file file_mapping.h
+ * @brief Read-only, whole-file memory mappings with a portable fallback.
+ *
+ * Regular files are mapped directly into the address space (mmap on POSIX,
+ * MapViewOfFile on Windows), so their contents can be tokenized without any
+ * intermediate copies. Inputs that cannot be mapped, such as pipes or
+ * character devices, are transparently read into a heap buffer instead.
+ */
+
+/**
+ * @brief Error codes related to file mapping operations.
+ */
+typedef enum {
+    FILE_MAPPING_SUCCESS = 0,         /*!< The file contents are available in memory. */
+    FILE_MAPPING_ERR_OPEN_FAILED,     /*!< The file could not be opened. */
+    FILE_MAPPING_ERR_READ_FAILED,     /*!< Reading from an unmappable stream failed. */
+    FILE_MAPPING_ERR_ALLOCATION_FAILED /*!< The fallback heap buffer could not be allocated. */
+} FileMappingErrorCode;
+
+/**
+ * @brief A read-only view of an entire file's contents.
+ *
+ * When is_mapped is true, data points into an OS mapping and is NOT
+ * null-terminated. When it is false, data is a heap buffer that carries an
+ * extra null terminator at data[size].
+ */
+typedef struct {
+    const char *data; /*!< First byte of the file contents (NULL for empty files). */
+    size_t size;      /*!< Number of bytes available at data. */
+    bool is_mapped;   /*!< True for an OS mapping, false for the heap-buffer fallback. */
+    void *os_file;    /*!< Platform file handle kept alive for the mapping (Windows only). */
+    void *os_mapping; /*!< Platform mapping object handle (Windows only). */
+} FileMapping;
+
+/**
+ * @brief Makes the whole contents of a file available in memory.
+ *
+ * Tries to create a read-only mapping first. If the input is not a regular
+ * file or the mapping cannot be created, the contents are read sequentially
+ * into a heap buffer, so pipes and FIFOs are supported as well.
+ *
+ * @param path The path of the file to open.
+ * @param out_mapping Pointer to the structure that receives the mapping.
+ * @return FILE_MAPPING_SUCCESS on success, or an appropriate FileMappingErrorCode.
+ */
+FileMappingErrorCode file_mapping_open(const char *path, FileMapping *out_mapping);
+
+/**
+ * @brief Makes the contents of a file available as private, writable memory.
+ *
+ * Behaves like file_mapping_open, but pages of the mapping may be modified
+ * (by casting away the const of data): the OS copies a page on its first
+ * write, so changes are never written back to the file. Pages that are only
+ * read stay shared with the page cache.
+ *
+ * @param path The path of the file to open.
+ * @param out_mapping Pointer to the structure that receives the mapping.
+ * @return FILE_MAPPING_SUCCESS on success, or an appropriate FileMappingErrorCode.
+ */
+FileMappingErrorCode file_mapping_open_copy_on_write(const char *path, FileMapping *out_mapping);
+
+/**
+ * @brief Releases a mapping or fallback buffer created by file_mapping_open.
+ * @param mapping Pointer to the mapping to release. It is reset to an empty state.
+ */
+void file_mapping_close(FileMapping *mapping);
+
+#endif // STATISTICALDATAPROCESSOR_FILE_MAPPING_H
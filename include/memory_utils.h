@@ -10,6 +10,9 @@
  * This module provides functions for allocating memory that is properly aligned
  * to specific memory boundaries (such as a CPU cache line). This helps prevent
  * false sharing and improves overall memory access performance.
+ *
+ * It also provides a bump-pointer arena for many small allocations that share
+ * one lifetime, such as the string cells of a DataFrame.
  */
 
 /**
@@ -42,4 +45,66 @@ void *aligned_calloc(size_t num, size_t size, size_t alignment);
  */
 void aligned_free(void *ptr);
 
+/**
+ * @brief A block of arena memory; allocations are carved out of it sequentially.
+ */
+typedef struct MemoryArenaBlock MemoryArenaBlock;
+
+/**
+ * @brief A bump-pointer allocator that releases all of its allocations at once.
+ *
+ * Allocations are carved sequentially from large blocks, so allocating is a
+ * pointer increment and releasing the arena costs one free per block instead
+ * of one per allocation. Individual allocations cannot be freed. A
+ * zero-initialized MemoryArena is a valid, empty arena.
+ */
+typedef struct {
+    MemoryArenaBlock *head; /*!< Block currently served from, followed by older blocks. */
+    size_t block_size;      /*!< Size of the next block to allocate (0 selects the default). */
+} MemoryArena;
+
+/**
+ * @brief Allocates uninitialized memory from the arena.
+ *
+ * Blocks grow geometrically, and requests larger than a block get a dedicated
+ * block, so any size can be served. The memory is aligned for any object type
+ * (_Alignof(max_align_t)).
+ *
+ * @param arena The arena to allocate from.
+ * @param size The number of bytes to allocate.
+ * @return A pointer valid until the arena is reset or released, or NULL if allocation fails.
+ */
+void *arena_alloc(MemoryArena *arena, size_t size);
+
+/**
+ * @brief Copies len bytes into the arena as a null-terminated string.
+ * @param arena The arena to allocate from.
+ * @param str The characters to copy (need not be null-terminated).
+ * @param len The number of characters to copy.
+ * @return The arena-owned copy, or NULL if allocation fails.
+ */
+char *arena_strndup(MemoryArena *arena, const char *str, size_t len);
+
+/**
+ * @brief Invalidates every allocation while keeping the newest block for reuse.
+ * @param arena The arena to reset.
+ */
+void arena_reset(MemoryArena *arena);
+
+/**
+ * @brief Transfers every block of src to dst, leaving src empty.
+ *
+ * Allocations made from src stay valid and are released together with dst.
+ *
+ * @param dst The arena taking ownership of the blocks.
+ * @param src The arena giving up its blocks.
+ */
+void arena_adopt(MemoryArena *dst, MemoryArena *src);
+
+/**
+ * @brief Frees every block of the arena, leaving it empty and reusable.
+ * @param arena The arena to release. If NULL, the function does nothing.
+ */
+void arena_release(MemoryArena *arena);
+
 #endif
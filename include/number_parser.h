@@ -0,0 +1,51 @@
+#ifndef STATISTICALDATAPROCESSOR_NUMBER_PARSER_H
+#define STATISTICALDATAPROCESSOR_NUMBER_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file number_parser.h
+ * @brief Fast, correctly rounded conversion of decimal text to double.
+ *
+ * Decimal numbers are parsed straight from a (begin, end) span without
+ * copying or null-terminating it. Values with at most 19 significant digits
+ * are converted exactly: small exponents with a single floating-point
+ * multiply or divide (Clinger's fast path), everything else with the
+ * Eisel-Lemire algorithm over a table of 128-bit powers of five. The rare
+ * inputs the fast paths cannot decide (more than 19 significant digits on a
+ * rounding boundary, "inf"/"nan", hexadecimal floats, leading whitespace) are
+ * handed to strtod, so results always match a correctly rounded strtod.
+ *
+ * Unlike strtod, the decimal separator is always '.', independently of the
+ * process locale. Integers can be read exactly into int64_t with
+ * parse_int64_span.
+ */
+
+/**
+ * @brief Parses the longest prefix of [begin, end) that forms a floating-point number.
+ *
+ * Accepts an optional sign, digits with an optional '.' fraction and an
+ * optional exponent ("1.5e-3"). The span does not have to be null-terminated.
+ *
+ * @param begin Pointer to the first character of the text.
+ * @param end Pointer one past the last character of the text.
+ * @param out_value Pointer receiving the parsed value (left untouched if nothing was parsed).
+ * @return The number of characters consumed, or 0 if the text does not start with a number.
+ */
+size_t parse_double_span(const char *begin, const char *end, double *out_value);
+
+/**
+ * @brief Parses the longest prefix of [begin, end) that forms a decimal integer.
+ *
+ * Accepts an optional sign followed by digits. Values outside the int64_t
+ * range are rejected rather than clamped.
+ *
+ * @param begin Pointer to the first character of the text.
+ * @param end Pointer one past the last character of the text.
+ * @param out_value Pointer receiving the parsed value (left untouched if nothing was parsed).
+ * @return The number of characters consumed, or 0 if there is no integer or it overflows.
+ */
+size_t parse_int64_span(const char *begin, const char *end, int64_t *out_value);
+
+#endif // STATISTICALDATAPROCESSOR_NUMBER_PARSER_H
@@ -0,0 +1,126 @@
+#ifndef STATISTICALDATAPROCESSOR_PARALLEL_H
+#define STATISTICALDATAPROCESSOR_PARALLEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file parallel.h
+ * @brief Minimal portable threading helpers built on native threads.
+ *
+ * Wraps POSIX threads or the Win32 thread API behind a parallel_for
+ * primitive, so data-parallel kernels can spread independent tasks across
+ * the available cores without depending on a threading runtime. Pipelines
+ * that overlap two stages use a background thread and a blocking queue, and
+ * objects shared between threads are reference counted with an atomic add.
+ */
+
+/**
+ * @brief A unit of work executed by parallel_for.
+ * @param context The shared context pointer passed to parallel_for.
+ * @param task_index The zero-based index of the task to execute.
+ */
+typedef void (*ParallelTask)(void *context, size_t task_index);
+
+/**
+ * @brief Returns the number of hardware threads available to the process.
+ * @return The number of online logical processors (at least 1).
+ */
+int parallel_hardware_threads(void);
+
+/**
+ * @brief Executes task(context, i) for every i in [0, task_count) using worker threads.
+ *
+ * Tasks are distributed round-robin over min(thread_count, task_count) threads,
+ * the calling thread acting as the first worker. The call returns once every
+ * task has finished. If worker threads cannot be created, the remaining tasks
+ * are executed on the calling thread, so all tasks always run exactly once.
+ *
+ * @param task_count The number of tasks to execute.
+ * @param thread_count The maximum number of threads to use (0 selects the hardware thread count).
+ * @param task The function executed for each task index.
+ * @param context Shared pointer handed to every task invocation.
+ * @return true if the work ran on more than one thread, false if it ran serially.
+ */
+bool parallel_for(size_t task_count, int thread_count, ParallelTask task, void *context);
+
+/**
+ * @brief Entry point of a background thread started with parallel_thread_start.
+ * @param context The pointer passed to parallel_thread_start.
+ */
+typedef void (*ParallelThreadEntry)(void *context);
+
+/**
+ * @brief Opaque handle of a background thread.
+ */
+typedef struct ParallelThread ParallelThread;
+
+/**
+ * @brief Opaque bounded FIFO of pointers shared between threads.
+ */
+typedef struct ParallelQueue ParallelQueue;
+
+/**
+ * @brief Runs entry(context) on a new thread.
+ * @param entry The function to run.
+ * @param context Pointer handed to entry.
+ * @return The thread handle, or NULL if the thread could not be created.
+ */
+ParallelThread *parallel_thread_start(ParallelThreadEntry entry, void *context);
+
+/**
+ * @brief Waits for a background thread to finish and releases its handle.
+ * @param thread The thread handle (NULL is ignored).
+ */
+void parallel_thread_join(ParallelThread *thread);
+
+/**
+ * @brief Creates an empty queue.
+ * @param capacity The maximum number of queued items (at least 1).
+ * @return The queue, or NULL on allocation failure.
+ */
+ParallelQueue *parallel_queue_create(size_t capacity);
+
+/**
+ * @brief Appends an item, waiting while the queue is full.
+ * @param queue The queue.
+ * @param item The item to append (must not be NULL).
+ * @return true if the item was queued, false if the queue has been closed.
+ */
+bool parallel_queue_push(ParallelQueue *queue, void *item);
+
+/**
+ * @brief Removes the oldest item, waiting while the queue is empty.
+ * @param queue The queue.
+ * @return The item, or NULL once the queue is closed and has no items left.
+ */
+void *parallel_queue_pop(ParallelQueue *queue);
+
+/**
+ * @brief Closes a queue: further pushes fail and waiting threads are woken up.
+ *
+ * Items already queued can still be popped.
+ *
+ * @param queue The queue.
+ */
+void parallel_queue_close(ParallelQueue *queue);
+
+/**
+ * @brief Frees a queue. No thread may be using it any more; queued items are not freed.
+ * @param queue The queue (NULL is ignored).
+ */
+void parallel_queue_free(ParallelQueue *queue);
+
+/**
+ * @brief Atomically adds delta to a counter shared between threads, e.g. a reference count.
+ *
+ * The update is a full barrier, so writes made before releasing a reference
+ * are visible to the thread that drops the last one.
+ *
+ * @param counter The counter.
+ * @param delta The amount to add (negative to subtract).
+ * @return The value of the counter after the addition.
+ */
+long parallel_atomic_add(volatile long *counter, long delta);
+
+#endif // STATISTICALDATAPROCESSOR_PARALLEL_H
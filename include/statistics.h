@@ -2,6 +2,7 @@
 #define STATISTICALDATAPROCESSOR_STATISTICS_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * @file statistics.h
@@ -11,6 +12,14 @@
  * Bollinger Bands, covariance, correlation, and trading signal generation.
  * For calculations dealing with the normal distribution, the standard notation
  * N(m, 𝜎) is assumed, where m is the mean and 𝜎 is the standard deviation.
+ *
+ * The plain kernels treat NaN elements as missing values. Their _masked
+ * variants take the missing values from a validity bitmap instead (bit i % 64
+ * of validity[i / 64] is set when element i holds a value, as returned by
+ * dataframe_column_validity), so a NaN marked valid is a value like any other
+ * and propagates into the results. A NULL bitmap means that every element is
+ * valid; the kernels then run without any per-element test, and so do runs
+ * of 64 elements whose bitmap word is full.
  */
 
 #if defined(_MSC_VER)
@@ -38,6 +47,18 @@ typedef struct {
     double variance;           /*!< The calculated sample variance (𝜎^2) */
 } SeriesStatistics;
 
+/**
+ * @brief Mergeable accumulator for computing N(m, 𝜎) over data that arrives in batches.
+ *
+ * Holds the running count, mean and sum of squared differences (Welford's M2),
+ * so arbitrarily long series can be summarized with O(1) memory.
+ */
+typedef struct {
+    size_t count; /*!< Number of valid (non-NaN) values accumulated. */
+    double mean;  /*!< Running mean of the accumulated values. */
+    double m2;    /*!< Running sum of squared differences from the mean. */
+} RunningStatistics;
+
 /**
  * @brief Calculates comprehensive descriptive statistics (mean, variance, and standard deviation).
  * These parameters describe the normal distribution N(m, 𝜎) of the provided dataset.
@@ -50,6 +71,78 @@ StatisticsErrorCode calculate_series_statistics(const double *restrict data,
                                                 size_t length,
                                                 SeriesStatistics *restrict out_stats);
 
+/**
+ * @brief Calculates mean, variance and standard deviation of the valid elements of a series.
+ * @param data Array of double-precision input values.
+ * @param validity Validity bitmap of data, or NULL if every element is valid.
+ * @param length Total number of elements in the data array.
+ * @param out_stats Pointer to the SeriesStatistics structure where results will be stored.
+ * @return STATS_SUCCESS on success, or an error code.
+ */
+StatisticsErrorCode calculate_series_statistics_masked(const double *restrict data,
+                                                       const uint64_t *restrict validity,
+                                                       size_t length,
+                                                       SeriesStatistics *restrict out_stats);
+
+/**
+ * @brief Resets a running accumulator to the empty state.
+ * @param acc Pointer to the accumulator to reset.
+ */
+void running_statistics_reset(RunningStatistics *acc);
+
+/**
+ * @brief Adds a single value to a running accumulator (one Welford step).
+ *
+ * Unlike the batch updates, the value is counted even if it is NaN, so
+ * callers that know which values are missing filter them out first.
+ *
+ * @param acc Pointer to the accumulator to update.
+ * @param value The value to add.
+ */
+void running_statistics_add(RunningStatistics *acc, double value);
+
+/**
+ * @brief Adds a batch of values to a running accumulator. NaN values are ignored.
+ * @param acc Pointer to the accumulator to update.
+ * @param data Array of double-precision input values.
+ * @param length Total number of elements in the data array.
+ * @return STATS_SUCCESS on success (also when the batch holds only NaN), or an error code.
+ */
+StatisticsErrorCode running_statistics_update(RunningStatistics *restrict acc,
+                                              const double *restrict data,
+                                              size_t length);
+
+/**
+ * @brief Adds the valid elements of a batch to a running accumulator.
+ * @param acc Pointer to the accumulator to update.
+ * @param data Array of double-precision input values.
+ * @param validity Validity bitmap of data, or NULL if every element is valid.
+ * @param length Total number of elements in the data array.
+ * @return STATS_SUCCESS on success (also when no element is valid), or an error code.
+ */
+StatisticsErrorCode running_statistics_update_masked(RunningStatistics *restrict acc,
+                                                     const double *restrict data,
+                                                     const uint64_t *restrict validity,
+                                                     size_t length);
+
+/**
+ * @brief Combines two accumulators (Chan et al. parallel variance update).
+ * @param acc Pointer to the accumulator receiving the combined result.
+ * @param other Pointer to the accumulator to fold into acc.
+ */
+void running_statistics_merge(RunningStatistics *restrict acc,
+                              const RunningStatistics *restrict other);
+
+/**
+ * @brief Derives mean, variance and standard deviation from a running accumulator.
+ * Results match calculate_series_statistics over the concatenation of all batches.
+ * @param acc Pointer to the accumulator.
+ * @param out_stats Pointer to the SeriesStatistics structure where results will be stored.
+ * @return STATS_SUCCESS on success, or STATS_ERR_INSUFFICIENT_DATA if no valid value was seen.
+ */
+StatisticsErrorCode running_statistics_finalize(const RunningStatistics *restrict acc,
+                                                SeriesStatistics *restrict out_stats);
+
 /**
  * @brief Calculates the Simple Moving Average (SMA) over a given period.
  * @param data Array of input values (e.g., stock prices).
@@ -61,6 +154,22 @@ StatisticsErrorCode calculate_series_statistics(const double *restrict data,
 StatisticsErrorCode
 calculate_sma(const double *restrict data, size_t length, int period, double *restrict out_sma);
 
+/**
+ * @brief Calculates the SMA of a series with a validity bitmap.
+ * Windows containing a missing element yield NaN.
+ * @param data Array of input values.
+ * @param validity Validity bitmap of data, or NULL if every element is valid.
+ * @param length Total number of elements in the array.
+ * @param period The sliding window size for the average.
+ * @param out_sma Array where the resulting SMA values will be stored.
+ * @return STATS_SUCCESS on success, or an error code.
+ */
+StatisticsErrorCode calculate_sma_masked(const double *restrict data,
+                                         const uint64_t *restrict validity,
+                                         size_t length,
+                                         int period,
+                                         double *restrict out_sma);
+
 /**
  * @brief Calculates the Exponential Moving Average (EMA) over a given period.
  * @param data Array of input values.
@@ -72,6 +181,22 @@ calculate_sma(const double *restrict data, size_t length, int period, double *re
 StatisticsErrorCode
 calculate_ema(const double *restrict data, size_t length, int period, double *restrict out_ema);
 
+/**
+ * @brief Calculates the EMA of a series with a validity bitmap.
+ * A missing element restarts the average, which is seeded again by the next period values.
+ * @param data Array of input values.
+ * @param validity Validity bitmap of data, or NULL if every element is valid.
+ * @param length Total number of elements in the array.
+ * @param period The smoothing period for the EMA calculation.
+ * @param out_ema Array where the resulting EMA values will be stored.
+ * @return STATS_SUCCESS on success, or an error code.
+ */
+StatisticsErrorCode calculate_ema_masked(const double *restrict data,
+                                         const uint64_t *restrict validity,
+                                         size_t length,
+                                         int period,
+                                         double *restrict out_ema);
+
 /**
  * @brief Generates standard trading signals (BUY, SELL, HOLD) based on price vs. SMA crossovers.
  * @param prices Array of input price values.
@@ -98,6 +223,22 @@ StatisticsErrorCode calculate_rolling_std(const double *restrict data,
                                           int period,
                                           double *restrict out_std);
 
+/**
+ * @brief Calculates the rolling sample standard deviation of a series with a validity bitmap.
+ * Each window uses its valid elements; fewer than two yield NaN.
+ * @param data Array of double-precision input values.
+ * @param validity Validity bitmap of data, or NULL if every element is valid.
+ * @param length Total number of elements in the data array.
+ * @param period The sliding window size.
+ * @param out_std Array where the resulting rolling standard deviation values will be stored.
+ * @return STATS_SUCCESS on success, or an error code.
+ */
+StatisticsErrorCode calculate_rolling_std_masked(const double *restrict data,
+                                                 const uint64_t *restrict validity,
+                                                 size_t length,
+                                                 int period,
+                                                 double *restrict out_std);
+
 /**
  * @brief Calculates Bollinger Bands based on a given SMA (m) and rolling standard deviation (𝜎).
  * The bands describe the dynamic boundaries of the N(m, 𝜎) normal distribution.
@@ -130,6 +271,23 @@ StatisticsErrorCode calculate_covariance(const double *restrict data_x,
                                          size_t length,
                                          double *restrict out_covariance);
 
+/**
+ * @brief Calculates the sample covariance over the pairs valid in both validity bitmaps.
+ * @param data_x First array of input values.
+ * @param validity_x Validity bitmap of data_x, or NULL if every element is valid.
+ * @param data_y Second array of input values.
+ * @param validity_y Validity bitmap of data_y, or NULL if every element is valid.
+ * @param length Number of elements in both arrays.
+ * @param out_covariance Pointer to store the resulting sample covariance.
+ * @return STATS_SUCCESS on success, or an error code.
+ */
+StatisticsErrorCode calculate_covariance_masked(const double *restrict data_x,
+                                                const uint64_t *restrict validity_x,
+                                                const double *restrict data_y,
+                                                const uint64_t *restrict validity_y,
+                                                size_t length,
+                                                double *restrict out_covariance);
+
 /**
  * @brief Calculates the Pearson correlation coefficient between two time series.
  * Mapped between -1.0 (perfect inverse correlation) and 1.0 (perfect correlation).
@@ -144,4 +302,21 @@ StatisticsErrorCode calculate_correlation(const double *restrict data_x,
                                           size_t length,
                                           double *restrict out_correlation);
 
+/**
+ * @brief Calculates the Pearson correlation over the pairs valid in both validity bitmaps.
+ * @param data_x First array of input values.
+ * @param validity_x Validity bitmap of data_x, or NULL if every element is valid.
+ * @param data_y Second array of input values.
+ * @param validity_y Validity bitmap of data_y, or NULL if every element is valid.
+ * @param length Number of elements in both arrays.
+ * @param out_correlation Pointer to store the resulting correlation.
+ * @return STATS_SUCCESS on success, or an error code.
+ */
+StatisticsErrorCode calculate_correlation_masked(const double *restrict data_x,
+                                                 const uint64_t *restrict validity_x,
+                                                 const double *restrict data_y,
+                                                 const uint64_t *restrict validity_y,
+                                                 size_t length,
+                                                 double *restrict out_correlation);
+
 #endif
@@ -0,0 +1,72 @@
+#ifndef STATISTICALDATAPROCESSOR_STRING_DICTIONARY_H
+#define STATISTICALDATAPROCESSOR_STRING_DICTIONARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "memory_utils.h"
+
+/**
+ * @file string_dictionary.h
+ * @brief Interning of repeated strings into dense integer codes.
+ *
+ * A dictionary assigns consecutive int32 codes (0, 1, 2, ...) to distinct
+ * strings in order of first appearance. Lookups go through an open-addressing
+ * hash table, and every distinct value is stored once in the dictionary's own
+ * arena. Columns with few distinct values can therefore store one code per
+ * cell, and equality tests or grouping become integer comparisons.
+ */
+
+/**
+ * @brief A growable set of distinct strings addressed by dense int32 codes.
+ */
+typedef struct {
+    char **values;       /*!< Distinct strings indexed by code (null-terminated). */
+    size_t *lengths;     /*!< Length of each distinct string. */
+    uint64_t *hashes;    /*!< Hash of each distinct string, reused when the table grows. */
+    int32_t count;       /*!< Number of distinct strings. */
+    int32_t capacity;    /*!< Number of entries allocated in values, lengths and hashes. */
+    int32_t *slots;      /*!< Hash table of codes (-1 marks an empty slot). */
+    size_t slot_count;   /*!< Number of hash table slots (a power of two). */
+    MemoryArena storage; /*!< Arena owning the characters of every value. */
+} StringDictionary;
+
+/**
+ * @brief Allocates an empty dictionary.
+ * @return The new dictionary, or NULL if allocation fails.
+ */
+StringDictionary *string_dictionary_create(void);
+
+/**
+ * @brief Returns the code of a string, adding it to the dictionary if it is new.
+ * @param dict The dictionary.
+ * @param str The characters of the string (need not be null-terminated).
+ * @param len The number of characters.
+ * @return The string's code, or -1 if allocation fails.
+ */
+int32_t string_dictionary_intern(StringDictionary *dict, const char *str, size_t len);
+
+/**
+ * @brief Looks up the code of a string without modifying the dictionary.
+ * @param dict The dictionary.
+ * @param str The characters of the string (need not be null-terminated).
+ * @param len The number of characters.
+ * @return The string's code, or -1 if it is not in the dictionary.
+ */
+int32_t string_dictionary_find(const StringDictionary *dict, const char *str, size_t len);
+
+/**
+ * @brief Returns the string stored under a code.
+ * @param dict The dictionary.
+ * @param code A code returned by string_dictionary_intern.
+ * @return The null-terminated string, or NULL if the code is out of range.
+ */
+const char *string_dictionary_value(const StringDictionary *dict, int32_t code);
+
+/**
+ * @brief Frees a dictionary and all of its strings.
+ * @param dict The dictionary to free. If NULL, the function does nothing.
+ */
+void string_dictionary_free(StringDictionary *dict);
+
+#endif // STATISTICALDATAPROCESSOR_STRING_DICTIONARY_H
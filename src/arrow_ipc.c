@@ -0,0 +1,1838 @@
+#include "arrow_ipc.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "file_mapping.h"
+#include "memory_utils.h"
+
+/**
+ * @brief Leading and trailing bytes of the file format (padded to 8 bytes at the start).
+ */
+static const char ARROW_FILE_MAGIC[6] = {'A', 'R', 'R', 'O', 'W', '1'};
+
+/**
+ * @brief Marks the start of an encapsulated message; a zero length after it ends the stream.
+ */
+#define ARROW_CONTINUATION 0xFFFFFFFFu
+
+/**
+ * @brief Alignment of message bodies and of every buffer within them.
+ */
+#define ARROW_ALIGNMENT 64
+
+/**
+ * @brief Number of values converted and written per fwrite call (a multiple of 8).
+ */
+#define ARROW_WRITE_CHUNK 1024
+
+/**
+ * @brief Most fields of any metadata table written here.
+ */
+#define FB_MAX_FIELDS 8
+
+/* Values of the enums and unions of Arrow's Schema.fbs and Message.fbs */
+enum { ARROW_METADATA_V4 = 3, ARROW_METADATA_V5 = 4 };
+enum { ARROW_HEADER_SCHEMA = 1, ARROW_HEADER_DICTIONARY_BATCH = 2, ARROW_HEADER_RECORD_BATCH = 3 };
+enum {
+    ARROW_TYPE_INT = 2,
+    ARROW_TYPE_FLOATING_POINT = 3,
+    ARROW_TYPE_UTF8 = 5,
+    ARROW_TYPE_BOOL = 6,
+    ARROW_TYPE_DATE = 8,
+    ARROW_TYPE_TIMESTAMP = 10,
+    ARROW_TYPE_LARGE_UTF8 = 20
+};
+enum { ARROW_PRECISION_SINGLE = 1, ARROW_PRECISION_DOUBLE = 2 };
+enum { ARROW_DATE_DAY = 0, ARROW_DATE_MILLISECOND = 1 };
+enum { ARROW_TIME_NANOSECOND = 3 };
+enum { ARROW_ENDIAN_LITTLE = 0 };
+
+/**
+ * @brief Location of a buffer within a message body.
+ */
+typedef struct {
+    uint64_t offset; /*!< Offset from the start of the body. */
+    uint64_t length; /*!< Number of bytes. */
+} ArrowBuffer;
+
+/**
+ * @brief Location of a message in the file format, as listed in the footer.
+ */
+typedef struct {
+    uint64_t offset;          /*!< Offset of the message's continuation marker in the file. */
+    uint32_t metadata_length; /*!< Prefix and padded metadata, in bytes. */
+    uint64_t body_length;     /*!< Number of body bytes. */
+} ArrowBlock;
+
+/**
+ * @brief Per-column facts gathered before anything is written.
+ */
+typedef struct {
+    uint64_t null_count; /*!< Number of missing values. */
+    uint64_t text_bytes; /*!< Bytes of all strings (TYPE_STRING) or dictionary values. */
+    bool large_text;     /*!< Text needs 64-bit offsets (LargeUtf8). */
+} ArrowColumnPlan;
+
+/**
+ * @brief Output stream that tracks its position and remembers failed writes.
+ */
+typedef struct {
+    FILE *file;   /*!< The destination. */
+    uint64_t pos; /*!< Number of bytes written so far. */
+    bool ok;      /*!< False once a write failed; later writes are skipped. */
+} ArrowSink;
+
+/**
+ * @brief Growable buffer in which one FlatBuffers object graph is laid out front to back.
+ *
+ * Usual FlatBuffers builders work back to front. Here every object is
+ * appended after its parent and the parent's offset field is patched once
+ * the child exists, which equally keeps all unsigned offsets pointing forward.
+ */
+typedef struct {
+    unsigned char *data; /*!< The bytes so far. */
+    size_t size;         /*!< Number of bytes used. */
+    size_t capacity;     /*!< Number of bytes allocated. */
+    bool failed;         /*!< Set when an allocation failed; later calls do nothing. */
+} FbBuilder;
+
+/**
+ * @brief A table appended to an FbBuilder, with the positions of its fields.
+ */
+typedef struct {
+    size_t pos;                   /*!< Position of the table. */
+    size_t fields[FB_MAX_FIELDS]; /*!< Position of every present field by field id. */
+} FbTable;
+
+/**
+ * @brief Read-only view of a FlatBuffers buffer; every access is bounds-checked.
+ */
+typedef struct {
+    const unsigned char *data; /*!< First byte of the buffer. */
+    size_t size;               /*!< Number of bytes. */
+} FbView;
+
+/**
+ * @brief Rounds a position up to a multiple of an alignment.
+ * @param value The position.
+ * @param alignment The alignment (a power of two).
+ * @return The aligned position.
+ */
+static uint64_t align_up(const uint64_t value, const uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Reads an unsigned little-endian integer.
+ * @param bytes The first byte.
+ * @param size The number of bytes (at most 8).
+ * @return The value.
+ */
+static uint64_t load_le(const unsigned char *bytes, const size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        value |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief Stores an integer in little-endian byte order.
+ * @param bytes The first byte of the destination.
+ * @param value The value (truncated to size bytes).
+ * @param size The number of bytes (at most 8).
+ */
+static void store_le(unsigned char *bytes, const uint64_t value, const size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Extends the builder to cover an object at a given position, zero-filling the gap.
+ * @param b The builder.
+ * @param pos The position of the object (not below the current size).
+ * @param size The size of the object.
+ * @return pos, or 0 if the builder has failed.
+ */
+static size_t fb_reserve_at(FbBuilder *b, const size_t pos, const size_t size)
+{
+    if (b->failed)
+        return 0;
+
+    if (pos + size > b->capacity) {
+        size_t capacity = b->capacity ? b->capacity : 256;
+        while (capacity < pos + size) {
+            capacity *= 2;
+        }
+        unsigned char *grown = realloc(b->data, capacity);
+        if (!grown) {
+            b->failed = true;
+            return 0;
+        }
+        b->data = grown;
+        b->capacity = capacity;
+    }
+
+    memset(b->data + b->size, 0, pos + size - b->size);
+    b->size = pos + size;
+    return pos;
+}
+
+/**
+ * @brief Appends a zeroed object.
+ * @param b The builder.
+ * @param size The size of the object.
+ * @param alignment The alignment of the object (a power of two).
+ * @return The position of the object.
+ */
+static size_t fb_reserve(FbBuilder *b, const size_t size, const size_t alignment)
+{
+    return fb_reserve_at(b, (size_t)align_up(b->size, alignment), size);
+}
+
+/**
+ * @brief Writes a scalar at a reserved position.
+ * @param b The builder.
+ * @param pos The position.
+ * @param value The value (truncated to size bytes).
+ * @param size The number of bytes.
+ */
+static void fb_put(FbBuilder *b, const size_t pos, const uint64_t value, const size_t size)
+{
+    if (!b->failed)
+        store_le(b->data + pos, value, size);
+}
+
+/**
+ * @brief Points an offset field (or offset vector element) at a later object.
+ * @param b The builder.
+ * @param field The position of the 4-byte offset.
+ * @param target The position of the object, after field.
+ */
+static void fb_link(FbBuilder *b, const size_t field, const size_t target)
+{
+    fb_put(b, field, target - field, 4);
+}
+
+/**
+ * @brief Appends a table and its vtable, with every field zeroed.
+ * @param b The builder.
+ * @param sizes The size of every field by field id (0 for absent fields).
+ * @param count The number of field ids (at most FB_MAX_FIELDS).
+ * @return The table; scalars are then written with fb_put and offsets with fb_link.
+ */
+static FbTable fb_table(FbBuilder *b, const uint8_t *sizes, const int count)
+{
+    FbTable table = {0};
+    const size_t vtable = fb_reserve(b, 4 + 2 * (size_t)count, 2);
+
+    table.pos = fb_reserve(b, 4, 4);
+    for (int i = 0; i < count; i++) {
+        if (sizes[i])
+            table.fields[i] = fb_reserve(b, sizes[i], sizes[i]);
+    }
+
+    fb_put(b, vtable, 4 + 2 * (uint64_t)count, 2);
+    fb_put(b, vtable + 2, b->size - table.pos, 2);
+    for (int i = 0; i < count; i++) {
+        if (sizes[i])
+            fb_put(b, vtable + 4 + 2 * (size_t)i, table.fields[i] - table.pos, 2);
+    }
+    fb_put(b, table.pos, table.pos - vtable, 4);
+    return table;
+}
+
+/**
+ * @brief Appends a vector with zeroed elements.
+ * @param b The builder.
+ * @param count The number of elements.
+ * @param element_size The size of one element (4 for offsets to tables).
+ * @param alignment The alignment of the elements (at least 4).
+ * @return The position of the vector; its elements follow 4 bytes later.
+ */
+static size_t fb_vector(FbBuilder *b,
+                        const size_t count,
+                        const size_t element_size,
+                        const size_t alignment)
+{
+    /* The length precedes the elements, which carry the alignment */
+    const size_t pos = (size_t)align_up(b->size + 4, alignment) - 4;
+    const size_t vector = fb_reserve_at(b, pos, 4 + count * element_size);
+    fb_put(b, vector, count, 4);
+    return vector;
+}
+
+/**
+ * @brief Appends a null-terminated string.
+ * @param b The builder.
+ * @param str The string.
+ * @return The position of the string.
+ */
+static size_t fb_string(FbBuilder *b, const char *str)
+{
+    const size_t len = strlen(str);
+    const size_t pos = fb_reserve(b, 4 + len + 1, 4);
+    fb_put(b, pos, len, 4);
+    if (!b->failed)
+        memcpy(b->data + pos + 4, str, len);
+    return pos;
+}
+
+/**
+ * @brief Locates a field of a table.
+ * @param v The buffer.
+ * @param table The position of the table.
+ * @param id The field id.
+ * @return The position of the field, or 0 if it is absent or the table is malformed.
+ */
+static size_t fb_field(const FbView *v, const size_t table, const int id)
+{
+    if (v->size < 4 || table == 0 || table > v->size - 4)
+        return 0;
+
+    const int64_t vtable = (int64_t)table - (int32_t)load_le(v->data + table, 4);
+    if (vtable < 0 || (uint64_t)vtable > v->size - 4)
+        return 0;
+
+    const size_t vtable_size = (size_t)load_le(v->data + vtable, 2);
+    const size_t entry = 4 + 2 * (size_t)id;
+    if (entry + 2 > vtable_size || (uint64_t)vtable + vtable_size > v->size)
+        return 0;
+
+    const size_t offset = (size_t)load_le(v->data + vtable + entry, 2);
+    return offset && table + offset < v->size ? table + offset : 0;
+}
+
+/**
+ * @brief Reads a signed scalar field of a table.
+ * @param v The buffer.
+ * @param table The position of the table.
+ * @param id The field id.
+ * @param size The size of the scalar in bytes.
+ * @param default_value Returned when the field is absent.
+ * @return The sign-extended value.
+ */
+static int64_t fb_int(const FbView *v,
+                      const size_t table,
+                      const int id,
+                      const size_t size,
+                      const int64_t default_value)
+{
+    const size_t pos = fb_field(v, table, id);
+    if (!pos || size > v->size - pos)
+        return default_value;
+
+    uint64_t value = load_le(v->data + pos, size);
+    if (size < 8 && (value >> (8 * size - 1) & 1))
+        value |= ~0ULL << (8 * size);
+    return (int64_t)value;
+}
+
+/**
+ * @brief Follows an offset field of a table.
+ * @param v The buffer.
+ * @param table The position of the table.
+ * @param id The field id.
+ * @return The position of the referenced object, or 0 if it is absent or out of bounds.
+ */
+static size_t fb_ref(const FbView *v, const size_t table, const int id)
+{
+    const size_t pos = fb_field(v, table, id);
+    if (!pos || pos > v->size - 4)
+        return 0;
+
+    const uint64_t target = pos + load_le(v->data + pos, 4);
+    return target <= v->size - 4 ? (size_t)target : 0;
+}
+
+/**
+ * @brief Validates a vector and locates its elements.
+ * @param v The buffer.
+ * @param vector The position of the vector (0 if absent).
+ * @param element_size The size of one element.
+ * @param out_count Receives the number of elements.
+ * @return The position of the first element, or 0 if the vector is absent or out of bounds.
+ */
+static size_t fb_elements(const FbView *v,
+                          const size_t vector,
+                          const size_t element_size,
+                          size_t *out_count)
+{
+    if (!vector)
+        return 0;
+
+    const uint64_t count = load_le(v->data + vector, 4);
+    if (count > (v->size - vector - 4) / element_size)
+        return 0;
+
+    *out_count = (size_t)count;
+    return vector + 4;
+}
+
+/**
+ * @brief Follows one element of a vector of tables.
+ * @param v The buffer.
+ * @param elements The position of the first element.
+ * @param index The element index (below the vector's count).
+ * @return The position of the table, or 0 if it is out of bounds.
+ */
+static size_t fb_element_ref(const FbView *v, const size_t elements, const size_t index)
+{
+    const size_t pos = elements + 4 * index;
+    const uint64_t target = pos + load_le(v->data + pos, 4);
+    return target <= v->size - 4 ? (size_t)target : 0;
+}
+
+/**
+ * @brief Writes bytes to a sink.
+ * @param sink The sink.
+ * @param data The bytes.
+ * @param size The number of bytes.
+ */
+static void sink_write(ArrowSink *sink, const void *data, const size_t size)
+{
+    if (sink->ok && size && fwrite(data, 1, size, sink->file) != size)
+        sink->ok = false;
+    sink->pos += size;
+}
+
+/**
+ * @brief Writes zero bytes until a sink reaches a position.
+ * @param sink The sink.
+ * @param target The position to reach (not below the current one).
+ */
+static void sink_pad_to(ArrowSink *sink, const uint64_t target)
+{
+    static const unsigned char zeros[ARROW_ALIGNMENT] = {0};
+
+    while (sink->pos < target) {
+        const uint64_t gap = target - sink->pos;
+        sink_write(sink, zeros, gap < sizeof(zeros) ? (size_t)gap : sizeof(zeros));
+    }
+}
+
+/**
+ * @brief Writes a 32-bit little-endian integer to a sink.
+ * @param sink The sink.
+ * @param value The value.
+ */
+static void sink_u32(ArrowSink *sink, const uint32_t value)
+{
+    unsigned char bytes[4];
+    store_le(bytes, value, sizeof(bytes));
+    sink_write(sink, bytes, sizeof(bytes));
+}
+
+/**
+ * @brief Returns one string of a text column or of a category column's dictionary.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ * @param index The row (TYPE_STRING) or dictionary code (TYPE_CATEGORY).
+ * @param out_len Receives the length of the string.
+ * @return The string, or NULL (with length 0) for a missing value.
+ */
+static const char *text_value(const DataFrame *df, const int col, const int index, size_t *out_len)
+{
+    if (df->col_types[col] == TYPE_CATEGORY) {
+        const StringDictionary *dict = df->dictionaries[col];
+        *out_len = dict->lengths[index];
+        return dict->values[index];
+    }
+
+    const char *str = dataframe_get_cell(df, index, col).v_str;
+    *out_len = str ? strlen(str) : 0;
+    return str;
+}
+
+/**
+ * @brief Returns the number of strings text_value can return for a column.
+ * @param df The DataFrame.
+ * @param col The zero-based column index (TYPE_STRING or TYPE_CATEGORY).
+ * @return The number of rows, or the size of the column's dictionary.
+ */
+static int text_count(const DataFrame *df, const int col)
+{
+    if (df->col_types[col] != TYPE_CATEGORY)
+        return df->rows;
+    return df->dictionaries && df->dictionaries[col] ? df->dictionaries[col]->count : 0;
+}
+
+/**
+ * @brief Counts missing values and text bytes of every column.
+ * @param df The DataFrame.
+ * @param plans Receives one plan per column.
+ */
+static void plan_columns(const DataFrame *df, ArrowColumnPlan *plans)
+{
+    for (int c = 0; c < df->cols; c++) {
+        ArrowColumnPlan *plan = &plans[c];
+        for (int r = 0; r < df->rows; r++) {
+            plan->null_count += dataframe_cell_is_null(df, r, c);
+        }
+
+        if (df->col_types[c] == TYPE_STRING || df->col_types[c] == TYPE_CATEGORY) {
+            const int count = text_count(df, c);
+            for (int i = 0; i < count; i++) {
+                size_t len;
+                text_value(df, c, i, &len);
+                plan->text_bytes += len;
+            }
+            plan->large_text = plan->text_bytes > INT32_MAX;
+        }
+    }
+}
+
+/**
+ * @brief Appends a buffer to a body layout.
+ * @param buffers The layout; receives the buffer.
+ * @param count The number of buffers so far; incremented.
+ * @param body_length The body length so far; advanced past the buffer.
+ * @param length The length of the buffer.
+ */
+static void add_buffer(ArrowBuffer *buffers,
+                       size_t *count,
+                       uint64_t *body_length,
+                       const uint64_t length)
+{
+    buffers[*count].offset = align_up(*body_length, ARROW_ALIGNMENT);
+    buffers[*count].length = length;
+    *body_length = buffers[*count].offset + length;
+    (*count)++;
+}
+
+/**
+ * @brief Appends the type table of a column.
+ * @param b The builder.
+ * @param type The column type.
+ * @param plan The column's plan.
+ * @param out_type_id Receives the member of Arrow's Type union.
+ * @return The position of the type table.
+ */
+static size_t add_type(FbBuilder *b,
+                       const DataType type,
+                       const ArrowColumnPlan *plan,
+                       uint8_t *out_type_id)
+{
+    static const uint8_t int_fields[] = {4, 1};
+    static const uint8_t unit_fields[] = {2};
+    static const uint8_t timestamp_fields[] = {2, 4};
+    FbTable table;
+
+    switch (type) {
+    case TYPE_NUMERIC:
+        *out_type_id = ARROW_TYPE_FLOATING_POINT;
+        table = fb_table(b, unit_fields, 1);
+        fb_put(b, table.fields[0], ARROW_PRECISION_DOUBLE, 2);
+        break;
+    case TYPE_INT64:
+        *out_type_id = ARROW_TYPE_INT;
+        table = fb_table(b, int_fields, 2);
+        fb_put(b, table.fields[0], 64, 4);
+        fb_put(b, table.fields[1], 1, 1);
+        break;
+    case TYPE_DATE:
+        *out_type_id = ARROW_TYPE_DATE;
+        table = fb_table(b, unit_fields, 1);
+        fb_put(b, table.fields[0], ARROW_DATE_DAY, 2);
+        break;
+    case TYPE_TIMESTAMP:
+        *out_type_id = ARROW_TYPE_TIMESTAMP;
+        table = fb_table(b, timestamp_fields, 2);
+        fb_put(b, table.fields[0], ARROW_TIME_NANOSECOND, 2);
+        fb_link(b, table.fields[1], fb_string(b, "UTC"));
+        break;
+    default:
+        /* Text and the values of dictionary-encoded columns; the type has no fields */
+        *out_type_id = plan->large_text ? ARROW_TYPE_LARGE_UTF8 : ARROW_TYPE_UTF8;
+        table = fb_table(b, NULL, 0);
+        break;
+    }
+    return table.pos;
+}
+
+/**
+ * @brief Appends the Field table describing one column.
+ * @param b The builder.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ * @param plan The column's plan.
+ * @return The position of the table.
+ */
+static size_t add_field(FbBuilder *b,
+                        const DataFrame *df,
+                        const int col,
+                        const ArrowColumnPlan *plan)
+{
+    static const uint8_t dictionary_fields[] = {8, 4, 1};
+    static const uint8_t int_fields[] = {4, 1};
+    const bool encoded = df->col_types[col] == TYPE_CATEGORY;
+
+    /* name, nullable, type_type, type, dictionary, children */
+    const uint8_t sizes[] = {4, 1, 1, 4, encoded ? 4 : 0, 4};
+    const FbTable field = fb_table(b, sizes, 6);
+    fb_put(b, field.fields[1], 1, 1);
+    fb_link(b, field.fields[0], fb_string(b, df->columns[col] ? df->columns[col] : ""));
+
+    uint8_t type_id;
+    fb_link(b, field.fields[3], add_type(b, df->col_types[col], plan, &type_id));
+    fb_put(b, field.fields[2], type_id, 1);
+
+    if (encoded) {
+        /* The dictionary id is the column index; indices are signed 32-bit codes */
+        const FbTable dictionary = fb_table(b, dictionary_fields, 3);
+        fb_put(b, dictionary.fields[0], (uint64_t)col, 8);
+        const FbTable index_type = fb_table(b, int_fields, 2);
+        fb_put(b, index_type.fields[0], 32, 4);
+        fb_put(b, index_type.fields[1], 1, 1);
+        fb_link(b, dictionary.fields[1], index_type.pos);
+        fb_link(b, field.fields[4], dictionary.pos);
+    }
+
+    /* Readers require the children vector even for flat types */
+    fb_link(b, field.fields[5], fb_vector(b, 0, 4, 4));
+    return field.pos;
+}
+
+/**
+ * @brief Appends the Schema table of a frame.
+ * @param b The builder.
+ * @param df The DataFrame.
+ * @param plans The column plans.
+ * @return The position of the table.
+ */
+static size_t add_schema(FbBuilder *b, const DataFrame *df, const ArrowColumnPlan *plans)
+{
+    static const uint8_t sizes[] = {2, 4};
+    const FbTable schema = fb_table(b, sizes, 2);
+    fb_put(b, schema.fields[0], ARROW_ENDIAN_LITTLE, 2);
+
+    const size_t fields = fb_vector(b, (size_t)df->cols, 4, 4);
+    fb_link(b, schema.fields[1], fields);
+    for (int c = 0; c < df->cols; c++) {
+        fb_link(b, fields + 4 + 4 * (size_t)c, add_field(b, df, c, &plans[c]));
+    }
+    return schema.pos;
+}
+
+/**
+ * @brief Appends a RecordBatch table with one field node per column.
+ * @param b The builder.
+ * @param length The number of rows.
+ * @param null_counts The number of missing values of every column.
+ * @param columns The number of columns.
+ * @param buffers The body layout.
+ * @param buffer_count The number of buffers.
+ * @return The position of the table.
+ */
+static size_t add_record_batch(FbBuilder *b,
+                               const uint64_t length,
+                               const uint64_t *null_counts,
+                               const size_t columns,
+                               const ArrowBuffer *buffers,
+                               const size_t buffer_count)
+{
+    static const uint8_t sizes[] = {8, 4, 4};
+    const FbTable batch = fb_table(b, sizes, 3);
+    fb_put(b, batch.fields[0], length, 8);
+
+    const size_t nodes = fb_vector(b, columns, 16, 8);
+    fb_link(b, batch.fields[1], nodes);
+    for (size_t i = 0; i < columns; i++) {
+        fb_put(b, nodes + 4 + 16 * i, length, 8);
+        fb_put(b, nodes + 12 + 16 * i, null_counts[i], 8);
+    }
+
+    const size_t vector = fb_vector(b, buffer_count, 16, 8);
+    fb_link(b, batch.fields[2], vector);
+    for (size_t i = 0; i < buffer_count; i++) {
+        fb_put(b, vector + 4 + 16 * i, buffers[i].offset, 8);
+        fb_put(b, vector + 12 + 16 * i, buffers[i].length, 8);
+    }
+    return batch.pos;
+}
+
+/**
+ * @brief Starts a new Message in a builder, discarding what it held.
+ * @param b The builder.
+ * @param header_type The member of the MessageHeader union.
+ * @param body_length The number of body bytes that follow the message.
+ * @return The position of the header offset field, to be linked to the header table.
+ */
+static size_t begin_message(FbBuilder *b, const int header_type, const uint64_t body_length)
+{
+    static const uint8_t sizes[] = {2, 1, 4, 8};
+
+    b->size = 0;
+    const size_t root = fb_reserve(b, 4, 4);
+    const FbTable message = fb_table(b, sizes, 4);
+    fb_link(b, root, message.pos);
+    fb_put(b, message.fields[0], ARROW_METADATA_V5, 2);
+    fb_put(b, message.fields[1], (uint64_t)header_type, 1);
+    fb_put(b, message.fields[3], body_length, 8);
+    return message.fields[2];
+}
+
+/**
+ * @brief Writes the framed metadata of a message; the caller writes the body next.
+ *
+ * The metadata is padded so that the body starts ARROW_ALIGNMENT-aligned in
+ * the output, which lets readers use mapped buffers in place.
+ *
+ * @param sink The sink.
+ * @param meta The built message.
+ * @param body_length The number of body bytes.
+ * @param out_block Receives the message's location (may be NULL).
+ */
+static void write_message(ArrowSink *sink,
+                          const FbBuilder *meta,
+                          const uint64_t body_length,
+                          ArrowBlock *out_block)
+{
+    if (meta->failed) {
+        sink->ok = false;
+        return;
+    }
+
+    const uint64_t start = sink->pos;
+    const uint64_t padded = align_up(start + 8 + meta->size, ARROW_ALIGNMENT) - start - 8;
+    sink_u32(sink, ARROW_CONTINUATION);
+    sink_u32(sink, (uint32_t)padded);
+    sink_write(sink, meta->data, meta->size);
+    sink_pad_to(sink, start + 8 + padded);
+
+    if (out_block) {
+        out_block->offset = start;
+        out_block->metadata_length = (uint32_t)(8 + padded);
+        out_block->body_length = body_length;
+    }
+}
+
+/**
+ * @brief Writes the validity bitmap of a column.
+ * @param sink The sink.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ */
+static void write_validity(ArrowSink *sink, const DataFrame *df, const int col)
+{
+    unsigned char chunk[ARROW_WRITE_CHUNK / 8];
+
+    for (int first = 0; first < df->rows; first += ARROW_WRITE_CHUNK) {
+        const int count =
+            df->rows - first < ARROW_WRITE_CHUNK ? df->rows - first : ARROW_WRITE_CHUNK;
+        const size_t bytes = ((size_t)count + 7) / 8;
+
+        memset(chunk, 0, bytes);
+        for (int i = 0; i < count; i++) {
+            if (!dataframe_cell_is_null(df, first + i, col))
+                chunk[i / 8] |= (unsigned char)(1u << (i % 8));
+        }
+        sink_write(sink, chunk, bytes);
+    }
+}
+
+/**
+ * @brief Writes the values buffer of a fixed-width column (or the indices of a category one).
+ * @param sink The sink.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ */
+static void write_values(ArrowSink *sink, const DataFrame *df, const int col)
+{
+    const DataType type = df->col_types[col];
+    const bool narrow = type == TYPE_DATE || type == TYPE_CATEGORY;
+
+    if (!narrow && df->layout == DATAFRAME_LAYOUT_COLUMNS) {
+        /* Float64, Int64 and nanosecond timestamps are the column array itself */
+        sink_write(sink, df->col_data[col], (size_t)df->rows * sizeof(DataCell));
+        return;
+    }
+
+    DataCell cells[ARROW_WRITE_CHUNK];
+    int32_t values[ARROW_WRITE_CHUNK];
+    for (int first = 0; first < df->rows; first += ARROW_WRITE_CHUNK) {
+        const int count =
+            df->rows - first < ARROW_WRITE_CHUNK ? df->rows - first : ARROW_WRITE_CHUNK;
+
+        for (int i = 0; i < count; i++) {
+            const DataCell cell = dataframe_get_cell(df, first + i, col);
+            if (type == TYPE_DATE)
+                values[i] = cell.v_int == DATAFRAME_NULL_INT64 ? 0 : (int32_t)cell.v_int;
+            else if (type == TYPE_CATEGORY)
+                values[i] = cell.v_code < 0 ? 0 : cell.v_code;
+            else
+                cells[i] = cell;
+        }
+        if (narrow)
+            sink_write(sink, values, (size_t)count * sizeof(int32_t));
+        else
+            sink_write(sink, cells, (size_t)count * sizeof(DataCell));
+    }
+}
+
+/**
+ * @brief Writes the offsets buffer of a text column or category dictionary.
+ * @param sink The sink.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ * @param large Whether to write 64-bit offsets.
+ */
+static void write_offsets(ArrowSink *sink, const DataFrame *df, const int col, const bool large)
+{
+    int64_t wide[ARROW_WRITE_CHUNK];
+    int32_t narrow[ARROW_WRITE_CHUNK];
+    const int count = text_count(df, col);
+    int64_t end = 0;
+    int pending = 0;
+
+    /* count + 1 offsets: the leading zero, then the end of every string */
+    for (int i = -1; i < count; i++) {
+        if (i >= 0) {
+            size_t len;
+            text_value(df, col, i, &len);
+            end += (int64_t)len;
+        }
+        wide[pending] = end;
+        narrow[pending] = (int32_t)end;
+
+        if (++pending == ARROW_WRITE_CHUNK || i == count - 1) {
+            if (large)
+                sink_write(sink, wide, (size_t)pending * sizeof(int64_t));
+            else
+                sink_write(sink, narrow, (size_t)pending * sizeof(int32_t));
+            pending = 0;
+        }
+    }
+}
+
+/**
+ * @brief Writes the character data of a text column or category dictionary.
+ * @param sink The sink.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ */
+static void write_text(ArrowSink *sink, const DataFrame *df, const int col)
+{
+    const int count = text_count(df, col);
+    for (int i = 0; i < count; i++) {
+        size_t len;
+        const char *str = text_value(df, col, i, &len);
+        sink_write(sink, str, len);
+    }
+}
+
+/**
+ * @brief Writes the dictionary of a TYPE_CATEGORY column as a DictionaryBatch message.
+ * @param sink The sink.
+ * @param meta The builder to use.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ * @param plan The column's plan.
+ * @param out_block Receives the message's location.
+ */
+static void write_dictionary_batch(ArrowSink *sink,
+                                   FbBuilder *meta,
+                                   const DataFrame *df,
+                                   const int col,
+                                   const ArrowColumnPlan *plan,
+                                   ArrowBlock *out_block)
+{
+    static const uint8_t sizes[] = {8, 4, 1};
+    const uint64_t count = (uint64_t)text_count(df, col);
+    const uint64_t null_count = 0;
+
+    ArrowBuffer buffers[3];
+    size_t buffer_count = 0;
+    uint64_t body_length = 0;
+    add_buffer(buffers, &buffer_count, &body_length, 0);
+    add_buffer(buffers, &buffer_count, &body_length, (count + 1) * (plan->large_text ? 8 : 4));
+    add_buffer(buffers, &buffer_count, &body_length, plan->text_bytes);
+    body_length = align_up(body_length, 8);
+
+    const size_t header = begin_message(meta, ARROW_HEADER_DICTIONARY_BATCH, body_length);
+    const FbTable batch = fb_table(meta, sizes, 3);
+    fb_link(meta, header, batch.pos);
+    fb_put(meta, batch.fields[0], (uint64_t)col, 8);
+    fb_link(meta, batch.fields[1],
+            add_record_batch(meta, count, &null_count, 1, buffers, buffer_count));
+    write_message(sink, meta, body_length, out_block);
+
+    const uint64_t start = sink->pos;
+    sink_pad_to(sink, start + buffers[1].offset);
+    write_offsets(sink, df, col, plan->large_text);
+    sink_pad_to(sink, start + buffers[2].offset);
+    write_text(sink, df, col);
+    sink_pad_to(sink, start + body_length);
+}
+
+/**
+ * @brief Writes all rows of a frame as one RecordBatch message.
+ * @param sink The sink.
+ * @param meta The builder to use.
+ * @param df The DataFrame.
+ * @param plans The column plans.
+ * @param buffers Scratch space for 3 buffers per column.
+ * @param null_counts Scratch space for one count per column.
+ * @param out_block Receives the message's location.
+ */
+static void write_record_batch(ArrowSink *sink,
+                               FbBuilder *meta,
+                               const DataFrame *df,
+                               const ArrowColumnPlan *plans,
+                               ArrowBuffer *buffers,
+                               uint64_t *null_counts,
+                               ArrowBlock *out_block)
+{
+    const uint64_t rows = (uint64_t)df->rows;
+    size_t buffer_count = 0;
+    uint64_t body_length = 0;
+
+    for (int c = 0; c < df->cols; c++) {
+        null_counts[c] = plans[c].null_count;
+        add_buffer(buffers, &buffer_count, &body_length,
+                   plans[c].null_count ? (rows + 7) / 8 : 0);
+
+        switch (df->col_types[c]) {
+        case TYPE_STRING:
+            add_buffer(buffers, &buffer_count, &body_length,
+                       (rows + 1) * (plans[c].large_text ? 8 : 4));
+            add_buffer(buffers, &buffer_count, &body_length, plans[c].text_bytes);
+            break;
+        case TYPE_DATE:
+        case TYPE_CATEGORY:
+            add_buffer(buffers, &buffer_count, &body_length, rows * sizeof(int32_t));
+            break;
+        default:
+            add_buffer(buffers, &buffer_count, &body_length, rows * sizeof(DataCell));
+            break;
+        }
+    }
+    body_length = align_up(body_length, 8);
+
+    const size_t header = begin_message(meta, ARROW_HEADER_RECORD_BATCH, body_length);
+    fb_link(meta, header,
+            add_record_batch(meta, rows, null_counts, (size_t)df->cols, buffers, buffer_count));
+    write_message(sink, meta, body_length, out_block);
+
+    const uint64_t start = sink->pos;
+    const ArrowBuffer *buffer = buffers;
+    for (int c = 0; c < df->cols; c++) {
+        if (plans[c].null_count) {
+            sink_pad_to(sink, start + buffer->offset);
+            write_validity(sink, df, c);
+        }
+        buffer++;
+
+        sink_pad_to(sink, start + buffer->offset);
+        if (df->col_types[c] == TYPE_STRING) {
+            write_offsets(sink, df, c, plans[c].large_text);
+            buffer++;
+            sink_pad_to(sink, start + buffer->offset);
+            write_text(sink, df, c);
+        } else {
+            write_values(sink, df, c);
+        }
+        buffer++;
+    }
+    sink_pad_to(sink, start + body_length);
+}
+
+/**
+ * @brief Writes the footer of the file format, followed by its length and the magic bytes.
+ * @param sink The sink, positioned after the end-of-stream marker.
+ * @param meta The builder to use.
+ * @param df The DataFrame.
+ * @param plans The column plans.
+ * @param blocks The dictionary batches, followed by the record batch.
+ * @param dictionary_count The number of dictionary batches.
+ */
+static void write_footer(ArrowSink *sink,
+                         FbBuilder *meta,
+                         const DataFrame *df,
+                         const ArrowColumnPlan *plans,
+                         const ArrowBlock *blocks,
+                         const size_t dictionary_count)
+{
+    static const uint8_t sizes[] = {2, 4, 4, 4};
+
+    meta->size = 0;
+    const size_t root = fb_reserve(meta, 4, 4);
+    const FbTable footer = fb_table(meta, sizes, 4);
+    fb_link(meta, root, footer.pos);
+    fb_put(meta, footer.fields[0], ARROW_METADATA_V5, 2);
+    fb_link(meta, footer.fields[1], add_schema(meta, df, plans));
+
+    /* Block structs: offset, metaDataLength (padded to 8 bytes), bodyLength */
+    for (int list = 0; list < 2; list++) {
+        const size_t first = list == 0 ? 0 : dictionary_count;
+        const size_t count = list == 0 ? dictionary_count : 1;
+        const size_t vector = fb_vector(meta, count, 24, 8);
+        fb_link(meta, footer.fields[2 + list], vector);
+        for (size_t i = 0; i < count; i++) {
+            const ArrowBlock *block = &blocks[first + i];
+            fb_put(meta, vector + 4 + 24 * i, block->offset, 8);
+            fb_put(meta, vector + 12 + 24 * i, block->metadata_length, 4);
+            fb_put(meta, vector + 20 + 24 * i, block->body_length, 8);
+        }
+    }
+
+    if (meta->failed) {
+        sink->ok = false;
+        return;
+    }
+    sink_write(sink, meta->data, meta->size);
+    sink_u32(sink, (uint32_t)meta->size);
+    sink_write(sink, ARROW_FILE_MAGIC, sizeof(ARROW_FILE_MAGIC));
+}
+
+DataframeErrorCode dataframe_write_arrow(const DataFrame *df,
+                                         FILE *file,
+                                         const ArrowIpcFormat format)
+{
+    if (!df || !file || df->cols <= 0)
+        return DATAFRAME_ERR_WRITE_FAILED;
+
+    const size_t cols = (size_t)df->cols;
+    ArrowColumnPlan *plans = calloc(cols, sizeof(ArrowColumnPlan));
+    ArrowBuffer *buffers = malloc(3 * cols * sizeof(ArrowBuffer));
+    uint64_t *null_counts = malloc(cols * sizeof(uint64_t));
+    ArrowBlock *blocks = malloc((cols + 1) * sizeof(ArrowBlock));
+    if (!plans || !buffers || !null_counts || !blocks) {
+        free(plans);
+        free(buffers);
+        free(null_counts);
+        free(blocks);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    plan_columns(df, plans);
+
+    ArrowSink sink = {file, 0, true};
+    FbBuilder meta = {0};
+    if (format == ARROW_IPC_FILE) {
+        sink_write(&sink, ARROW_FILE_MAGIC, sizeof(ARROW_FILE_MAGIC));
+        sink_pad_to(&sink, 8);
+    }
+
+    const size_t header = begin_message(&meta, ARROW_HEADER_SCHEMA, 0);
+    fb_link(&meta, header, add_schema(&meta, df, plans));
+    write_message(&sink, &meta, 0, NULL);
+
+    /* Dictionaries must precede the record batch that references them */
+    size_t dictionary_count = 0;
+    for (int c = 0; c < df->cols; c++) {
+        if (df->col_types[c] == TYPE_CATEGORY)
+            write_dictionary_batch(&sink, &meta, df, c, &plans[c], &blocks[dictionary_count++]);
+    }
+    write_record_batch(&sink, &meta, df, plans, buffers, null_counts, &blocks[dictionary_count]);
+
+    sink_u32(&sink, ARROW_CONTINUATION);
+    sink_u32(&sink, 0);
+    if (format == ARROW_IPC_FILE)
+        write_footer(&sink, &meta, df, plans, blocks, dictionary_count);
+    if (fflush(file) != 0)
+        sink.ok = false;
+
+    const bool allocated = !meta.failed;
+    free(meta.data);
+    free(plans);
+    free(buffers);
+    free(null_counts);
+    free(blocks);
+
+    if (!allocated)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    return sink.ok ? DATAFRAME_SUCCESS : DATAFRAME_ERR_WRITE_FAILED;
+}
+
+DataframeErrorCode dataframe_save_arrow(const DataFrame *df,
+                                        const char *path,
+                                        const ArrowIpcFormat format)
+{
+    if (!df || !path)
+        return DATAFRAME_ERR_WRITE_FAILED;
+
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return DATAFRAME_ERR_WRITE_FAILED;
+
+    DataframeErrorCode err = dataframe_write_arrow(df, file, format);
+    if (fclose(file) != 0 && err == DATAFRAME_SUCCESS)
+        err = DATAFRAME_ERR_WRITE_FAILED;
+    if (err != DATAFRAME_SUCCESS)
+        remove(path);
+    return err;
+}
+
+/**
+ * @brief Physical representation of the values of an imported column.
+ */
+typedef enum {
+    ARROW_VALUES_FLOAT64,
+    ARROW_VALUES_FLOAT32,
+    ARROW_VALUES_INT,
+    ARROW_VALUES_BOOL,
+    ARROW_VALUES_DATE32,
+    ARROW_VALUES_DATE64,
+    ARROW_VALUES_TIMESTAMP,
+    ARROW_VALUES_UTF8,
+    ARROW_VALUES_LARGE_UTF8
+} ArrowValues;
+
+/**
+ * @brief How the cells of one imported column are decoded.
+ */
+typedef struct {
+    ArrowValues values;    /*!< Representation of the values (of the dictionary if encoded). */
+    int bit_width;         /*!< ARROW_VALUES_INT: width of the integers. */
+    bool is_signed;        /*!< ARROW_VALUES_INT: whether the integers are signed. */
+    int64_t unit_nanos;    /*!< ARROW_VALUES_TIMESTAMP: nanoseconds per unit. */
+    bool encoded;          /*!< The column is dictionary-encoded. */
+    int64_t dictionary_id; /*!< Id of the column's dictionary batches. */
+    int index_width;       /*!< Width of the dictionary indices. */
+    bool index_signed;     /*!< Whether the dictionary indices are signed. */
+    int32_t *codes;        /*!< Frame dictionary code of every current dictionary index. */
+    size_t code_count;     /*!< Number of entries in codes. */
+} ArrowField;
+
+/**
+ * @brief One encapsulated message of an IPC stream.
+ */
+typedef struct {
+    FbView meta;               /*!< The FlatBuffers metadata. */
+    int header_type;           /*!< Member of the MessageHeader union. */
+    size_t header;             /*!< Position of the header table in meta. */
+    const unsigned char *body; /*!< The message body. */
+    uint64_t body_length;      /*!< Number of body bytes. */
+} ArrowMessage;
+
+/**
+ * @brief The decoded RecordBatch table of a message.
+ */
+typedef struct {
+    int64_t length;               /*!< Number of rows. */
+    const unsigned char *nodes;   /*!< FieldNode structs: length, null_count. */
+    size_t node_count;            /*!< Number of field nodes. */
+    const unsigned char *buffers; /*!< Buffer structs: offset, length. */
+    size_t buffer_count;          /*!< Number of buffers. */
+} ArrowBatch;
+
+/**
+ * @brief A byte range of a message body.
+ */
+typedef struct {
+    const unsigned char *data; /*!< First byte. */
+    uint64_t length;           /*!< Number of bytes. */
+} ArrowSlice;
+
+/**
+ * @brief Reads the message at a position of the stream.
+ * @param data The IPC data.
+ * @param end The end of the messages within data.
+ * @param pos The position of the message; advanced past it.
+ * @param out Receives the message.
+ * @return 1 for a message, 0 at the end of the stream, -1 for malformed framing.
+ */
+static int next_message(const unsigned char *data, const size_t end, size_t *pos, ArrowMessage *out)
+{
+    size_t at = *pos;
+    if (end - at < 4)
+        return 0;
+
+    /* Streams written before Arrow 0.15 lack the continuation marker */
+    uint64_t length = load_le(data + at, 4);
+    at += 4;
+    if (length == ARROW_CONTINUATION) {
+        if (end - at < 4)
+            return -1;
+        length = load_le(data + at, 4);
+        at += 4;
+    }
+    if (length == 0)
+        return 0;
+    if (length < 8 || length > end - at)
+        return -1;
+
+    out->meta.data = data + at;
+    out->meta.size = (size_t)length;
+    const size_t root = (size_t)load_le(out->meta.data, 4);
+    const int64_t version = fb_int(&out->meta, root, 0, 2, 0);
+    const int64_t body_length = fb_int(&out->meta, root, 3, 8, 0);
+    out->header_type = (int)fb_int(&out->meta, root, 1, 1, 0);
+    out->header = fb_ref(&out->meta, root, 2);
+    at += (size_t)length;
+
+    if (version < ARROW_METADATA_V4 || !out->header || body_length < 0 ||
+        (uint64_t)body_length > end - at)
+        return -1;
+
+    out->body = data + at;
+    out->body_length = (uint64_t)body_length;
+    *pos = at + (size_t)body_length;
+    return 1;
+}
+
+/**
+ * @brief Decodes the RecordBatch table of a record or dictionary batch.
+ * @param meta The message metadata.
+ * @param table The position of the RecordBatch table.
+ * @param out Receives the batch.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT, or DATAFRAME_ERR_UNSUPPORTED_FORMAT
+ * for compressed bodies.
+ */
+static DataframeErrorCode parse_batch(const FbView *meta, const size_t table, ArrowBatch *out)
+{
+    out->length = fb_int(meta, table, 0, 8, 0);
+    if (fb_field(meta, table, 3))
+        return DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+
+    const size_t nodes = fb_elements(meta, fb_ref(meta, table, 1), 16, &out->node_count);
+    const size_t buffers = fb_elements(meta, fb_ref(meta, table, 2), 16, &out->buffer_count);
+    if (out->length < 0 || out->length > INT_MAX || !nodes || !buffers)
+        return DATAFRAME_ERR_INVALID_FORMAT;
+
+    out->nodes = meta->data + nodes;
+    out->buffers = meta->data + buffers;
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Locates a buffer of a batch in the message body.
+ * @param message The message.
+ * @param batch The batch.
+ * @param index The buffer index.
+ * @param out Receives the buffer.
+ * @return true if the buffer exists and lies inside the body.
+ */
+static bool batch_buffer(const ArrowMessage *message,
+                         const ArrowBatch *batch,
+                         const size_t index,
+                         ArrowSlice *out)
+{
+    if (index >= batch->buffer_count)
+        return false;
+
+    const uint64_t offset = load_le(batch->buffers + 16 * index, 8);
+    const uint64_t length = load_le(batch->buffers + 16 * index + 8, 8);
+    if (offset > message->body_length || length > message->body_length - offset)
+        return false;
+
+    out->data = message->body + offset;
+    out->length = length;
+    return true;
+}
+
+/**
+ * @brief Checks a validity bit.
+ * @param bits The bitmap, or NULL if every value is valid.
+ * @param index The value index.
+ * @return true if the value is valid.
+ */
+static bool is_valid(const unsigned char *bits, const int64_t index)
+{
+    return !bits || (bits[index >> 3] >> (index & 7) & 1);
+}
+
+/**
+ * @brief Reads one integer of an integer buffer.
+ * @param values The buffer.
+ * @param index The value index.
+ * @param width The width in bits (8, 16, 32 or 64).
+ * @param is_signed Whether the integers are signed.
+ * @param out Receives the value.
+ * @return false for unsigned values above INT64_MAX.
+ */
+static bool load_integer(const unsigned char *values,
+                         const int64_t index,
+                         const int width,
+                         const bool is_signed,
+                         int64_t *out)
+{
+    const size_t size = (size_t)width / 8;
+    uint64_t value = load_le(values + (size_t)index * size, size);
+
+    if (is_signed && width < 64 && (value >> (width - 1) & 1))
+        value |= ~0ULL << width;
+    else if (!is_signed && value > INT64_MAX)
+        return false;
+
+    *out = (int64_t)value;
+    return true;
+}
+
+/**
+ * @brief Locates one string of a Utf8 or LargeUtf8 array.
+ * @param offsets The offsets buffer.
+ * @param text The character data.
+ * @param large Whether the offsets are 64-bit.
+ * @param index The value index (the offsets buffer must hold index + 2 entries).
+ * @param out_len Receives the length of the string.
+ * @return The first character, or NULL if the offsets are out of bounds.
+ */
+static const char *text_at(const ArrowSlice *offsets,
+                           const ArrowSlice *text,
+                           const bool large,
+                           const int64_t index,
+                           size_t *out_len)
+{
+    const int width = large ? 64 : 32;
+    int64_t start, end;
+    load_integer(offsets->data, index, width, true, &start);
+    load_integer(offsets->data, index + 1, width, true, &end);
+    if (start < 0 || end < start || (uint64_t)end > text->length)
+        return NULL;
+
+    *out_len = (size_t)(end - start);
+    return (const char *)text->data + start;
+}
+
+/**
+ * @brief Decodes the Int table of an integer type or dictionary index type.
+ * @param meta The message metadata.
+ * @param table The position of the table.
+ * @param out_width Receives the width in bits.
+ * @param out_signed Receives whether the integers are signed.
+ * @return true for widths of 8, 16, 32 and 64 bits.
+ */
+static bool read_int_type(const FbView *meta, const size_t table, int *out_width, bool *out_signed)
+{
+    const int64_t width = fb_int(meta, table, 0, 4, 0);
+    *out_width = (int)width;
+    *out_signed = fb_int(meta, table, 1, 1, 0) != 0;
+    return width == 8 || width == 16 || width == 32 || width == 64;
+}
+
+/**
+ * @brief Decodes the type of a schema field.
+ * @param meta The message metadata.
+ * @param field_table The position of the Field table.
+ * @param out Receives how the column's values are stored.
+ * @param out_type Receives the column type of the frame.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT or DATAFRAME_ERR_UNSUPPORTED_FORMAT.
+ */
+static DataframeErrorCode read_field_type(const FbView *meta,
+                                          const size_t field_table,
+                                          ArrowField *out,
+                                          DataType *out_type)
+{
+    static const int64_t unit_nanos[] = {1000000000, 1000000, 1000, 1};
+    const int64_t type_id = fb_int(meta, field_table, 2, 1, 0);
+    const size_t type = fb_ref(meta, field_table, 3);
+    if (!type)
+        return DATAFRAME_ERR_INVALID_FORMAT;
+
+    size_t child_count = 0;
+    if (fb_elements(meta, fb_ref(meta, field_table, 5), 4, &child_count) && child_count > 0)
+        return DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+
+    switch (type_id) {
+    case ARROW_TYPE_INT:
+        out->values = ARROW_VALUES_INT;
+        *out_type = TYPE_INT64;
+        if (!read_int_type(meta, type, &out->bit_width, &out->is_signed))
+            return DATAFRAME_ERR_INVALID_FORMAT;
+        break;
+    case ARROW_TYPE_FLOATING_POINT: {
+        const int64_t precision = fb_int(meta, type, 0, 2, 0);
+        if (precision != ARROW_PRECISION_SINGLE && precision != ARROW_PRECISION_DOUBLE)
+            return DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+        out->values =
+            precision == ARROW_PRECISION_DOUBLE ? ARROW_VALUES_FLOAT64 : ARROW_VALUES_FLOAT32;
+        *out_type = TYPE_NUMERIC;
+        break;
+    }
+    case ARROW_TYPE_BOOL:
+        out->values = ARROW_VALUES_BOOL;
+        *out_type = TYPE_NUMERIC;
+        break;
+    case ARROW_TYPE_DATE:
+        out->values = fb_int(meta, type, 0, 2, ARROW_DATE_MILLISECOND) == ARROW_DATE_DAY
+                          ? ARROW_VALUES_DATE32
+                          : ARROW_VALUES_DATE64;
+        *out_type = TYPE_DATE;
+        break;
+    case ARROW_TYPE_TIMESTAMP: {
+        const int64_t unit = fb_int(meta, type, 0, 2, 0);
+        if (unit < 0 || unit > ARROW_TIME_NANOSECOND)
+            return DATAFRAME_ERR_INVALID_FORMAT;
+        out->values = ARROW_VALUES_TIMESTAMP;
+        out->unit_nanos = unit_nanos[unit];
+        *out_type = TYPE_TIMESTAMP;
+        break;
+    }
+    case ARROW_TYPE_UTF8:
+    case ARROW_TYPE_LARGE_UTF8:
+        out->values = type_id == ARROW_TYPE_UTF8 ? ARROW_VALUES_UTF8 : ARROW_VALUES_LARGE_UTF8;
+        *out_type = TYPE_STRING;
+        break;
+    default:
+        return DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+    }
+
+    const size_t dictionary = fb_ref(meta, field_table, 4);
+    if (dictionary) {
+        if (*out_type != TYPE_STRING)
+            return DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+
+        /* Indices default to signed 32-bit integers */
+        out->encoded = true;
+        out->dictionary_id = fb_int(meta, dictionary, 0, 8, 0);
+        out->index_width = 32;
+        out->index_signed = true;
+        const size_t index_type = fb_ref(meta, dictionary, 1);
+        if (index_type && !read_int_type(meta, index_type, &out->index_width, &out->index_signed))
+            return DATAFRAME_ERR_INVALID_FORMAT;
+        *out_type = TYPE_CATEGORY;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Creates the frame described by a Schema message.
+ * @param schema The Schema message.
+ * @param rows The total number of rows of all record batches.
+ * @param out_df Receives the columnar DataFrame.
+ * @param out_fields Receives one decoder per column.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT, DATAFRAME_ERR_UNSUPPORTED_FORMAT,
+ * DATAFRAME_ERR_EMPTY_FILE or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode create_frame(const ArrowMessage *schema,
+                                       const uint64_t rows,
+                                       DataFrame **out_df,
+                                       ArrowField **out_fields)
+{
+    const FbView *meta = &schema->meta;
+    if (fb_int(meta, schema->header, 0, 2, ARROW_ENDIAN_LITTLE) != ARROW_ENDIAN_LITTLE)
+        return DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+
+    size_t cols = 0;
+    const size_t fields = fb_elements(meta, fb_ref(meta, schema->header, 1), 4, &cols);
+    if (!fields)
+        return DATAFRAME_ERR_INVALID_FORMAT;
+    if (cols == 0)
+        return DATAFRAME_ERR_EMPTY_FILE;
+    if (cols > INT_MAX)
+        return DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+
+    DataFrame *df =
+        create_dataframe_with_layout(rows ? (size_t)rows : 1, cols, DATAFRAME_LAYOUT_COLUMNS);
+    ArrowField *decoders = calloc(cols, sizeof(ArrowField));
+    if (!df || !decoders || dataframe_enable_validity(df) != DATAFRAME_SUCCESS) {
+        free_dataframe(df);
+        free(decoders);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    DataframeErrorCode err = DATAFRAME_SUCCESS;
+    for (size_t c = 0; c < cols && err == DATAFRAME_SUCCESS; c++) {
+        const size_t field = fb_element_ref(meta, fields, c);
+        err = read_field_type(meta, field, &decoders[c], &df->col_types[c]);
+        if (err != DATAFRAME_SUCCESS)
+            break;
+
+        /* Strings are length-prefixed; the terminator is not relied upon */
+        const size_t name = fb_ref(meta, field, 0);
+        const uint64_t name_len = name ? load_le(meta->data + name, 4) : 0;
+        if (name_len > meta->size - name - 4) {
+            err = DATAFRAME_ERR_INVALID_FORMAT;
+            break;
+        }
+        df->columns[c] = malloc((size_t)name_len + 1);
+        if (!df->columns[c]) {
+            err = DATAFRAME_ERR_ALLOCATION_FAILED;
+            break;
+        }
+        if (name_len)
+            memcpy(df->columns[c], meta->data + name + 4, (size_t)name_len);
+        df->columns[c][name_len] = '\0';
+    }
+    if (err == DATAFRAME_SUCCESS)
+        err = dataframe_index_columns(df);
+
+    if (err != DATAFRAME_SUCCESS) {
+        free_dataframe(df);
+        free(decoders);
+        return err;
+    }
+    *out_df = df;
+    *out_fields = decoders;
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Adds the values of a DictionaryBatch to the dictionaries of the columns using it.
+ * @param df The DataFrame.
+ * @param fields The column decoders; their code tables are replaced or extended.
+ * @param message The DictionaryBatch message.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT, DATAFRAME_ERR_UNSUPPORTED_FORMAT or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode read_dictionary_batch(DataFrame *df,
+                                                ArrowField *fields,
+                                                const ArrowMessage *message)
+{
+    const FbView *meta = &message->meta;
+    const int64_t id = fb_int(meta, message->header, 0, 8, 0);
+    const bool delta = fb_int(meta, message->header, 2, 1, 0) != 0;
+
+    ArrowBatch batch;
+    const DataframeErrorCode err = parse_batch(meta, fb_ref(meta, message->header, 1), &batch);
+    if (err != DATAFRAME_SUCCESS)
+        return err;
+
+    ArrowSlice validity, offsets, text;
+    if (batch.node_count < 1 || (int64_t)load_le(batch.nodes, 8) != batch.length ||
+        !batch_buffer(message, &batch, 0, &validity) ||
+        !batch_buffer(message, &batch, 1, &offsets) || !batch_buffer(message, &batch, 2, &text))
+        return DATAFRAME_ERR_INVALID_FORMAT;
+    const bool has_nulls = load_le(batch.nodes + 8, 8) != 0;
+    const unsigned char *bits = has_nulls ? validity.data : NULL;
+
+    for (int c = 0; c < df->cols; c++) {
+        ArrowField *field = &fields[c];
+        if (!field->encoded || field->dictionary_id != id)
+            continue;
+
+        const bool large = field->values == ARROW_VALUES_LARGE_UTF8;
+        const uint64_t needed = batch.length ? ((uint64_t)batch.length + 1) * (large ? 8 : 4) : 0;
+        if (offsets.length < needed ||
+            (has_nulls && validity.length < ((uint64_t)batch.length + 7) / 8))
+            return DATAFRAME_ERR_INVALID_FORMAT;
+
+        /* A replacement dictionary restarts the index table; earlier rows keep their codes */
+        const size_t base = delta ? field->code_count : 0;
+        int32_t *codes = realloc(field->codes, (base + (size_t)batch.length + 1) * sizeof(int32_t));
+        if (!codes)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        field->codes = codes;
+
+        for (int64_t i = 0; i < batch.length; i++) {
+            size_t len;
+            const char *str = text_at(&offsets, &text, large, i, &len);
+            if (!str)
+                return DATAFRAME_ERR_INVALID_FORMAT;
+
+            codes[base + (size_t)i] =
+                is_valid(bits, i) ? dataframe_intern_string(df, c, str, len) : -1;
+            if (is_valid(bits, i) && codes[base + (size_t)i] < 0)
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+        field->code_count = base + (size_t)batch.length;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Decodes one column of a record batch into rows [first, first + count) of the frame.
+ * @param df The columnar DataFrame.
+ * @param col The zero-based column index.
+ * @param field The column's decoder.
+ * @param message The RecordBatch message.
+ * @param batch The batch.
+ * @param buffer The index of the column's first buffer; advanced past its buffers.
+ * @param first The first row to fill.
+ * @param in_place Whether a fixed-width column may become the mapped buffer itself.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode read_column(DataFrame *df,
+                                      const int col,
+                                      const ArrowField *field,
+                                      const ArrowMessage *message,
+                                      const ArrowBatch *batch,
+                                      size_t *buffer,
+                                      const int first,
+                                      const bool in_place)
+{
+    const unsigned char *node = batch->nodes + 16 * (size_t)col;
+    const int64_t count = batch->length;
+    const bool has_nulls = load_le(node + 8, 8) != 0;
+
+    ArrowSlice validity, values, text = {NULL, 0};
+    if ((int64_t)load_le(node, 8) != count ||
+        !batch_buffer(message, batch, (*buffer)++, &validity) ||
+        !batch_buffer(message, batch, (*buffer)++, &values))
+        return DATAFRAME_ERR_INVALID_FORMAT;
+    if (has_nulls && validity.length < ((uint64_t)count + 7) / 8)
+        return DATAFRAME_ERR_INVALID_FORMAT;
+    const unsigned char *bits = has_nulls ? validity.data : NULL;
+
+    const bool text_values =
+        field->values == ARROW_VALUES_UTF8 || field->values == ARROW_VALUES_LARGE_UTF8;
+    if (text_values && !field->encoded && !batch_buffer(message, batch, (*buffer)++, &text))
+        return DATAFRAME_ERR_INVALID_FORMAT;
+    if (count == 0)
+        return DATAFRAME_SUCCESS;
+    if (bits) {
+        const DataframeErrorCode err =
+            dataframe_set_validity_bitmap(df, col, first, bits, (size_t)count);
+        if (err != DATAFRAME_SUCCESS)
+            return err;
+    }
+
+    /* Bytes per value of the buffer following the validity bitmap */
+    uint64_t width;
+    if (field->encoded)
+        width = (uint64_t)field->index_width / 8;
+    else if (field->values == ARROW_VALUES_INT)
+        width = (uint64_t)field->bit_width / 8;
+    else if (field->values == ARROW_VALUES_FLOAT32 || field->values == ARROW_VALUES_DATE32 ||
+             field->values == ARROW_VALUES_UTF8)
+        width = 4;
+    else
+        width = 8;
+
+    const uint64_t needed = field->values == ARROW_VALUES_BOOL ? ((uint64_t)count + 7) / 8
+                            : text_values && !field->encoded ? ((uint64_t)count + 1) * width
+                                                             : (uint64_t)count * width;
+    if (values.length < needed)
+        return DATAFRAME_ERR_INVALID_FORMAT;
+
+    DataCell *cells = df->col_data[col] + first;
+    const bool same_representation =
+        !field->encoded &&
+        (field->values == ARROW_VALUES_FLOAT64 ||
+         (field->values == ARROW_VALUES_INT && field->bit_width == 64 && field->is_signed) ||
+         (field->values == ARROW_VALUES_TIMESTAMP && field->unit_nanos == 1));
+
+    if (same_representation) {
+        if (in_place && (uintptr_t)values.data % CACHE_LINE_SIZE == 0) {
+            /* The copy-on-write mapping becomes the column; only nulls are patched below */
+            aligned_free(df->col_data[col]);
+            df->col_data[col] = (DataCell *)values.data;
+            cells = df->col_data[col];
+        } else {
+            memcpy(cells, values.data, (size_t)count * sizeof(DataCell));
+        }
+        for (int64_t i = 0; bits && i < count; i++) {
+            if (!is_valid(bits, i)) {
+                if (field->values == ARROW_VALUES_FLOAT64)
+                    cells[i].v_num = NAN;
+                else
+                    cells[i].v_int = DATAFRAME_NULL_INT64;
+            }
+        }
+        return DATAFRAME_SUCCESS;
+    }
+
+    for (int64_t i = 0; i < count; i++) {
+        DataCell cell = {0};
+        const bool valid = is_valid(bits, i);
+
+        if (field->encoded) {
+            int64_t index = 0;
+            cell.v_code = -1;
+            if (valid) {
+                if (!load_integer(values.data, i, field->index_width, field->index_signed,
+                                  &index) ||
+                    index < 0 || (uint64_t)index >= field->code_count)
+                    return DATAFRAME_ERR_INVALID_FORMAT;
+                cell.v_code = field->codes[index];
+            }
+        } else if (text_values) {
+            size_t len = 0;
+            const char *str = text_at(&values, &text, field->values == ARROW_VALUES_LARGE_UTF8,
+                                      i, &len);
+            if (!str)
+                return DATAFRAME_ERR_INVALID_FORMAT;
+            if (valid) {
+                cell.v_str = dataframe_store_string(df, str, len);
+                if (!cell.v_str)
+                    return DATAFRAME_ERR_ALLOCATION_FAILED;
+            }
+        } else if (field->values == ARROW_VALUES_FLOAT32) {
+            float value;
+            memcpy(&value, values.data + 4 * (size_t)i, sizeof(value));
+            cell.v_num = valid ? value : NAN;
+        } else if (field->values == ARROW_VALUES_BOOL) {
+            /* Booleans are bit-packed like validity bitmaps */
+            cell.v_num = valid ? (double)(values.data[i >> 3] >> (i & 7) & 1) : NAN;
+        } else {
+            int64_t value = 0;
+            const int value_width = field->values == ARROW_VALUES_INT ? field->bit_width
+                                    : field->values == ARROW_VALUES_DATE32 ? 32
+                                                                           : 64;
+            const bool value_signed = field->values != ARROW_VALUES_INT || field->is_signed;
+            bool ok = valid && load_integer(values.data, i, value_width, value_signed, &value);
+
+            if (ok && field->values == ARROW_VALUES_DATE64) {
+                /* Milliseconds to days, rounding towards negative infinity */
+                value = value / 86400000 - (value % 86400000 < 0);
+            } else if (ok && field->values == ARROW_VALUES_TIMESTAMP) {
+                /* Instants beyond the nanosecond range become missing */
+                const int64_t limit = INT64_MAX / field->unit_nanos;
+                ok = value <= limit && value >= -limit;
+                if (ok)
+                    value *= field->unit_nanos;
+            }
+            cell.v_int = ok ? value : DATAFRAME_NULL_INT64;
+            if (valid && !ok && !dataframe_set_valid(df, first + (int)i, col, false))
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+        cells[i] = cell;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Appends the rows of a RecordBatch message to the frame.
+ * @param df The columnar DataFrame, with enough row capacity.
+ * @param fields The column decoders.
+ * @param message The RecordBatch message.
+ * @param in_place Whether fixed-width columns may use the mapped buffers in place.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT, DATAFRAME_ERR_UNSUPPORTED_FORMAT or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode read_record_batch(DataFrame *df,
+                                            const ArrowField *fields,
+                                            const ArrowMessage *message,
+                                            const bool in_place)
+{
+    ArrowBatch batch;
+    DataframeErrorCode err = parse_batch(&message->meta, message->header, &batch);
+    if (err != DATAFRAME_SUCCESS)
+        return err;
+    if (batch.node_count != (size_t)df->cols || batch.length > df->row_capacity - df->rows)
+        return DATAFRAME_ERR_INVALID_FORMAT;
+
+    /* The rows exist before their columns are read, so nulls can be recorded as they are met */
+    const int first = df->rows;
+    df->rows += (int)batch.length;
+
+    size_t buffer = 0;
+    for (int c = 0; c < df->cols && err == DATAFRAME_SUCCESS; c++) {
+        err = read_column(df, c, &fields[c], message, &batch, &buffer, first, in_place);
+    }
+    return err;
+}
+
+/**
+ * @brief Builds a frame from IPC data in either format.
+ * @param data The IPC data.
+ * @param size The number of bytes at data.
+ * @param mapping The mapping holding data, adopted by the frame (NULL to copy all values).
+ * Released on failure.
+ * @param out_df Receives the DataFrame on success.
+ * @return As dataframe_read_arrow.
+ */
+static DataframeErrorCode read_ipc(const unsigned char *data,
+                                   const size_t size,
+                                   FileMapping *mapping,
+                                   DataFrame **out_df)
+{
+    size_t begin = 0;
+    size_t end = size;
+    DataframeErrorCode err = size ? DATAFRAME_SUCCESS : DATAFRAME_ERR_EMPTY_FILE;
+
+    if (size >= 8 && memcmp(data, ARROW_FILE_MAGIC, sizeof(ARROW_FILE_MAGIC)) == 0) {
+        /* The file format wraps the stream; its footer only repeats what the stream holds */
+        const uint64_t footer = size >= 18 ? load_le(data + size - 10, 4) : 0;
+        if (size < 18 || memcmp(data + size - 6, ARROW_FILE_MAGIC, 6) != 0 || footer > size - 18) {
+            err = DATAFRAME_ERR_INVALID_FORMAT;
+        } else {
+            begin = 8;
+            end = size - 10 - (size_t)footer;
+        }
+    }
+
+    /* First pass: framing, the schema and the total number of rows */
+    ArrowMessage schema = {0};
+    ArrowMessage message;
+    uint64_t rows = 0;
+    size_t batches = 0;
+    size_t pos = begin;
+    int status;
+    while (err == DATAFRAME_SUCCESS && (status = next_message(data, end, &pos, &message)) != 0) {
+        ArrowBatch batch;
+        /* The schema comes first and only once */
+        if (status < 0 || (message.header_type == ARROW_HEADER_SCHEMA) == (schema.header != 0))
+            err = DATAFRAME_ERR_INVALID_FORMAT;
+        else if (message.header_type == ARROW_HEADER_SCHEMA)
+            schema = message;
+        else if (message.header_type == ARROW_HEADER_RECORD_BATCH) {
+            err = parse_batch(&message.meta, message.header, &batch);
+            rows += (uint64_t)batch.length;
+            batches++;
+        } else if (message.header_type != ARROW_HEADER_DICTIONARY_BATCH)
+            err = DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+    }
+    if (err == DATAFRAME_SUCCESS && !schema.header)
+        err = DATAFRAME_ERR_INVALID_FORMAT;
+    if (err == DATAFRAME_SUCCESS && rows > INT_MAX)
+        err = DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+
+    DataFrame *df = NULL;
+    ArrowField *fields = NULL;
+    if (err == DATAFRAME_SUCCESS)
+        err = create_frame(&schema, rows, &df, &fields);
+    if (err != DATAFRAME_SUCCESS) {
+        if (mapping) {
+            file_mapping_close(mapping);
+            free(mapping);
+        }
+        return err;
+    }
+
+    /* From here on the frame owns the mapping and free_dataframe releases it */
+    if (mapping)
+        dataframe_adopt_mapping(df, mapping);
+
+    /* Second pass: the dictionaries and rows; a single batch can be used in place */
+    pos = begin;
+    while (err == DATAFRAME_SUCCESS && next_message(data, end, &pos, &message) > 0) {
+        if (message.header_type == ARROW_HEADER_DICTIONARY_BATCH)
+            err = read_dictionary_batch(df, fields, &message);
+        else if (message.header_type == ARROW_HEADER_RECORD_BATCH)
+            err = read_record_batch(df, fields, &message, mapping && batches == 1);
+    }
+
+    for (int c = 0; c < df->cols; c++) {
+        free(fields[c].codes);
+    }
+    free(fields);
+
+    if (err != DATAFRAME_SUCCESS) {
+        free_dataframe(df);
+        return err;
+    }
+    *out_df = df;
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode dataframe_read_arrow(const void *data, const size_t size, DataFrame **out_df)
+{
+    if (!out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+    if (!data && size)
+        return DATAFRAME_ERR_INVALID_FORMAT;
+
+    return read_ipc(data, size, NULL, out_df);
+}
+
+DataframeErrorCode dataframe_load_arrow(const char *path, DataFrame **out_df)
+{
+    if (!out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+    if (!path)
+        return DATAFRAME_ERR_FILE_NOT_FOUND;
+
+    FileMapping *mapping = malloc(sizeof(FileMapping));
+    if (!mapping)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    const FileMappingErrorCode map_err = file_mapping_open_copy_on_write(path, mapping);
+    if (map_err != FILE_MAPPING_SUCCESS) {
+        free(mapping);
+        return map_err == FILE_MAPPING_ERR_ALLOCATION_FAILED ? DATAFRAME_ERR_ALLOCATION_FAILED
+                                                             : DATAFRAME_ERR_FILE_NOT_FOUND;
+    }
+    return read_ipc((const unsigned char *)mapping->data, mapping->size, mapping, out_df);
+}
@@ -0,0 +1,445 @@
+#include "compressed_input.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "parallel.h"
+
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+/**
+ * @brief Size of each decompressed block handed from the decoder to the reader.
+ */
+#define DECODED_BLOCK_SIZE (256 * 1024)
+
+/**
+ * @brief Number of decompressed blocks in flight between the decoder and the reader.
+ */
+#define DECODED_BLOCK_COUNT 4
+
+/**
+ * @brief Number of compressed bytes read from the file at a time.
+ */
+#define COMPRESSED_READ_SIZE (64 * 1024)
+
+/**
+ * @brief A block of decompressed bytes together with the decoder's status after producing it.
+ */
+typedef struct {
+    char *data;                      /*!< DECODED_BLOCK_SIZE bytes of storage. */
+    size_t length;                   /*!< Number of valid bytes in data. */
+    bool last;                       /*!< Whether no block follows this one. */
+    CompressedInputErrorCode status; /*!< Error that ended decoding (only if last). */
+} DecodedBlock;
+
+struct CompressedInput {
+    FILE *file;                 /*!< The compressed stream (owned by the caller). */
+    CompressionFormat format;   /*!< Format of the stream. */
+    unsigned char *compressed;  /*!< Staging buffer for compressed bytes. */
+    const unsigned char *next_in; /*!< First compressed byte not yet handed to the decoder. */
+    size_t avail_in;            /*!< Number of compressed bytes available at next_in. */
+    bool input_eof;             /*!< Whether the whole file has been read. */
+    bool frame_complete;        /*!< Whether the decoder ended on a frame boundary. */
+    void *decoder;              /*!< z_stream or ZSTD_DStream, depending on format. */
+    DecodedBlock blocks[DECODED_BLOCK_COUNT]; /*!< Storage of all blocks in flight. */
+    ParallelQueue *free_blocks;  /*!< Blocks the decoder may fill. */
+    ParallelQueue *ready_blocks; /*!< Filled blocks, in stream order. */
+    ParallelThread *thread;      /*!< Background decoder, NULL when decoding inline. */
+    DecodedBlock *current;       /*!< Block being consumed by the reader. */
+    size_t offset;               /*!< Number of bytes of current already consumed. */
+};
+
+CompressionFormat compression_detect(const void *data, const size_t size)
+{
+    const unsigned char *bytes = data;
+    if (!bytes)
+        return COMPRESSION_NONE;
+
+    if (size >= 2 && bytes[0] == 0x1F && bytes[1] == 0x8B)
+        return COMPRESSION_GZIP;
+    if (size >= 4 && bytes[0] == 0x28 && bytes[1] == 0xB5 && bytes[2] == 0x2F && bytes[3] == 0xFD)
+        return COMPRESSION_ZSTD;
+    return COMPRESSION_NONE;
+}
+
+bool compression_supported(const CompressionFormat format)
+{
+    switch (format) {
+#if defined(HAVE_ZLIB)
+    case COMPRESSION_GZIP:
+        return true;
+#endif
+#if defined(HAVE_ZSTD)
+    case COMPRESSION_ZSTD:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+#if defined(HAVE_ZLIB) || defined(HAVE_ZSTD)
+
+/**
+ * @brief Makes more compressed bytes available once the decoder has consumed the previous ones.
+ * @param input The reader.
+ * @return COMPRESSED_INPUT_SUCCESS (setting input_eof at the end of the file) or a read error.
+ */
+static CompressedInputErrorCode refill_compressed(CompressedInput *input)
+{
+    if (input->avail_in > 0 || input->input_eof)
+        return COMPRESSED_INPUT_SUCCESS;
+
+    const size_t got = fread(input->compressed, 1, COMPRESSED_READ_SIZE, input->file);
+    input->next_in = input->compressed;
+    input->avail_in = got;
+
+    if (got == 0) {
+        if (ferror(input->file))
+            return COMPRESSED_INPUT_ERR_READ_FAILED;
+        input->input_eof = true;
+    }
+    return COMPRESSED_INPUT_SUCCESS;
+}
+
+#endif
+
+#if defined(HAVE_ZLIB)
+
+/**
+ * @brief Decodes gzip data into a block until it is full or the stream ends.
+ * @param input The reader.
+ * @param block The block to fill; last and status are set when the stream ends.
+ */
+static void decode_gzip(CompressedInput *input, DecodedBlock *block)
+{
+    z_stream *stream = input->decoder;
+    stream->next_out = (Bytef *)block->data + block->length;
+    stream->avail_out = (uInt)(DECODED_BLOCK_SIZE - block->length);
+
+    while (stream->avail_out > 0) {
+        block->status = refill_compressed(input);
+        if (block->status != COMPRESSED_INPUT_SUCCESS)
+            break;
+        if (input->avail_in == 0) {
+            /* A file cut off inside a member is corrupt, not merely short */
+            if (!input->frame_complete)
+                block->status = COMPRESSED_INPUT_ERR_CORRUPT;
+            break;
+        }
+
+        /* A new member starts after the end of the previous one (as written by cat a.gz b.gz) */
+        if (input->frame_complete) {
+            inflateReset(stream);
+            input->frame_complete = false;
+        }
+
+        stream->next_in = (Bytef *)input->next_in;
+        stream->avail_in = (uInt)input->avail_in;
+        const int ret = inflate(stream, Z_NO_FLUSH);
+        input->next_in = stream->next_in;
+        input->avail_in = stream->avail_in;
+
+        if (ret == Z_STREAM_END) {
+            input->frame_complete = true;
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            block->status = COMPRESSED_INPUT_ERR_CORRUPT;
+            break;
+        }
+    }
+
+    block->length = DECODED_BLOCK_SIZE - stream->avail_out;
+    block->last = stream->avail_out > 0;
+}
+
+#endif
+
+#if defined(HAVE_ZSTD)
+
+/**
+ * @brief Decodes Zstandard data into a block until it is full or the stream ends.
+ * @param input The reader.
+ * @param block The block to fill; last and status are set when the stream ends.
+ */
+static void decode_zstd(CompressedInput *input, DecodedBlock *block)
+{
+    ZSTD_outBuffer out = {block->data, DECODED_BLOCK_SIZE, block->length};
+
+    while (out.pos < out.size) {
+        block->status = refill_compressed(input);
+        if (block->status != COMPRESSED_INPUT_SUCCESS)
+            break;
+        if (input->avail_in == 0) {
+            if (!input->frame_complete)
+                block->status = COMPRESSED_INPUT_ERR_CORRUPT;
+            break;
+        }
+
+        ZSTD_inBuffer in = {input->next_in, input->avail_in, 0};
+        const size_t ret = ZSTD_decompressStream(input->decoder, &out, &in);
+        input->next_in += in.pos;
+        input->avail_in -= in.pos;
+
+        if (ZSTD_isError(ret)) {
+            block->status = COMPRESSED_INPUT_ERR_CORRUPT;
+            break;
+        }
+        /* 0 means a frame was fully decoded and flushed; the next bytes start a new frame */
+        input->frame_complete = ret == 0;
+    }
+
+    block->length = out.pos;
+    block->last = out.pos < out.size;
+}
+
+#endif
+
+/**
+ * @brief Fills an empty block with the next decompressed bytes.
+ * @param input The reader.
+ * @param block The block to fill.
+ */
+static void decode_block(CompressedInput *input, DecodedBlock *block)
+{
+    block->length = 0;
+    block->last = false;
+    block->status = COMPRESSED_INPUT_SUCCESS;
+
+    switch (input->format) {
+#if defined(HAVE_ZLIB)
+    case COMPRESSION_GZIP:
+        decode_gzip(input, block);
+        break;
+#endif
+#if defined(HAVE_ZSTD)
+    case COMPRESSION_ZSTD:
+        decode_zstd(input, block);
+        break;
+#endif
+    default:
+        block->last = true;
+        block->status = COMPRESSED_INPUT_ERR_UNSUPPORTED;
+        break;
+    }
+
+    if (block->status != COMPRESSED_INPUT_SUCCESS)
+        block->last = true;
+}
+
+/**
+ * @brief Background decoder: fills free blocks and queues them until the stream ends.
+ * @param context The reader.
+ */
+static void decode_thread(void *context)
+{
+    CompressedInput *input = context;
+
+    for (;;) {
+        /* NULL means the reader was closed before the end of the stream */
+        DecodedBlock *block = parallel_queue_pop(input->free_blocks);
+        if (!block)
+            return;
+
+        decode_block(input, block);
+        if (!parallel_queue_push(input->ready_blocks, block) || block->last)
+            return;
+    }
+}
+
+/**
+ * @brief Creates the decoder state of a format.
+ * @param input The reader.
+ * @return COMPRESSED_INPUT_SUCCESS, or an appropriate CompressedInputErrorCode.
+ */
+static CompressedInputErrorCode create_decoder(CompressedInput *input)
+{
+    switch (input->format) {
+#if defined(HAVE_ZLIB)
+    case COMPRESSION_GZIP: {
+        z_stream *stream = calloc(1, sizeof(z_stream));
+        if (!stream)
+            return COMPRESSED_INPUT_ERR_ALLOCATION_FAILED;
+        /* 16 + MAX_WBITS selects the gzip wrapper */
+        if (inflateInit2(stream, 16 + MAX_WBITS) != Z_OK) {
+            free(stream);
+            return COMPRESSED_INPUT_ERR_ALLOCATION_FAILED;
+        }
+        input->decoder = stream;
+        return COMPRESSED_INPUT_SUCCESS;
+    }
+#endif
+#if defined(HAVE_ZSTD)
+    case COMPRESSION_ZSTD:
+        input->decoder = ZSTD_createDStream();
+        if (!input->decoder)
+            return COMPRESSED_INPUT_ERR_ALLOCATION_FAILED;
+        ZSTD_initDStream(input->decoder);
+        return COMPRESSED_INPUT_SUCCESS;
+#endif
+    default:
+        return COMPRESSED_INPUT_ERR_UNSUPPORTED;
+    }
+}
+
+/**
+ * @brief Frees the decoder state of a format.
+ * @param input The reader.
+ */
+static void free_decoder(CompressedInput *input)
+{
+    if (!input->decoder)
+        return;
+
+#if defined(HAVE_ZLIB)
+    if (input->format == COMPRESSION_GZIP) {
+        inflateEnd(input->decoder);
+        free(input->decoder);
+    }
+#endif
+#if defined(HAVE_ZSTD)
+    if (input->format == COMPRESSION_ZSTD)
+        ZSTD_freeDStream(input->decoder);
+#endif
+    input->decoder = NULL;
+}
+
+CompressedInputErrorCode compressed_input_open(FILE *file,
+                                               const CompressionFormat format,
+                                               const void *prefix,
+                                               const size_t prefix_size,
+                                               CompressedInput **out_input)
+{
+    if (!out_input)
+        return COMPRESSED_INPUT_ERR_ALLOCATION_FAILED;
+    *out_input = NULL;
+
+    if (!file || prefix_size > COMPRESSED_READ_SIZE || (prefix_size > 0 && !prefix))
+        return COMPRESSED_INPUT_ERR_READ_FAILED;
+    if (!compression_supported(format))
+        return COMPRESSED_INPUT_ERR_UNSUPPORTED;
+
+    CompressedInput *input = calloc(1, sizeof(CompressedInput));
+    if (!input)
+        return COMPRESSED_INPUT_ERR_ALLOCATION_FAILED;
+    input->file = file;
+    input->format = format;
+    input->frame_complete = true;
+
+    CompressedInputErrorCode err = COMPRESSED_INPUT_ERR_ALLOCATION_FAILED;
+    input->compressed = malloc(COMPRESSED_READ_SIZE);
+    input->free_blocks = parallel_queue_create(DECODED_BLOCK_COUNT);
+    input->ready_blocks = parallel_queue_create(DECODED_BLOCK_COUNT);
+    bool allocated = input->compressed && input->free_blocks && input->ready_blocks;
+
+    for (int i = 0; allocated && i < DECODED_BLOCK_COUNT; i++) {
+        input->blocks[i].data = malloc(DECODED_BLOCK_SIZE);
+        allocated = input->blocks[i].data != NULL;
+    }
+    if (allocated)
+        err = create_decoder(input);
+    if (err != COMPRESSED_INPUT_SUCCESS) {
+        compressed_input_close(input);
+        return err;
+    }
+
+    if (prefix_size > 0)
+        memcpy(input->compressed, prefix, prefix_size);
+    input->next_in = input->compressed;
+    input->avail_in = prefix_size;
+
+    for (int i = 0; i < DECODED_BLOCK_COUNT; i++) {
+        parallel_queue_push(input->free_blocks, &input->blocks[i]);
+    }
+
+    /* Without a thread, compressed_input_read decodes each block on demand */
+    input->thread = parallel_thread_start(decode_thread, input);
+
+    *out_input = input;
+    return COMPRESSED_INPUT_SUCCESS;
+}
+
+/**
+ * @brief Returns the consumed block to the decoder and takes the next filled one.
+ * @param input The reader.
+ */
+static void next_block(CompressedInput *input)
+{
+    if (!input->thread) {
+        DecodedBlock *block = input->current ? input->current : &input->blocks[0];
+        decode_block(input, block);
+        input->current = block;
+        return;
+    }
+
+    if (input->current)
+        parallel_queue_push(input->free_blocks, input->current);
+    input->current = parallel_queue_pop(input->ready_blocks);
+}
+
+CompressedInputErrorCode compressed_input_read(CompressedInput *input,
+                                               void *buffer,
+                                               const size_t capacity,
+                                               size_t *out_size)
+{
+    if (!out_size)
+        return COMPRESSED_INPUT_ERR_READ_FAILED;
+    *out_size = 0;
+    if (!input || (!buffer && capacity > 0))
+        return COMPRESSED_INPUT_ERR_READ_FAILED;
+
+    char *dst = buffer;
+    size_t copied = 0;
+
+    while (copied < capacity) {
+        if (!input->current || input->offset == input->current->length) {
+            if (input->current && input->current->last)
+                break;
+            next_block(input);
+            input->offset = 0;
+            if (!input->current)
+                return COMPRESSED_INPUT_ERR_READ_FAILED;
+            continue;
+        }
+
+        size_t chunk = input->current->length - input->offset;
+        if (chunk > capacity - copied)
+            chunk = capacity - copied;
+        memcpy(dst + copied, input->current->data + input->offset, chunk);
+        input->offset += chunk;
+        copied += chunk;
+    }
+
+    *out_size = copied;
+    /* Errors surface once the bytes decoded before them have been delivered */
+    if (copied == 0 && input->current && input->current->last)
+        return input->current->status;
+    return COMPRESSED_INPUT_SUCCESS;
+}
+
+void compressed_input_close(CompressedInput *input)
+{
+    if (!input)
+        return;
+
+    /* Closing the queues wakes the decoder whether it waits for a free block or not */
+    if (input->thread) {
+        parallel_queue_close(input->free_blocks);
+        parallel_queue_close(input->ready_blocks);
+        parallel_thread_join(input->thread);
+    }
+
+    free_decoder(input);
+    for (int i = 0; i < DECODED_BLOCK_COUNT; i++) {
+        free(input->blocks[i].data);
+    }
+    parallel_queue_free(input->ready_blocks);
+    parallel_queue_free(input->free_blocks);
+    free(input->compressed);
+    free(input);
+}
@@ -0,0 +1,177 @@
+#include "csv_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "dataframe_binary.h"
+
+/**
+ * @brief Folds bytes into a 64-bit FNV-1a hash.
+ * @param hash The hash so far.
+ * @param data The bytes to add.
+ * @param size The number of bytes.
+ * @return The updated hash.
+ */
+static uint64_t hash_bytes(uint64_t hash, const void *data, const size_t size)
+{
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Folds a 64-bit value into a hash.
+ * @param hash The hash so far.
+ * @param value The value to add.
+ * @return The updated hash.
+ */
+static uint64_t hash_value(const uint64_t hash, const uint64_t value)
+{
+    return hash_bytes(hash, &value, sizeof(value));
+}
+
+/**
+ * @brief Reads the size and modification time of a file.
+ * @param path The path of the file.
+ * @param out_size Receives the size in bytes.
+ * @param out_mtime Receives the modification time in platform-specific units.
+ * @return true on success, false if the file cannot be inspected.
+ */
+static bool source_signature(const char *path, uint64_t *out_size, uint64_t *out_mtime)
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &info))
+        return false;
+
+    *out_size = (uint64_t)info.nFileSizeHigh << 32 | info.nFileSizeLow;
+    *out_mtime = (uint64_t)info.ftLastWriteTime.dwHighDateTime << 32 |
+                 info.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return false;
+
+    /* Nanoseconds catch rewrites within the same second */
+#if defined(__APPLE__)
+    const long nanos = st.st_mtimespec.tv_nsec;
+#else
+    const long nanos = st.st_mtim.tv_nsec;
+#endif
+    *out_size = (uint64_t)st.st_size;
+    *out_mtime = (uint64_t)st.st_mtime * 1000000000u + (uint64_t)nanos;
+#endif
+    return true;
+}
+
+bool csv_cache_key(const char *path, const CsvReadOptions *options, uint64_t *out_key)
+{
+    uint64_t size, mtime;
+    if (!path || !options || !options->delim || !out_key || !source_signature(path, &size, &mtime))
+        return false;
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = hash_value(hash, size);
+    hash = hash_value(hash, mtime);
+    hash = hash_value(hash, options->has_header);
+    hash = hash_value(hash, (unsigned char)options->delim[0]);
+    hash = hash_value(hash, options->usecols ? 1 : options->usecols_indices ? 2 : 0);
+    hash = hash_value(hash, options->usecols_count);
+    for (size_t i = 0; i < options->usecols_count; i++) {
+        if (options->usecols) {
+            const size_t len = strlen(options->usecols[i]);
+            hash = hash_value(hash, len);
+            hash = hash_bytes(hash, options->usecols[i], len);
+        } else if (options->usecols_indices) {
+            hash = hash_value(hash, (uint64_t)options->usecols_indices[i]);
+        }
+    }
+    hash = hash_value(hash, options->dictionary_encode);
+    hash = hash_value(hash, options->inference_rows);
+    hash = hash_value(hash, options->infer_integers);
+    hash = hash_value(hash, options->infer_dates);
+    hash = hash_value(hash, options->bad_rows);
+    hash = hash_value(hash, options->bad_row_log_limit);
+    hash = hash_value(hash, options->filter ? options->filter->count : 0);
+    for (size_t i = 0; options->filter && i < options->filter->count; i++) {
+        const FilterCondition *condition = &options->filter->conditions[i];
+        const size_t column_len = condition->column ? strlen(condition->column) : 0;
+        const size_t value_len = condition->value ? strlen(condition->value) : 0;
+        hash = hash_value(hash, (uint64_t)condition->op);
+        hash = hash_value(hash, column_len);
+        hash = hash_bytes(hash, condition->column, column_len);
+        hash = hash_value(hash, value_len);
+        hash = hash_bytes(hash, condition->value, value_len);
+    }
+
+    *out_key = hash;
+    return true;
+}
+
+/**
+ * @brief Builds the path of a file next to the source by appending a suffix.
+ * @param path The source path.
+ * @param suffix The suffix to append.
+ * @return The heap-allocated path, or NULL if allocation fails.
+ */
+static char *sidecar_path(const char *path, const char *suffix)
+{
+    const size_t path_len = strlen(path);
+    const size_t suffix_len = strlen(suffix);
+
+    char *result = malloc(path_len + suffix_len + 1);
+    if (result) {
+        memcpy(result, path, path_len);
+        memcpy(result + path_len, suffix, suffix_len + 1);
+    }
+    return result;
+}
+
+DataframeErrorCode csv_cache_store(const char *path, const uint64_t key, const DataFrame *df)
+{
+    if (!path || !df)
+        return DATAFRAME_ERR_WRITE_FAILED;
+
+    char *cache_path = sidecar_path(path, CSV_CACHE_SUFFIX);
+    if (!cache_path)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    const DataframeErrorCode err = dataframe_save_binary(df, cache_path, key);
+    free(cache_path);
+    return err;
+}
+
+DataframeErrorCode csv_cache_load(const char *path,
+                                  const uint64_t key,
+                                  const DataFrameLayout layout,
+                                  DataFrame **out_df)
+{
+    if (!out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+    if (!path)
+        return DATAFRAME_ERR_FILE_NOT_FOUND;
+
+    char *cache_path = sidecar_path(path, CSV_CACHE_SUFFIX);
+    if (!cache_path)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    /* A sidecar written for another state of the source carries another tag */
+    DataFrameBinaryOpenOptions options = dataframe_binary_default_open_options();
+    options.layout = layout;
+    options.check_tag = true;
+    options.tag = key;
+
+    const DataframeErrorCode err = dataframe_open_mmap_with_options(cache_path, &options, out_df);
+    free(cache_path);
+    return err;
+}
@@ -2,266 +2,1540 @@
 
 #include <ctype.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include "typedefs.h"
+#include "compressed_input.h"
+#include "csv_cache.h"
+#include "csv_scanner.h"
+#include "date_parser.h"
+#include "file_mapping.h"
+#include "number_parser.h"
+#include "parallel.h"
 
 /**
- * @brief Reads a single line from a file into a dynamically resizing buffer.
- * * @param file The file pointer to read from.
- * @param buffer Pointer to the character buffer pointer. Will be allocated/reallocated as needed.
- * @param capacity Pointer to the size variable tracking the current buffer capacity.
- * @return The number of characters read (excluding null terminator), or -1 if EOF or error.
+ * @brief Initial number of field slots reserved for tokenizing a record.
  */
-static ssize_t read_line(FILE *file, char **buffer, size_t *capacity)
-{
-    if (*buffer == NULL || *capacity == 0) {
-        *capacity = 256;
-        *buffer = malloc(*capacity);
-        if (!*buffer)
-            return -1;
-    }
+#define INITIAL_FIELD_CAPACITY 64
 
-    size_t length = 0;
-    int c;
+/**
+ * @brief Size of the blocks read from a stream by the non-mapped loader.
+ */
+#define STREAM_CHUNK_SIZE (256 * 1024)
 
-    while ((c = fgetc(file)) != EOF) {
-        if (length + 1 >= *capacity) {
-            const size_t new_cap = *capacity * 2;
-            char *tmp = realloc(*buffer, new_cap);
-            if (!tmp)
-                return -1;
-            *buffer = tmp;
-            *capacity = new_cap;
-        }
+/**
+ * @brief Number of leading bytes inspected to recognize compressed input.
+ */
+#define COMPRESSION_MAGIC_SIZE 4
 
-        (*buffer)[length++] = (char)c;
+/**
+ * @brief Number of input bytes indexed by the structural scanner per refill.
+ */
+#define SCAN_WINDOW_SIZE (64 * 1024)
 
-        if (c == '\n')
-            break;
-    }
+/**
+ * @brief Minimum number of input bytes handed to a single parsing thread.
+ */
+#define MIN_PARALLEL_CHUNK_SIZE (1024 * 1024)
+
+/**
+ * @brief A non-owning view of a single field inside a CSV buffer.
+ */
+typedef struct {
+    const char *begin; /*!< First character of the field. */
+    const char *end;   /*!< One past the last character of the field. */
+} CsvSpan;
 
-    if (length == 0 && c == EOF)
-        return -1;
+/**
+ * @brief Iterator over the field-boundary index of a buffer, refilled one window at a time.
+ */
+typedef struct {
+    const char *window;     /*!< Base address the stored offsets are relative to. */
+    const char *scanned_to; /*!< First byte that has not been indexed yet. */
+    const char *end;        /*!< One past the last byte of the buffer. */
+    uint32_t *positions;    /*!< Offsets of delimiters/newlines outside quotes in the window. */
+    size_t count;           /*!< Number of valid entries in positions. */
+    size_t next;            /*!< Index of the next entry to hand out. */
+    bool in_quotes;         /*!< Quote state at scanned_to. */
+    char delim;             /*!< The field delimiter character. */
+} StructuralCursor;
 
-    (*buffer)[length] = '\0';
-    return (ssize_t)length;
-}
+/**
+ * @brief Incremental state used to turn tokenized records into a DataFrame.
+ */
+typedef struct {
+    DataFrame *df;            /*!< The frame being filled (created on the first record). */
+    const CsvReadOptions *options; /*!< Caller options consulted on the first record. */
+    int source_cols;          /*!< Number of fields per record in the file. */
+    int *field_map;           /*!< Output column of each source field, -1 if skipped (NULL = all). */
+    uint32_t *positions;      /*!< Scratch index of SCAN_WINDOW_SIZE structural offsets. */
+    CsvSpan *fields;          /*!< Scratch array receiving the fields of the current record. */
+    int field_capacity;       /*!< Number of slots available in fields. */
+    bool has_header;          /*!< Whether the first record holds column names. */
+    bool types_detected;      /*!< Whether column types have been inferred yet. */
+    bool pause_when_typed;    /*!< Stop after the record that fixes the column types. */
+    size_t row_limit;         /*!< Stop once the frame holds this many rows (0 = unlimited). */
+    size_t row_capacity_hint; /*!< Number of row slots to reserve when creating the frame. */
+    size_t input_bytes;       /*!< Size of the whole input if parsed in one buffer, else 0. */
+    size_t inference_rows;    /*!< Number of data records sampled before types are fixed. */
+    CsvSpan *sample_fields;   /*!< Fields of the sampled records, cols entries per record. */
+    size_t sample_rows;       /*!< Number of records held in sample_fields. */
+    size_t sample_capacity;   /*!< Number of records sample_fields has room for. */
+    size_t sample_bytes;      /*!< Total size in bytes of the sampled records. */
+    MemoryArena sample_text;  /*!< Copies of the sampled fields' characters. */
+    const char *buffer_start; /*!< First byte of the buffer being parsed. */
+    const char *record_start; /*!< First byte of the record being added. */
+    const char *record_end;   /*!< First byte after the record being added. */
+    uint64_t base_offset;     /*!< Input offset of buffer_start. */
+    const char *line_mark;    /*!< Position up to which newlines have been counted. */
+    uint64_t lines_before;    /*!< Number of newlines in the input before line_mark. */
+    FilterTerm *filter_terms; /*!< The options' filter, compiled once the types are known. */
+    size_t filter_count;      /*!< Number of filter_terms. */
+} CsvBuilder;
 
 /**
- * @brief Removes leading and trailing whitespace, as well as surrounding quotes from a string.
- * * @param str The null-terminated string to be trimmed in-place.
- * @return A pointer to the first non-whitespace, non-quote character of the string.
+ * @brief Sequential block reader that keeps an unterminated trailing record between reads.
  */
-static char *trim_and_unquote(char *str)
+typedef struct {
+    FILE *file;                /*!< The stream being read. */
+    CompressedInput *inflater; /*!< Background decompressor of file, NULL for plain input. */
+    char *buffer;              /*!< Block buffer; its first length bytes are not yet consumed. */
+    size_t capacity;           /*!< Allocated size of buffer. */
+    size_t length;             /*!< Number of unconsumed bytes in buffer. */
+    bool at_eof;               /*!< Whether the stream has been fully read. */
+} BlockReader;
+
+/**
+ * @brief State of an open CSV batch stream.
+ */
+struct CsvStream {
+    CsvReadOptions options; /*!< Copy of the options the stream was opened with. */
+    BlockReader reader; /*!< Source of raw blocks. */
+    CsvBuilder builder; /*!< Builder whose frame is recycled as the batch buffer. */
+    char delim;         /*!< The field delimiter character. */
+};
+
+/**
+ * @brief Shared state of a multi-threaded parse over byte ranges of one buffer.
+ */
+typedef struct {
+    const char *region;        /*!< First byte of the split region (a record boundary). */
+    size_t region_size;        /*!< Number of bytes in the region. */
+    char delim;                /*!< The field delimiter character. */
+    int source_cols;           /*!< Number of fields per record in the file. */
+    int *field_map;            /*!< Column projection shared (read-only) by all chunks. */
+    FilterTerm *filter_terms;  /*!< Compiled row filter shared (read-only) by all chunks. */
+    size_t filter_count;       /*!< Number of filter_terms. */
+    size_t chunk_count;        /*!< Number of byte ranges the region is split into. */
+    size_t record_bytes;       /*!< Size of a typical record, used to pre-size partial frames. */
+    const DataFrame *schema;   /*!< Frame providing the column count and inferred types. */
+    const CsvReadOptions *options; /*!< Caller options (bad-row policy) shared by all chunks. */
+    uint64_t region_offset;    /*!< Input offset of region, for bad-row locations. */
+    size_t *quote_counts;      /*!< Number of quote characters in each raw byte range. */
+    size_t *newline_counts;    /*!< Number of newlines in each raw byte range. */
+    const char **starts;       /*!< First record of each chunk after resynchronization. */
+    bool *split_in_quotes;     /*!< Quote state at the start of each raw byte range. */
+    DataFrame **partials;      /*!< Rows parsed by each chunk, in input order. */
+    DataframeErrorCode *errors; /*!< Result of each chunk. */
+} ParallelParseJob;
+
+/**
+ * @brief Narrows a raw field to its content, mirroring trim_and_unquote without modifying input.
+ * @param begin First character of the raw field.
+ * @param end One past the last character of the raw field.
+ * @return The trimmed span with surrounding whitespace and quotes removed.
+ */
+static CsvSpan trim_span(const char *begin, const char *end)
 {
-    while (isspace((unsigned char)*str))
-        str++;
-    if (*str == '"') {
-        str++;
-        char *end = str + strlen(str) - 1;
-        while (end > str && (isspace((unsigned char)*end) || *end == '"')) {
-            *end = '\0';
+    while (begin < end && isspace((unsigned char)*begin))
+        begin++;
+
+    if (begin < end && *begin == '"') {
+        begin++;
+        while (end > begin && (isspace((unsigned char)end[-1]) || end[-1] == '"'))
             end--;
-        }
     } else {
-        char *end = str + strlen(str) - 1;
-        while (end > str && isspace((unsigned char)*end)) {
-            *end = '\0';
+        while (end > begin && isspace((unsigned char)end[-1]))
             end--;
-        }
     }
 
-    return str;
+    return (CsvSpan){begin, end};
+}
+
+/**
+ * @brief Positions a structural cursor at the start of a record.
+ * @param sc The cursor to initialize.
+ * @param from The first byte of the record (always outside quotes).
+ * @param end One past the last byte of the buffer.
+ * @param delim The field delimiter character.
+ * @param positions Scratch index with room for SCAN_WINDOW_SIZE offsets.
+ */
+static void structural_cursor_reset(StructuralCursor *sc,
+                                    const char *from,
+                                    const char *end,
+                                    const char delim,
+                                    uint32_t *positions)
+{
+    sc->window = from;
+    sc->scanned_to = from;
+    sc->end = end;
+    sc->positions = positions;
+    sc->count = 0;
+    sc->next = 0;
+    sc->in_quotes = false;
+    sc->delim = delim;
 }
 
 /**
- * @brief Parses a single CSV line into an array of tokens.
- * * Safely handles quoted sections containing the delimiter. It modifies the
- * input line in-place by inserting null terminators.
+ * @brief Returns the next delimiter or newline outside quotes, indexing more input as needed.
+ * @param sc The structural cursor.
+ * @return A pointer to the structural character, or NULL once the buffer is exhausted.
+ */
+static const char *next_structural(StructuralCursor *sc)
+{
+    while (sc->next == sc->count) {
+        if (sc->scanned_to >= sc->end)
+            return NULL;
+
+        const size_t remaining = (size_t)(sc->end - sc->scanned_to);
+        const size_t len = remaining < SCAN_WINDOW_SIZE ? remaining : SCAN_WINDOW_SIZE;
+
+        sc->window = sc->scanned_to;
+        sc->count =
+            csv_scan_structurals(sc->window, len, sc->delim, &sc->in_quotes, sc->positions);
+        sc->next = 0;
+        sc->scanned_to += len;
+    }
+
+    return sc->window + sc->positions[sc->next++];
+}
+
+/**
+ * @brief Splits the next record into field spans using the structural index.
  *
- * @param line The raw line string read from the CSV.
- * @param tokens Array of character pointers where the resulting tokens will be stored.
- * @param max_cols The maximum number of expected columns to prevent buffer overflow.
- * @param delim The delimiter character used to separate fields.
- * @return The actual number of parsed tokens (columns).
+ * Delimiters and newlines inside double quotes do not terminate a field. A
+ * trailing carriage return is stripped from the record. The cursor is advanced
+ * past the record's terminating newline.
+ *
+ * @param sc The structural cursor, positioned at the start of the record.
+ * @param cursor Pointer to the current read position; updated to the next record.
+ * @param fields Array receiving the trimmed spans of the kept fields.
+ * @param max_fields The number of source fields that may be stored (the field_map length).
+ * @param field_map Output slot of each source field, -1 to skip it, or NULL to keep all.
+ * @param out_complete Set to true if the record was terminated by a newline, false if it ran
+ * into the end of the buffer.
+ * @return The number of fields in the record (may exceed max_fields), or 0 for a blank record.
  */
-static int parse_line_to_tokens(char *line, char **tokens, const int max_cols, const char *delim)
+static int split_record(StructuralCursor *sc,
+                        const char **cursor,
+                        CsvSpan *fields,
+                        const int max_fields,
+                        const int *field_map,
+                        bool *out_complete)
 {
+    const char *start = *cursor;
+    const char *ptr;
     int count = 0;
-    char *ptr = line;
-    bool in_quotes = false;
-    char *start = line;
-
-    while (*ptr) {
-        if (*ptr == '"') {
-            in_quotes = !in_quotes;
-        } else if (*ptr == delim[0] && !in_quotes) {
-            *ptr = '\0';
-
-            if (count < max_cols) {
-                tokens[count] = trim_and_unquote(start);
-            }
 
-            count++;
-            start = ptr + 1;
+    while ((ptr = next_structural(sc)) != NULL && *ptr != '\n') {
+        /* Projected-out fields are only delimited, never trimmed, copied or converted */
+        if (count < max_fields) {
+            if (!field_map)
+                fields[count] = trim_span(start, ptr);
+            else if (field_map[count] >= 0)
+                fields[field_map[count]] = trim_span(start, ptr);
         }
-        ptr++;
+        count++;
+        start = ptr + 1;
     }
 
-    if (count < max_cols) {
-        tokens[count] = trim_and_unquote(start);
+    *out_complete = ptr != NULL;
+    *cursor = ptr ? ptr + 1 : sc->end;
+
+    const char *record_end = ptr ? ptr : sc->end;
+    if (record_end > start && record_end[-1] == '\r')
+        record_end--;
+
+    /* A record with no delimiters and no content is a blank line */
+    if (count == 0 && record_end == start)
+        return 0;
+
+    if (count < max_fields) {
+        if (!field_map)
+            fields[count] = trim_span(start, record_end);
+        else if (field_map[count] >= 0)
+            fields[field_map[count]] = trim_span(start, record_end);
     }
-    count++;
+    return count + 1;
+}
 
-    return count;
+/**
+ * @brief Duplicates a span into a newly allocated null-terminated string.
+ * @param span The span to copy.
+ * @return A malloc'd copy (used for column names), or NULL on allocation failure.
+ */
+static char *span_strdup(const CsvSpan *span)
+{
+    const size_t len = (size_t)(span->end - span->begin);
+    char *copy = malloc(len + 1);
+    if (!copy)
+        return NULL;
+
+    memcpy(copy, span->begin, len);
+    copy[len] = '\0';
+    return copy;
 }
 
-DataframeErrorCode
-read_csv(const char *path, const bool has_header, const char *delim, DataFrame **out_df)
+/**
+ * @brief Converts the leading numeric part of a span.
+ * @param span The span to convert.
+ * @param out_value Pointer receiving the parsed value.
+ * @return The number of characters consumed (0 if no number was found).
+ */
+static inline size_t parse_number_span(const CsvSpan *span, double *out_value)
 {
-    if (!out_df)
+    return parse_double_span(span->begin, span->end, out_value);
+}
+
+/**
+ * @brief Checks whether a span holds exactly the given null-terminated string.
+ * @param span The span to compare.
+ * @param str The string to compare against.
+ * @return true if both contain the same characters.
+ */
+static bool span_equals(const CsvSpan *span, const char *str)
+{
+    const size_t len = (size_t)(span->end - span->begin);
+    return strlen(str) == len && memcmp(span->begin, str, len) == 0;
+}
+
+/**
+ * @brief Resolves the usecols options against the first record into a source-to-output map.
+ *
+ * Names are matched against the header fields, or against the generated
+ * "col_N" names when the file has no header. Selected columns keep their
+ * order of appearance in the file.
+ *
+ * @param builder The builder; receives field_map (left NULL when every column is kept).
+ * @param count The number of fields in the first record.
+ * @param out_cols Pointer receiving the number of output columns.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode resolve_projection(CsvBuilder *builder, const int count, int *out_cols)
+{
+    const CsvReadOptions *options = builder->options;
+    *out_cols = count;
+
+    if (!options || options->usecols_count == 0 || (!options->usecols && !options->usecols_indices))
+        return DATAFRAME_SUCCESS;
+
+    int *map = malloc((size_t)count * sizeof(int));
+    if (!map)
         return DATAFRAME_ERR_ALLOCATION_FAILED;
-    *out_df = NULL;
+    for (int c = 0; c < count; c++) {
+        map[c] = -1;
+    }
 
-    FILE *file = fopen(path, "r");
-    if (!file)
-        return DATAFRAME_ERR_FILE_NOT_FOUND;
+    for (size_t i = 0; i < options->usecols_count; i++) {
+        int source = -1;
+
+        if (options->usecols) {
+            for (int c = 0; c < count && source < 0; c++) {
+                char generated[32];
+                snprintf(generated, sizeof(generated), "col_%d", c + 1);
+
+                const bool match = builder->has_header
+                                       ? span_equals(&builder->fields[c], options->usecols[i])
+                                       : strcmp(generated, options->usecols[i]) == 0;
+                if (match)
+                    source = c;
+            }
+        } else if (options->usecols_indices[i] >= 0 && options->usecols_indices[i] < count) {
+            source = options->usecols_indices[i];
+        }
 
-    char *line = NULL;
-    size_t capacity = 0;
+        if (source < 0) {
+            free(map);
+            return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+        }
+        map[source] = 0;
+    }
 
-    ssize_t read_len = read_line(file, &line, &capacity);
-    if (read_len <= 0) {
-        if (line)
-            free(line);
-        fclose(file);
-        return DATAFRAME_ERR_EMPTY_FILE;
+    int output = 0;
+    for (int c = 0; c < count; c++) {
+        if (map[c] >= 0)
+            map[c] = output++;
     }
 
-    int expected_cols = 0;
-    bool in_q = false;
-    for (const char *p = line; *p; p++) {
-        if (*p == '"')
-            in_q = !in_q;
-        if (*p == delim[0] && !in_q)
-            expected_cols++;
+    builder->field_map = map;
+    *out_cols = output;
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Checks whether a field is one of the placeholders commonly used for missing data.
+ * @param span The field to test.
+ * @return true for empty fields and tokens such as "NA", "N/A" or "null".
+ */
+static bool is_missing_token(const CsvSpan *span)
+{
+    static const char *const TOKENS[] = {"NA", "N/A", "null", "NULL", "None"};
+
+    if (span->begin == span->end)
+        return true;
+    for (size_t i = 0; i < sizeof(TOKENS) / sizeof(TOKENS[0]); i++) {
+        if (span_equals(span, TOKENS[i]))
+            return true;
     }
-    expected_cols++;
+    return false;
+}
 
-    int data_rows_count = 0;
-    while ((read_len = read_line(file, &line, &capacity)) > 0) {
-        if (read_len > 1 || (line[0] != '\n' && line[0] != '\r')) {
-            data_rows_count++;
-        }
+/**
+ * @brief Counts the newline characters in a range of the input.
+ * @param begin First byte of the range.
+ * @param end One past the last byte of the range.
+ * @return The number of '\n' bytes in [begin, end).
+ */
+static uint64_t count_newlines(const char *begin, const char *end)
+{
+    uint64_t lines = 0;
+    while (begin < end) {
+        const char *newline = memchr(begin, '\n', (size_t)(end - begin));
+        if (!newline)
+            break;
+        lines++;
+        begin = newline + 1;
     }
+    return lines;
+}
+
+/**
+ * @brief Checks whether malformed records are tolerated rather than fatal.
+ * @param builder The builder state.
+ * @return true if the bad_rows policy is skip or pad.
+ */
+static bool tolerates_bad_rows(const CsvBuilder *builder)
+{
+    return builder->options && builder->options->bad_rows != CSV_BAD_ROWS_ERROR;
+}
+
+/**
+ * @brief Handles a record whose field count differs from the header's.
+ *
+ * Under the default policy this is an error. Otherwise the record's location
+ * is logged and, when padding, absent fields are replaced by empty spans so
+ * that they become missing values.
+ *
+ * @param builder The builder state; record_start marks the record.
+ * @param count The number of fields in the record.
+ * @param out_skip Set to true if the record must not be added.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_MISMATCH or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode
+handle_bad_record(CsvBuilder *builder, const int count, bool *out_skip)
+{
+    if (!tolerates_bad_rows(builder))
+        return DATAFRAME_ERR_COLUMN_MISMATCH;
 
-    if (!has_header)
-        data_rows_count++;
-    rewind(file);
+    /* Newlines are only counted up to the last bad record, never on the clean path */
+    const char *record = builder->record_start;
+    builder->lines_before += count_newlines(builder->line_mark, record);
+    builder->line_mark = record;
 
-    DataFrame *df = create_dataframe((size_t)data_rows_count, (size_t)expected_cols);
-    if (!df) {
-        free(line);
-        fclose(file);
+    DataFrameBadRow entry;
+    entry.line = builder->lines_before + 1;
+    entry.offset = builder->base_offset + (uint64_t)(record - builder->buffer_start);
+    entry.fields = (uint32_t)count;
+    if (!dataframe_log_bad_row(builder->df, &entry, builder->options->bad_row_log_limit))
         return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    *out_skip = builder->options->bad_rows == CSV_BAD_ROWS_SKIP;
+    for (int c = count; c < builder->source_cols; c++) {
+        const int out = builder->field_map ? builder->field_map[c] : c;
+        if (out >= 0)
+            builder->fields[out] = (CsvSpan){record, record};
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Checks a data record against the row filter before any of its fields is stored.
+ * @param builder The builder state; the filter must already be compiled.
+ * @param fields The record's fields in output column order.
+ * @return true if the record satisfies every filter term (or there is no filter).
+ */
+static bool record_passes_filter(const CsvBuilder *builder, const CsvSpan *fields)
+{
+    for (size_t t = 0; t < builder->filter_count; t++) {
+        const FilterTerm *term = &builder->filter_terms[t];
+        if (!dataframe_filter_matches_field(term, fields[term->col].begin, fields[term->col].end))
+            return false;
     }
+    return true;
+}
+
+/**
+ * @brief Converts the fields of one data record into a new row of the frame.
+ * @param builder The builder state; the column types must already be known.
+ * @param fields The record's fields in output column order.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode append_record(CsvBuilder *builder, const CsvSpan *fields)
+{
+    DataFrame *df = builder->df;
 
-    char **row_tokens = malloc((size_t)expected_cols * sizeof(char *));
-    if (!row_tokens) {
-        free_dataframe(df);
-        free(line);
-        fclose(file);
+    const int r = dataframe_push_row(df);
+    if (r < 0)
         return DATAFRAME_ERR_ALLOCATION_FAILED;
+    DataCell *row = df->layout == DATAFRAME_LAYOUT_ROWS ? df->data[r] : NULL;
+
+    for (int c = 0; c < df->cols; c++) {
+        const size_t len = (size_t)(fields[c].end - fields[c].begin);
+        DataCell *cell = row ? &row[c] : &df->col_data[c][r];
+        double value;
+        int64_t integer;
+        bool parsed;
+
+        switch (df->col_types[c]) {
+        case TYPE_CATEGORY:
+            cell->v_code = dataframe_intern_string(df, c, fields[c].begin, len);
+            if (cell->v_code < 0)
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+            continue;
+        case TYPE_STRING:
+            cell->v_str = dataframe_store_string(df, fields[c].begin, len);
+            if (!cell->v_str)
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+            continue;
+        case TYPE_INT64:
+            parsed = len && parse_int64_span(fields[c].begin, fields[c].end, &integer) == len;
+            cell->v_int = parsed ? integer : DATAFRAME_NULL_INT64;
+            break;
+        case TYPE_DATE:
+            parsed = parse_date_span(fields[c].begin, fields[c].end, &integer);
+            cell->v_int = parsed ? integer : DATAFRAME_NULL_INT64;
+            break;
+        case TYPE_TIMESTAMP:
+            parsed = parse_timestamp_span(fields[c].begin, fields[c].end, &integer);
+            cell->v_int = parsed ? integer : DATAFRAME_NULL_INT64;
+            break;
+        default:
+            parsed = len && parse_number_span(&fields[c], &value) > 0;
+            cell->v_num = parsed ? value : NAN;
+            break;
+        }
+
+        /* Fields that hold no value are recorded in the column's validity bitmap */
+        if (!parsed && !dataframe_set_valid(df, r, c, false))
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
     }
 
-    int current_r = 0;
-    bool is_first_line = true;
-    bool types_detected = false;
+    return DATAFRAME_SUCCESS;
+}
 
-    while (read_line(file, &line, &capacity) > 0) {
-        line[strcspn(line, "\r\n")] = 0;
+/**
+ * @brief Copies a data record into the type inference sample.
+ *
+ * The fields are copied because the input buffer may be recycled before the
+ * sample is complete.
+ *
+ * @param builder The builder state.
+ * @param fields The record's fields in output column order.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode stage_sample_record(CsvBuilder *builder, const CsvSpan *fields)
+{
+    const size_t cols = (size_t)builder->df->cols;
+
+    if (builder->sample_rows == builder->sample_capacity) {
+        const size_t capacity = builder->sample_capacity ? builder->sample_capacity * 2 : 16;
+        CsvSpan *grown = realloc(builder->sample_fields, capacity * cols * sizeof(CsvSpan));
+        if (!grown)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        builder->sample_fields = grown;
+        builder->sample_capacity = capacity;
+    }
+
+    CsvSpan *staged = builder->sample_fields + builder->sample_rows * cols;
+    for (size_t c = 0; c < cols; c++) {
+        const size_t len = (size_t)(fields[c].end - fields[c].begin);
+        char *copy = arena_strndup(&builder->sample_text, fields[c].begin, len);
+        if (!copy)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        staged[c].begin = copy;
+        staged[c].end = copy + len;
+    }
+
+    builder->sample_rows++;
+    builder->sample_bytes += (size_t)(builder->record_end - builder->record_start);
+    return DATAFRAME_SUCCESS;
+}
 
-        if (line[0] == '\0')
+/**
+ * @brief Chooses the narrowest type that fits every non-missing sampled value of a column.
+ *
+ * Integers are preferred over floating-point numbers, numbers over dates,
+ * dates over timestamps and timestamps over text. A column with no values in
+ * the sample is numeric.
+ *
+ * @param builder The builder state holding the sample.
+ * @param col The output column index.
+ * @return The inferred DataType.
+ */
+static DataType infer_column_type(const CsvBuilder *builder, const int col)
+{
+    const CsvReadOptions *options = builder->options;
+    const size_t cols = (size_t)builder->df->cols;
+
+    bool seen = false;
+    bool all_int64 = options && options->infer_integers;
+    bool all_numeric = true;
+    bool all_dates = options && options->infer_dates;
+    bool all_timestamps = all_dates;
+
+    for (size_t r = 0; r < builder->sample_rows; r++) {
+        const CsvSpan *field = &builder->sample_fields[r * cols + (size_t)col];
+        if (is_missing_token(field))
             continue;
 
-        int const actual_cols = parse_line_to_tokens(line, row_tokens, expected_cols, delim);
+        const size_t len = (size_t)(field->end - field->begin);
+        double value;
+        int64_t integer;
+        seen = true;
 
-        if (actual_cols != expected_cols) {
-            free(row_tokens);
-            free_dataframe(df);
-            free(line);
-            fclose(file);
-            return DATAFRAME_ERR_COLUMN_MISMATCH;
-        }
+        if (all_int64 && parse_int64_span(field->begin, field->end, &integer) != len)
+            all_int64 = false;
+        if (all_numeric && parse_number_span(field, &value) != len)
+            all_numeric = false;
+        if (all_dates && !parse_date_span(field->begin, field->end, &integer))
+            all_dates = false;
+        if (all_timestamps && !parse_timestamp_span(field->begin, field->end, &integer))
+            all_timestamps = false;
+        if (!all_int64 && !all_numeric && !all_timestamps)
+            break;
+    }
 
-        if (is_first_line) {
-            is_first_line = false;
+    if (!seen)
+        return TYPE_NUMERIC;
+    if (all_int64)
+        return TYPE_INT64;
+    if (all_numeric)
+        return TYPE_NUMERIC;
+    if (all_dates)
+        return TYPE_DATE;
+    if (all_timestamps)
+        return TYPE_TIMESTAMP;
+    return options && options->dictionary_encode ? TYPE_CATEGORY : TYPE_STRING;
+}
+
+/**
+ * @brief Releases the type inference sample.
+ * @param builder The builder state.
+ */
+static void release_sample(CsvBuilder *builder)
+{
+    free(builder->sample_fields);
+    arena_release(&builder->sample_text);
+    builder->sample_fields = NULL;
+    builder->sample_capacity = 0;
+    builder->sample_rows = 0;
+    builder->sample_bytes = 0;
+}
 
-            if (has_header) {
-                for (int c = 0; c < expected_cols; c++) {
-                    // strdup alokuje łańcuch zwykłym mallocem, co jest kompatybilne z naszym free() w free_dataframe
-                    df->columns[c] = strdup(row_tokens[c]);
-                }
+/**
+ * @brief Fixes the column types from the sample, compiles the row filter and appends the
+ * sampled records that pass it as rows.
+ * @param builder The builder state.
+ * @return DATAFRAME_SUCCESS, a dataframe_predicate_compile error or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode finish_type_inference(CsvBuilder *builder)
+{
+    DataFrame *df = builder->df;
+    if (!df || builder->types_detected)
+        return DATAFRAME_SUCCESS;
+
+    for (int c = 0; c < df->cols; c++) {
+        df->col_types[c] = infer_column_type(builder, c);
+    }
+    builder->types_detected = true;
+
+    /* Size the row table from the sampled records' average width instead of a counting pass */
+    if (builder->input_bytes && builder->sample_rows) {
+        const size_t record_bytes = builder->sample_bytes / builder->sample_rows;
+        const size_t rows = builder->input_bytes / (record_bytes ? record_bytes : 1) + 1;
+        if (!dataframe_reserve_rows(df, rows))
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    DataframeErrorCode err = DATAFRAME_SUCCESS;
+    const FilterPredicate *filter = builder->options ? builder->options->filter : NULL;
+    if (filter) {
+        err = dataframe_predicate_compile(df, filter, &builder->filter_terms);
+        builder->filter_count = err == DATAFRAME_SUCCESS ? filter->count : 0;
+    }
+
+    for (size_t r = 0; r < builder->sample_rows && err == DATAFRAME_SUCCESS; r++) {
+        const CsvSpan *fields = builder->sample_fields + r * (size_t)df->cols;
+        if (record_passes_filter(builder, fields))
+            err = append_record(builder, fields);
+    }
+
+    release_sample(builder);
+    return err;
+}
+
+/**
+ * @brief Consumes one tokenized record: creates the frame, reads headers, samples records for
+ * type inference and appends data rows.
+ * @param builder The builder state; its fields array holds the record's spans.
+ * @param count The number of fields in the record.
+ * @return DATAFRAME_SUCCESS, or an error code on allocation failure or (unless tolerated) column
+ * mismatch.
+ */
+static DataframeErrorCode builder_add_record(CsvBuilder *builder, const int count)
+{
+    CsvSpan *fields = builder->fields;
+
+    if (!builder->df) {
+        int output_cols;
+        const DataframeErrorCode err = resolve_projection(builder, count, &output_cols);
+        if (err != DATAFRAME_SUCCESS)
+            return err;
+        builder->source_cols = count;
+
+        const DataFrameLayout layout =
+            builder->options ? builder->options->layout : DATAFRAME_LAYOUT_ROWS;
+        builder->df = create_dataframe_with_layout(
+            builder->row_capacity_hint, (size_t)output_cols, layout);
+        if (!builder->df || dataframe_enable_validity(builder->df) != DATAFRAME_SUCCESS)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+        /* The first record was split without the map; compact it to the output layout */
+        DataFrame *df = builder->df;
+        for (int c = 0; c < count; c++) {
+            const int out = builder->field_map ? builder->field_map[c] : c;
+            if (out < 0)
                 continue;
-            }
 
-            for (int c = 0; c < expected_cols; c++) {
+            if (builder->has_header) {
+                df->columns[out] = span_strdup(&fields[c]);
+            } else {
                 char buf[32];
                 snprintf(buf, sizeof(buf), "col_%d", c + 1);
-                df->columns[c] = strdup(buf);
+                df->columns[out] = strdup(buf);
             }
+            if (!df->columns[out])
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+            fields[out] = fields[c];
+        }
+        if (dataframe_index_columns(df) != DATAFRAME_SUCCESS)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+        if (builder->has_header)
+            return DATAFRAME_SUCCESS;
+    }
+
+    if (count != builder->source_cols) {
+        bool skip = false;
+        const DataframeErrorCode err = handle_bad_record(builder, count, &skip);
+        if (err != DATAFRAME_SUCCESS || skip)
+            return err;
+    }
+
+    if (builder->types_detected) {
+        if (!record_passes_filter(builder, fields))
+            return DATAFRAME_SUCCESS;
+        return append_record(builder, fields);
+    }
+
+    /* Hold the first data records back until the sample that fixes the types is complete */
+    const DataframeErrorCode err = stage_sample_record(builder, fields);
+    if (err != DATAFRAME_SUCCESS || builder->sample_rows < builder->inference_rows)
+        return err;
+    return finish_type_inference(builder);
+}
+
+/**
+ * @brief Prepares a builder and allocates its tokenizer scratch buffers.
+ * @param builder The builder to initialize.
+ * @param has_header Whether the first record holds column names.
+ * @param field_capacity Initial number of field slots (the expected column count if known).
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode
+builder_init(CsvBuilder *builder, const bool has_header, const int field_capacity)
+{
+    memset(builder, 0, sizeof(*builder));
+    builder->has_header = has_header;
+    builder->inference_rows = 1;
+    builder->field_capacity = field_capacity;
+    builder->fields = malloc((size_t)field_capacity * sizeof(CsvSpan));
+    builder->positions = malloc(SCAN_WINDOW_SIZE * sizeof(uint32_t));
+
+    if (!builder->fields || !builder->positions) {
+        free(builder->fields);
+        free(builder->positions);
+        builder->fields = NULL;
+        builder->positions = NULL;
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Frees the builder's scratch buffers (the frame itself is left to the caller).
+ * @param builder The builder to release.
+ */
+static void builder_release_scratch(CsvBuilder *builder)
+{
+    release_sample(builder);
+    free(builder->fields);
+    free(builder->positions);
+    free(builder->field_map);
+    free(builder->filter_terms);
+    builder->fields = NULL;
+    builder->positions = NULL;
+    builder->field_map = NULL;
+    builder->filter_terms = NULL;
+    builder->filter_count = 0;
+}
+
+/**
+ * @brief Tokenizes the records of an in-memory CSV buffer and feeds them to the builder.
+ *
+ * When is_final is false the buffer is one block of a larger stream: a trailing
+ * record that is not yet terminated by a newline is left unconsumed so that it can
+ * be completed by the next block.
+ *
+ * @param builder The builder state to fill.
+ * @param data The first byte of the buffer.
+ * @param size The number of bytes in the buffer.
+ * @param delim The delimiter character used to separate fields.
+ * @param is_final Whether no further data follows this buffer.
+ * @param out_consumed Pointer receiving the number of bytes fully processed (can be NULL).
+ * @return DATAFRAME_SUCCESS, or an error code from tokenization or frame construction.
+ */
+static DataframeErrorCode parse_buffer(CsvBuilder *builder,
+                                       const char *data,
+                                       const size_t size,
+                                       const char delim,
+                                       const bool is_final,
+                                       size_t *out_consumed)
+{
+    const char *cursor = data;
+    const char *end = data + size;
+    DataframeErrorCode err = DATAFRAME_SUCCESS;
+
+    StructuralCursor sc;
+    structural_cursor_reset(&sc, data, end, delim, builder->positions);
+    builder->buffer_start = data;
+    builder->line_mark = data;
+
+    while (cursor < end) {
+        const char *record_start = cursor;
+        const int limit = builder->field_map ? builder->source_cols : builder->field_capacity;
+        bool complete;
+        int count =
+            split_record(&sc, &cursor, builder->fields, limit, builder->field_map, &complete);
+
+        if (!complete && !is_final) {
+            cursor = record_start;
+            break;
         }
+        if (count == 0)
+            continue;
 
-        if (!types_detected) {
-            for (int c = 0; c < expected_cols; c++) {
-                char *endptr;
-                const char *token = row_tokens[c];
-                while (isspace((unsigned char)*token))
-                    token++;
-
-                if (*token == '\0') {
-                    df->col_types[c] = TYPE_NUMERIC;
-                } else {
-                    strtod(token, &endptr);
-                    if (token != endptr && *endptr == '\0') {
-                        df->col_types[c] = TYPE_NUMERIC;
-                    } else {
-                        df->col_types[c] = TYPE_STRING;
-                    }
-                }
+        /* Only the first record may widen the scratch array; later ones are mismatches */
+        if (count > limit && builder->df && !tolerates_bad_rows(builder)) {
+            err = DATAFRAME_ERR_COLUMN_MISMATCH;
+            break;
+        }
+        if (count > limit && !builder->df) {
+            CsvSpan *wider = realloc(builder->fields, (size_t)count * sizeof(CsvSpan));
+            if (!wider) {
+                err = DATAFRAME_ERR_ALLOCATION_FAILED;
+                break;
             }
-            types_detected = true;
+            builder->fields = wider;
+            builder->field_capacity = count;
+
+            cursor = record_start;
+            structural_cursor_reset(&sc, record_start, end, delim, builder->positions);
+            count = split_record(&sc, &cursor, builder->fields, count, NULL, &complete);
         }
 
-        for (int c = 0; c < expected_cols; c++) {
-            const char *token = row_tokens[c];
-            while (isspace((unsigned char)*token))
-                token++;
+        /* A buffer holding the whole input lets the sampled records size the row table */
+        const bool filtered = builder->options && builder->options->filter;
+        if (!builder->df && builder->row_capacity_hint == 0 && is_final && !filtered)
+            builder->input_bytes = size;
 
-            if (df->col_types[c] == TYPE_STRING) {
-                df->data[current_r][c].v_str = strdup(token);
-            } else {
-                if (*token == '\0') {
-                    df->data[current_r][c].v_num = NAN;
-                } else {
-                    char *endptr;
-                    const double val = strtod(token, &endptr);
-                    df->data[current_r][c].v_num = token == endptr ? NAN : val;
-                }
+        builder->record_start = record_start;
+        builder->record_end = cursor;
+        err = builder_add_record(builder, count);
+        if (err != DATAFRAME_SUCCESS)
+            break;
+
+        if (builder->pause_when_typed && builder->types_detected)
+            break;
+        if (builder->row_limit && builder->df && (size_t)builder->df->rows >= builder->row_limit)
+            break;
+    }
+
+    /* Carry the position over to the next block so later bad records get absolute locations */
+    if (tolerates_bad_rows(builder))
+        builder->lines_before += count_newlines(builder->line_mark, cursor);
+    builder->base_offset += (uint64_t)(cursor - data);
+
+    if (out_consumed)
+        *out_consumed = (size_t)(cursor - data);
+    return err;
+}
+
+/**
+ * @brief Returns the raw (not yet record-aligned) start offset of a chunk.
+ * @param job The parallel job.
+ * @param chunk The chunk index (chunk_count denotes the end of the region).
+ * @return The byte offset into the region.
+ */
+static size_t chunk_split_offset(const ParallelParseJob *job, const size_t chunk)
+{
+    if (chunk >= job->chunk_count)
+        return job->region_size;
+    return job->region_size / job->chunk_count * chunk;
+}
+
+/**
+ * @brief Pass 1 task: counts the quote and newline characters in one raw byte range.
+ *
+ * Newline counts let bad records found by the chunks be given absolute line numbers.
+ *
+ * @param context The ParallelParseJob.
+ * @param chunk The chunk index.
+ */
+static void count_quotes_task(void *context, const size_t chunk)
+{
+    ParallelParseJob *job = context;
+    const char *ptr = job->region + chunk_split_offset(job, chunk);
+    const char *end = job->region + chunk_split_offset(job, chunk + 1);
+
+    size_t quotes = 0;
+    size_t newlines = 0;
+    for (; ptr < end; ptr++) {
+        quotes += *ptr == '"';
+        newlines += *ptr == '\n';
+    }
+    job->quote_counts[chunk] = quotes;
+    job->newline_counts[chunk] = newlines;
+}
+
+/**
+ * @brief Moves a raw split offset forward to the start of the next record.
+ *
+ * The quote state at the split offset is known from the quote-count prefix, so
+ * a split that falls inside a quoted field (even one spanning lines) skips to
+ * the first newline that really terminates a record.
+ *
+ * @param job The parallel job.
+ * @param chunk The chunk index whose start should be resolved.
+ * @param positions Scratch index with room for SCAN_WINDOW_SIZE offsets.
+ * @return A pointer to the first byte of the chunk's first record.
+ */
+static const char *
+resync_to_record(const ParallelParseJob *job, const size_t chunk, uint32_t *positions)
+{
+    const char *end = job->region + job->region_size;
+    if (chunk == 0)
+        return job->region;
+    if (chunk >= job->chunk_count)
+        return end;
+
+    StructuralCursor sc;
+    structural_cursor_reset(
+        &sc, job->region + chunk_split_offset(job, chunk), end, job->delim, positions);
+    sc.in_quotes = job->split_in_quotes[chunk];
+
+    const char *ptr;
+    while ((ptr = next_structural(&sc)) != NULL) {
+        if (*ptr == '\n')
+            return ptr + 1;
+    }
+    return end;
+}
+
+/**
+ * @brief Pass 2 task: parses the records of one chunk into a private partial frame.
+ * @param context The ParallelParseJob.
+ * @param chunk The chunk index.
+ */
+static void parse_chunk_task(void *context, const size_t chunk)
+{
+    ParallelParseJob *job = context;
+    const DataFrame *schema = job->schema;
+
+    CsvBuilder builder;
+    DataframeErrorCode err = builder_init(&builder, false, schema->cols);
+    builder.types_detected = true;
+    builder.source_cols = job->source_cols;
+    builder.field_map = job->field_map;
+    builder.filter_terms = job->filter_terms;
+    builder.filter_count = job->filter_count;
+    builder.options = job->options;
+
+    if (err == DATAFRAME_SUCCESS) {
+        const char *start = resync_to_record(job, chunk, builder.positions);
+        const char *stop = resync_to_record(job, chunk + 1, builder.positions);
+        const size_t size = (size_t)(stop - start);
+        job->starts[chunk] = start;
+
+        /* Line numbers stay relative to the chunk until the chunks are stitched together */
+        builder.base_offset = job->region_offset + (uint64_t)(start - job->region);
+
+        builder.df = create_dataframe_with_layout(
+            size / job->record_bytes + 1, (size_t)schema->cols, schema->layout);
+        if (builder.df && dataframe_enable_validity(builder.df) == DATAFRAME_SUCCESS) {
+            memcpy(builder.df->col_types, schema->col_types, (size_t)schema->cols * sizeof(DataType));
+            err = parse_buffer(&builder, start, size, job->delim, true, NULL);
+        } else {
+            err = DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+    }
+
+    /* Borrowed from the main builder */
+    builder.field_map = NULL;
+    builder.filter_terms = NULL;
+    builder_release_scratch(&builder);
+    job->partials[chunk] = builder.df;
+    job->errors[chunk] = err;
+}
+
+/**
+ * @brief Appends the bad-row log of a chunk's partial frame to the final frame.
+ * @param dst The final frame.
+ * @param partial The chunk's frame, whose line numbers are relative to the chunk start.
+ * @param lines_before Number of newlines in the input before the chunk's first record.
+ * @param max_logged The maximum number of entries the final log may hold.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode merge_bad_rows(DataFrame *dst,
+                                         const DataFrame *partial,
+                                         const uint64_t lines_before,
+                                         const size_t max_logged)
+{
+    const DataFrameBadRowLog *log = &partial->bad_rows;
+
+    for (size_t i = 0; i < log->count; i++) {
+        DataFrameBadRow entry = log->entries[i];
+        entry.line += lines_before;
+        if (!dataframe_log_bad_row(dst, &entry, max_logged))
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    dst->bad_rows.total += log->total - log->count;
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Tokenizes an in-memory buffer using several threads.
+ *
+ * The header and the type inference sample are parsed on the calling thread to fix
+ * the schema. The rest is split into equal byte ranges; a first parallel pass counts
+ * quotes per range so every split point's quote state is known, then each worker
+ * resynchronizes on the next record boundary and parses its range into a private
+ * frame. The partial frames are stitched together in input order by moving row
+ * pointers (or, for columnar frames, by copying column slices).
+ *
+ * @param builder The builder state to fill.
+ * @param data The first byte of the buffer.
+ * @param size The number of bytes in the buffer.
+ * @param delim The delimiter character used to separate fields.
+ * @param num_threads The maximum number of threads to use.
+ * @return DATAFRAME_SUCCESS, or the first error encountered in input order.
+ */
+static DataframeErrorCode parse_buffer_parallel(CsvBuilder *builder,
+                                                const char *data,
+                                                const size_t size,
+                                                const char delim,
+                                                const int num_threads)
+{
+    size_t consumed = 0;
+    builder->pause_when_typed = true;
+    DataframeErrorCode err = parse_buffer(builder, data, size, delim, true, &consumed);
+    builder->pause_when_typed = false;
+
+    if (err != DATAFRAME_SUCCESS || !builder->types_detected || consumed >= size)
+        return err;
+
+    ParallelParseJob job = {0};
+    job.region = data + consumed;
+    job.region_size = size - consumed;
+    job.delim = delim;
+    job.schema = builder->df;
+    job.options = builder->options;
+    job.region_offset = builder->base_offset;
+    job.source_cols = builder->source_cols;
+    job.field_map = builder->field_map;
+    job.filter_terms = builder->filter_terms;
+    job.filter_count = builder->filter_count;
+    /* Counting kept rows only, a filtered load sizes the partial frames for the rows it keeps */
+    const size_t parsed_records = (size_t)builder->df->rows + (builder->has_header ? 1 : 0);
+    job.record_bytes = consumed / (parsed_records ? parsed_records : 1);
+    if (job.record_bytes == 0)
+        job.record_bytes = 1;
+
+    job.chunk_count = job.region_size / MIN_PARALLEL_CHUNK_SIZE;
+    if (job.chunk_count > (size_t)num_threads)
+        job.chunk_count = (size_t)num_threads;
+    if (job.chunk_count < 2)
+        return parse_buffer(builder, job.region, job.region_size, delim, true, NULL);
+
+    job.quote_counts = calloc(job.chunk_count, sizeof(size_t));
+    job.newline_counts = calloc(job.chunk_count, sizeof(size_t));
+    job.starts = calloc(job.chunk_count, sizeof(const char *));
+    job.split_in_quotes = calloc(job.chunk_count, sizeof(bool));
+    job.partials = calloc(job.chunk_count, sizeof(DataFrame *));
+    job.errors = calloc(job.chunk_count, sizeof(DataframeErrorCode));
+
+    if (!job.quote_counts || !job.newline_counts || !job.starts || !job.split_in_quotes ||
+        !job.partials || !job.errors) {
+        err = DATAFRAME_ERR_ALLOCATION_FAILED;
+    } else {
+        parallel_for(job.chunk_count, num_threads, count_quotes_task, &job);
+
+        /* The region starts outside quotes, so quote parity gives the state at each split */
+        size_t quotes_before = 0;
+        for (size_t k = 0; k < job.chunk_count; k++) {
+            job.split_in_quotes[k] = (quotes_before & 1u) != 0;
+            quotes_before += job.quote_counts[k];
+        }
+
+        parallel_for(job.chunk_count, num_threads, parse_chunk_task, &job);
+
+        size_t total_rows = (size_t)builder->df->rows;
+        for (size_t k = 0; k < job.chunk_count && err == DATAFRAME_SUCCESS; k++) {
+            err = job.errors[k];
+            if (err == DATAFRAME_SUCCESS)
+                total_rows += (size_t)job.partials[k]->rows;
+        }
+
+        if (err == DATAFRAME_SUCCESS && !dataframe_reserve_rows(builder->df, total_rows))
+            err = DATAFRAME_ERR_ALLOCATION_FAILED;
+
+        uint64_t lines = builder->lines_before;
+        for (size_t k = 0; k < job.chunk_count && err == DATAFRAME_SUCCESS; k++) {
+            /* Clean chunks still advance the line count of the chunks after them */
+            if (job.partials[k]->bad_rows.total) {
+                const char *split = job.region + chunk_split_offset(&job, k);
+                const uint64_t chunk_lines = lines + count_newlines(split, job.starts[k]);
+                err = merge_bad_rows(builder->df,
+                                     job.partials[k],
+                                     chunk_lines,
+                                     builder->options->bad_row_log_limit);
             }
+            lines += job.newline_counts[k];
+        }
+
+        for (size_t k = 0; k < job.chunk_count && err == DATAFRAME_SUCCESS; k++) {
+            err = dataframe_move_rows(builder->df, job.partials[k]);
+        }
+    }
+
+    if (job.partials) {
+        for (size_t k = 0; k < job.chunk_count; k++) {
+            free_dataframe(job.partials[k]);
+        }
+    }
+    free(job.quote_counts);
+    free(job.newline_counts);
+    free(job.starts);
+    free(job.split_in_quotes);
+    free(job.partials);
+    free(job.errors);
+    return err;
+}
+
+/**
+ * @brief Maps a decompression error to the corresponding DataFrame error code.
+ * @param err The decompression error.
+ * @return The DataframeErrorCode reported to the caller.
+ */
+static DataframeErrorCode compressed_input_error(const CompressedInputErrorCode err)
+{
+    switch (err) {
+    case COMPRESSED_INPUT_SUCCESS:
+        return DATAFRAME_SUCCESS;
+    case COMPRESSED_INPUT_ERR_UNSUPPORTED:
+        return DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+    case COMPRESSED_INPUT_ERR_ALLOCATION_FAILED:
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    default:
+        return DATAFRAME_ERR_READ_FAILED;
+    }
+}
+
+/**
+ * @brief Closes the stream and frees the block buffer of a reader.
+ * @param reader The reader to release.
+ */
+static void block_reader_close(BlockReader *reader)
+{
+    /* The decompressor thread reads from the file, so it has to stop first */
+    compressed_input_close(reader->inflater);
+    if (reader->file)
+        fclose(reader->file);
+    free(reader->buffer);
+    memset(reader, 0, sizeof(*reader));
+}
+
+/**
+ * @brief Opens a file for sequential block reading, decompressing it if needed.
+ *
+ * The first bytes are inspected for a gzip or zstd signature. Plain input
+ * keeps them buffered as the start of the first block; compressed input is
+ * handed to a background decompressor that feeds all subsequent reads.
+ *
+ * @param reader The reader to initialize.
+ * @param path The file path to open.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_FILE_NOT_FOUND, DATAFRAME_ERR_UNSUPPORTED_FORMAT or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode block_reader_open(BlockReader *reader, const char *path)
+{
+    memset(reader, 0, sizeof(*reader));
+
+    reader->file = fopen(path, "rb");
+    if (!reader->file)
+        return DATAFRAME_ERR_FILE_NOT_FOUND;
+
+    reader->capacity = STREAM_CHUNK_SIZE;
+    reader->buffer = malloc(reader->capacity);
+    if (!reader->buffer) {
+        fclose(reader->file);
+        reader->file = NULL;
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    reader->length = fread(reader->buffer, 1, COMPRESSION_MAGIC_SIZE, reader->file);
+    const CompressionFormat format = compression_detect(reader->buffer, reader->length);
+    if (format != COMPRESSION_NONE) {
+        const CompressedInputErrorCode err = compressed_input_open(
+            reader->file, format, reader->buffer, reader->length, &reader->inflater);
+        reader->length = 0;
+        if (err != COMPRESSED_INPUT_SUCCESS) {
+            block_reader_close(reader);
+            return compressed_input_error(err);
         }
-        current_r++;
     }
+    return DATAFRAME_SUCCESS;
+}
 
-    df->rows = current_r;
+/**
+ * @brief Appends the next block of the stream after the unconsumed bytes.
+ *
+ * The buffer only grows when a single record is larger than it.
+ *
+ * @param reader The block reader.
+ * @return DATAFRAME_SUCCESS (setting at_eof at the end of input) or an I/O/allocation error.
+ */
+static DataframeErrorCode block_reader_fill(BlockReader *reader)
+{
+    if (reader->length == reader->capacity) {
+        const size_t new_cap = reader->capacity * 2;
+        char *tmp = realloc(reader->buffer, new_cap);
+        if (!tmp)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        reader->buffer = tmp;
+        reader->capacity = new_cap;
+    }
 
-    free(row_tokens);
-    free(line);
-    fclose(file);
+    char *dst = reader->buffer + reader->length;
+    const size_t room = reader->capacity - reader->length;
+    size_t got;
+    if (reader->inflater) {
+        const CompressedInputErrorCode err =
+            compressed_input_read(reader->inflater, dst, room, &got);
+        if (err != COMPRESSED_INPUT_SUCCESS)
+            return compressed_input_error(err);
+    } else {
+        got = fread(dst, 1, room, reader->file);
+        if (got == 0 && ferror(reader->file))
+            return DATAFRAME_ERR_READ_FAILED;
+    }
 
-    *out_df = df;
+    reader->length += got;
+    if (got == 0)
+        reader->at_eof = true;
     return DATAFRAME_SUCCESS;
 }
+
+/**
+ * @brief Feeds blocks from a reader to a builder until the input ends or the row limit is hit.
+ *
+ * Each block is parsed as soon as it is read; an incomplete trailing record is
+ * moved to the front of the buffer and completed by the next block. Bytes past
+ * the row limit stay buffered for the next call.
+ *
+ * @param reader The block reader.
+ * @param builder The builder state to fill.
+ * @param delim The delimiter character used to separate fields.
+ * @return DATAFRAME_SUCCESS, or an appropriate DataframeErrorCode on failure.
+ */
+static DataframeErrorCode parse_blocks(BlockReader *reader, CsvBuilder *builder, const char delim)
+{
+    for (;;) {
+        if (reader->length > 0 || reader->at_eof) {
+            size_t consumed = 0;
+            const DataframeErrorCode err = parse_buffer(
+                builder, reader->buffer, reader->length, delim, reader->at_eof, &consumed);
+
+            memmove(reader->buffer, reader->buffer + consumed, reader->length - consumed);
+            reader->length -= consumed;
+
+            if (err != DATAFRAME_SUCCESS)
+                return err;
+            if (builder->row_limit && builder->df &&
+                (size_t)builder->df->rows >= builder->row_limit)
+                return DATAFRAME_SUCCESS;
+            if (reader->at_eof)
+                return DATAFRAME_SUCCESS;
+        }
+
+        const DataframeErrorCode err = block_reader_fill(reader);
+        if (err != DATAFRAME_SUCCESS)
+            return err;
+    }
+}
+
+/**
+ * @brief Tokenizes a file in a single sequential pass over fixed-size blocks.
+ * @param path The file path to the CSV file.
+ * @param builder The builder state to fill.
+ * @param delim The delimiter character used to separate fields.
+ * @return DATAFRAME_SUCCESS, or an appropriate DataframeErrorCode on failure.
+ */
+static DataframeErrorCode load_streamed(const char *path, CsvBuilder *builder, const char delim)
+{
+    BlockReader reader;
+    DataframeErrorCode err = block_reader_open(&reader, path);
+    if (err != DATAFRAME_SUCCESS)
+        return err;
+
+    err = parse_blocks(&reader, builder, delim);
+
+    block_reader_close(&reader);
+    return err;
+}
+
+/**
+ * @brief Tokenizes a whole file through a read-only mapping (or its heap fallback).
+ * @param path The file path to the CSV file.
+ * @param builder The builder state to fill.
+ * @param delim The delimiter character used to separate fields.
+ * @param num_threads Number of parsing threads (1 parses on the calling thread).
+ * @return DATAFRAME_SUCCESS, or an appropriate DataframeErrorCode on failure.
+ */
+static DataframeErrorCode
+load_mapped(const char *path, CsvBuilder *builder, const char delim, const int num_threads)
+{
+    FileMapping mapping;
+    const FileMappingErrorCode map_err = file_mapping_open(path, &mapping);
+    if (map_err == FILE_MAPPING_ERR_OPEN_FAILED)
+        return DATAFRAME_ERR_FILE_NOT_FOUND;
+    if (map_err == FILE_MAPPING_ERR_READ_FAILED)
+        return DATAFRAME_ERR_READ_FAILED;
+    if (map_err != FILE_MAPPING_SUCCESS)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    /* Compressed input cannot be tokenized in place; it is decoded while streaming instead */
+    if (compression_detect(mapping.data, mapping.size) != COMPRESSION_NONE) {
+        file_mapping_close(&mapping);
+        return load_streamed(path, builder, delim);
+    }
+
+    DataframeErrorCode err;
+    if (num_threads > 1)
+        err = parse_buffer_parallel(builder, mapping.data, mapping.size, delim, num_threads);
+    else
+        err = parse_buffer(builder, mapping.data, mapping.size, delim, true, NULL);
+
+    file_mapping_close(&mapping);
+    return err;
+}
+
+CsvReadOptions csv_default_read_options(void)
+{
+    CsvReadOptions options;
+    options.has_header = true;
+    options.delim = ",";
+    options.row_capacity_hint = 0;
+    options.memory_map = false;
+    options.num_threads = 1;
+    options.usecols = NULL;
+    options.usecols_indices = NULL;
+    options.usecols_count = 0;
+    options.layout = DATAFRAME_LAYOUT_ROWS;
+    options.dictionary_encode = false;
+    options.inference_rows = 100;
+    options.infer_integers = false;
+    options.infer_dates = false;
+    options.bad_rows = CSV_BAD_ROWS_ERROR;
+    options.bad_row_log_limit = 1000;
+    options.use_cache = false;
+    options.filter = NULL;
+    return options;
+}
+
+DataframeErrorCode
+read_csv_with_options(const char *path, const CsvReadOptions *options, DataFrame **out_df)
+{
+    if (!out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+
+    if (!path || !options || !options->delim)
+        return DATAFRAME_ERR_FILE_NOT_FOUND;
+
+    /* The key is taken before parsing, so a file changed meanwhile is not cached as current */
+    uint64_t cache_key = 0;
+    const bool cacheable = options->use_cache && csv_cache_key(path, options, &cache_key);
+    if (cacheable && csv_cache_load(path, cache_key, options->layout, out_df) == DATAFRAME_SUCCESS)
+        return DATAFRAME_SUCCESS;
+
+    CsvBuilder builder;
+    DataframeErrorCode err = builder_init(&builder, options->has_header, INITIAL_FIELD_CAPACITY);
+    if (err != DATAFRAME_SUCCESS)
+        return err;
+    builder.row_capacity_hint = options->row_capacity_hint;
+    builder.inference_rows = options->inference_rows ? options->inference_rows : 1;
+    builder.options = options;
+
+    const int num_threads =
+        options->num_threads <= 0 ? parallel_hardware_threads() : options->num_threads;
+
+    if (options->memory_map || num_threads > 1)
+        err = load_mapped(path, &builder, options->delim[0], num_threads);
+    else
+        err = load_streamed(path, &builder, options->delim[0]);
+
+    /* Files shorter than the inference sample end before the types are fixed */
+    if (err == DATAFRAME_SUCCESS)
+        err = finish_type_inference(&builder);
+    if (err == DATAFRAME_SUCCESS && !builder.df)
+        err = DATAFRAME_ERR_EMPTY_FILE;
+
+    builder_release_scratch(&builder);
+
+    if (err != DATAFRAME_SUCCESS) {
+        free_dataframe(builder.df);
+        return err;
+    }
+
+    /* A sidecar that cannot be written only costs the next load its speed-up */
+    if (cacheable)
+        (void)csv_cache_store(path, cache_key, builder.df);
+
+    *out_df = builder.df;
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode
+read_csv(const char *path, const bool has_header, const char *delim, DataFrame **out_df)
+{
+    CsvReadOptions options = csv_default_read_options();
+    options.has_header = has_header;
+    options.delim = delim;
+    return read_csv_with_options(path, &options, out_df);
+}
+
+DataframeErrorCode read_csv_mmap(const char *path,
+                                 const bool has_header,
+                                 const char *delim,
+                                 DataFrame **out_df)
+{
+    CsvReadOptions options = csv_default_read_options();
+    options.has_header = has_header;
+    options.delim = delim;
+    options.memory_map = true;
+    return read_csv_with_options(path, &options, out_df);
+}
+
+DataframeErrorCode
+csv_stream_open(const char *path, const CsvReadOptions *options, CsvStream **out_stream)
+{
+    if (!out_stream)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_stream = NULL;
+
+    if (!path || !options || !options->delim)
+        return DATAFRAME_ERR_FILE_NOT_FOUND;
+
+    CsvStream *stream = calloc(1, sizeof(CsvStream));
+    if (!stream)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    DataframeErrorCode err = block_reader_open(&stream->reader, path);
+    if (err != DATAFRAME_SUCCESS) {
+        free(stream);
+        return err;
+    }
+
+    err = builder_init(&stream->builder, options->has_header, INITIAL_FIELD_CAPACITY);
+    if (err != DATAFRAME_SUCCESS) {
+        block_reader_close(&stream->reader);
+        free(stream);
+        return err;
+    }
+
+    stream->options = *options;
+    stream->builder.options = &stream->options;
+    stream->delim = options->delim[0];
+    *out_stream = stream;
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode
+csv_stream_next_batch(CsvStream *stream, const size_t max_rows, DataFrame **out_batch)
+{
+    if (!out_batch)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_batch = NULL;
+
+    if (!stream || max_rows == 0)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    CsvBuilder *builder = &stream->builder;
+
+    /* Recycle the previous batch: its row arrays are reused by the next appends */
+    if (builder->df)
+        dataframe_clear_rows(builder->df);
+    builder->row_limit = max_rows;
+    builder->row_capacity_hint = max_rows;
+
+    /* The sampled records become rows of the first batch, so the sample must fit in it */
+    if (!builder->types_detected) {
+        const size_t sample = stream->options.inference_rows ? stream->options.inference_rows : 1;
+        builder->inference_rows = sample < max_rows ? sample : max_rows;
+    }
+
+    DataframeErrorCode err = parse_blocks(&stream->reader, builder, stream->delim);
+    if (err == DATAFRAME_SUCCESS && stream->reader.at_eof)
+        err = finish_type_inference(builder);
+    if (err != DATAFRAME_SUCCESS)
+        return err;
+
+    if (builder->df && builder->df->rows > 0)
+        *out_batch = builder->df;
+    return DATAFRAME_SUCCESS;
+}
+
+void csv_stream_close(CsvStream *stream)
+{
+    if (!stream)
+        return;
+
+    block_reader_close(&stream->reader);
+    builder_release_scratch(&stream->builder);
+    free_dataframe(stream->builder.df);
+    free(stream);
+}
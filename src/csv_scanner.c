@@ -0,0 +1,293 @@
+#include "csv_scanner.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CSV_SCANNER_X86 1
+#endif
+
+#if defined(CSV_SCANNER_X86) &&                                                                    \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CSV_SCANNER_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(CSV_SCANNER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CSV_SCANNER_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Number of input bytes classified per iteration (one bit per byte in a uint64_t).
+ */
+#define SCAN_BLOCK_SIZE 64
+
+/**
+ * @brief Returns the index of the lowest set bit of a non-zero 64-bit value.
+ * @param bits The value to inspect (must not be zero).
+ * @return The zero-based position of the least significant set bit.
+ */
+static inline unsigned trailing_zeros64(const uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(bits);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (unsigned)index;
+#else
+    unsigned index = 0;
+    while (!((bits >> index) & 1u))
+        index++;
+    return index;
+#endif
+}
+
+/**
+ * @brief Computes the running XOR of all lower bits for every bit position.
+ *
+ * Applied to a quote bitmask, bit i of the result is set when an odd number of
+ * quotes occurs at or before position i, i.e. when byte i is inside quotes.
+ *
+ * @param bits The quote bitmask of a block.
+ * @return The inclusive prefix XOR of bits.
+ */
+static inline uint64_t prefix_xor(uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+/**
+ * @brief Removes quoted candidates from a block's structural mask and emits their offsets.
+ * @param quotes Bitmask of double quote characters in the block.
+ * @param candidates Bitmask of delimiter and newline characters in the block.
+ * @param quote_carry All ones if the block starts inside quotes, zero otherwise; updated for
+ * the next block.
+ * @param base Offset of the block's first byte relative to the scanned buffer.
+ * @param out_positions Destination for the emitted offsets.
+ * @return The number of offsets written.
+ */
+static inline size_t emit_block(const uint64_t quotes,
+                                uint64_t candidates,
+                                uint64_t *quote_carry,
+                                const uint32_t base,
+                                uint32_t *out_positions)
+{
+    const uint64_t inside = prefix_xor(quotes) ^ *quote_carry;
+    *quote_carry = (inside >> 63) ? ~(uint64_t)0 : 0;
+
+    candidates &= ~inside;
+
+    size_t count = 0;
+    while (candidates) {
+        out_positions[count++] = base + trailing_zeros64(candidates);
+        candidates &= candidates - 1;
+    }
+    return count;
+}
+
+size_t csv_scan_structurals_scalar(const char *data,
+                                   const size_t length,
+                                   const char delim,
+                                   bool *in_quotes,
+                                   uint32_t *out_positions)
+{
+    bool quoted = *in_quotes;
+    size_t count = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        const char ch = data[i];
+        if (ch == '"')
+            quoted = !quoted;
+        else if (!quoted && (ch == delim || ch == '\n'))
+            out_positions[count++] = (uint32_t)i;
+    }
+
+    *in_quotes = quoted;
+    return count;
+}
+
+#if defined(CSV_SCANNER_HAVE_SSE2)
+
+/**
+ * @brief Classifies one 64-byte block with four 16-byte SSE2 compares.
+ * @param block Pointer to 64 readable bytes.
+ * @param delim The field delimiter character.
+ * @param out_quotes Receives the quote bitmask.
+ * @param out_candidates Receives the delimiter/newline bitmask.
+ */
+static inline void classify_block_sse2(const char *block,
+                                       const char delim,
+                                       uint64_t *out_quotes,
+                                       uint64_t *out_candidates)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i separator = _mm_set1_epi8(delim);
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    uint64_t quotes = 0;
+    uint64_t candidates = 0;
+
+    for (int i = 0; i < 4; i++) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i *)(block + 16 * i));
+        const __m128i structural =
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, separator), _mm_cmpeq_epi8(chunk, newline));
+
+        quotes |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)) << (16 * i);
+        candidates |= (uint64_t)(uint32_t)_mm_movemask_epi8(structural) << (16 * i);
+    }
+
+    *out_quotes = quotes;
+    *out_candidates = candidates;
+}
+
+/**
+ * @brief SSE2 implementation of csv_scan_structurals.
+ */
+static size_t scan_sse2(const char *data,
+                        const size_t length,
+                        const char delim,
+                        bool *in_quotes,
+                        uint32_t *out_positions)
+{
+    uint64_t carry = *in_quotes ? ~(uint64_t)0 : 0;
+    uint64_t quotes, candidates;
+    size_t count = 0;
+    size_t offset = 0;
+
+    for (; offset + SCAN_BLOCK_SIZE <= length; offset += SCAN_BLOCK_SIZE) {
+        classify_block_sse2(data + offset, delim, &quotes, &candidates);
+        count += emit_block(quotes, candidates, &carry, (uint32_t)offset, out_positions + count);
+    }
+
+    if (offset < length) {
+        /* Classify the tail from a padded copy and mask off the padding bits */
+        char tail[SCAN_BLOCK_SIZE] = {0};
+        const size_t remaining = length - offset;
+        memcpy(tail, data + offset, remaining);
+
+        classify_block_sse2(tail, delim, &quotes, &candidates);
+        const uint64_t valid = ((uint64_t)1 << remaining) - 1;
+        count += emit_block(
+            quotes & valid, candidates & valid, &carry, (uint32_t)offset, out_positions + count);
+    }
+
+    *in_quotes = carry != 0;
+    return count;
+}
+
+#endif
+
+#if defined(CSV_SCANNER_HAVE_AVX2)
+
+/**
+ * @brief Classifies one 64-byte block with two 32-byte AVX2 compares.
+ * @param block Pointer to 64 readable bytes.
+ * @param delim The field delimiter character.
+ * @param out_quotes Receives the quote bitmask.
+ * @param out_candidates Receives the delimiter/newline bitmask.
+ */
+__attribute__((target("avx2"))) static inline void classify_block_avx2(const char *block,
+                                                                      const char delim,
+                                                                      uint64_t *out_quotes,
+                                                                      uint64_t *out_candidates)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i separator = _mm256_set1_epi8(delim);
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    const __m256i lo = _mm256_loadu_si256((const __m256i *)block);
+    const __m256i hi = _mm256_loadu_si256((const __m256i *)(block + 32));
+
+    const uint64_t quotes_lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, quote));
+    const uint64_t quotes_hi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, quote));
+
+    const __m256i structural_lo =
+        _mm256_or_si256(_mm256_cmpeq_epi8(lo, separator), _mm256_cmpeq_epi8(lo, newline));
+    const __m256i structural_hi =
+        _mm256_or_si256(_mm256_cmpeq_epi8(hi, separator), _mm256_cmpeq_epi8(hi, newline));
+
+    *out_quotes = quotes_lo | (quotes_hi << 32);
+    *out_candidates = (uint64_t)(uint32_t)_mm256_movemask_epi8(structural_lo) |
+                      ((uint64_t)(uint32_t)_mm256_movemask_epi8(structural_hi) << 32);
+}
+
+/**
+ * @brief AVX2 implementation of csv_scan_structurals.
+ */
+__attribute__((target("avx2"))) static size_t scan_avx2(const char *data,
+                                                        const size_t length,
+                                                        const char delim,
+                                                        bool *in_quotes,
+                                                        uint32_t *out_positions)
+{
+    uint64_t carry = *in_quotes ? ~(uint64_t)0 : 0;
+    uint64_t quotes, candidates;
+    size_t count = 0;
+    size_t offset = 0;
+
+    for (; offset + SCAN_BLOCK_SIZE <= length; offset += SCAN_BLOCK_SIZE) {
+        classify_block_avx2(data + offset, delim, &quotes, &candidates);
+        count += emit_block(quotes, candidates, &carry, (uint32_t)offset, out_positions + count);
+    }
+
+    if (offset < length) {
+        /* Classify the tail from a padded copy and mask off the padding bits */
+        char tail[SCAN_BLOCK_SIZE] = {0};
+        const size_t remaining = length - offset;
+        memcpy(tail, data + offset, remaining);
+
+        classify_block_avx2(tail, delim, &quotes, &candidates);
+        const uint64_t valid = ((uint64_t)1 << remaining) - 1;
+        count += emit_block(
+            quotes & valid, candidates & valid, &carry, (uint32_t)offset, out_positions + count);
+    }
+
+    *in_quotes = carry != 0;
+    return count;
+}
+
+#endif
+
+CsvScanBackend csv_scan_backend(void)
+{
+#if defined(CSV_SCANNER_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+        return CSV_SCAN_AVX2;
+#endif
+#if defined(CSV_SCANNER_HAVE_SSE2)
+    return CSV_SCAN_SSE2;
+#else
+    return CSV_SCAN_SCALAR;
+#endif
+}
+
+size_t csv_scan_structurals(const char *data,
+                            const size_t length,
+                            const char delim,
+                            bool *in_quotes,
+                            uint32_t *out_positions)
+{
+    switch (csv_scan_backend()) {
+#if defined(CSV_SCANNER_HAVE_AVX2)
+    case CSV_SCAN_AVX2:
+        return scan_avx2(data, length, delim, in_quotes, out_positions);
+#endif
+#if defined(CSV_SCANNER_HAVE_SSE2)
+    case CSV_SCAN_SSE2:
+        return scan_sse2(data, length, delim, in_quotes, out_positions);
+#endif
+    default:
+        return csv_scan_structurals_scalar(data, length, delim, in_quotes, out_positions);
+    }
+}
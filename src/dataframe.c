@@ -1,10 +1,28 @@
 #include "dataframe.h"
 
+#include <limits.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "date_parser.h"
 #include "memory_utils.h"
+#include "parallel.h"
+
+/**
+ * @brief Default number of row slots reserved when no capacity is requested.
+ */
+#define DEFAULT_ROW_CAPACITY 64
+
+/**
+ * @brief Number of rows gathered by one task when a column is permuted.
+ */
+#define GATHER_CHUNK_ROWS 65536
+
+/* Columnar columns are exposed as double and int64_t arrays, which requires this layout */
+_Static_assert(sizeof(DataCell) == sizeof(double), "DataCell must be exactly one double wide");
+_Static_assert(sizeof(DataCell) == sizeof(int64_t), "DataCell must be exactly one int64_t wide");
 
 DataFrame *create_dataframe(const size_t rows, const size_t cols)
 {
@@ -15,9 +33,11 @@ DataFrame *create_dataframe(const size_t rows, const size_t cols)
     DataFrame *df = (DataFrame *)aligned_calloc(1, sizeof(DataFrame), CACHE_LINE_SIZE);
     if (!df)
         return NULL;
+    df->references = 1;
 
     df->rows = (int)rows;
     df->cols = (int)cols;
+    df->row_capacity = (int)rows;
 
     /* Allocate arrays for column names, data types, and row pointers */
     df->columns = (char **)aligned_calloc(cols, sizeof(char *), CACHE_LINE_SIZE);
@@ -41,9 +61,1220 @@ DataFrame *create_dataframe(const size_t rows, const size_t cols)
     return df;
 }
 
-void free_dataframe(DataFrame *df)
+DataFrame *create_dataframe_with_capacity(const size_t row_capacity, const size_t cols)
+{
+    return create_dataframe_with_layout(row_capacity, cols, DATAFRAME_LAYOUT_ROWS);
+}
+
+DataFrame *
+create_dataframe_with_layout(size_t row_capacity, const size_t cols, const DataFrameLayout layout)
+{
+    if (cols == 0)
+        return NULL;
+    if (row_capacity == 0)
+        row_capacity = DEFAULT_ROW_CAPACITY;
+
+    DataFrame *df = (DataFrame *)aligned_calloc(1, sizeof(DataFrame), CACHE_LINE_SIZE);
+    if (!df)
+        return NULL;
+    df->references = 1;
+
+    df->rows = 0;
+    df->cols = (int)cols;
+    df->row_capacity = (int)row_capacity;
+    df->layout = layout;
+
+    df->columns = (char **)aligned_calloc(cols, sizeof(char *), CACHE_LINE_SIZE);
+    df->col_types = (DataType *)aligned_calloc(cols, sizeof(DataType), CACHE_LINE_SIZE);
+    if (!df->columns || !df->col_types) {
+        free_dataframe(df);
+        return NULL;
+    }
+
+    if (layout == DATAFRAME_LAYOUT_COLUMNS) {
+        /* Every column is one contiguous array, allocated up front */
+        df->col_data = (DataCell **)aligned_calloc(cols, sizeof(DataCell *), CACHE_LINE_SIZE);
+        if (!df->col_data) {
+            free_dataframe(df);
+            return NULL;
+        }
+        for (size_t c = 0; c < cols; c++) {
+            df->col_data[c] =
+                (DataCell *)aligned_calloc(row_capacity, sizeof(DataCell), CACHE_LINE_SIZE);
+            if (!df->col_data[c]) {
+                free_dataframe(df);
+                return NULL;
+            }
+        }
+    } else {
+        /* Only the row pointer table is reserved; rows are allocated on append */
+        df->data = (DataCell **)aligned_calloc(row_capacity, sizeof(DataCell *), CACHE_LINE_SIZE);
+        if (!df->data) {
+            free_dataframe(df);
+            return NULL;
+        }
+    }
+
+    return df;
+}
+
+/**
+ * @brief Moves the row pointer table into a larger aligned allocation.
+ * @param df Pointer to the DataFrame whose table should grow.
+ * @param new_capacity The new number of row slots (must exceed the current capacity).
+ * @return 1 on success, 0 if the allocation failed (the old table is left untouched).
+ */
+static int grow_row_table(DataFrame *df, const size_t new_capacity)
+{
+    DataCell **table =
+        (DataCell **)aligned_calloc(new_capacity, sizeof(DataCell *), CACHE_LINE_SIZE);
+    if (!table)
+        return 0;
+
+    if (df->data) {
+        memcpy(table, df->data, (size_t)df->row_capacity * sizeof(DataCell *));
+        aligned_free(df->data);
+    }
+
+    df->data = table;
+    df->row_capacity = (int)new_capacity;
+    return 1;
+}
+
+/**
+ * @brief Checks whether memory lives in the frame's file mapping rather than the heap.
+ * @param df Pointer to the DataFrame.
+ * @param ptr The memory (may be NULL).
+ * @return true if the memory must not be freed or reallocated.
+ */
+static bool is_mapped(const DataFrame *df, const void *ptr)
+{
+    if (!df->mapping || !df->mapping->data || !ptr)
+        return false;
+
+    const char *bytes = (const char *)ptr;
+    return bytes >= df->mapping->data && bytes < df->mapping->data + df->mapping->size;
+}
+
+/**
+ * @brief Checks whether a column array lives in the frame's file mapping rather than the heap.
+ * @param df Pointer to the columnar DataFrame.
+ * @param col The zero-based column index.
+ * @return true if the column must not be passed to aligned_free.
+ */
+static bool column_is_mapped(const DataFrame *df, const int col)
+{
+    return is_mapped(df, df->col_data[col]);
+}
+
+/**
+ * @brief Returns the string a deferred string cell refers to.
+ * @param heap The column's heap.
+ * @param offset The stored offset.
+ * @return The string, or NULL for negative and out-of-range offsets.
+ */
+static char *heap_string(const DataFrameStringHeap *heap, const int64_t offset)
+{
+    return offset >= 0 && (uint64_t)offset < heap->size ? (char *)heap->data + offset : NULL;
+}
+
+/**
+ * @brief Checks whether a column's string cells still hold heap offsets.
+ * @param df Pointer to the DataFrame.
+ * @param col The zero-based column index.
+ * @return true if the cells must be read through heap_string.
+ */
+static bool column_is_deferred(const DataFrame *df, const int col)
+{
+    return df->string_heaps && df->string_heaps[col].data;
+}
+
+/**
+ * @brief Turns the heap offsets of a deferred string column into pointers, in place.
+ * @param df Pointer to the columnar DataFrame.
+ * @param col The zero-based column index.
+ */
+static void resolve_string_heap(DataFrame *df, const int col)
+{
+    DataFrameStringHeap *heap = &df->string_heaps[col];
+    DataCell *cells = df->col_data[col];
+
+    for (int r = 0; r < df->rows; r++) {
+        cells[r].v_str = heap_string(heap, cells[r].v_int);
+    }
+    heap->data = NULL;
+    heap->size = 0;
+}
+
+/**
+ * @brief Turns every deferred string column of a frame into pointers.
+ * @param df Pointer to the DataFrame.
+ */
+static void resolve_string_heaps(DataFrame *df)
+{
+    for (int c = 0; df->string_heaps && c < df->cols; c++) {
+        if (column_is_deferred(df, c))
+            resolve_string_heap(df, c);
+    }
+}
+
+/**
+ * @brief Moves every column of a columnar DataFrame into larger aligned arrays.
+ *
+ * All new arrays are allocated before any old one is released, so a failure
+ * leaves the DataFrame unchanged.
+ *
+ * @param df Pointer to the columnar DataFrame whose columns should grow.
+ * @param new_capacity The new number of row slots (must exceed the current capacity).
+ * @return 1 on success, 0 if an allocation failed.
+ */
+static int grow_columns(DataFrame *df, const size_t new_capacity)
+{
+    DataCell **grown = (DataCell **)calloc((size_t)df->cols, sizeof(DataCell *));
+    if (!grown)
+        return 0;
+
+    for (int c = 0; c < df->cols; c++) {
+        grown[c] = (DataCell *)aligned_calloc(new_capacity, sizeof(DataCell), CACHE_LINE_SIZE);
+        if (!grown[c]) {
+            for (int k = 0; k < c; k++) {
+                aligned_free(grown[k]);
+            }
+            free(grown);
+            return 0;
+        }
+    }
+
+    for (int c = 0; c < df->cols; c++) {
+        memcpy(grown[c], df->col_data[c], (size_t)df->rows * sizeof(DataCell));
+        if (!column_is_mapped(df, c))
+            aligned_free(df->col_data[c]);
+        df->col_data[c] = grown[c];
+    }
+
+    free(grown);
+    df->row_capacity = (int)new_capacity;
+    return 1;
+}
+
+/**
+ * @brief Returns the number of bitmap words covering a number of row slots.
+ * @param rows The number of row slots.
+ * @return The number of 64-bit words.
+ */
+static size_t validity_words(const size_t rows)
+{
+    return (rows + 63) / 64;
+}
+
+/**
+ * @brief Gives a column its bitmap, with every bit set, unless it already has one.
+ * @param validity The column's validity.
+ * @param row_capacity The number of row slots of the frame.
+ * @return true on success, false if the allocation failed.
+ */
+static bool validity_allocate(DataFrameValidity *validity, const size_t row_capacity)
+{
+    if (validity->bits)
+        return true;
+
+    const size_t words = validity_words(row_capacity);
+    validity->bits = malloc((words ? words : 1) * sizeof(uint64_t));
+    if (!validity->bits)
+        return false;
+    memset(validity->bits, 0xFF, (words ? words : 1) * sizeof(uint64_t));
+    return true;
+}
+
+/**
+ * @brief Sets or clears the bit of one row in an allocated bitmap, keeping null_count exact.
+ * @param validity The column's validity (bits must not be NULL).
+ * @param row The zero-based row index.
+ * @param valid Whether the row holds a value.
+ */
+static void validity_assign(DataFrameValidity *validity, const size_t row, const bool valid)
+{
+    uint64_t *word = &validity->bits[row / 64];
+    const uint64_t bit = (uint64_t)1 << (row % 64);
+
+    if (valid && !(*word & bit)) {
+        *word |= bit;
+        validity->null_count--;
+    } else if (!valid && (*word & bit)) {
+        *word &= ~bit;
+        validity->null_count++;
+    }
+}
+
+/**
+ * @brief Marks every row of every column valid again, e.g. once the rows are gone.
+ * @param df Pointer to the DataFrame.
+ * @param rows The number of rows whose bits may be clear.
+ */
+static void reset_validity(DataFrame *df, const int rows)
+{
+    for (int c = 0; df->validity && c < df->cols; c++) {
+        DataFrameValidity *validity = &df->validity[c];
+        if (validity->bits)
+            memset(validity->bits, 0xFF, validity_words((size_t)rows) * sizeof(uint64_t));
+        validity->null_count = 0;
+    }
+}
+
+/**
+ * @brief Extends the validity bitmaps to a larger row capacity, with the new bits set.
+ *
+ * Bitmaps that were already extended keep their size if a later one fails;
+ * their extra bits are set, so the frame stays consistent.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param new_capacity The new number of row slots (must exceed the current capacity).
+ * @return 1 on success, 0 if an allocation failed.
+ */
+static int grow_validity(DataFrame *df, const size_t new_capacity)
+{
+    const size_t old_words = validity_words((size_t)df->row_capacity);
+    const size_t new_words = validity_words(new_capacity);
+
+    for (int c = 0; df->validity && c < df->cols; c++) {
+        DataFrameValidity *validity = &df->validity[c];
+        if (!validity->bits || new_words <= old_words)
+            continue;
+
+        /* A bitmap in the file mapping is copied out instead of reallocated */
+        uint64_t *grown;
+        if (is_mapped(df, validity->bits)) {
+            grown = malloc(new_words * sizeof(uint64_t));
+            if (grown)
+                memcpy(grown, validity->bits, old_words * sizeof(uint64_t));
+        } else {
+            grown = realloc(validity->bits, new_words * sizeof(uint64_t));
+        }
+        if (!grown)
+            return 0;
+        memset(grown + old_words, 0xFF, (new_words - old_words) * sizeof(uint64_t));
+        validity->bits = grown;
+    }
+    return 1;
+}
+
+/**
+ * @brief Grows the storage of a DataFrame of either layout.
+ * @param df Pointer to the DataFrame.
+ * @param new_capacity The new number of row slots (must exceed the current capacity).
+ * @return 1 on success, 0 if the allocation failed (the DataFrame is left unchanged).
+ */
+static int grow_storage(DataFrame *df, const size_t new_capacity)
+{
+    if (!grow_validity(df, new_capacity))
+        return 0;
+    if (df->layout == DATAFRAME_LAYOUT_COLUMNS)
+        return grow_columns(df, new_capacity);
+    return grow_row_table(df, new_capacity);
+}
+
+/**
+ * @brief Makes room for one more row, doubling the capacity when it is exhausted.
+ * @param df Pointer to the DataFrame.
+ * @return 1 on success, 0 if the allocation failed.
+ */
+static int ensure_row_slot(DataFrame *df)
+{
+    if (df->rows < df->row_capacity)
+        return 1;
+
+    const size_t current = (size_t)df->row_capacity;
+    return grow_storage(df, current < DEFAULT_ROW_CAPACITY ? DEFAULT_ROW_CAPACITY : current * 2);
+}
+
+int dataframe_reserve_rows(DataFrame *df, const size_t row_capacity)
 {
     if (!df)
+        return 0;
+    if (row_capacity <= (size_t)df->row_capacity)
+        return 1;
+    return grow_storage(df, row_capacity);
+}
+
+/**
+ * @brief Frees the translation tables produced by build_code_maps.
+ * @param code_maps The per-column tables (may be NULL).
+ * @param cols The number of columns.
+ */
+static void free_code_maps(int32_t **code_maps, const int cols)
+{
+    if (!code_maps)
+        return;
+    for (int c = 0; c < cols; c++) {
+        free(code_maps[c]);
+    }
+    free(code_maps);
+}
+
+/**
+ * @brief Interns every value of a dictionary into a TYPE_CATEGORY column of dst.
+ * @param dst The DataFrame receiving the values.
+ * @param col The zero-based column of dst.
+ * @param dict The dictionary providing the values.
+ * @return A table translating dict's codes to dst's codes (to be freed), or NULL if
+ * allocation fails.
+ */
+static int32_t *build_code_map(DataFrame *dst, const int col, const StringDictionary *dict)
+{
+    int32_t *map = malloc((dict->count ? (size_t)dict->count : 1) * sizeof(int32_t));
+    if (!map)
+        return NULL;
+
+    for (int32_t code = 0; code < dict->count; code++) {
+        map[code] = dataframe_intern_string(dst, col, dict->values[code], dict->lengths[code]);
+        if (map[code] < 0) {
+            free(map);
+            return NULL;
+        }
+    }
+    return map;
+}
+
+/**
+ * @brief Interns every dictionary value of src's TYPE_CATEGORY columns into dst.
+ * @param dst The DataFrame receiving rows.
+ * @param src The DataFrame providing rows.
+ * @param out_maps Receives per-column tables translating src codes to dst codes (NULL
+ * entries for other columns), or NULL if no column is dictionary-encoded.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode build_code_maps(DataFrame *dst, const DataFrame *src, int32_t ***out_maps)
+{
+    *out_maps = NULL;
+    if (!src->dictionaries)
+        return DATAFRAME_SUCCESS;
+
+    int32_t **maps = calloc((size_t)dst->cols, sizeof(int32_t *));
+    if (!maps)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    for (int c = 0; c < dst->cols; c++) {
+        const StringDictionary *dict = src->dictionaries[c];
+        if (!dict || dst->col_types[c] != TYPE_CATEGORY)
+            continue;
+
+        maps[c] = build_code_map(dst, c, dict);
+        if (!maps[c]) {
+            free_code_maps(maps, dst->cols);
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+    }
+
+    *out_maps = maps;
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode dataframe_move_rows(DataFrame *dst, DataFrame *src)
+{
+    if (!dst || !src)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (dst->cols != src->cols)
+        return DATAFRAME_ERR_COLUMN_MISMATCH;
+    if (src->rows == 0)
+        return DATAFRAME_SUCCESS;
+
+    if (!dataframe_reserve_rows(dst, (size_t)dst->rows + (size_t)src->rows))
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    /* Cells change frames below, so both must hold string pointers */
+    resolve_string_heaps(dst);
+    resolve_string_heaps(src);
+
+    /* Dictionary codes are per frame: build src-to-dst translations before moving anything */
+    int32_t **code_maps = NULL;
+    const DataframeErrorCode map_err = build_code_maps(dst, src, &code_maps);
+    if (map_err != DATAFRAME_SUCCESS)
+        return map_err;
+    const int first_moved = dst->rows;
+
+    /* Bitmaps receiving nulls are allocated up front, so copying the bits cannot fail */
+    if (dst->validity) {
+        bool allocated = dataframe_enable_validity(src) == DATAFRAME_SUCCESS;
+        for (int c = 0; allocated && c < dst->cols; c++) {
+            if (src->validity[c].null_count)
+                allocated = validity_allocate(&dst->validity[c], (size_t)dst->row_capacity);
+        }
+        if (!allocated) {
+            free_code_maps(code_maps, dst->cols);
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+    }
+
+    if (dst->layout == DATAFRAME_LAYOUT_ROWS && src->layout == DATAFRAME_LAYOUT_ROWS) {
+        /* Row arrays are independent allocations, so only the pointers change hands */
+        for (int r = 0; r < src->rows; r++) {
+            DataCell **slot = &dst->data[dst->rows + r];
+            if (*slot)
+                aligned_free(*slot);
+            *slot = src->data[r];
+            src->data[r] = NULL;
+        }
+    } else if (dst->layout == DATAFRAME_LAYOUT_COLUMNS && src->layout == DATAFRAME_LAYOUT_COLUMNS) {
+        for (int c = 0; c < dst->cols; c++) {
+            memcpy(dst->col_data[c] + dst->rows,
+                   src->col_data[c],
+                   (size_t)src->rows * sizeof(DataCell));
+        }
+    } else {
+        /* Mixed layouts: copy cell by cell (row slots of a row-layout dst are allocated first) */
+        const int base = dst->rows;
+        for (int r = 0; r < src->rows; r++) {
+            if (dataframe_push_row(dst) < 0) {
+                dst->rows = base;
+                free_code_maps(code_maps, dst->cols);
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+            }
+            for (int c = 0; c < dst->cols; c++) {
+                dataframe_set_cell(dst, base + r, c, dataframe_get_cell(src, r, c));
+            }
+        }
+        dst->rows = base;
+    }
+
+    /* The moved string cells point into src's arena blocks */
+    arena_adopt(&dst->strings, &src->strings);
+
+    /* Only words holding a clear bit need attention; bits past src's rows are set */
+    for (int c = 0; dst->validity && c < dst->cols; c++) {
+        const uint64_t *bits = src->validity[c].bits;
+        for (size_t w = 0; bits && w < validity_words((size_t)src->rows); w++) {
+            const uint64_t missing = ~bits[w];
+            for (unsigned b = 0; missing && b < 64; b++) {
+                if (missing >> b & 1u)
+                    validity_assign(&dst->validity[c], (size_t)first_moved + w * 64 + b, false);
+            }
+        }
+    }
+    reset_validity(src, src->rows);
+
+    dst->rows += src->rows;
+    src->rows = 0;
+
+    /* Translate the moved codes into dst's dictionaries */
+    for (int c = 0; code_maps && c < dst->cols; c++) {
+        if (!code_maps[c])
+            continue;
+        for (int r = first_moved; r < dst->rows; r++) {
+            DataCell cell = dataframe_get_cell(dst, r, c);
+            if (cell.v_code >= 0)
+                cell.v_code = code_maps[c][cell.v_code];
+            dataframe_set_cell(dst, r, c, cell);
+        }
+    }
+
+    free_code_maps(code_maps, dst->cols);
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Shared state of a parallel gather of one column through a row permutation.
+ */
+typedef struct {
+    const DataCell *src; /*!< The column's current cells. */
+    DataCell *dst;       /*!< Receives the cells in their new order. */
+    const int *order;    /*!< Former row of each new row. */
+    size_t rows;         /*!< Number of rows to gather. */
+} GatherJob;
+
+/**
+ * @brief Gathers one chunk of GATHER_CHUNK_ROWS rows of a column.
+ * @param context The GatherJob.
+ * @param chunk The chunk index.
+ */
+static void gather_task(void *context, const size_t chunk)
+{
+    const GatherJob *job = context;
+    const size_t begin = chunk * GATHER_CHUNK_ROWS;
+    const size_t remaining = job->rows - begin;
+    const size_t end = remaining < GATHER_CHUNK_ROWS ? job->rows : begin + GATHER_CHUNK_ROWS;
+
+    for (size_t r = begin; r < end; r++) {
+        job->dst[r] = job->src[job->order[r]];
+    }
+}
+
+/**
+ * @brief Releases the buffers allocated by dataframe_permute_rows.
+ * @param spares Spare column arrays (may be NULL).
+ * @param spare_count Number of entries in spares.
+ * @param row_table Scratch copy of the row pointers (may be NULL).
+ * @param bits New validity bitmaps by column (may be NULL).
+ * @param cols Number of entries in bits.
+ */
+static void free_permute_buffers(DataCell **spares,
+                                 const int spare_count,
+                                 DataCell **row_table,
+                                 uint64_t **bits,
+                                 const int cols)
+{
+    for (int i = 0; spares && i < spare_count; i++) {
+        aligned_free(spares[i]);
+    }
+    for (int c = 0; bits && c < cols; c++) {
+        free(bits[c]);
+    }
+    free(spares);
+    free(row_table);
+    free(bits);
+}
+
+DataframeErrorCode dataframe_permute_rows(DataFrame *df, const int *order)
+{
+    if (!df || !order)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (df->rows == 0)
+        return DATAFRAME_SUCCESS;
+
+    const size_t rows = (size_t)df->rows;
+    const size_t words = validity_words((size_t)df->row_capacity);
+
+    /* Everything is allocated up front, so a failure leaves the frame unchanged */
+    int spare_count = 0;
+    DataCell **spares = NULL;
+    DataCell **row_table = NULL;
+    uint64_t **bits = NULL;
+    bool allocated = true;
+
+    if (df->layout == DATAFRAME_LAYOUT_COLUMNS) {
+        /* One spare array rotates through the columns; mapped columns cannot be reused */
+        spare_count = 1;
+        for (int c = 0; c < df->cols; c++) {
+            spare_count += column_is_mapped(df, c);
+        }
+        spares = calloc((size_t)spare_count, sizeof(DataCell *));
+        allocated = spares != NULL;
+        for (int i = 0; allocated && i < spare_count; i++) {
+            spares[i] = (DataCell *)aligned_calloc(
+                (size_t)df->row_capacity, sizeof(DataCell), CACHE_LINE_SIZE);
+            allocated = spares[i] != NULL;
+        }
+    } else {
+        row_table = malloc(rows * sizeof(DataCell *));
+        allocated = row_table != NULL;
+    }
+
+    if (allocated && df->validity) {
+        bits = calloc((size_t)df->cols, sizeof(uint64_t *));
+        allocated = bits != NULL;
+        for (int c = 0; allocated && c < df->cols; c++) {
+            if (!df->validity[c].bits)
+                continue;
+            bits[c] = malloc(words * sizeof(uint64_t));
+            allocated = bits[c] != NULL;
+        }
+    }
+
+    if (!allocated) {
+        free_permute_buffers(spares, spare_count, row_table, bits, df->cols);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    if (df->layout == DATAFRAME_LAYOUT_COLUMNS) {
+        GatherJob job = {0};
+        job.order = order;
+        job.rows = rows;
+        const size_t chunks = (rows + GATHER_CHUNK_ROWS - 1) / GATHER_CHUNK_ROWS;
+        int next = 0;
+
+        for (int c = 0; c < df->cols; c++) {
+            job.src = df->col_data[c];
+            job.dst = spares[next];
+            parallel_for(chunks, 0, gather_task, &job);
+
+            /* The replaced array becomes the next spare unless it lives in the mapping */
+            if (column_is_mapped(df, c))
+                spares[next++] = NULL;
+            else
+                spares[next] = (DataCell *)job.src;
+            df->col_data[c] = job.dst;
+        }
+    } else {
+        /* Rows are separate allocations: only their pointers move */
+        memcpy(row_table, df->data, rows * sizeof(DataCell *));
+        for (size_t r = 0; r < rows; r++) {
+            df->data[r] = row_table[order[r]];
+        }
+    }
+
+    for (int c = 0; bits && c < df->cols; c++) {
+        if (!bits[c])
+            continue;
+
+        const uint64_t *old_bits = df->validity[c].bits;
+        memset(bits[c], 0xFF, words * sizeof(uint64_t));
+        for (size_t r = 0; r < rows; r++) {
+            const size_t from = (size_t)order[r];
+            if (!(old_bits[from / 64] >> (from % 64) & 1u))
+                bits[c][r / 64] &= ~((uint64_t)1 << (r % 64));
+        }
+        if (!is_mapped(df, df->validity[c].bits))
+            free(df->validity[c].bits);
+        df->validity[c].bits = bits[c];
+        bits[c] = NULL;
+    }
+
+    free_permute_buffers(spares, spare_count, row_table, bits, df->cols);
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Shared state of a parallel gather of selected rows of one column into another frame.
+ */
+typedef struct {
+    const DataFrame *src; /*!< The frame providing the cells. */
+    int src_col;          /*!< The column of src to gather. */
+    DataCell *dst;        /*!< Receives the gathered cells. */
+    const int *rows;      /*!< Row of src for each gathered cell (negative for none). */
+    size_t count;         /*!< Number of cells to gather. */
+} TakeJob;
+
+/**
+ * @brief Gathers one chunk of GATHER_CHUNK_ROWS cells of a column.
+ * @param context The TakeJob.
+ * @param chunk The chunk index.
+ */
+static void take_task(void *context, const size_t chunk)
+{
+    const TakeJob *job = context;
+    const size_t begin = chunk * GATHER_CHUNK_ROWS;
+    const size_t remaining = job->count - begin;
+    const size_t end = remaining < GATHER_CHUNK_ROWS ? job->count : begin + GATHER_CHUNK_ROWS;
+    const DataCell empty = {0};
+
+    if (column_is_deferred(job->src, job->src_col)) {
+        for (size_t r = begin; r < end; r++) {
+            job->dst[r] =
+                job->rows[r] < 0 ? empty : dataframe_get_cell(job->src, job->rows[r], job->src_col);
+        }
+    } else if (job->src->layout == DATAFRAME_LAYOUT_COLUMNS) {
+        const DataCell *column = job->src->col_data[job->src_col];
+        for (size_t r = begin; r < end; r++) {
+            job->dst[r] = job->rows[r] < 0 ? empty : column[job->rows[r]];
+        }
+    } else {
+        for (size_t r = begin; r < end; r++) {
+            job->dst[r] = job->rows[r] < 0 ? empty : job->src->data[job->rows[r]][job->src_col];
+        }
+    }
+}
+
+/**
+ * @brief Gives the cells of one gathered column their own strings, codes and validity.
+ *
+ * The cells still hold src's string pointers and dictionary codes: strings
+ * are copied into dst's arena, codes translated into dst's dictionary, and
+ * missing cells marked.
+ *
+ * @param dst The frame receiving the column.
+ * @param dst_col The gathered column of dst.
+ * @param src The frame providing the cells.
+ * @param src_col The column of src.
+ * @param rows Row of src for each cell (negative for none).
+ * @param count Number of cells.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode adopt_gathered_column(DataFrame *dst,
+                                                const int dst_col,
+                                                const DataFrame *src,
+                                                const int src_col,
+                                                const int *rows,
+                                                const size_t count)
+{
+    const DataType type = src->col_types[src_col];
+    DataCell *cells = dst->col_data[dst_col];
+
+    if (type == TYPE_CATEGORY && src->dictionaries && src->dictionaries[src_col]) {
+        int32_t *map = build_code_map(dst, dst_col, src->dictionaries[src_col]);
+        if (!map)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        for (size_t r = 0; r < count; r++) {
+            if (rows[r] >= 0 && cells[r].v_code >= 0)
+                cells[r].v_code = map[cells[r].v_code];
+        }
+        free(map);
+    } else if (type == TYPE_STRING) {
+        for (size_t r = 0; r < count; r++) {
+            if (rows[r] < 0 || !cells[r].v_str)
+                continue;
+            cells[r].v_str = dataframe_store_string(dst, cells[r].v_str, strlen(cells[r].v_str));
+            if (!cells[r].v_str)
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+    }
+
+    /* With validity tracking, a column without a bitmap has no missing values */
+    const uint64_t *bits = dataframe_column_validity(src, src_col, NULL);
+    for (size_t r = 0; r < count; r++) {
+        const int from = rows[r];
+        bool missing = from < 0;
+        if (!missing && bits)
+            missing = !(bits[from / 64] >> (from % 64) & 1u);
+        else if (!missing && !src->validity)
+            missing = dataframe_cell_is_null(src, from, src_col);
+        if (missing && !dataframe_set_valid(dst, (int)r, dst_col, false))
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode dataframe_gather_rows(DataFrame *dst,
+                                         const int dst_col,
+                                         const DataFrame *src,
+                                         const int *src_cols,
+                                         const int col_count,
+                                         const int *rows,
+                                         const size_t count)
+{
+    if (!dst || !src || (col_count > 0 && !src_cols) || (count > 0 && !rows))
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (dst->layout != DATAFRAME_LAYOUT_COLUMNS)
+        return DATAFRAME_ERR_UNSUPPORTED_FORMAT;
+    if (dst_col < 0 || col_count < 0 || dst_col + col_count > dst->cols || count > INT_MAX)
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+    for (int i = 0; i < col_count; i++) {
+        if (src_cols[i] < 0 || src_cols[i] >= src->cols)
+            return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+    }
+    for (size_t r = 0; r < count; r++) {
+        if (rows[r] >= src->rows)
+            return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+    }
+
+    if (!dataframe_reserve_rows(dst, count))
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if ((size_t)dst->rows < count)
+        dst->rows = (int)count;
+
+    TakeJob job = {0};
+    job.src = src;
+    job.rows = rows;
+    job.count = count;
+    const size_t chunks = (count + GATHER_CHUNK_ROWS - 1) / GATHER_CHUNK_ROWS;
+
+    for (int i = 0; i < col_count; i++) {
+        const int col = dst_col + i;
+        dst->col_types[col] = src->col_types[src_cols[i]];
+        job.src_col = src_cols[i];
+        job.dst = dst->col_data[col];
+        parallel_for(chunks, 0, take_task, &job);
+
+        const DataframeErrorCode err =
+            adopt_gathered_column(dst, col, src, src_cols[i], rows, count);
+        if (err != DATAFRAME_SUCCESS)
+            return err;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+void dataframe_clear_rows(DataFrame *df)
+{
+    if (!df)
+        return;
+
+    reset_validity(df, df->rows);
+    df->rows = 0;
+    arena_reset(&df->strings);
+    free(df->string_heaps);
+    df->string_heaps = NULL;
+    df->bad_rows.count = 0;
+    df->bad_rows.total = 0;
+}
+
+void dataframe_adopt_mapping(DataFrame *df, FileMapping *mapping)
+{
+    if (df && !df->mapping)
+        df->mapping = mapping;
+}
+
+bool dataframe_log_bad_row(DataFrame *df, const DataFrameBadRow *entry, const size_t max_logged)
+{
+    if (!df || !entry)
+        return false;
+
+    DataFrameBadRowLog *log = &df->bad_rows;
+    log->total++;
+    if (log->count >= max_logged)
+        return true;
+
+    if (log->count == log->capacity) {
+        size_t capacity = log->capacity ? log->capacity * 2 : 16;
+        if (capacity > max_logged)
+            capacity = max_logged;
+        DataFrameBadRow *grown = realloc(log->entries, capacity * sizeof(DataFrameBadRow));
+        if (!grown)
+            return false;
+        log->entries = grown;
+        log->capacity = capacity;
+    }
+
+    log->entries[log->count++] = *entry;
+    return true;
+}
+
+DataCell *dataframe_append_row(DataFrame *df)
+{
+    if (!df || df->cols <= 0 || df->layout != DATAFRAME_LAYOUT_ROWS)
+        return NULL;
+
+    const int index = dataframe_push_row(df);
+    return index < 0 ? NULL : df->data[index];
+}
+
+int dataframe_push_row(DataFrame *df)
+{
+    if (!df || df->cols <= 0)
+        return -1;
+
+    if (!ensure_row_slot(df))
+        return -1;
+
+    const int index = df->rows;
+    if (df->layout == DATAFRAME_LAYOUT_COLUMNS) {
+        /* A blank cell of a deferred column would read as the heap's first string */
+        resolve_string_heaps(df);
+
+        /* Slots past rows may hold values from before a clear */
+        for (int c = 0; c < df->cols; c++) {
+            memset(&df->col_data[c][index], 0, sizeof(DataCell));
+        }
+    } else {
+        DataCell *row = df->data[index];
+        if (!row) {
+            row = (DataCell *)aligned_calloc((size_t)df->cols, sizeof(DataCell), CACHE_LINE_SIZE);
+            if (!row)
+                return -1;
+            df->data[index] = row;
+        } else {
+            /* Reusing a slot left behind by a shrunk row count: clear old contents */
+            memset(row, 0, (size_t)df->cols * sizeof(DataCell));
+        }
+    }
+
+    df->rows++;
+    return index;
+}
+
+bool dataframe_type_is_int64(const DataType type)
+{
+    return type == TYPE_INT64 || type == TYPE_DATE || type == TYPE_TIMESTAMP;
+}
+
+/**
+ * @brief Checks whether a cell holds its type's missing-value sentinel.
+ * @param df Pointer to the DataFrame.
+ * @param row The zero-based row index.
+ * @param col The zero-based column index.
+ * @return true for NAN numbers, DATAFRAME_NULL_INT64, NULL strings and negative category codes.
+ */
+static bool cell_holds_sentinel(const DataFrame *df, const int row, const int col)
+{
+    const DataCell cell = dataframe_get_cell(df, row, col);
+
+    switch (df->col_types[col]) {
+    case TYPE_NUMERIC:
+        return isnan(cell.v_num);
+    case TYPE_STRING:
+        return cell.v_str == NULL;
+    case TYPE_CATEGORY:
+        return cell.v_code < 0;
+    default:
+        return cell.v_int == DATAFRAME_NULL_INT64;
+    }
+}
+
+bool dataframe_cell_is_null(const DataFrame *df, const int row, const int col)
+{
+    if (!df->validity)
+        return cell_holds_sentinel(df, row, col);
+
+    const uint64_t *bits = df->validity[col].bits;
+    return bits && !(bits[row / 64] >> (row % 64) & 1u);
+}
+
+DataframeErrorCode dataframe_enable_validity(DataFrame *df)
+{
+    if (!df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (df->validity)
+        return DATAFRAME_SUCCESS;
+
+    DataFrameValidity *validity = calloc((size_t)df->cols, sizeof(DataFrameValidity));
+    if (!validity)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    for (int c = 0; c < df->cols; c++) {
+        for (int r = 0; r < df->rows; r++) {
+            if (!cell_holds_sentinel(df, r, c))
+                continue;
+            if (!validity_allocate(&validity[c], (size_t)df->row_capacity)) {
+                for (int k = 0; k <= c; k++) {
+                    free(validity[k].bits);
+                }
+                free(validity);
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+            }
+            validity_assign(&validity[c], (size_t)r, false);
+        }
+    }
+
+    df->validity = validity;
+    return DATAFRAME_SUCCESS;
+}
+
+bool dataframe_set_valid(DataFrame *df, const int row, const int col, const bool valid)
+{
+    if (!df || row < 0 || row >= df->rows || col < 0 || col >= df->cols)
+        return false;
+
+    if (!valid) {
+        DataCell cell = {0};
+        switch (df->col_types[col]) {
+        case TYPE_NUMERIC:
+            cell.v_num = NAN;
+            break;
+        case TYPE_STRING:
+            cell.v_str = NULL;
+            break;
+        case TYPE_CATEGORY:
+            cell.v_code = -1;
+            break;
+        default:
+            cell.v_int = DATAFRAME_NULL_INT64;
+            break;
+        }
+        dataframe_set_cell(df, row, col, cell);
+    }
+    if (!df->validity)
+        return true;
+
+    DataFrameValidity *validity = &df->validity[col];
+    if (valid && !validity->bits)
+        return true;
+    if (!validity_allocate(validity, (size_t)df->row_capacity))
+        return false;
+    validity_assign(validity, (size_t)row, valid);
+    return true;
+}
+
+DataframeErrorCode dataframe_set_validity_bitmap(DataFrame *df,
+                                                 const int col,
+                                                 const int first_row,
+                                                 const uint8_t *bitmap,
+                                                 const size_t count)
+{
+    if (!df || col < 0 || col >= df->cols || first_row < 0 ||
+        (size_t)first_row > (size_t)df->rows || count > (size_t)(df->rows - first_row) ||
+        (count && !bitmap))
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+    if (dataframe_enable_validity(df) != DATAFRAME_SUCCESS)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    DataFrameValidity *validity = &df->validity[col];
+    for (size_t i = 0; i < count; i++) {
+        const bool valid = bitmap[i / 8] >> (i % 8) & 1u;
+        if (valid && !validity->bits)
+            continue;
+        if (!validity_allocate(validity, (size_t)df->row_capacity))
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        validity_assign(validity, (size_t)first_row + i, valid);
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+const uint64_t *
+dataframe_column_validity(const DataFrame *df, const int col, size_t *out_null_count)
+{
+    if (out_null_count)
+        *out_null_count = 0;
+    if (!df || !df->validity || col < 0 || col >= df->cols)
+        return NULL;
+
+    const DataFrameValidity *validity = &df->validity[col];
+    if (out_null_count)
+        *out_null_count = validity->null_count;
+    return validity->null_count ? validity->bits : NULL;
+}
+
+const int64_t *dataframe_int64_column(const DataFrame *df, const int col)
+{
+    if (!df || df->layout != DATAFRAME_LAYOUT_COLUMNS || col < 0 || col >= df->cols ||
+        !dataframe_type_is_int64(df->col_types[col]))
+        return NULL;
+
+    return &df->col_data[col][0].v_int;
+}
+
+DataCell dataframe_get_cell(const DataFrame *df, const int row, const int col)
+{
+    if (df->layout == DATAFRAME_LAYOUT_COLUMNS) {
+        DataCell cell = df->col_data[col][row];
+        if (column_is_deferred(df, col))
+            cell.v_str = heap_string(&df->string_heaps[col], cell.v_int);
+        return cell;
+    }
+    return df->data[row][col];
+}
+
+void dataframe_set_cell(DataFrame *df, const int row, const int col, const DataCell value)
+{
+    if (df->layout == DATAFRAME_LAYOUT_COLUMNS) {
+        if (column_is_deferred(df, col))
+            resolve_string_heap(df, col);
+        df->col_data[col][row] = value;
+    } else {
+        df->data[row][col] = value;
+    }
+}
+
+const double *dataframe_numeric_column(const DataFrame *df, const int col)
+{
+    if (!df || df->layout != DATAFRAME_LAYOUT_COLUMNS || col < 0 || col >= df->cols ||
+        df->col_types[col] != TYPE_NUMERIC)
+        return NULL;
+
+    /* DataCell is exactly one double wide, so the cells of a column form a double array */
+    return &df->col_data[col][0].v_num;
+}
+
+char *dataframe_store_string(DataFrame *df, const char *str, const size_t len)
+{
+    if (!df)
+        return NULL;
+    return arena_strndup(&df->strings, str, len);
+}
+
+int32_t dataframe_intern_string(DataFrame *df, const int col, const char *str, const size_t len)
+{
+    if (!df || col < 0 || col >= df->cols)
+        return -1;
+
+    if (!df->dictionaries) {
+        df->dictionaries = calloc((size_t)df->cols, sizeof(StringDictionary *));
+        if (!df->dictionaries)
+            return -1;
+    }
+    if (!df->dictionaries[col]) {
+        df->dictionaries[col] = string_dictionary_create();
+        if (!df->dictionaries[col])
+            return -1;
+    }
+
+    return string_dictionary_intern(df->dictionaries[col], str, len);
+}
+
+const char *dataframe_get_string(const DataFrame *df, const int row, const int col)
+{
+    const DataCell cell = dataframe_get_cell(df, row, col);
+
+    if (df->col_types[col] == TYPE_STRING)
+        return cell.v_str;
+    if (df->col_types[col] == TYPE_CATEGORY && df->dictionaries)
+        return string_dictionary_value(df->dictionaries[col], cell.v_code);
+    return NULL;
+}
+
+DataframeErrorCode dataframe_dictionary_encode(DataFrame *df, const int col)
+{
+    if (!df || col < 0 || col >= df->cols ||
+        (df->col_types[col] != TYPE_STRING && df->col_types[col] != TYPE_CATEGORY))
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+    if (df->col_types[col] == TYPE_CATEGORY)
+        return DATAFRAME_SUCCESS;
+
+    /* Codes are written in place only once every value has been interned */
+    int32_t *codes = malloc((df->rows ? (size_t)df->rows : 1) * sizeof(int32_t));
+    if (!codes)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    for (int r = 0; r < df->rows; r++) {
+        const char *str = dataframe_get_cell(df, r, col).v_str;
+        codes[r] = dataframe_intern_string(df, col, str, str ? strlen(str) : 0);
+        if (codes[r] < 0) {
+            free(codes);
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+    }
+
+    for (int r = 0; r < df->rows; r++) {
+        DataCell cell = {0};
+        cell.v_code = codes[r];
+        dataframe_set_cell(df, r, col, cell);
+    }
+
+    free(codes);
+    df->col_types[col] = TYPE_CATEGORY;
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode dataframe_index_columns(DataFrame *df)
+{
+    if (!df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    StringDictionary *index = string_dictionary_create();
+    int *cols = malloc((size_t)df->cols * sizeof(int));
+    if (!index || !cols) {
+        string_dictionary_free(index);
+        free(cols);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    for (int c = 0; c < df->cols; c++) {
+        if (!df->columns[c])
+            continue;
+
+        /* Codes are dense, so a new name receives the next one; duplicates keep the first */
+        const int32_t known = index->count;
+        const char *name = df->columns[c];
+        const int32_t code = string_dictionary_intern(index, name, strlen(name));
+        if (code < 0) {
+            string_dictionary_free(index);
+            free(cols);
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+        if (code == known)
+            cols[code] = c;
+    }
+
+    string_dictionary_free(df->name_index);
+    free(df->name_index_cols);
+    df->name_index = index;
+    df->name_index_cols = cols;
+    return DATAFRAME_SUCCESS;
+}
+
+int dataframe_col_index(const DataFrame *df, const char *name)
+{
+    if (!df || !name)
+        return -1;
+
+    if (df->name_index) {
+        const int32_t code = string_dictionary_find(df->name_index, name, strlen(name));
+        return code < 0 ? -1 : df->name_index_cols[code];
+    }
+
+    for (int c = 0; c < df->cols; c++) {
+        if (df->columns[c] && strcmp(df->columns[c], name) == 0)
+            return c;
+    }
+    return -1;
+}
+
+DataFrame *dataframe_retain(DataFrame *df)
+{
+    if (df)
+        parallel_atomic_add(&df->references, 1);
+    return df;
+}
+
+void free_dataframe(DataFrame *df)
+{
+    if (!df || parallel_atomic_add(&df->references, -1) > 0)
         return;
 
     /* Free column names */
@@ -56,28 +1287,88 @@ void free_dataframe(DataFrame *df)
         aligned_free(df->columns);
     }
 
-    /* Free cell contents and row arrays */
-    if (df->data && df->col_types) {
-        for (int r = 0; r < df->rows; r++) {
+    /* Free row arrays (slots past rows may still hold allocations) */
+    if (df->data) {
+        for (int r = 0; r < df->row_capacity; r++) {
             if (df->data[r]) {
-                for (int c = 0; c < df->cols; c++) {
-                    if (df->col_types[c] == TYPE_STRING && df->data[r][c].v_str) {
-                        free(df->data[r][c].v_str); /* Dynamically allocated strings */
-                    }
-                }
                 aligned_free(df->data[r]);
             }
         }
         aligned_free(df->data);
     }
 
+    /* Free column arrays of the columnar layout */
+    if (df->col_data) {
+        for (int c = 0; c < df->cols; c++) {
+            if (df->col_data[c] && !column_is_mapped(df, c))
+                aligned_free(df->col_data[c]);
+        }
+        aligned_free(df->col_data);
+    }
+
+    /* String cells are released block by block together with their arena */
+    arena_release(&df->strings);
+
+    if (df->dictionaries) {
+        for (int c = 0; c < df->cols; c++) {
+            string_dictionary_free(df->dictionaries[c]);
+        }
+        free(df->dictionaries);
+    }
+
     if (df->col_types) {
         aligned_free(df->col_types);
     }
 
+    free(df->bad_rows.entries);
+    string_dictionary_free(df->name_index);
+    free(df->name_index_cols);
+
+    if (df->validity) {
+        for (int c = 0; c < df->cols; c++) {
+            if (!is_mapped(df, df->validity[c].bits))
+                free(df->validity[c].bits);
+        }
+        free(df->validity);
+    }
+    free(df->string_heaps);
+
+    /* Mapped columns and strings become invalid only now */
+    if (df->mapping) {
+        file_mapping_close(df->mapping);
+        free(df->mapping);
+    }
     aligned_free(df);
 }
 
+/**
+ * @brief Prints a TYPE_TIMESTAMP value as an ISO-8601 date and time in UTC.
+ * @param nanos Nanoseconds since 1970-01-01T00:00:00.
+ */
+static void print_timestamp(const int64_t nanos)
+{
+    const int64_t nanos_per_day = INT64_C(86400000000000);
+    int64_t days = nanos / nanos_per_day;
+    int64_t remainder = nanos % nanos_per_day;
+    if (remainder < 0) {
+        remainder += nanos_per_day;
+        days--;
+    }
+
+    int64_t year;
+    int month, day;
+    date_to_civil(days, &year, &month, &day);
+
+    const int64_t seconds = remainder / INT64_C(1000000000);
+    printf("%04lld-%02d-%02d %02d:%02d:%02d ",
+           (long long)year,
+           month,
+           day,
+           (int)(seconds / 3600),
+           (int)(seconds / 60 % 60),
+           (int)(seconds % 60));
+}
+
 void print_head_dataframe(const DataFrame *df, const int limit)
 {
     if (!df)
@@ -94,13 +1385,28 @@ void print_head_dataframe(const DataFrame *df, const int limit)
     const int print_rows = limit < df->rows ? limit : df->rows;
     for (int r = 0; r < print_rows; r++) {
         for (int c = 0; c < df->cols; c++) {
-            if (df->col_types[c] == TYPE_STRING) {
-                printf("%-12s ", df->data[r][c].v_str ? df->data[r][c].v_str : "NULL");
+            const DataCell cell = dataframe_get_cell(df, r, c);
+            if (dataframe_cell_is_null(df, r, c)) {
+                printf("%-12s ", "NULL");
+            } else if (df->col_types[c] == TYPE_STRING || df->col_types[c] == TYPE_CATEGORY) {
+                const char *str = dataframe_get_string(df, r, c);
+                printf("%-12s ", str ? str : "NULL");
+            } else if (dataframe_type_is_int64(df->col_types[c])) {
+                if (df->col_types[c] == TYPE_DATE) {
+                    int64_t year;
+                    int month, day;
+                    date_to_civil(cell.v_int, &year, &month, &day);
+                    printf("%04lld-%02d-%02d   ", (long long)year, month, day);
+                } else if (df->col_types[c] == TYPE_TIMESTAMP) {
+                    print_timestamp(cell.v_int);
+                } else {
+                    printf("%-12lld ", (long long)cell.v_int);
+                }
             } else {
-                if (isnan(df->data[r][c].v_num)) {
+                if (isnan(cell.v_num)) {
                     printf("%-12s ", "NaN");
                 } else {
-                    printf("%-12.4f ", df->data[r][c].v_num);
+                    printf("%-12.4f ", cell.v_num);
                 }
             }
         }
@@ -0,0 +1,643 @@
+#include "dataframe_binary.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "file_mapping.h"
+#include "memory_utils.h"
+
+/**
+ * @brief Leading bytes of every binary DataFrame file.
+ */
+static const char BINARY_MAGIC[8] = {'S', 'D', 'P', 'F', 'R', 'A', 'M', 'E'};
+
+/**
+ * @brief Written as a native uint32 so files from machines of another byte order are rejected.
+ */
+#define BINARY_BYTE_ORDER 0x01020304u
+
+/**
+ * @brief Number of cells converted and written per fwrite call (a multiple of 8).
+ */
+#define BINARY_WRITE_CHUNK 1024
+
+/* The structures are written as raw bytes, so they must not contain padding */
+_Static_assert(sizeof(DataFrameBinaryHeader) == 72, "DataFrameBinaryHeader must not be padded");
+_Static_assert(sizeof(DataFrameBinaryColumn) == 64, "DataFrameBinaryColumn must not be padded");
+_Static_assert(sizeof(DataFrameBinaryBadRow) == 24, "DataFrameBinaryBadRow must not be padded");
+
+/**
+ * @brief Returns the number of bytes of a validity bitmap, a whole number of 64-bit words.
+ * @param rows The number of rows.
+ * @return The bitmap size in bytes.
+ */
+static uint64_t validity_size(const uint64_t rows)
+{
+    return (rows + 63) / 64 * sizeof(uint64_t);
+}
+
+/**
+ * @brief Rounds a file offset up to a multiple of an alignment.
+ * @param value The offset.
+ * @param alignment The alignment (a power of two).
+ * @return The aligned offset.
+ */
+static uint64_t align_up(const uint64_t value, const uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Computes the size of the string heap of one column.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ * @param out_dictionary_count Receives the number of dictionary values (TYPE_CATEGORY).
+ * @return The number of heap bytes, including the terminator of every string.
+ */
+static uint64_t heap_size(const DataFrame *df, const int col, uint64_t *out_dictionary_count)
+{
+    uint64_t size = 0;
+    *out_dictionary_count = 0;
+
+    if (df->col_types[col] == TYPE_STRING) {
+        for (int r = 0; r < df->rows; r++) {
+            const char *str = dataframe_get_cell(df, r, col).v_str;
+            if (str)
+                size += strlen(str) + 1;
+        }
+    } else if (df->col_types[col] == TYPE_CATEGORY && df->dictionaries &&
+               df->dictionaries[col]) {
+        const StringDictionary *dict = df->dictionaries[col];
+        for (int32_t code = 0; code < dict->count; code++) {
+            size += dict->lengths[code] + 1;
+        }
+        *out_dictionary_count = (uint64_t)dict->count;
+    }
+    return size;
+}
+
+/**
+ * @brief Assigns a file offset to every section of the file.
+ * @param df The DataFrame to store.
+ * @param tag The caller's tag.
+ * @param header Receives the header.
+ * @param columns Receives one schema entry per column.
+ */
+static void plan_layout(const DataFrame *df,
+                        const uint64_t tag,
+                        DataFrameBinaryHeader *header,
+                        DataFrameBinaryColumn *columns)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header->version = DATAFRAME_BINARY_VERSION;
+    header->byte_order = BINARY_BYTE_ORDER;
+    header->tag = tag;
+    header->rows = (uint64_t)df->rows;
+    header->cols = (uint64_t)df->cols;
+
+    uint64_t pos =
+        sizeof(DataFrameBinaryHeader) + (uint64_t)df->cols * sizeof(DataFrameBinaryColumn);
+    for (int c = 0; c < df->cols; c++) {
+        memset(&columns[c], 0, sizeof(DataFrameBinaryColumn));
+        columns[c].type = (uint32_t)df->col_types[c];
+        columns[c].name_length = df->columns[c] ? (uint32_t)strlen(df->columns[c]) : 0;
+        columns[c].name_offset = pos;
+        pos += columns[c].name_length + 1;
+    }
+
+    pos = align_up(pos, sizeof(uint64_t));
+    header->bad_row_count = df->bad_rows.count;
+    header->bad_row_total = df->bad_rows.total;
+    header->bad_row_offset = pos;
+    pos += header->bad_row_count * sizeof(DataFrameBinaryBadRow);
+
+    for (int c = 0; c < df->cols; c++) {
+        DataFrameBinaryColumn *column = &columns[c];
+
+        pos = align_up(pos, DATAFRAME_BINARY_ALIGNMENT);
+        column->data_offset = pos;
+        pos += (uint64_t)df->rows * sizeof(DataCell);
+
+        for (int r = 0; r < df->rows; r++) {
+            column->null_count += dataframe_cell_is_null(df, r, c);
+        }
+        if (column->null_count) {
+            pos = align_up(pos, DATAFRAME_BINARY_ALIGNMENT);
+            column->validity_offset = pos;
+            pos += validity_size((uint64_t)df->rows);
+        }
+
+        column->heap_offset = pos;
+        column->heap_size = heap_size(df, c, &column->dictionary_count);
+        pos += column->heap_size;
+    }
+    header->file_size = pos;
+}
+
+/**
+ * @brief Writes zero bytes until the file reaches an offset.
+ * @param file The destination.
+ * @param pos The current offset, updated.
+ * @param target The offset to reach.
+ * @return true on success.
+ */
+static bool write_padding(FILE *file, uint64_t *pos, const uint64_t target)
+{
+    static const char zeros[DATAFRAME_BINARY_ALIGNMENT] = {0};
+
+    while (*pos < target) {
+        const uint64_t gap = target - *pos;
+        const size_t count = gap < sizeof(zeros) ? (size_t)gap : sizeof(zeros);
+        if (fwrite(zeros, 1, count, file) != count)
+            return false;
+        *pos += count;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the cells of one column; string cells become offsets into the column's heap.
+ * @param file The destination.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ * @return true on success.
+ */
+static bool write_cells(FILE *file, const DataFrame *df, const int col)
+{
+    DataCell chunk[BINARY_WRITE_CHUNK];
+    int64_t heap_pos = 0;
+
+    for (int first = 0; first < df->rows; first += BINARY_WRITE_CHUNK) {
+        const int count =
+            df->rows - first < BINARY_WRITE_CHUNK ? df->rows - first : BINARY_WRITE_CHUNK;
+
+        for (int i = 0; i < count; i++) {
+            const DataCell cell = dataframe_get_cell(df, first + i, col);
+            DataCell out = {0};
+
+            if (df->col_types[col] == TYPE_STRING) {
+                out.v_int = cell.v_str ? heap_pos : DATAFRAME_BINARY_NULL_STRING;
+                if (cell.v_str)
+                    heap_pos += (int64_t)strlen(cell.v_str) + 1;
+            } else if (df->col_types[col] == TYPE_CATEGORY) {
+                /* Only the code's bytes are meaningful; the rest of the cell is zeroed */
+                out.v_code = cell.v_code;
+            } else {
+                out = cell;
+            }
+            chunk[i] = out;
+        }
+        if (fwrite(chunk, sizeof(DataCell), (size_t)count, file) != (size_t)count)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the validity bitmap of one column in the in-memory word layout.
+ *
+ * Bits past the last row are set, as in a frame's own bitmaps.
+ *
+ * @param file The destination.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ * @return true on success.
+ */
+static bool write_validity(FILE *file, const DataFrame *df, const int col)
+{
+    uint64_t chunk[BINARY_WRITE_CHUNK / 64];
+
+    for (int first = 0; first < df->rows; first += BINARY_WRITE_CHUNK) {
+        const int count =
+            df->rows - first < BINARY_WRITE_CHUNK ? df->rows - first : BINARY_WRITE_CHUNK;
+        const size_t words = ((size_t)count + 63) / 64;
+
+        memset(chunk, 0xFF, words * sizeof(uint64_t));
+        for (int i = 0; i < count; i++) {
+            if (dataframe_cell_is_null(df, first + i, col))
+                chunk[i / 64] &= ~((uint64_t)1 << (i % 64));
+        }
+        if (fwrite(chunk, sizeof(uint64_t), words, file) != words)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the strings of a TYPE_STRING column or the dictionary of a TYPE_CATEGORY one.
+ * @param file The destination.
+ * @param df The DataFrame.
+ * @param col The zero-based column index.
+ * @return true on success.
+ */
+static bool write_heap(FILE *file, const DataFrame *df, const int col)
+{
+    if (df->col_types[col] == TYPE_STRING) {
+        for (int r = 0; r < df->rows; r++) {
+            const char *str = dataframe_get_cell(df, r, col).v_str;
+            if (str && fwrite(str, 1, strlen(str) + 1, file) != strlen(str) + 1)
+                return false;
+        }
+    } else if (df->col_types[col] == TYPE_CATEGORY && df->dictionaries &&
+               df->dictionaries[col]) {
+        const StringDictionary *dict = df->dictionaries[col];
+        for (int32_t code = 0; code < dict->count; code++) {
+            const size_t size = dict->lengths[code] + 1;
+            if (fwrite(dict->values[code], 1, size, file) != size)
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Writes a complete file following a planned layout.
+ * @param file The destination, positioned at its start.
+ * @param df The DataFrame.
+ * @param header The planned header.
+ * @param columns The planned schema.
+ * @return true on success.
+ */
+static bool write_frame(FILE *file,
+                        const DataFrame *df,
+                        const DataFrameBinaryHeader *header,
+                        const DataFrameBinaryColumn *columns)
+{
+    const size_t cols = (size_t)df->cols;
+    if (fwrite(header, sizeof(DataFrameBinaryHeader), 1, file) != 1 ||
+        fwrite(columns, sizeof(DataFrameBinaryColumn), cols, file) != cols)
+        return false;
+
+    uint64_t pos = sizeof(DataFrameBinaryHeader) + cols * sizeof(DataFrameBinaryColumn);
+    for (int c = 0; c < df->cols; c++) {
+        const char *name = df->columns[c] ? df->columns[c] : "";
+        if (fwrite(name, 1, columns[c].name_length + 1, file) != columns[c].name_length + 1)
+            return false;
+        pos += columns[c].name_length + 1;
+    }
+
+    if (!write_padding(file, &pos, header->bad_row_offset))
+        return false;
+    for (size_t i = 0; i < df->bad_rows.count; i++) {
+        const DataFrameBadRow *entry = &df->bad_rows.entries[i];
+        const DataFrameBinaryBadRow stored = {entry->line, entry->offset, entry->fields, 0};
+        if (fwrite(&stored, sizeof(stored), 1, file) != 1)
+            return false;
+        pos += sizeof(stored);
+    }
+
+    for (int c = 0; c < df->cols; c++) {
+        const DataFrameBinaryColumn *column = &columns[c];
+        if (!write_padding(file, &pos, column->data_offset) || !write_cells(file, df, c))
+            return false;
+        pos = column->data_offset + (uint64_t)df->rows * sizeof(DataCell);
+
+        if (column->null_count) {
+            if (!write_padding(file, &pos, column->validity_offset) ||
+                !write_validity(file, df, c))
+                return false;
+            pos = column->validity_offset + validity_size((uint64_t)df->rows);
+        }
+
+        if (!write_heap(file, df, c))
+            return false;
+        pos = column->heap_offset + column->heap_size;
+    }
+    return true;
+}
+
+DataframeErrorCode dataframe_save_binary(const DataFrame *df, const char *path, const uint64_t tag)
+{
+    if (!df || !path || df->cols <= 0)
+        return DATAFRAME_ERR_WRITE_FAILED;
+
+    const size_t path_len = strlen(path);
+    char *temp_path = malloc(path_len + sizeof(".tmp"));
+    DataFrameBinaryColumn *columns = calloc((size_t)df->cols, sizeof(DataFrameBinaryColumn));
+    if (!temp_path || !columns) {
+        free(temp_path);
+        free(columns);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    memcpy(temp_path, path, path_len);
+    memcpy(temp_path + path_len, ".tmp", sizeof(".tmp"));
+
+    DataFrameBinaryHeader header;
+    plan_layout(df, tag, &header, columns);
+
+    bool ok = false;
+    FILE *file = fopen(temp_path, "wb");
+    if (file) {
+        ok = write_frame(file, df, &header, columns);
+        ok = fclose(file) == 0 && ok;
+    }
+    if (ok) {
+#if defined(_WIN32)
+        /* rename does not replace existing files on Windows */
+        remove(path);
+#endif
+        ok = rename(temp_path, path) == 0;
+    }
+    if (!ok)
+        remove(temp_path);
+
+    free(temp_path);
+    free(columns);
+    return ok ? DATAFRAME_SUCCESS : DATAFRAME_ERR_WRITE_FAILED;
+}
+
+/**
+ * @brief Checks that an array of items lies completely inside the mapping.
+ * @param mapping The file mapping.
+ * @param offset The file offset of the first item.
+ * @param count The number of items.
+ * @param item_size The size of one item in bytes (non-zero).
+ * @return true if the array fits.
+ */
+static bool section_fits(const FileMapping *mapping,
+                         const uint64_t offset,
+                         const uint64_t count,
+                         const uint64_t item_size)
+{
+    return offset <= mapping->size && count <= (mapping->size - offset) / item_size;
+}
+
+/**
+ * @brief Validates the schema entry of one column.
+ * @param mapping The file mapping.
+ * @param rows The number of rows from the header.
+ * @param column The schema entry.
+ * @return true if the column's sections lie inside the file.
+ */
+static bool column_is_valid(const FileMapping *mapping,
+                            const uint64_t rows,
+                            const DataFrameBinaryColumn *column)
+{
+    if (column->type > TYPE_TIMESTAMP ||
+        !section_fits(mapping, column->name_offset, column->name_length + 1ULL, 1) ||
+        mapping->data[column->name_offset + column->name_length] != '\0' ||
+        column->data_offset % DATAFRAME_BINARY_ALIGNMENT != 0 ||
+        !section_fits(mapping, column->data_offset, rows, sizeof(DataCell)) ||
+        !section_fits(mapping, column->heap_offset, column->heap_size, 1) ||
+        column->null_count > rows)
+        return false;
+
+    if (column->null_count) {
+        /* The bitmap is used in place, so it must be aligned and have its tail bits set */
+        if (column->validity_offset % DATAFRAME_BINARY_ALIGNMENT != 0 ||
+            !section_fits(mapping, column->validity_offset, validity_size(rows), 1))
+            return false;
+
+        const uint64_t *bits = (const uint64_t *)(mapping->data + column->validity_offset);
+        const uint64_t tail = rows % 64 ? ~(uint64_t)0 << (rows % 64) : 0;
+        if ((bits[(rows - 1) / 64] & tail) != tail)
+            return false;
+    }
+
+    /* A terminated heap keeps every string lookup inside the file */
+    return column->heap_size == 0 ||
+           mapping->data[column->heap_offset + column->heap_size - 1] == '\0';
+}
+
+/**
+ * @brief Validates the header and schema of a mapped file.
+ * @param mapping The file mapping.
+ * @param options The open options (tag check).
+ * @return true if the file is of this version and its sections lie inside it.
+ */
+static bool file_is_valid(const FileMapping *mapping, const DataFrameBinaryOpenOptions *options)
+{
+    if (mapping->size < sizeof(DataFrameBinaryHeader))
+        return false;
+
+    const DataFrameBinaryHeader *header = (const DataFrameBinaryHeader *)mapping->data;
+    if (memcmp(header->magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 ||
+        header->version != DATAFRAME_BINARY_VERSION || header->byte_order != BINARY_BYTE_ORDER ||
+        header->file_size != mapping->size || (options->check_tag && header->tag != options->tag))
+        return false;
+    if (header->rows > INT_MAX || header->cols == 0 || header->cols > INT_MAX ||
+        !section_fits(mapping,
+                      sizeof(DataFrameBinaryHeader),
+                      header->cols,
+                      sizeof(DataFrameBinaryColumn)) ||
+        header->bad_row_offset % sizeof(uint64_t) != 0 ||
+        !section_fits(
+            mapping, header->bad_row_offset, header->bad_row_count, sizeof(DataFrameBinaryBadRow)))
+        return false;
+
+    const DataFrameBinaryColumn *columns =
+        (const DataFrameBinaryColumn *)(mapping->data + sizeof(DataFrameBinaryHeader));
+    for (uint64_t c = 0; c < header->cols; c++) {
+        if (!column_is_valid(mapping, header->rows, &columns[c]))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Rebuilds the dictionary of a TYPE_CATEGORY column from its heap.
+ * @param df The DataFrame being opened.
+ * @param col The zero-based column index.
+ * @param heap The column's heap in the mapping.
+ * @param column The column's schema entry.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode load_dictionary(DataFrame *df,
+                                          const int col,
+                                          const char *heap,
+                                          const DataFrameBinaryColumn *column)
+{
+    uint64_t pos = 0;
+    for (uint64_t code = 0; code < column->dictionary_count; code++) {
+        if (pos >= column->heap_size)
+            return DATAFRAME_ERR_INVALID_FORMAT;
+
+        const size_t len = strlen(heap + pos);
+        const int32_t interned = dataframe_intern_string(df, col, heap + pos, len);
+        if (interned < 0)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        if ((uint64_t)interned != code)
+            return DATAFRAME_ERR_INVALID_FORMAT;
+        pos += len + 1;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Turns a stored string cell (a heap offset) back into a string pointer.
+ * @param cell The stored cell; receives the pointer.
+ * @param heap The column's heap in the mapping.
+ * @param heap_size The number of bytes in the heap.
+ * @return true on success, false if the offset lies outside the heap.
+ */
+static bool resolve_string(DataCell *cell, const char *heap, const uint64_t heap_size)
+{
+    const int64_t offset = cell->v_int;
+    if (offset == DATAFRAME_BINARY_NULL_STRING) {
+        cell->v_str = NULL;
+        return true;
+    }
+    if (offset < 0 || (uint64_t)offset >= heap_size)
+        return false;
+
+    cell->v_str = (char *)heap + offset;
+    return true;
+}
+
+/**
+ * @brief Fills a frame that owns the file's mapping with the file's columns.
+ *
+ * A columnar frame uses the cells, validity bitmaps and string heaps in
+ * place, so the work done does not depend on the number of rows.
+ *
+ * @param df The DataFrame, created with the requested layout and a row capacity of
+ * exactly the file's rows (the mapped bitmaps have no room for more).
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_INVALID_FORMAT or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode fill_frame(DataFrame *df)
+{
+    /* Copy-on-write pages: later writes to mapped cells and bitmaps never touch the file */
+    char *base = (char *)df->mapping->data;
+    const DataFrameBinaryHeader *header = (const DataFrameBinaryHeader *)base;
+    const DataFrameBinaryColumn *columns =
+        (const DataFrameBinaryColumn *)(base + sizeof(DataFrameBinaryHeader));
+    const int rows = (int)header->rows;
+
+    /* Enabled while the frame is empty, so no bitmap is derived from the blank cells */
+    if (dataframe_enable_validity(df) != DATAFRAME_SUCCESS)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    if (df->layout == DATAFRAME_LAYOUT_ROWS) {
+        for (int r = 0; r < rows; r++) {
+            if (!dataframe_append_row(df))
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+    } else if (rows > 0) {
+        /* Columns are used in place; the heap arrays allocated with the frame are not needed */
+        for (int c = 0; c < df->cols; c++) {
+            aligned_free(df->col_data[c]);
+            df->col_data[c] = (DataCell *)(base + columns[c].data_offset);
+        }
+        df->rows = rows;
+        df->row_capacity = rows;
+    }
+
+    for (int c = 0; c < df->cols; c++) {
+        const DataFrameBinaryColumn *column = &columns[c];
+        const char *heap = base + column->heap_offset;
+
+        df->col_types[c] = (DataType)column->type;
+        df->columns[c] = strdup(base + column->name_offset);
+        if (!df->columns[c])
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+        if (column->type == TYPE_CATEGORY) {
+            const DataframeErrorCode err = load_dictionary(df, c, heap, column);
+            if (err != DATAFRAME_SUCCESS)
+                return err;
+        }
+        if (column->null_count) {
+            df->validity[c].bits = (uint64_t *)(base + column->validity_offset);
+            df->validity[c].null_count = (size_t)column->null_count;
+        }
+
+        /* Mapped string cells keep their offsets until dataframe_get_cell reads them */
+        if (df->layout == DATAFRAME_LAYOUT_COLUMNS) {
+            if (column->type != TYPE_STRING || rows == 0)
+                continue;
+            if (!df->string_heaps) {
+                df->string_heaps = calloc((size_t)df->cols, sizeof(DataFrameStringHeap));
+                if (!df->string_heaps)
+                    return DATAFRAME_ERR_ALLOCATION_FAILED;
+            }
+            df->string_heaps[c].data = heap;
+            df->string_heaps[c].size = (size_t)column->heap_size;
+            continue;
+        }
+
+        const DataCell *cells = (const DataCell *)(base + column->data_offset);
+        for (int r = 0; r < rows; r++) {
+            DataCell cell = cells[r];
+            if (column->type == TYPE_STRING && !resolve_string(&cell, heap, column->heap_size))
+                return DATAFRAME_ERR_INVALID_FORMAT;
+            df->data[r][c] = cell;
+        }
+    }
+    if (dataframe_index_columns(df) != DATAFRAME_SUCCESS)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    const DataFrameBinaryBadRow *entries =
+        (const DataFrameBinaryBadRow *)(base + header->bad_row_offset);
+    for (uint64_t i = 0; i < header->bad_row_count; i++) {
+        const DataFrameBadRow entry = {entries[i].line, entries[i].offset, entries[i].fields};
+        if (!dataframe_log_bad_row(df, &entry, (size_t)header->bad_row_count))
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    df->bad_rows.total = (size_t)header->bad_row_total;
+    return DATAFRAME_SUCCESS;
+}
+
+DataFrameBinaryOpenOptions dataframe_binary_default_open_options(void)
+{
+    DataFrameBinaryOpenOptions options;
+    options.layout = DATAFRAME_LAYOUT_COLUMNS;
+    options.check_tag = false;
+    options.tag = 0;
+    return options;
+}
+
+DataframeErrorCode dataframe_open_mmap(const char *path, DataFrame **out_df)
+{
+    const DataFrameBinaryOpenOptions options = dataframe_binary_default_open_options();
+    return dataframe_open_mmap_with_options(path, &options, out_df);
+}
+
+DataframeErrorCode dataframe_open_mmap_with_options(const char *path,
+                                                    const DataFrameBinaryOpenOptions *options,
+                                                    DataFrame **out_df)
+{
+    if (!out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+    if (!path || !options)
+        return DATAFRAME_ERR_FILE_NOT_FOUND;
+
+    FileMapping *mapping = malloc(sizeof(FileMapping));
+    if (!mapping)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    const FileMappingErrorCode map_err = file_mapping_open_copy_on_write(path, mapping);
+    if (map_err != FILE_MAPPING_SUCCESS) {
+        free(mapping);
+        return map_err == FILE_MAPPING_ERR_ALLOCATION_FAILED ? DATAFRAME_ERR_ALLOCATION_FAILED
+                                                             : DATAFRAME_ERR_FILE_NOT_FOUND;
+    }
+    if (!file_is_valid(mapping, options)) {
+        file_mapping_close(mapping);
+        free(mapping);
+        return DATAFRAME_ERR_INVALID_FORMAT;
+    }
+
+    const DataFrameBinaryHeader *header = (const DataFrameBinaryHeader *)mapping->data;
+    const size_t capacity = options->layout == DATAFRAME_LAYOUT_ROWS ? (size_t)header->rows : 1;
+    DataFrame *df = create_dataframe_with_layout(capacity, (size_t)header->cols, options->layout);
+    if (!df) {
+        file_mapping_close(mapping);
+        free(mapping);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    /* From here on the frame owns the mapping and free_dataframe releases it */
+    dataframe_adopt_mapping(df, mapping);
+    const DataframeErrorCode err = fill_frame(df);
+    if (err != DATAFRAME_SUCCESS) {
+        free_dataframe(df);
+        return err;
+    }
+
+    *out_df = df;
+    return DATAFRAME_SUCCESS;
+}
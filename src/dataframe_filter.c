@@ -0,0 +1,1111 @@
+#include "dataframe_filter.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "date_parser.h"
+#include "number_parser.h"
+#include "parallel.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FILTER_X86 1
+#endif
+
+#if defined(FILTER_X86) &&                                                                         \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define FILTER_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(FILTER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define FILTER_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Number of rows evaluated by one task (a multiple of 64).
+ */
+#define FILTER_CHUNK_ROWS 65536
+
+/**
+ * @brief Returns the index of the lowest set bit of a non-zero 64-bit value.
+ * @param bits The value to inspect (must not be zero).
+ * @return The zero-based position of the least significant set bit.
+ */
+static inline unsigned trailing_zeros64(const uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(bits);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (unsigned)index;
+#else
+    unsigned index = 0;
+    while (!((bits >> index) & 1u))
+        index++;
+    return index;
+#endif
+}
+
+/**
+ * @brief Counts the set bits of a 64-bit value.
+ * @param bits The value to inspect.
+ * @return The number of set bits.
+ */
+static inline size_t popcount64(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_popcountll(bits);
+#else
+    size_t count = 0;
+    for (; bits; bits &= bits - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Returns a mask of the low bits of a word that cover rows of a range.
+ * @param count The number of rows the word covers (1 to 64).
+ * @return A word with the count lowest bits set.
+ */
+static inline uint64_t low_bits(const size_t count)
+{
+    return count >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << count) - 1;
+}
+
+/**
+ * @brief Applies a comparison to two doubles.
+ * @param op The comparison.
+ * @param a The column value.
+ * @param b The constant.
+ * @return The result of a op b.
+ */
+static inline bool compare_double(const FilterOperator op, const double a, const double b)
+{
+    switch (op) {
+    case FILTER_LESS:
+        return a < b;
+    case FILTER_LESS_EQUAL:
+        return a <= b;
+    case FILTER_GREATER:
+        return a > b;
+    case FILTER_GREATER_EQUAL:
+        return a >= b;
+    case FILTER_EQUAL:
+        return a == b;
+    default:
+        return a != b;
+    }
+}
+
+/**
+ * @brief Applies a comparison to two integers.
+ * @param op The comparison.
+ * @param a The column value.
+ * @param b The constant.
+ * @return The result of a op b.
+ */
+static inline bool compare_int64(const FilterOperator op, const int64_t a, const int64_t b)
+{
+    switch (op) {
+    case FILTER_LESS:
+        return a < b;
+    case FILTER_LESS_EQUAL:
+        return a <= b;
+    case FILTER_GREATER:
+        return a > b;
+    case FILTER_GREATER_EQUAL:
+        return a >= b;
+    case FILTER_EQUAL:
+        return a == b;
+    default:
+        return a != b;
+    }
+}
+
+/**
+ * @brief Applies a comparison to two strings, ordered byte-wise.
+ * @param op The comparison.
+ * @param a The column value.
+ * @param a_length Length of a.
+ * @param b The constant.
+ * @param b_length Length of b.
+ * @return The result of a op b.
+ */
+static bool compare_text(const FilterOperator op,
+                         const char *a,
+                         const size_t a_length,
+                         const char *b,
+                         const size_t b_length)
+{
+    const int prefix = memcmp(a, b, a_length < b_length ? a_length : b_length);
+    const int64_t order = prefix ? prefix : (int64_t)a_length - (int64_t)b_length;
+    return compare_int64(op, order, 0);
+}
+
+/**
+ * @brief Checks whether a double satisfies a term.
+ * @param term The term.
+ * @param value The column value.
+ * @return true if the value satisfies the term.
+ */
+static inline bool term_matches_number(const FilterTerm *term, const double value)
+{
+    return compare_double(term->op, value, term->number);
+}
+
+/**
+ * @brief Checks whether an int64-backed value satisfies a term.
+ * @param term The term.
+ * @param value The column value.
+ * @return true if the value satisfies the term.
+ */
+static inline bool term_matches_integer(const FilterTerm *term, const int64_t value)
+{
+    if (term->exact_integer)
+        return compare_int64(term->op, value, term->integer);
+    return compare_double(term->op, (double)value, term->number);
+}
+
+/**
+ * @brief ANDs the comparison of a run of doubles with a constant into a bitmap (scalar).
+ * @param values The values of the rows covered by mask.
+ * @param count The number of values.
+ * @param op The comparison.
+ * @param operand The constant.
+ * @param mask The bitmap of the rows, (count + 63) / 64 words; zero words are skipped.
+ */
+static void and_doubles_scalar(const double *values,
+                               const size_t count,
+                               const FilterOperator op,
+                               const double operand,
+                               uint64_t *mask)
+{
+    for (size_t w = 0; w * 64 < count; w++) {
+        if (!mask[w])
+            continue;
+        const double *block = values + w * 64;
+        const size_t n = count - w * 64 < 64 ? count - w * 64 : 64;
+        uint64_t bits = 0;
+        for (size_t i = 0; i < n; i++) {
+            bits |= (uint64_t)compare_double(op, block[i], operand) << i;
+        }
+        mask[w] &= bits;
+    }
+}
+
+/**
+ * @brief ANDs the comparison of a run of integers with a constant into a bitmap (scalar).
+ * @param values The values of the rows covered by mask.
+ * @param count The number of values.
+ * @param op The comparison.
+ * @param operand The constant.
+ * @param mask The bitmap of the rows; zero words are skipped.
+ */
+static void and_int64s_scalar(const int64_t *values,
+                              const size_t count,
+                              const FilterOperator op,
+                              const int64_t operand,
+                              uint64_t *mask)
+{
+    for (size_t w = 0; w * 64 < count; w++) {
+        if (!mask[w])
+            continue;
+        const int64_t *block = values + w * 64;
+        const size_t n = count - w * 64 < 64 ? count - w * 64 : 64;
+        uint64_t bits = 0;
+        for (size_t i = 0; i < n; i++) {
+            bits |= (uint64_t)compare_int64(op, block[i], operand) << i;
+        }
+        mask[w] &= bits;
+    }
+}
+
+#if defined(FILTER_HAVE_SSE2)
+
+/**
+ * @brief ANDs the comparison of a run of doubles with a constant into a bitmap (SSE2).
+ *
+ * Full words are compared two values at a time; a partial last word falls
+ * back to the scalar loop. Comparisons with NaN follow the C operators.
+ *
+ * @param values The values of the rows covered by mask.
+ * @param count The number of values.
+ * @param op The comparison.
+ * @param operand The constant.
+ * @param mask The bitmap of the rows; zero words are skipped.
+ */
+static void and_doubles_sse2(const double *values,
+                             const size_t count,
+                             const FilterOperator op,
+                             const double operand,
+                             uint64_t *mask)
+{
+    const __m128d b = _mm_set1_pd(operand);
+    const size_t full = count / 64;
+
+    for (size_t w = 0; w < full; w++) {
+        if (!mask[w])
+            continue;
+        const double *block = values + w * 64;
+        uint64_t bits = 0;
+        for (size_t i = 0; i < 64; i += 2) {
+            const __m128d a = _mm_loadu_pd(block + i);
+            __m128d m;
+            switch (op) {
+            case FILTER_LESS:
+                m = _mm_cmplt_pd(a, b);
+                break;
+            case FILTER_LESS_EQUAL:
+                m = _mm_cmple_pd(a, b);
+                break;
+            case FILTER_GREATER:
+                m = _mm_cmpgt_pd(a, b);
+                break;
+            case FILTER_GREATER_EQUAL:
+                m = _mm_cmpge_pd(a, b);
+                break;
+            case FILTER_EQUAL:
+                m = _mm_cmpeq_pd(a, b);
+                break;
+            default:
+                m = _mm_cmpneq_pd(a, b);
+                break;
+            }
+            bits |= (uint64_t)_mm_movemask_pd(m) << i;
+        }
+        mask[w] &= bits;
+    }
+
+    if (full * 64 < count)
+        and_doubles_scalar(values + full * 64, count - full * 64, op, operand, mask + full);
+}
+
+#endif
+
+#if defined(FILTER_HAVE_AVX2)
+
+/**
+ * @brief ANDs the comparison of a run of doubles with a constant into a bitmap (AVX2).
+ *
+ * Full words are compared four values at a time; a partial last word falls
+ * back to the scalar loop. The predicates are the ordered, non-signaling ones
+ * ("!=" the unordered one), so NaN compares as with the C operators.
+ *
+ * @param values The values of the rows covered by mask.
+ * @param count The number of values.
+ * @param op The comparison.
+ * @param operand The constant.
+ * @param mask The bitmap of the rows; zero words are skipped.
+ */
+__attribute__((target("avx2"))) static void and_doubles_avx2(const double *values,
+                                                             const size_t count,
+                                                             const FilterOperator op,
+                                                             const double operand,
+                                                             uint64_t *mask)
+{
+    const __m256d b = _mm256_set1_pd(operand);
+    const size_t full = count / 64;
+
+    for (size_t w = 0; w < full; w++) {
+        if (!mask[w])
+            continue;
+        const double *block = values + w * 64;
+        uint64_t bits = 0;
+        for (size_t i = 0; i < 64; i += 4) {
+            const __m256d a = _mm256_loadu_pd(block + i);
+            __m256d m;
+            switch (op) {
+            case FILTER_LESS:
+                m = _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+                break;
+            case FILTER_LESS_EQUAL:
+                m = _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+                break;
+            case FILTER_GREATER:
+                m = _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+                break;
+            case FILTER_GREATER_EQUAL:
+                m = _mm256_cmp_pd(a, b, _CMP_GE_OQ);
+                break;
+            case FILTER_EQUAL:
+                m = _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+                break;
+            default:
+                m = _mm256_cmp_pd(a, b, _CMP_NEQ_UQ);
+                break;
+            }
+            bits |= (uint64_t)_mm256_movemask_pd(m) << i;
+        }
+        mask[w] &= bits;
+    }
+
+    if (full * 64 < count)
+        and_doubles_scalar(values + full * 64, count - full * 64, op, operand, mask + full);
+}
+
+/**
+ * @brief ANDs the comparison of a run of integers with a constant into a bitmap (AVX2).
+ *
+ * AVX2 only has signed "greater than" and "equal" for 64-bit lanes; the other
+ * comparisons swap the operands or invert the result.
+ *
+ * @param values The values of the rows covered by mask.
+ * @param count The number of values.
+ * @param op The comparison.
+ * @param operand The constant.
+ * @param mask The bitmap of the rows; zero words are skipped.
+ */
+__attribute__((target("avx2"))) static void and_int64s_avx2(const int64_t *values,
+                                                            const size_t count,
+                                                            const FilterOperator op,
+                                                            const int64_t operand,
+                                                            uint64_t *mask)
+{
+    const __m256i b = _mm256_set1_epi64x((long long)operand);
+    const bool invert =
+        op == FILTER_LESS_EQUAL || op == FILTER_GREATER_EQUAL || op == FILTER_NOT_EQUAL;
+    const size_t full = count / 64;
+
+    for (size_t w = 0; w < full; w++) {
+        if (!mask[w])
+            continue;
+        const int64_t *block = values + w * 64;
+        uint64_t bits = 0;
+        for (size_t i = 0; i < 64; i += 4) {
+            const __m256i a = _mm256_loadu_si256((const __m256i *)(block + i));
+            __m256i m;
+            switch (op) {
+            case FILTER_LESS:
+            case FILTER_GREATER_EQUAL:
+                m = _mm256_cmpgt_epi64(b, a);
+                break;
+            case FILTER_GREATER:
+            case FILTER_LESS_EQUAL:
+                m = _mm256_cmpgt_epi64(a, b);
+                break;
+            default:
+                m = _mm256_cmpeq_epi64(a, b);
+                break;
+            }
+            bits |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(m)) << i;
+        }
+        mask[w] &= invert ? ~bits : bits;
+    }
+
+    if (full * 64 < count)
+        and_int64s_scalar(values + full * 64, count - full * 64, op, operand, mask + full);
+}
+
+#endif
+
+/**
+ * @brief ANDs the comparison of a run of doubles into a bitmap with the widest available unit.
+ * @param values The values of the rows covered by mask.
+ * @param count The number of values.
+ * @param op The comparison.
+ * @param operand The constant.
+ * @param mask The bitmap of the rows; zero words are skipped.
+ */
+static void and_doubles(const double *values,
+                        const size_t count,
+                        const FilterOperator op,
+                        const double operand,
+                        uint64_t *mask)
+{
+#if defined(FILTER_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        and_doubles_avx2(values, count, op, operand, mask);
+        return;
+    }
+#endif
+#if defined(FILTER_HAVE_SSE2)
+    and_doubles_sse2(values, count, op, operand, mask);
+#else
+    and_doubles_scalar(values, count, op, operand, mask);
+#endif
+}
+
+/**
+ * @brief ANDs the comparison of a run of integers into a bitmap with the widest available unit.
+ * @param values The values of the rows covered by mask.
+ * @param count The number of values.
+ * @param op The comparison.
+ * @param operand The constant.
+ * @param mask The bitmap of the rows; zero words are skipped.
+ */
+static void and_int64s(const int64_t *values,
+                       const size_t count,
+                       const FilterOperator op,
+                       const int64_t operand,
+                       uint64_t *mask)
+{
+#if defined(FILTER_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        and_int64s_avx2(values, count, op, operand, mask);
+        return;
+    }
+#endif
+    and_int64s_scalar(values, count, op, operand, mask);
+}
+
+/**
+ * @brief Checks whether a category code satisfies a term.
+ *
+ * Codes known when the term was compiled are looked up in its table; codes
+ * added to the dictionary since are compared by their text.
+ *
+ * @param df The DataFrame.
+ * @param term The term.
+ * @param code The code (negative for a missing value).
+ * @return true if the code's value satisfies the term.
+ */
+static bool term_matches_code(const DataFrame *df, const FilterTerm *term, const int32_t code)
+{
+    if (code < 0)
+        return false;
+    if (code < term->code_count)
+        return term->code_matches[code] != 0;
+
+    const StringDictionary *dict = df->dictionaries ? df->dictionaries[term->col] : NULL;
+    return dict && code < dict->count &&
+           compare_text(
+               term->op, dict->values[code], dict->lengths[code], term->text, term->text_length);
+}
+
+/**
+ * @brief ANDs a term evaluated cell by cell into a bitmap.
+ *
+ * Used for row-layout frames, text columns and int64 columns compared with a
+ * fractional constant. Only rows whose bit is still set are read.
+ *
+ * @param df The DataFrame.
+ * @param term The term.
+ * @param first_row The first row covered by mask.
+ * @param count The number of rows.
+ * @param mask The bitmap of the rows.
+ */
+static void and_cells(const DataFrame *df,
+                      const FilterTerm *term,
+                      const size_t first_row,
+                      const size_t count,
+                      uint64_t *mask)
+{
+    for (size_t w = 0; w * 64 < count; w++) {
+        uint64_t pending = mask[w];
+        while (pending) {
+            const unsigned bit = trailing_zeros64(pending);
+            pending &= pending - 1;
+            const int row = (int)(first_row + w * 64 + bit);
+            const DataCell cell = dataframe_get_cell(df, row, term->col);
+
+            bool matches;
+            switch (term->type) {
+            case TYPE_NUMERIC:
+                matches = term_matches_number(term, cell.v_num);
+                break;
+            case TYPE_STRING:
+                matches = cell.v_str && compare_text(term->op,
+                                                     cell.v_str,
+                                                     strlen(cell.v_str),
+                                                     term->text,
+                                                     term->text_length);
+                break;
+            case TYPE_CATEGORY:
+                matches = term_matches_code(df, term, cell.v_code);
+                break;
+            default:
+                matches = term_matches_integer(term, cell.v_int);
+                break;
+            }
+            if (!matches)
+                mask[w] &= ~((uint64_t)1 << bit);
+        }
+    }
+}
+
+/**
+ * @brief ANDs the validity of a column over a range of rows into a bitmap.
+ * @param validity The column's validity bitmap.
+ * @param first_row The first row covered by mask.
+ * @param count The number of rows.
+ * @param mask The bitmap of the rows.
+ */
+static void and_validity(const uint64_t *validity,
+                         const size_t first_row,
+                         const size_t count,
+                         uint64_t *mask)
+{
+    const size_t shift = first_row % 64;
+    const uint64_t *words = validity + first_row / 64;
+
+    for (size_t w = 0; w * 64 < count; w++) {
+        if (!mask[w])
+            continue;
+        uint64_t bits = words[w] >> shift;
+        /* The next word exists whenever rows of this one spill into it */
+        const size_t n = count - w * 64 < 64 ? count - w * 64 : 64;
+        if (shift && shift + n > 64)
+            bits |= words[w + 1] << (64 - shift);
+        mask[w] &= bits;
+    }
+}
+
+/**
+ * @brief ANDs one term into the bitmap of a range of rows.
+ * @param df The DataFrame.
+ * @param term The term.
+ * @param first_row The first row covered by mask.
+ * @param count The number of rows.
+ * @param mask The bitmap of the rows.
+ */
+static void and_term(const DataFrame *df,
+                     const FilterTerm *term,
+                     const size_t first_row,
+                     const size_t count,
+                     uint64_t *mask)
+{
+    const double *numbers = dataframe_numeric_column(df, term->col);
+    const int64_t *integers = term->exact_integer ? dataframe_int64_column(df, term->col) : NULL;
+
+    if (numbers) {
+        and_doubles(numbers + first_row, count, term->op, term->number, mask);
+    } else if (integers) {
+        and_int64s(integers + first_row, count, term->op, term->integer, mask);
+    } else {
+        and_cells(df, term, first_row, count, mask);
+    }
+
+    if (df->validity) {
+        const uint64_t *validity = dataframe_column_validity(df, term->col, NULL);
+        if (validity)
+            and_validity(validity, first_row, count, mask);
+        return;
+    }
+
+    /* Without validity tracking, missing values are sentinels that may still compare true */
+    for (size_t w = 0; w * 64 < count; w++) {
+        uint64_t pending = mask[w];
+        while (pending) {
+            const unsigned bit = trailing_zeros64(pending);
+            pending &= pending - 1;
+            if (dataframe_cell_is_null(df, (int)(first_row + w * 64 + bit), term->col))
+                mask[w] &= ~((uint64_t)1 << bit);
+        }
+    }
+}
+
+void dataframe_filter_range(const DataFrame *df,
+                            const FilterTerm *terms,
+                            const size_t term_count,
+                            const size_t first_row,
+                            const size_t row_count,
+                            uint64_t *out_mask)
+{
+    const size_t words = (row_count + 63) / 64;
+    for (size_t w = 0; w < words; w++) {
+        out_mask[w] = low_bits(row_count - w * 64);
+    }
+    dataframe_filter_and_range(df, terms, term_count, first_row, row_count, out_mask);
+}
+
+void dataframe_filter_and_range(const DataFrame *df,
+                                const FilterTerm *terms,
+                                const size_t term_count,
+                                const size_t first_row,
+                                const size_t row_count,
+                                uint64_t *mask)
+{
+    for (size_t t = 0; t < term_count; t++) {
+        and_term(df, &terms[t], first_row, row_count, mask);
+    }
+}
+
+bool dataframe_filter_matches_field(const FilterTerm *term, const char *begin, const char *end)
+{
+    const size_t len = (size_t)(end - begin);
+    double value;
+    int64_t integer;
+
+    switch (term->type) {
+    case TYPE_STRING:
+    case TYPE_CATEGORY:
+        return compare_text(term->op, begin, len, term->text, term->text_length);
+    case TYPE_INT64:
+        return len && parse_int64_span(begin, end, &integer) == len &&
+               term_matches_integer(term, integer);
+    case TYPE_DATE:
+        return parse_date_span(begin, end, &integer) && term_matches_integer(term, integer);
+    case TYPE_TIMESTAMP:
+        return parse_timestamp_span(begin, end, &integer) && term_matches_integer(term, integer);
+    default:
+        return len && parse_double_span(begin, end, &value) > 0 &&
+               term_matches_number(term, value);
+    }
+}
+
+/**
+ * @brief Resolves the column and parses the constant of one condition.
+ * @param df The DataFrame.
+ * @param condition The condition.
+ * @param out_term Receives the term.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND or DATAFRAME_ERR_INVALID_FORMAT.
+ */
+static DataframeErrorCode
+compile_term(const DataFrame *df, const FilterCondition *condition, FilterTerm *out_term)
+{
+    memset(out_term, 0, sizeof(*out_term));
+    const int col = dataframe_col_index(df, condition->column);
+    if (col < 0)
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+    if (!condition->value || condition->op < FILTER_LESS || condition->op > FILTER_NOT_EQUAL)
+        return DATAFRAME_ERR_INVALID_FORMAT;
+
+    const char *begin = condition->value;
+    const size_t len = strlen(begin);
+    const char *end = begin + len;
+    out_term->col = col;
+    out_term->op = condition->op;
+    out_term->type = df->col_types[col];
+
+    bool parsed;
+    switch (out_term->type) {
+    case TYPE_STRING:
+    case TYPE_CATEGORY:
+        out_term->text = begin;
+        out_term->text_length = len;
+        parsed = true;
+        break;
+    case TYPE_INT64:
+        out_term->exact_integer = len && parse_int64_span(begin, end, &out_term->integer) == len;
+        parsed = out_term->exact_integer ||
+                 (len && parse_double_span(begin, end, &out_term->number) == len);
+        break;
+    case TYPE_DATE:
+        out_term->exact_integer = parsed = parse_date_span(begin, end, &out_term->integer);
+        break;
+    case TYPE_TIMESTAMP:
+        out_term->exact_integer = parsed = parse_timestamp_span(begin, end, &out_term->integer);
+        break;
+    default:
+        parsed = len && parse_double_span(begin, end, &out_term->number) == len;
+        break;
+    }
+    return parsed ? DATAFRAME_SUCCESS : DATAFRAME_ERR_INVALID_FORMAT;
+}
+
+DataframeErrorCode dataframe_predicate_compile(const DataFrame *df,
+                                               const FilterPredicate *predicate,
+                                               FilterTerm **out_terms)
+{
+    if (!out_terms)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_terms = NULL;
+    if (!df || !predicate || (predicate->count && !predicate->conditions))
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (predicate->count == 0)
+        return DATAFRAME_SUCCESS;
+
+    /* The tables of category terms live in the same block as the terms */
+    size_t table_bytes = 0;
+    for (size_t i = 0; i < predicate->count; i++) {
+        const int col = dataframe_col_index(df, predicate->conditions[i].column);
+        if (col >= 0 && df->col_types[col] == TYPE_CATEGORY && df->dictionaries &&
+            df->dictionaries[col])
+            table_bytes += (size_t)df->dictionaries[col]->count;
+    }
+
+    FilterTerm *terms = malloc(predicate->count * sizeof(FilterTerm) + table_bytes);
+    if (!terms)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    uint8_t *tables = (uint8_t *)(terms + predicate->count);
+    for (size_t i = 0; i < predicate->count; i++) {
+        const DataframeErrorCode err = compile_term(df, &predicate->conditions[i], &terms[i]);
+        if (err != DATAFRAME_SUCCESS) {
+            free(terms);
+            return err;
+        }
+
+        const StringDictionary *dict = df->dictionaries ? df->dictionaries[terms[i].col] : NULL;
+        if (terms[i].type != TYPE_CATEGORY || !dict)
+            continue;
+        for (int32_t code = 0; code < dict->count; code++) {
+            tables[code] = compare_text(terms[i].op,
+                                        dict->values[code],
+                                        dict->lengths[code],
+                                        terms[i].text,
+                                        terms[i].text_length);
+        }
+        terms[i].code_matches = tables;
+        terms[i].code_count = dict->count;
+        tables += dict->count;
+    }
+
+    *out_terms = terms;
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Skips whitespace.
+ * @param ptr The current position.
+ * @return The first non-whitespace character at or after ptr.
+ */
+static const char *skip_spaces(const char *ptr)
+{
+    while (isspace((unsigned char)*ptr)) {
+        ptr++;
+    }
+    return ptr;
+}
+
+/**
+ * @brief Checks whether a character can appear in an operator.
+ * @param c The character.
+ * @return true for '<', '>', '=' and '!'.
+ */
+static bool is_operator_char(const char c)
+{
+    return c == '<' || c == '>' || c == '=' || c == '!';
+}
+
+/**
+ * @brief Reads a column name or constant, unquoting it into the predicate's storage.
+ *
+ * An unquoted column name ends before whitespace or an operator character, an
+ * unquoted constant before whitespace or '&'.
+ *
+ * @param ptr The current position; advanced past the token.
+ * @param storage The next free byte of the storage; advanced past the copy.
+ * @param is_column Whether the token is a column name.
+ * @param out_token Receives the null-terminated copy.
+ * @return false if the token is empty or its quote is not closed.
+ */
+static bool read_token(const char **ptr, char **storage, const bool is_column, char **out_token)
+{
+    const char *begin = *ptr;
+    const char *end;
+
+    if (*begin == '"' || *begin == '\'' || *begin == '`') {
+        end = strchr(begin + 1, *begin);
+        if (!end)
+            return false;
+        *ptr = end + 1;
+        begin++;
+    } else {
+        end = begin;
+        while (*end && !isspace((unsigned char)*end) &&
+               (is_column ? !is_operator_char(*end) : *end != '&')) {
+            end++;
+        }
+        *ptr = end;
+        if (end == begin)
+            return false;
+    }
+
+    const size_t len = (size_t)(end - begin);
+    memcpy(*storage, begin, len);
+    (*storage)[len] = '\0';
+    *out_token = *storage;
+    *storage += len + 1;
+    return true;
+}
+
+/**
+ * @brief Reads a comparison operator.
+ * @param ptr The current position; advanced past the operator.
+ * @param out_op Receives the operator.
+ * @return false if no operator starts at ptr.
+ */
+static bool read_operator(const char **ptr, FilterOperator *out_op)
+{
+    static const struct {
+        const char *text;
+        FilterOperator op;
+    } operators[] = {
+        {"<=", FILTER_LESS_EQUAL},
+        {">=", FILTER_GREATER_EQUAL},
+        {"==", FILTER_EQUAL},
+        {"!=", FILTER_NOT_EQUAL},
+        {"<>", FILTER_NOT_EQUAL},
+        {"<", FILTER_LESS},
+        {">", FILTER_GREATER},
+        {"=", FILTER_EQUAL},
+    };
+
+    for (size_t i = 0; i < sizeof(operators) / sizeof(operators[0]); i++) {
+        const size_t len = strlen(operators[i].text);
+        if (strncmp(*ptr, operators[i].text, len) == 0) {
+            *ptr += len;
+            *out_op = operators[i].op;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Reads the AND or && joining two conditions.
+ * @param ptr The current position; advanced past the conjunction.
+ * @return false if no conjunction starts at ptr.
+ */
+static bool read_conjunction(const char **ptr)
+{
+    const char *p = *ptr;
+    if (p[0] == '&' && p[1] == '&') {
+        *ptr = p + 2;
+        return true;
+    }
+    if (tolower((unsigned char)p[0]) == 'a' && tolower((unsigned char)p[1]) == 'n' &&
+        tolower((unsigned char)p[2]) == 'd' &&
+        (isspace((unsigned char)p[3]) || p[3] == '"' || p[3] == '\'' || p[3] == '`')) {
+        *ptr = p + 3;
+        return true;
+    }
+    return false;
+}
+
+DataframeErrorCode dataframe_predicate_parse(const char *expression,
+                                             FilterPredicate *out_predicate)
+{
+    if (!expression || !out_predicate)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    memset(out_predicate, 0, sizeof(*out_predicate));
+
+    /* Every condition takes at least three characters and stores at most two more */
+    const size_t length = strlen(expression);
+    FilterCondition *conditions = malloc((length / 3 + 1) * sizeof(FilterCondition));
+    char *storage = malloc(2 * length + 2);
+    if (!conditions || !storage) {
+        free(conditions);
+        free(storage);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    const char *ptr = expression;
+    char *next = storage;
+    size_t count = 0;
+    bool valid;
+    for (;;) {
+        FilterCondition *condition = &conditions[count];
+        char *column;
+        char *value;
+
+        ptr = skip_spaces(ptr);
+        valid = read_token(&ptr, &next, true, &column);
+        ptr = skip_spaces(ptr);
+        valid = valid && read_operator(&ptr, &condition->op);
+        ptr = skip_spaces(ptr);
+        valid = valid && read_token(&ptr, &next, false, &value);
+        if (!valid)
+            break;
+        condition->column = column;
+        condition->value = value;
+        count++;
+
+        ptr = skip_spaces(ptr);
+        if (!*ptr)
+            break;
+        valid = read_conjunction(&ptr);
+        if (!valid)
+            break;
+    }
+
+    if (!valid) {
+        free(conditions);
+        free(storage);
+        return DATAFRAME_ERR_INVALID_FORMAT;
+    }
+
+    out_predicate->conditions = conditions;
+    out_predicate->count = count;
+    out_predicate->storage = storage;
+    return DATAFRAME_SUCCESS;
+}
+
+void dataframe_predicate_free(FilterPredicate *predicate)
+{
+    if (!predicate)
+        return;
+    if (predicate->storage) {
+        free((void *)predicate->conditions);
+        free(predicate->storage);
+    }
+    memset(predicate, 0, sizeof(*predicate));
+}
+
+/**
+ * @brief Shared state of filtering the rows of a frame in chunks.
+ */
+typedef struct {
+    const DataFrame *df;     /*!< The frame. */
+    const FilterTerm *terms; /*!< The compiled predicate. */
+    size_t term_count;       /*!< Number of terms. */
+    size_t rows;             /*!< Number of rows of the frame. */
+    uint64_t *mask;          /*!< Bitmap of the selected rows. */
+    size_t *offsets;         /*!< Selected rows of each chunk, then its first output slot. */
+    int *out_rows;           /*!< Receives the selected rows. */
+} FilterJob;
+
+/**
+ * @brief Returns the number of rows of a chunk.
+ * @param job The filter job.
+ * @param chunk The chunk index.
+ * @return The number of rows.
+ */
+static size_t chunk_rows(const FilterJob *job, const size_t chunk)
+{
+    const size_t begin = chunk * FILTER_CHUNK_ROWS;
+    const size_t remaining = job->rows - begin;
+    return remaining < FILTER_CHUNK_ROWS ? remaining : FILTER_CHUNK_ROWS;
+}
+
+/**
+ * @brief Evaluates the predicate over one chunk and counts its selected rows.
+ * @param context The FilterJob.
+ * @param chunk The chunk index.
+ */
+static void evaluate_task(void *context, const size_t chunk)
+{
+    FilterJob *job = context;
+    const size_t count = chunk_rows(job, chunk);
+    uint64_t *mask = job->mask + chunk * (FILTER_CHUNK_ROWS / 64);
+
+    dataframe_filter_range(
+        job->df, job->terms, job->term_count, chunk * FILTER_CHUNK_ROWS, count, mask);
+
+    size_t selected = 0;
+    for (size_t w = 0; w * 64 < count; w++) {
+        selected += popcount64(mask[w]);
+    }
+    job->offsets[chunk] = selected;
+}
+
+/**
+ * @brief Writes the selected rows of one chunk to its slice of the selection vector.
+ * @param context The FilterJob.
+ * @param chunk The chunk index.
+ */
+static void select_task(void *context, const size_t chunk)
+{
+    FilterJob *job = context;
+    const size_t count = chunk_rows(job, chunk);
+    const uint64_t *mask = job->mask + chunk * (FILTER_CHUNK_ROWS / 64);
+    int *out = job->out_rows + job->offsets[chunk];
+
+    for (size_t w = 0; w * 64 < count; w++) {
+        const int base = (int)(chunk * FILTER_CHUNK_ROWS + w * 64);
+        uint64_t bits = mask[w];
+        while (bits) {
+            *out++ = base + (int)trailing_zeros64(bits);
+            bits &= bits - 1;
+        }
+    }
+}
+
+DataframeErrorCode dataframe_filter_rows(const DataFrame *df,
+                                         const FilterPredicate *predicate,
+                                         const int num_threads,
+                                         int **out_rows,
+                                         size_t *out_count)
+{
+    if (!out_rows || !out_count)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_rows = NULL;
+    *out_count = 0;
+
+    FilterTerm *terms;
+    DataframeErrorCode err = dataframe_predicate_compile(df, predicate, &terms);
+    if (err != DATAFRAME_SUCCESS)
+        return err;
+
+    FilterJob job = {0};
+    job.df = df;
+    job.terms = terms;
+    job.term_count = predicate->count;
+    job.rows = (size_t)df->rows;
+    const size_t chunk_count = (job.rows + FILTER_CHUNK_ROWS - 1) / FILTER_CHUNK_ROWS;
+    const int threads = num_threads <= 0 ? parallel_hardware_threads() : num_threads;
+
+    const size_t chunks = chunk_count ? chunk_count : 1;
+    job.mask = malloc(chunks * (FILTER_CHUNK_ROWS / 64) * sizeof(uint64_t));
+    job.offsets = malloc(chunks * sizeof(size_t));
+    if (!job.mask || !job.offsets) {
+        err = DATAFRAME_ERR_ALLOCATION_FAILED;
+    } else {
+        parallel_for(chunk_count, threads, evaluate_task, &job);
+
+        size_t total = 0;
+        for (size_t k = 0; k < chunk_count; k++) {
+            const size_t selected = job.offsets[k];
+            job.offsets[k] = total;
+            total += selected;
+        }
+
+        job.out_rows = malloc((total ? total : 1) * sizeof(int));
+        if (!job.out_rows) {
+            err = DATAFRAME_ERR_ALLOCATION_FAILED;
+        } else {
+            parallel_for(chunk_count, threads, select_task, &job);
+            *out_rows = job.out_rows;
+            *out_count = total;
+        }
+    }
+
+    free(terms);
+    free(job.mask);
+    free(job.offsets);
+    return err;
+}
+
+DataframeErrorCode dataframe_filter(const DataFrame *df,
+                                    const FilterPredicate *predicate,
+                                    const int num_threads,
+                                    DataFrame **out_df)
+{
+    if (!out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+
+    int *rows = NULL;
+    size_t count = 0;
+    DataframeErrorCode err = dataframe_filter_rows(df, predicate, num_threads, &rows, &count);
+    if (err != DATAFRAME_SUCCESS)
+        return err;
+
+    int *cols = malloc((df->cols ? (size_t)df->cols : 1) * sizeof(int));
+    DataFrame *out =
+        create_dataframe_with_layout(count ? count : 1, (size_t)df->cols, DATAFRAME_LAYOUT_COLUMNS);
+    err = DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (cols && out && dataframe_enable_validity(out) == DATAFRAME_SUCCESS) {
+        for (int c = 0; c < df->cols; c++) {
+            cols[c] = c;
+        }
+        err = dataframe_gather_rows(out, 0, df, cols, df->cols, rows, count);
+    }
+
+    for (int c = 0; err == DATAFRAME_SUCCESS && c < df->cols; c++) {
+        out->columns[c] = strdup(df->columns[c] ? df->columns[c] : "");
+        if (!out->columns[c])
+            err = DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    if (err == DATAFRAME_SUCCESS)
+        err = dataframe_index_columns(out);
+
+    free(rows);
+    free(cols);
+    if (err != DATAFRAME_SUCCESS) {
+        free_dataframe(out);
+        return err;
+    }
+    *out_df = out;
+    return DATAFRAME_SUCCESS;
+}
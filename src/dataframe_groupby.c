@@ -0,0 +1,757 @@
+#include "dataframe_groupby.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parallel.h"
+#include "statistics.h"
+
+/**
+ * @brief Minimum number of rows aggregated by one thread; smaller inputs use fewer threads.
+ */
+#define GROUPBY_CHUNK_ROWS 65536
+
+/**
+ * @brief Number of groups, and half the number of hash slots, reserved by a new table.
+ */
+#define GROUPBY_INITIAL_GROUPS 64
+
+/**
+ * @brief Running aggregates of one column within one group.
+ */
+typedef struct {
+    RunningStatistics stats; /*!< Count, mean and M2 of the non-missing values. */
+    double sum;              /*!< Sum of the non-missing values. */
+    double min;              /*!< Smallest value (+INFINITY while there is none). */
+    double max;              /*!< Largest value (-INFINITY while there is none). */
+} GroupAccumulator;
+
+/**
+ * @brief An open-addressing hash table of groups with their accumulators.
+ *
+ * Groups are stored in insertion order in parallel arrays; the slots map
+ * hashes to group indices with linear probing.
+ */
+typedef struct {
+    size_t count;            /*!< Number of groups. */
+    size_t capacity;         /*!< Number of groups the arrays can hold. */
+    uint64_t *hashes;        /*!< Hash of each group's key. */
+    uint64_t *keys;          /*!< Encoded key values, key_count words per group. */
+    uint8_t *key_missing;    /*!< Whether each key value is missing, key_count flags per group. */
+    int *first_rows;         /*!< First row of each group, which also holds its key values. */
+    GroupAccumulator *accs;  /*!< Accumulators, value_count per group. */
+    int32_t *slots;          /*!< Group index of each slot (-1 marks an empty slot). */
+    size_t slot_count;       /*!< Number of slots (a power of two). */
+    bool failed;             /*!< Whether an allocation failed while filling the table. */
+} GroupTable;
+
+/**
+ * @brief Shared state of one group-by: the columns involved and the partial tables.
+ */
+typedef struct {
+    const DataFrame *df;             /*!< The frame being aggregated. */
+    const int *keys;                 /*!< The key columns. */
+    int key_count;                   /*!< Number of key columns. */
+    int *values;                     /*!< The distinct aggregated columns. */
+    int value_count;                 /*!< Number of distinct aggregated columns. */
+    bool *value_numeric;             /*!< Whether each aggregated column holds numbers. */
+    const uint64_t **validity;       /*!< Bitmap of each key, then each value column, or NULL. */
+    size_t rows;                     /*!< Number of rows of the frame. */
+    size_t chunk_rows;               /*!< Number of rows aggregated by one task. */
+    GroupTable *partials;            /*!< The table filled by each task. */
+} GroupByJob;
+
+/**
+ * @brief Mixes one more word into a running key hash.
+ * @param hash The hash so far.
+ * @param word The word to mix in.
+ * @return The new hash.
+ */
+static uint64_t mix_hash(uint64_t hash, const uint64_t word)
+{
+    hash ^= word + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    hash ^= hash >> 31;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    return hash ^ hash >> 29;
+}
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a string.
+ * @param text The null-terminated string.
+ * @return The hash value.
+ */
+static uint64_t hash_text(const char *text)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (; *text; text++) {
+        hash ^= (unsigned char)*text;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Checks whether a cell is missing, using the column's bitmap when there is one.
+ * @param job The group-by state.
+ * @param validity The column's validity bitmap, or NULL.
+ * @param row The row.
+ * @param col The column.
+ * @return true if the cell is missing.
+ */
+static bool
+cell_is_missing(const GroupByJob *job, const uint64_t *validity, const int row, const int col)
+{
+    if (validity)
+        return !(validity[row / 64] >> (row % 64) & 1u);
+    /* With validity tracking, a column without a bitmap has no missing values */
+    return !job->df->validity && dataframe_cell_is_null(job->df, row, col);
+}
+
+/**
+ * @brief Encodes a key value as a word that is equal for equal values.
+ *
+ * Numbers are compared by value (0.0 and -0.0 match, as do all NaN) and
+ * strings by a hash of their text, which is confirmed with strcmp on lookup.
+ *
+ * @param df Pointer to the DataFrame.
+ * @param row The row.
+ * @param col The key column.
+ * @return The encoded value.
+ */
+static uint64_t encode_key(const DataFrame *df, const int row, const int col)
+{
+    const DataCell cell = dataframe_get_cell(df, row, col);
+
+    switch (df->col_types[col]) {
+    case TYPE_NUMERIC: {
+        double value = cell.v_num == 0.0 ? 0.0 : cell.v_num;
+        if (isnan(value))
+            value = NAN;
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    case TYPE_STRING:
+        return hash_text(cell.v_str);
+    case TYPE_CATEGORY:
+        return (uint64_t)(uint32_t)cell.v_code;
+    default:
+        return (uint64_t)cell.v_int;
+    }
+}
+
+/**
+ * @brief Resets an accumulator to the empty state.
+ * @param acc The accumulator.
+ */
+static void accumulator_reset(GroupAccumulator *acc)
+{
+    running_statistics_reset(&acc->stats);
+    acc->sum = 0.0;
+    acc->min = INFINITY;
+    acc->max = -INFINITY;
+}
+
+/**
+ * @brief Folds one accumulator into another.
+ * @param acc The accumulator receiving the combined result.
+ * @param other The accumulator to fold into acc.
+ */
+static void accumulator_merge(GroupAccumulator *acc, const GroupAccumulator *other)
+{
+    running_statistics_merge(&acc->stats, &other->stats);
+    acc->sum += other->sum;
+    if (other->min < acc->min)
+        acc->min = other->min;
+    if (other->max > acc->max)
+        acc->max = other->max;
+}
+
+/**
+ * @brief Allocates the arrays of an empty table.
+ * @param table The table.
+ * @param job The group-by state (for the key and value counts).
+ * @return true on success, false on allocation failure.
+ */
+static bool table_init(GroupTable *table, const GroupByJob *job)
+{
+    memset(table, 0, sizeof(GroupTable));
+    table->capacity = GROUPBY_INITIAL_GROUPS;
+    table->slot_count = 2 * GROUPBY_INITIAL_GROUPS;
+    table->hashes = malloc(table->capacity * sizeof(uint64_t));
+    table->keys = malloc(table->capacity * (size_t)job->key_count * sizeof(uint64_t));
+    table->key_missing = malloc(table->capacity * (size_t)job->key_count);
+    table->first_rows = malloc(table->capacity * sizeof(int));
+    table->accs = malloc(table->capacity * (size_t)job->value_count * sizeof(GroupAccumulator) + 1);
+    table->slots = malloc(table->slot_count * sizeof(int32_t));
+
+    table->failed = !table->hashes || !table->keys || !table->key_missing ||
+                    !table->first_rows || !table->accs || !table->slots;
+    if (!table->failed)
+        memset(table->slots, 0xFF, table->slot_count * sizeof(int32_t));
+    return !table->failed;
+}
+
+/**
+ * @brief Frees the arrays of a table.
+ * @param table The table.
+ */
+static void table_release(GroupTable *table)
+{
+    free(table->hashes);
+    free(table->keys);
+    free(table->key_missing);
+    free(table->first_rows);
+    free(table->accs);
+    free(table->slots);
+    memset(table, 0, sizeof(GroupTable));
+}
+
+/**
+ * @brief Doubles the number of groups a table can hold and rehashes its slots if needed.
+ * @param table The table (its count equals its capacity).
+ * @param job The group-by state.
+ * @return true on success, false on allocation failure (the table is left usable).
+ */
+static bool table_grow(GroupTable *table, const GroupByJob *job)
+{
+    const size_t capacity = table->capacity * 2;
+    const size_t keys = (size_t)job->key_count;
+    const size_t values = (size_t)job->value_count;
+
+    uint64_t *hashes = realloc(table->hashes, capacity * sizeof(uint64_t));
+    if (hashes)
+        table->hashes = hashes;
+    uint64_t *key_words = realloc(table->keys, capacity * keys * sizeof(uint64_t));
+    if (key_words)
+        table->keys = key_words;
+    uint8_t *key_missing = realloc(table->key_missing, capacity * keys);
+    if (key_missing)
+        table->key_missing = key_missing;
+    int *first_rows = realloc(table->first_rows, capacity * sizeof(int));
+    if (first_rows)
+        table->first_rows = first_rows;
+    GroupAccumulator *accs = realloc(table->accs, capacity * values * sizeof(GroupAccumulator) + 1);
+    if (accs)
+        table->accs = accs;
+    int32_t *slots = malloc(2 * capacity * sizeof(int32_t));
+    if (!hashes || !key_words || !key_missing || !first_rows || !accs || !slots) {
+        free(slots);
+        return false;
+    }
+
+    /* Keep the load factor at or below one half */
+    free(table->slots);
+    table->slots = slots;
+    table->slot_count = 2 * capacity;
+    table->capacity = capacity;
+    memset(slots, 0xFF, table->slot_count * sizeof(int32_t));
+    for (size_t g = 0; g < table->count; g++) {
+        size_t slot = table->hashes[g] & (table->slot_count - 1);
+        while (slots[slot] >= 0) {
+            slot = (slot + 1) & (table->slot_count - 1);
+        }
+        slots[slot] = (int32_t)g;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether a group's key equals the key of a row.
+ * @param table The table.
+ * @param job The group-by state.
+ * @param group The group index.
+ * @param hash The row's key hash.
+ * @param words The row's encoded key values.
+ * @param missing The row's key missing flags.
+ * @param row The row, whose strings confirm string key matches.
+ * @return true if the keys are equal.
+ */
+static bool group_matches(const GroupTable *table,
+                          const GroupByJob *job,
+                          const size_t group,
+                          const uint64_t hash,
+                          const uint64_t *words,
+                          const uint8_t *missing,
+                          const int row)
+{
+    const size_t keys = (size_t)job->key_count;
+    if (table->hashes[group] != hash ||
+        memcmp(&table->keys[group * keys], words, keys * sizeof(uint64_t)) != 0 ||
+        memcmp(&table->key_missing[group * keys], missing, keys) != 0)
+        return false;
+
+    for (size_t k = 0; k < keys; k++) {
+        const int col = job->keys[k];
+        if (job->df->col_types[col] != TYPE_STRING || missing[k])
+            continue;
+        if (strcmp(dataframe_get_string(job->df, table->first_rows[group], col),
+                   dataframe_get_string(job->df, row, col)) != 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Finds the group of a key, adding an empty group if the key is new.
+ * @param table The table.
+ * @param job The group-by state.
+ * @param hash The key's hash.
+ * @param words The encoded key values.
+ * @param missing The key missing flags.
+ * @param row A row holding the key (the first row of a new group).
+ * @return The group index, or -1 on allocation failure.
+ */
+static int32_t find_group(GroupTable *table,
+                          const GroupByJob *job,
+                          const uint64_t hash,
+                          const uint64_t *words,
+                          const uint8_t *missing,
+                          const int row)
+{
+    size_t slot = hash & (table->slot_count - 1);
+    for (; table->slots[slot] >= 0; slot = (slot + 1) & (table->slot_count - 1)) {
+        const int32_t group = table->slots[slot];
+        if (group_matches(table, job, (size_t)group, hash, words, missing, row))
+            return group;
+    }
+
+    if (table->count == table->capacity) {
+        if (!table_grow(table, job))
+            return -1;
+        /* The slots were rebuilt; find the free slot again */
+        slot = hash & (table->slot_count - 1);
+        while (table->slots[slot] >= 0) {
+            slot = (slot + 1) & (table->slot_count - 1);
+        }
+    }
+
+    const size_t group = table->count++;
+    const size_t keys = (size_t)job->key_count;
+    table->slots[slot] = (int32_t)group;
+    table->hashes[group] = hash;
+    memcpy(&table->keys[group * keys], words, keys * sizeof(uint64_t));
+    memcpy(&table->key_missing[group * keys], missing, keys);
+    table->first_rows[group] = row;
+    for (int v = 0; v < job->value_count; v++) {
+        accumulator_reset(&table->accs[group * (size_t)job->value_count + (size_t)v]);
+    }
+    return (int32_t)group;
+}
+
+/**
+ * @brief Task aggregating one range of rows into its own partial table.
+ * @param context The GroupByJob.
+ * @param chunk The task index.
+ */
+static void aggregate_chunk_task(void *context, const size_t chunk)
+{
+    const GroupByJob *job = context;
+    GroupTable *table = &job->partials[chunk];
+    const size_t begin = chunk * job->chunk_rows;
+    const size_t end = job->rows - begin < job->chunk_rows ? job->rows : begin + job->chunk_rows;
+
+    uint64_t *words = malloc((size_t)job->key_count * sizeof(uint64_t));
+    uint8_t *missing = malloc((size_t)job->key_count);
+    if (!words || !missing || !table_init(table, job)) {
+        table->failed = true;
+        free(words);
+        free(missing);
+        return;
+    }
+
+    for (size_t r = begin; r < end; r++) {
+        const int row = (int)r;
+        uint64_t hash = 0;
+        for (int k = 0; k < job->key_count; k++) {
+            const int col = job->keys[k];
+            missing[k] = cell_is_missing(job, job->validity[k], row, col);
+            words[k] = missing[k] ? 0 : encode_key(job->df, row, col);
+            hash = mix_hash(hash, words[k] ^ missing[k]);
+        }
+
+        const int32_t group = find_group(table, job, hash, words, missing, row);
+        if (group < 0) {
+            table->failed = true;
+            break;
+        }
+
+        GroupAccumulator *accs = &table->accs[(size_t)group * (size_t)job->value_count];
+        for (int v = 0; v < job->value_count; v++) {
+            const int col = job->values[v];
+            if (cell_is_missing(job, job->validity[job->key_count + v], row, col))
+                continue;
+            if (!job->value_numeric[v]) {
+                accs[v].stats.count++;
+                continue;
+            }
+
+            const DataCell cell = dataframe_get_cell(job->df, row, col);
+            const double x =
+                job->df->col_types[col] == TYPE_NUMERIC ? cell.v_num : (double)cell.v_int;
+            running_statistics_add(&accs[v].stats, x);
+            accs[v].sum += x;
+            if (x < accs[v].min)
+                accs[v].min = x;
+            if (x > accs[v].max)
+                accs[v].max = x;
+        }
+    }
+
+    free(words);
+    free(missing);
+}
+
+/**
+ * @brief Folds the groups of a partial table into the final table.
+ * @param dst The final table.
+ * @param src A partial table.
+ * @param job The group-by state.
+ * @return true on success, false on allocation failure.
+ */
+static bool table_merge(GroupTable *dst, const GroupTable *src, const GroupByJob *job)
+{
+    const size_t keys = (size_t)job->key_count;
+    const size_t values = (size_t)job->value_count;
+
+    for (size_t g = 0; g < src->count; g++) {
+        const int row = src->first_rows[g];
+        const int32_t group = find_group(
+            dst, job, src->hashes[g], &src->keys[g * keys], &src->key_missing[g * keys], row);
+        if (group < 0)
+            return false;
+
+        if (row < dst->first_rows[group])
+            dst->first_rows[group] = row;
+        for (size_t v = 0; v < values; v++) {
+            accumulator_merge(&dst->accs[(size_t)group * values + v], &src->accs[g * values + v]);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Orders group indices by their first row.
+ * @param a Pointer to the first group's first row and index.
+ * @param b Pointer to the second group's first row and index.
+ * @return A negative value, zero or a positive value as for qsort.
+ */
+static int compare_first_rows(const void *a, const void *b)
+{
+    const int row_a = ((const int *)a)[0];
+    const int row_b = ((const int *)b)[0];
+    return (row_a > row_b) - (row_a < row_b);
+}
+
+const char *dataframe_groupby_suffix(const GroupByAggregation aggregation)
+{
+    switch (aggregation) {
+    case GROUPBY_COUNT:
+        return "count";
+    case GROUPBY_SUM:
+        return "sum";
+    case GROUPBY_MEAN:
+        return "mean";
+    case GROUPBY_VARIANCE:
+        return "variance";
+    case GROUPBY_MIN:
+        return "min";
+    default:
+        return "max";
+    }
+}
+
+/**
+ * @brief Writes the key cells of one output row.
+ * @param out The result frame.
+ * @param job The group-by state.
+ * @param table The final table.
+ * @param group The group index.
+ * @param out_row The output row.
+ * @return true on success, false on allocation failure.
+ */
+static bool write_keys(DataFrame *out,
+                       const GroupByJob *job,
+                       const GroupTable *table,
+                       const size_t group,
+                       const int out_row)
+{
+    const int row = table->first_rows[group];
+
+    for (int k = 0; k < job->key_count; k++) {
+        const int col = job->keys[k];
+        if (table->key_missing[group * (size_t)job->key_count + (size_t)k]) {
+            if (!dataframe_set_valid(out, out_row, k, false))
+                return false;
+            continue;
+        }
+
+        DataCell cell = dataframe_get_cell(job->df, row, col);
+        if (out->col_types[k] == TYPE_STRING) {
+            cell.v_str = dataframe_store_string(out, cell.v_str, strlen(cell.v_str));
+            if (!cell.v_str)
+                return false;
+        } else if (out->col_types[k] == TYPE_CATEGORY) {
+            const char *text = dataframe_get_string(job->df, row, col);
+            cell.v_int = 0;
+            cell.v_code = dataframe_intern_string(out, k, text, strlen(text));
+            if (cell.v_code < 0)
+                return false;
+        }
+        dataframe_set_cell(out, out_row, k, cell);
+    }
+    return true;
+}
+
+/**
+ * @brief Builds the result frame from the final table.
+ * @param job The group-by state.
+ * @param table The final table.
+ * @param aggregates The output aggregates.
+ * @param aggregate_count The number of aggregates.
+ * @param value_slots The accumulator index of each aggregate.
+ * @param out_df Receives the result.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode build_result(const GroupByJob *job,
+                                       const GroupTable *table,
+                                       const GroupByAggregate *aggregates,
+                                       const int aggregate_count,
+                                       const int *value_slots,
+                                       DataFrame **out_df)
+{
+    const DataFrame *df = job->df;
+    const size_t groups = table->count;
+    const int cols = job->key_count + aggregate_count;
+
+    /* Groups come out in order of first appearance, whatever the thread split */
+    int *order = malloc((groups ? groups : 1) * 2 * sizeof(int));
+    DataFrame *out =
+        create_dataframe_with_layout(groups ? groups : 1, (size_t)cols, DATAFRAME_LAYOUT_COLUMNS);
+    if (!order || !out || dataframe_enable_validity(out) != DATAFRAME_SUCCESS) {
+        free(order);
+        free_dataframe(out);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    for (size_t g = 0; g < groups; g++) {
+        order[2 * g] = table->first_rows[g];
+        order[2 * g + 1] = (int)g;
+    }
+    qsort(order, groups, 2 * sizeof(int), compare_first_rows);
+
+    bool ok = true;
+    for (int c = 0; c < cols && ok; c++) {
+        char name[256];
+        if (c < job->key_count) {
+            out->col_types[c] = df->col_types[job->keys[c]];
+            const char *key_name = df->columns[job->keys[c]];
+            snprintf(name, sizeof(name), "%s", key_name ? key_name : "");
+        } else {
+            const GroupByAggregate *agg = &aggregates[c - job->key_count];
+            out->col_types[c] = agg->aggregation == GROUPBY_COUNT ? TYPE_INT64 : TYPE_NUMERIC;
+            if (agg->name)
+                snprintf(name, sizeof(name), "%s", agg->name);
+            else
+                snprintf(name,
+                         sizeof(name),
+                         "%s_%s",
+                         df->columns[agg->col] ? df->columns[agg->col] : "",
+                         dataframe_groupby_suffix(agg->aggregation));
+        }
+        out->columns[c] = strdup(name);
+        ok = out->columns[c] != NULL;
+    }
+
+    for (size_t i = 0; i < groups && ok; i++) {
+        const size_t group = (size_t)order[2 * i + 1];
+        const int out_row = dataframe_push_row(out);
+        ok = out_row >= 0 && write_keys(out, job, table, group, out_row);
+
+        for (int a = 0; a < aggregate_count && ok; a++) {
+            const GroupAccumulator *acc =
+                &table->accs[group * (size_t)job->value_count + (size_t)value_slots[a]];
+            const size_t n = acc->stats.count;
+            const int col = job->key_count + a;
+            DataCell cell = {0};
+            bool valid = true;
+
+            switch (aggregates[a].aggregation) {
+            case GROUPBY_COUNT:
+                cell.v_int = (int64_t)n;
+                break;
+            case GROUPBY_SUM:
+                cell.v_num = acc->sum;
+                valid = n > 0;
+                break;
+            case GROUPBY_MEAN:
+                cell.v_num = acc->stats.mean;
+                valid = n > 0;
+                break;
+            case GROUPBY_VARIANCE:
+                cell.v_num = n > 1 ? acc->stats.m2 / (double)(n - 1) : NAN;
+                valid = n > 1;
+                break;
+            case GROUPBY_MIN:
+                cell.v_num = acc->min;
+                valid = n > 0;
+                break;
+            default:
+                cell.v_num = acc->max;
+                valid = n > 0;
+                break;
+            }
+            dataframe_set_cell(out, out_row, col, cell);
+            if (!valid)
+                ok = dataframe_set_valid(out, out_row, col, false);
+        }
+    }
+
+    free(order);
+    if (!ok || dataframe_index_columns(out) != DATAFRAME_SUCCESS) {
+        free_dataframe(out);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    *out_df = out;
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Checks the key and aggregate columns and collects the distinct aggregated columns.
+ * @param df Pointer to the DataFrame.
+ * @param keys The key columns.
+ * @param key_count The number of key columns.
+ * @param aggregates The output aggregates.
+ * @param aggregate_count The number of aggregates.
+ * @param job Receives the distinct columns in values and value_count (values must hold
+ * aggregate_count entries).
+ * @param value_slots Receives the index in values of each aggregate's column.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_COLUMN_NOT_FOUND.
+ */
+static DataframeErrorCode validate_columns(const DataFrame *df,
+                                           const int *keys,
+                                           const int key_count,
+                                           const GroupByAggregate *aggregates,
+                                           const int aggregate_count,
+                                           GroupByJob *job,
+                                           int *value_slots)
+{
+    for (int k = 0; k < key_count; k++) {
+        if (keys[k] < 0 || keys[k] >= df->cols)
+            return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+    }
+
+    job->value_count = 0;
+    for (int a = 0; a < aggregate_count; a++) {
+        const int col = aggregates[a].col;
+        if (col < 0 || col >= df->cols || aggregates[a].aggregation < GROUPBY_COUNT ||
+            aggregates[a].aggregation > GROUPBY_MAX)
+            return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+
+        const bool numeric =
+            df->col_types[col] == TYPE_NUMERIC || dataframe_type_is_int64(df->col_types[col]);
+        if (!numeric && aggregates[a].aggregation != GROUPBY_COUNT)
+            return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+
+        int slot = 0;
+        while (slot < job->value_count && job->values[slot] != col) {
+            slot++;
+        }
+        if (slot == job->value_count) {
+            job->values[slot] = col;
+            job->value_numeric[slot] = numeric;
+            job->value_count++;
+        }
+        value_slots[a] = slot;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode dataframe_groupby_agg(const DataFrame *df,
+                                         const int *keys,
+                                         const int key_count,
+                                         const GroupByAggregate *aggregates,
+                                         const int aggregate_count,
+                                         const int num_threads,
+                                         DataFrame **out_df)
+{
+    if (!out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+    if (!df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (!keys || key_count <= 0 || aggregate_count < 0 || (aggregate_count > 0 && !aggregates))
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+
+    GroupByJob job = {0};
+    job.df = df;
+    job.keys = keys;
+    job.key_count = key_count;
+    job.rows = (size_t)df->rows;
+
+    const size_t slots = aggregate_count ? (size_t)aggregate_count : 1;
+    int *value_slots = malloc(slots * sizeof(int));
+    job.values = malloc(slots * sizeof(int));
+    job.value_numeric = malloc(slots * sizeof(bool));
+    job.validity = malloc(((size_t)key_count + slots) * sizeof(const uint64_t *));
+    if (!value_slots || !job.values || !job.value_numeric || !job.validity) {
+        free(value_slots);
+        free(job.values);
+        free(job.value_numeric);
+        free((void *)job.validity);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    DataframeErrorCode err =
+        validate_columns(df, keys, key_count, aggregates, aggregate_count, &job, value_slots);
+
+    size_t tasks = 0;
+    if (err == DATAFRAME_SUCCESS) {
+        for (int k = 0; k < key_count; k++) {
+            job.validity[k] = dataframe_column_validity(df, keys[k], NULL);
+        }
+        for (int v = 0; v < job.value_count; v++) {
+            job.validity[key_count + v] = dataframe_column_validity(df, job.values[v], NULL);
+        }
+
+        const size_t threads =
+            (size_t)(num_threads > 0 ? num_threads : parallel_hardware_threads());
+        tasks = (job.rows + GROUPBY_CHUNK_ROWS - 1) / GROUPBY_CHUNK_ROWS;
+        if (tasks > threads)
+            tasks = threads;
+        if (tasks == 0)
+            tasks = 1;
+        job.chunk_rows = (job.rows + tasks - 1) / tasks;
+        job.partials = calloc(tasks, sizeof(GroupTable));
+        if (!job.partials)
+            err = DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    if (err == DATAFRAME_SUCCESS) {
+        parallel_for(tasks, num_threads, aggregate_chunk_task, &job);
+
+        /* Partial tables are folded into the first one in row order */
+        for (size_t t = 0; t < tasks && err == DATAFRAME_SUCCESS; t++) {
+            if (job.partials[t].failed)
+                err = DATAFRAME_ERR_ALLOCATION_FAILED;
+            else if (t > 0 && !table_merge(&job.partials[0], &job.partials[t], &job))
+                err = DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+    }
+
+    if (err == DATAFRAME_SUCCESS)
+        err = build_result(
+            &job, &job.partials[0], aggregates, aggregate_count, value_slots, out_df);
+
+    for (size_t t = 0; job.partials && t < tasks; t++) {
+        table_release(&job.partials[t]);
+    }
+    free(job.partials);
+    free(value_slots);
+    free(job.values);
+    free(job.value_numeric);
+    free((void *)job.validity);
+    return err;
+}
@@ -0,0 +1,984 @@
+#include "dataframe_join.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parallel.h"
+
+/**
+ * @brief Number of rows hashed or probed by one task.
+ */
+#define JOIN_CHUNK_ROWS 65536
+
+/**
+ * @brief Upper bound on the number of hash partitions the index is built in.
+ */
+#define JOIN_MAX_PARTITIONS 64
+
+/**
+ * @brief Number of keys, and half the number of hash slots, reserved by a new partition.
+ */
+#define JOIN_INITIAL_GROUPS 64
+
+/**
+ * @brief How the values of a key column are compared.
+ */
+typedef enum {
+    KEY_NUMBER,  /*!< TYPE_NUMERIC: compared as doubles. */
+    KEY_INTEGER, /*!< Int64-backed types: compared as integers. */
+    KEY_TEXT     /*!< TYPE_STRING and TYPE_CATEGORY: compared by their text. */
+} KeyKind;
+
+/**
+ * @brief The key columns of one side of a join.
+ */
+typedef struct {
+    const DataFrame *df;       /*!< The frame. */
+    const int *cols;           /*!< The key columns. */
+    int count;                 /*!< Number of key columns. */
+    const uint64_t **validity; /*!< Validity bitmap of each key column, or NULL. */
+} KeySide;
+
+/**
+ * @brief An open-addressing table of the distinct keys of one hash partition.
+ */
+typedef struct {
+    int32_t *slots;    /*!< Local key index of each slot (-1 marks an empty slot). */
+    size_t slot_count; /*!< Number of slots (a power of two). */
+    uint64_t *hashes;  /*!< Hash of each key. */
+    int *first_rows;   /*!< First row holding each key. */
+    size_t count;      /*!< Number of keys. */
+    size_t capacity;   /*!< Number of keys the arrays can hold. */
+    bool failed;       /*!< Whether an allocation failed while filling the table. */
+} KeyPartition;
+
+/**
+ * @brief The rows of a frame listed by distinct key.
+ *
+ * The rows of key g are group_rows[group_start[g]] .. group_rows[group_start[g + 1] - 1],
+ * in ascending order.
+ */
+typedef struct {
+    KeySide side;           /*!< The indexed key columns. */
+    int time_col;           /*!< Column whose missing values also exclude a row, or -1. */
+    size_t rows;            /*!< Number of rows of the frame. */
+    size_t chunk_count;     /*!< Number of JOIN_CHUNK_ROWS chunks of rows. */
+    uint64_t *row_hashes;   /*!< Key hash of each row. */
+    uint8_t *row_usable;    /*!< Whether each row has every key value (and a time). */
+    int32_t *row_groups;    /*!< Key index of each usable row. */
+    size_t *chunk_counts;   /*!< Usable rows per chunk and partition, then scatter offsets. */
+    int *part_rows;         /*!< Usable rows grouped by partition, ascending within each. */
+    size_t *part_start;     /*!< First entry of part_rows of each partition (part_count + 1). */
+    KeyPartition *parts;    /*!< The table of each partition. */
+    size_t part_count;      /*!< Number of partitions (a power of two). */
+    unsigned part_shift;    /*!< Shift moving a hash's top bits to its partition. */
+    size_t *part_first;     /*!< Global index of the first key of each partition. */
+    size_t group_count;     /*!< Number of distinct keys. */
+    int *group_start;       /*!< First entry of group_rows of each key (group_count + 1). */
+    int *group_rows;        /*!< Usable rows grouped by key. */
+} KeyIndex;
+
+/**
+ * @brief Returns how the values of a column type are compared as keys.
+ * @param type The column type.
+ * @return The key kind.
+ */
+static KeyKind key_kind(const DataType type)
+{
+    if (type == TYPE_NUMERIC)
+        return KEY_NUMBER;
+    if (type == TYPE_STRING || type == TYPE_CATEGORY)
+        return KEY_TEXT;
+    return KEY_INTEGER;
+}
+
+/**
+ * @brief Mixes one more word into a running key hash.
+ * @param hash The hash so far.
+ * @param word The word to mix in.
+ * @return The new hash.
+ */
+static uint64_t mix_hash(uint64_t hash, const uint64_t word)
+{
+    hash ^= word + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    hash ^= hash >> 31;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    return hash ^ hash >> 29;
+}
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a string.
+ * @param text The null-terminated string.
+ * @return The hash value.
+ */
+static uint64_t hash_text(const char *text)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (; *text; text++) {
+        hash ^= (unsigned char)*text;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Checks whether a cell is missing, using the column's bitmap when there is one.
+ * @param df Pointer to the DataFrame.
+ * @param validity The column's validity bitmap, or NULL.
+ * @param row The row.
+ * @param col The column.
+ * @return true if the cell is missing.
+ */
+static bool
+cell_is_missing(const DataFrame *df, const uint64_t *validity, const int row, const int col)
+{
+    if (validity)
+        return !(validity[row / 64] >> (row % 64) & 1u);
+    /* With validity tracking, a column without a bitmap has no missing values */
+    return !df->validity && dataframe_cell_is_null(df, row, col);
+}
+
+/**
+ * @brief Hashes the key of a row.
+ *
+ * Numbers hash by value (0.0 and -0.0 alike) and text by its characters, so
+ * that equal keys of two frames hash alike whatever their column types.
+ *
+ * @param side The key columns.
+ * @param row The row.
+ * @param out_hash Receives the hash.
+ * @return false if a key value is missing or NaN.
+ */
+static bool row_key_hash(const KeySide *side, const int row, uint64_t *out_hash)
+{
+    uint64_t hash = 0;
+    for (int k = 0; k < side->count; k++) {
+        const int col = side->cols[k];
+        if (cell_is_missing(side->df, side->validity[k], row, col))
+            return false;
+
+        const DataCell cell = dataframe_get_cell(side->df, row, col);
+        uint64_t word;
+        switch (key_kind(side->df->col_types[col])) {
+        case KEY_NUMBER: {
+            /* NaN equals nothing, not even itself, so it cannot match either */
+            if (isnan(cell.v_num))
+                return false;
+            const double value = cell.v_num == 0.0 ? 0.0 : cell.v_num;
+            memcpy(&word, &value, sizeof(word));
+            break;
+        }
+        case KEY_TEXT:
+            word = hash_text(dataframe_get_string(side->df, row, col));
+            break;
+        default:
+            word = (uint64_t)cell.v_int;
+            break;
+        }
+        hash = mix_hash(hash, word);
+    }
+    *out_hash = hash;
+    return true;
+}
+
+/**
+ * @brief Checks whether the keys of two rows, possibly of different frames, are equal.
+ * @param a The key columns of the first row.
+ * @param row_a The first row.
+ * @param b The key columns of the second row (of the same kinds as a's).
+ * @param row_b The second row.
+ * @return true if every key value is equal.
+ */
+static bool keys_equal(const KeySide *a, const int row_a, const KeySide *b, const int row_b)
+{
+    for (int k = 0; k < a->count; k++) {
+        const int col_a = a->cols[k];
+        const int col_b = b->cols[k];
+
+        switch (key_kind(a->df->col_types[col_a])) {
+        case KEY_NUMBER:
+            if (dataframe_get_cell(a->df, row_a, col_a).v_num !=
+                dataframe_get_cell(b->df, row_b, col_b).v_num)
+                return false;
+            break;
+        case KEY_TEXT:
+            if (strcmp(dataframe_get_string(a->df, row_a, col_a),
+                       dataframe_get_string(b->df, row_b, col_b)) != 0)
+                return false;
+            break;
+        default:
+            if (dataframe_get_cell(a->df, row_a, col_a).v_int !=
+                dataframe_get_cell(b->df, row_b, col_b).v_int)
+                return false;
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks the key columns of both sides and prepares their descriptions.
+ * @param left The left key columns (its df, cols and count set; validity receives the bitmaps).
+ * @param right The right key columns (likewise).
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_NOT_FOUND, DATAFRAME_ERR_COLUMN_MISMATCH or
+ * DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode prepare_keys(KeySide *left, KeySide *right)
+{
+    KeySide *sides[] = {left, right};
+    for (int s = 0; s < 2; s++) {
+        for (int k = 0; k < sides[s]->count; k++) {
+            if (sides[s]->cols[k] < 0 || sides[s]->cols[k] >= sides[s]->df->cols)
+                return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+        }
+    }
+    for (int k = 0; k < left->count; k++) {
+        if (key_kind(left->df->col_types[left->cols[k]]) !=
+            key_kind(right->df->col_types[right->cols[k]]))
+            return DATAFRAME_ERR_COLUMN_MISMATCH;
+    }
+
+    for (int s = 0; s < 2; s++) {
+        const uint64_t **validity = malloc(((size_t)sides[s]->count + 1) * sizeof(uint64_t *));
+        if (!validity)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        for (int k = 0; k < sides[s]->count; k++) {
+            validity[k] = dataframe_column_validity(sides[s]->df, sides[s]->cols[k], NULL);
+        }
+        sides[s]->validity = validity;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Returns the hash partition of a key hash.
+ * @param index The index.
+ * @param hash The key hash.
+ * @return The partition, taken from the hash's top bits.
+ */
+static size_t partition_of(const KeyIndex *index, const uint64_t hash)
+{
+    return index->part_count > 1 ? (size_t)(hash >> index->part_shift) : 0;
+}
+
+/**
+ * @brief Task hashing one chunk of rows and counting them per partition.
+ * @param context The KeyIndex.
+ * @param chunk The chunk index.
+ */
+static void hash_rows_task(void *context, const size_t chunk)
+{
+    KeyIndex *index = context;
+    const DataFrame *df = index->side.df;
+    const uint64_t *time_validity = NULL;
+    if (index->time_col >= 0)
+        time_validity = dataframe_column_validity(df, index->time_col, NULL);
+
+    size_t *counts = &index->chunk_counts[chunk * index->part_count];
+    const size_t begin = chunk * JOIN_CHUNK_ROWS;
+    const size_t remaining = index->rows - begin;
+    const size_t end = remaining < JOIN_CHUNK_ROWS ? index->rows : begin + JOIN_CHUNK_ROWS;
+
+    for (size_t r = begin; r < end; r++) {
+        const int row = (int)r;
+        bool usable = row_key_hash(&index->side, row, &index->row_hashes[r]);
+        if (usable && index->time_col >= 0) {
+            /* NaN times cannot be ordered, so they are treated as missing */
+            usable = !cell_is_missing(df, time_validity, row, index->time_col) &&
+                     !(df->col_types[index->time_col] == TYPE_NUMERIC &&
+                       isnan(dataframe_get_cell(df, row, index->time_col).v_num));
+        }
+        index->row_usable[r] = usable;
+        if (usable)
+            counts[partition_of(index, index->row_hashes[r])]++;
+    }
+}
+
+/**
+ * @brief Task scattering one chunk of usable rows into the rows of their partitions.
+ * @param context The KeyIndex.
+ * @param chunk The chunk index.
+ */
+static void scatter_rows_task(void *context, const size_t chunk)
+{
+    KeyIndex *index = context;
+    size_t *offsets = &index->chunk_counts[chunk * index->part_count];
+    const size_t begin = chunk * JOIN_CHUNK_ROWS;
+    const size_t remaining = index->rows - begin;
+    const size_t end = remaining < JOIN_CHUNK_ROWS ? index->rows : begin + JOIN_CHUNK_ROWS;
+
+    for (size_t r = begin; r < end; r++) {
+        if (index->row_usable[r])
+            index->part_rows[offsets[partition_of(index, index->row_hashes[r])]++] = (int)r;
+    }
+}
+
+/**
+ * @brief Doubles the number of keys a partition can hold and rehashes its slots.
+ * @param part The partition (its count equals its capacity).
+ * @return true on success, false on allocation failure (the partition is left usable).
+ */
+static bool partition_grow(KeyPartition *part)
+{
+    const size_t capacity = part->capacity ? part->capacity * 2 : JOIN_INITIAL_GROUPS;
+
+    uint64_t *hashes = realloc(part->hashes, capacity * sizeof(uint64_t));
+    if (hashes)
+        part->hashes = hashes;
+    int *first_rows = realloc(part->first_rows, capacity * sizeof(int));
+    if (first_rows)
+        part->first_rows = first_rows;
+    int32_t *slots = malloc(2 * capacity * sizeof(int32_t));
+    if (!hashes || !first_rows || !slots) {
+        free(slots);
+        return false;
+    }
+
+    /* Keep the load factor at or below one half */
+    free(part->slots);
+    part->slots = slots;
+    part->slot_count = 2 * capacity;
+    part->capacity = capacity;
+    memset(slots, 0xFF, part->slot_count * sizeof(int32_t));
+    for (size_t g = 0; g < part->count; g++) {
+        size_t slot = part->hashes[g] & (part->slot_count - 1);
+        while (slots[slot] >= 0) {
+            slot = (slot + 1) & (part->slot_count - 1);
+        }
+        slots[slot] = (int32_t)g;
+    }
+    return true;
+}
+
+/**
+ * @brief Task inserting the keys of one partition's rows into the partition's table.
+ * @param context The KeyIndex.
+ * @param p The partition index.
+ */
+static void build_partition_task(void *context, const size_t p)
+{
+    KeyIndex *index = context;
+    KeyPartition *part = &index->parts[p];
+    if (!partition_grow(part)) {
+        part->failed = true;
+        return;
+    }
+
+    for (size_t i = index->part_start[p]; i < index->part_start[p + 1]; i++) {
+        const int row = index->part_rows[i];
+        const uint64_t hash = index->row_hashes[row];
+
+        size_t slot = hash & (part->slot_count - 1);
+        int32_t group = -1;
+        for (; part->slots[slot] >= 0; slot = (slot + 1) & (part->slot_count - 1)) {
+            const int32_t candidate = part->slots[slot];
+            if (part->hashes[candidate] == hash &&
+                keys_equal(&index->side, part->first_rows[candidate], &index->side, row)) {
+                group = candidate;
+                break;
+            }
+        }
+
+        if (group < 0) {
+            if (part->count == part->capacity) {
+                if (!partition_grow(part)) {
+                    part->failed = true;
+                    return;
+                }
+                /* The slots were rebuilt; find the free slot again */
+                slot = hash & (part->slot_count - 1);
+                while (part->slots[slot] >= 0) {
+                    slot = (slot + 1) & (part->slot_count - 1);
+                }
+            }
+            group = (int32_t)part->count++;
+            part->slots[slot] = group;
+            part->hashes[group] = hash;
+            part->first_rows[group] = row;
+        }
+        index->row_groups[row] = group;
+    }
+}
+
+/**
+ * @brief Releases the memory of an index.
+ * @param index The index.
+ */
+static void index_release(KeyIndex *index)
+{
+    for (size_t p = 0; index->parts && p < index->part_count; p++) {
+        free(index->parts[p].slots);
+        free(index->parts[p].hashes);
+        free(index->parts[p].first_rows);
+    }
+    free(index->parts);
+    free(index->row_hashes);
+    free(index->row_usable);
+    free(index->row_groups);
+    free(index->chunk_counts);
+    free(index->part_rows);
+    free(index->part_start);
+    free(index->part_first);
+    free(index->group_start);
+    free(index->group_rows);
+    free((void *)index->side.validity);
+    memset(index, 0, sizeof(KeyIndex));
+}
+
+/**
+ * @brief Indexes the rows of a frame by their key.
+ *
+ * Rows are hashed and counted per partition in parallel, scattered into their
+ * partitions, and each partition's keys are inserted into its own table by a
+ * separate task, so no table is shared between threads. The rows of every key
+ * are finally listed together with a counting sort.
+ *
+ * @param index Receives the index; side (with its validity) and time_col must be set.
+ * @param num_threads The maximum number of threads (0 selects the hardware thread count).
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode index_build(KeyIndex *index, const int num_threads)
+{
+    const size_t threads = (size_t)(num_threads > 0 ? num_threads : parallel_hardware_threads());
+    index->rows = (size_t)index->side.df->rows;
+    index->chunk_count = (index->rows + JOIN_CHUNK_ROWS - 1) / JOIN_CHUNK_ROWS;
+    index->part_count = 1;
+    index->part_shift = 64;
+    while (index->part_count < threads && index->part_count < JOIN_MAX_PARTITIONS) {
+        index->part_count *= 2;
+        index->part_shift--;
+    }
+
+    const size_t rows = index->rows ? index->rows : 1;
+    const size_t chunks = index->chunk_count ? index->chunk_count : 1;
+    index->row_hashes = malloc(rows * sizeof(uint64_t));
+    index->row_usable = malloc(rows);
+    index->row_groups = malloc(rows * sizeof(int32_t));
+    index->chunk_counts = calloc(chunks * index->part_count, sizeof(size_t));
+    index->part_rows = malloc(rows * sizeof(int));
+    index->part_start = malloc((index->part_count + 1) * sizeof(size_t));
+    index->parts = calloc(index->part_count, sizeof(KeyPartition));
+    if (!index->row_hashes || !index->row_usable || !index->row_groups || !index->chunk_counts ||
+        !index->part_rows || !index->part_start || !index->parts)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    parallel_for(index->chunk_count, num_threads, hash_rows_task, index);
+
+    /* Partition-major prefix sums: chunk c of partition p follows chunk c - 1 of p */
+    size_t offset = 0;
+    for (size_t p = 0; p < index->part_count; p++) {
+        index->part_start[p] = offset;
+        for (size_t c = 0; c < index->chunk_count; c++) {
+            size_t *count = &index->chunk_counts[c * index->part_count + p];
+            const size_t rows_here = *count;
+            *count = offset;
+            offset += rows_here;
+        }
+    }
+    index->part_start[index->part_count] = offset;
+
+    parallel_for(index->chunk_count, num_threads, scatter_rows_task, index);
+    parallel_for(index->part_count, num_threads, build_partition_task, index);
+
+    /* Number the keys globally, partition after partition */
+    index->part_first = malloc(index->part_count * sizeof(size_t));
+    if (!index->part_first)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    for (size_t p = 0; p < index->part_count; p++) {
+        if (index->parts[p].failed)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        index->part_first[p] = index->group_count;
+        index->group_count += index->parts[p].count;
+    }
+
+    index->group_start = calloc(index->group_count + 1, sizeof(int));
+    index->group_rows = malloc((offset ? offset : 1) * sizeof(int));
+    int *cursor = malloc((index->group_count + 1) * sizeof(int));
+    if (!index->group_start || !index->group_rows || !cursor) {
+        free(cursor);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    /* Counting sort of the usable rows by key; ascending row order is kept */
+    for (size_t r = 0; r < index->rows; r++) {
+        if (!index->row_usable[r])
+            continue;
+        const size_t p = partition_of(index, index->row_hashes[r]);
+        index->row_groups[r] += (int32_t)index->part_first[p];
+        index->group_start[index->row_groups[r] + 1]++;
+    }
+    for (size_t g = 0; g < index->group_count; g++) {
+        index->group_start[g + 1] += index->group_start[g];
+    }
+    memcpy(cursor, index->group_start, (index->group_count + 1) * sizeof(int));
+    for (size_t r = 0; r < index->rows; r++) {
+        if (index->row_usable[r])
+            index->group_rows[cursor[index->row_groups[r]]++] = (int)r;
+    }
+
+    free(cursor);
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Finds the key of another frame's row in an index.
+ * @param index The index.
+ * @param probe The key columns of the other frame.
+ * @param row The row of the other frame.
+ * @return The key index, or -1 if the row's key is missing or not indexed.
+ */
+static int32_t index_find(const KeyIndex *index, const KeySide *probe, const int row)
+{
+    uint64_t hash;
+    if (!row_key_hash(probe, row, &hash))
+        return -1;
+
+    const size_t p = partition_of(index, hash);
+    const KeyPartition *part = &index->parts[p];
+
+    for (size_t slot = hash & (part->slot_count - 1); part->slots[slot] >= 0;
+         slot = (slot + 1) & (part->slot_count - 1)) {
+        const int32_t candidate = part->slots[slot];
+        if (part->hashes[candidate] == hash &&
+            keys_equal(&index->side, part->first_rows[candidate], probe, row))
+            return (int32_t)index->part_first[p] + candidate;
+    }
+    return -1;
+}
+
+/**
+ * @brief Shared state of probing the left rows of a hash join against the right index.
+ */
+typedef struct {
+    const KeyIndex *index;   /*!< The index of the right rows. */
+    KeySide left;            /*!< The left key columns. */
+    DataFrameJoinType type;  /*!< The join type. */
+    size_t rows;             /*!< Number of left rows. */
+    int32_t *left_groups;    /*!< Matching key of each left row, or -1. */
+    size_t *chunk_pairs;     /*!< Pairs emitted per chunk, then each chunk's first pair. */
+    int *out_left;           /*!< Receives the left row of each pair. */
+    int *out_right;          /*!< Receives the right row of each pair. */
+} ProbeJob;
+
+/**
+ * @brief Task looking up one chunk of left rows and counting their pairs.
+ * @param context The ProbeJob.
+ * @param chunk The chunk index.
+ */
+static void probe_count_task(void *context, const size_t chunk)
+{
+    ProbeJob *job = context;
+    const size_t begin = chunk * JOIN_CHUNK_ROWS;
+    const size_t end = job->rows - begin < JOIN_CHUNK_ROWS ? job->rows : begin + JOIN_CHUNK_ROWS;
+    size_t pairs = 0;
+
+    for (size_t r = begin; r < end; r++) {
+        const int32_t group = index_find(job->index, &job->left, (int)r);
+        job->left_groups[r] = group;
+        if (group >= 0)
+            pairs += (size_t)(job->index->group_start[group + 1] - job->index->group_start[group]);
+        else if (job->type == DATAFRAME_JOIN_LEFT)
+            pairs++;
+    }
+    job->chunk_pairs[chunk] = pairs;
+}
+
+/**
+ * @brief Task writing the pairs of one chunk of left rows.
+ * @param context The ProbeJob.
+ * @param chunk The chunk index.
+ */
+static void probe_emit_task(void *context, const size_t chunk)
+{
+    const ProbeJob *job = context;
+    const size_t begin = chunk * JOIN_CHUNK_ROWS;
+    const size_t end = job->rows - begin < JOIN_CHUNK_ROWS ? job->rows : begin + JOIN_CHUNK_ROWS;
+    size_t out = job->chunk_pairs[chunk];
+
+    for (size_t r = begin; r < end; r++) {
+        const int32_t group = job->left_groups[r];
+        if (group < 0) {
+            if (job->type == DATAFRAME_JOIN_LEFT) {
+                job->out_left[out] = (int)r;
+                job->out_right[out++] = -1;
+            }
+            continue;
+        }
+        for (int i = job->index->group_start[group]; i < job->index->group_start[group + 1]; i++) {
+            job->out_left[out] = (int)r;
+            job->out_right[out++] = job->index->group_rows[i];
+        }
+    }
+}
+
+DataframeErrorCode dataframe_hash_join_indices(const DataFrame *left,
+                                               const int *left_keys,
+                                               const DataFrame *right,
+                                               const int *right_keys,
+                                               const int key_count,
+                                               const DataFrameJoinType type,
+                                               const int num_threads,
+                                               int **out_left_rows,
+                                               int **out_right_rows,
+                                               size_t *out_count)
+{
+    if (!out_left_rows || !out_right_rows || !out_count)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_left_rows = NULL;
+    *out_right_rows = NULL;
+    *out_count = 0;
+    if (!left || !right)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (!left_keys || !right_keys || key_count <= 0)
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+
+    ProbeJob job = {0};
+    KeyIndex index = {0};
+    job.left = (KeySide){left, left_keys, key_count, NULL};
+    index.side = (KeySide){right, right_keys, key_count, NULL};
+    index.time_col = -1;
+
+    DataframeErrorCode err = prepare_keys(&job.left, &index.side);
+    if (err == DATAFRAME_SUCCESS)
+        err = index_build(&index, num_threads);
+
+    const size_t chunks = ((size_t)left->rows + JOIN_CHUNK_ROWS - 1) / JOIN_CHUNK_ROWS;
+    if (err == DATAFRAME_SUCCESS) {
+        job.index = &index;
+        job.type = type;
+        job.rows = (size_t)left->rows;
+        job.left_groups = malloc((job.rows ? job.rows : 1) * sizeof(int32_t));
+        job.chunk_pairs = malloc((chunks ? chunks : 1) * sizeof(size_t));
+        if (!job.left_groups || !job.chunk_pairs)
+            err = DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    size_t pairs = 0;
+    if (err == DATAFRAME_SUCCESS) {
+        parallel_for(chunks, num_threads, probe_count_task, &job);
+        for (size_t c = 0; c < chunks; c++) {
+            const size_t count = job.chunk_pairs[c];
+            job.chunk_pairs[c] = pairs;
+            pairs += count;
+        }
+        job.out_left = malloc((pairs ? pairs : 1) * sizeof(int));
+        job.out_right = malloc((pairs ? pairs : 1) * sizeof(int));
+        if (!job.out_left || !job.out_right)
+            err = DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    if (err == DATAFRAME_SUCCESS) {
+        parallel_for(chunks, num_threads, probe_emit_task, &job);
+        *out_left_rows = job.out_left;
+        *out_right_rows = job.out_right;
+        *out_count = pairs;
+    } else {
+        free(job.out_left);
+        free(job.out_right);
+    }
+
+    free(job.left_groups);
+    free(job.chunk_pairs);
+    free((void *)job.left.validity);
+    index_release(&index);
+    return err;
+}
+
+/**
+ * @brief Builds the result of a join from its row pairs.
+ * @param left The left DataFrame.
+ * @param left_rows The left row of each output row.
+ * @param right The right DataFrame.
+ * @param right_rows The right row of each output row (negative for none).
+ * @param count The number of output rows.
+ * @param skipped The right columns left out of the result.
+ * @param skipped_count The number of entries in skipped.
+ * @param out_df Receives the result.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED, also when the result would have
+ * more rows than a DataFrame can hold.
+ */
+static DataframeErrorCode build_joined_frame(const DataFrame *left,
+                                             const int *left_rows,
+                                             const DataFrame *right,
+                                             const int *right_rows,
+                                             const size_t count,
+                                             const int *skipped,
+                                             const int skipped_count,
+                                             DataFrame **out_df)
+{
+    if (count > INT_MAX)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    int *cols = malloc(((size_t)left->cols + (size_t)right->cols + 1) * sizeof(int));
+    if (!cols)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    int right_count = 0;
+    int *right_cols = cols + left->cols;
+    for (int c = 0; c < left->cols; c++) {
+        cols[c] = c;
+    }
+    for (int c = 0; c < right->cols; c++) {
+        int s = 0;
+        while (s < skipped_count && skipped[s] != c) {
+            s++;
+        }
+        if (s == skipped_count)
+            right_cols[right_count++] = c;
+    }
+
+    const size_t out_cols = (size_t)left->cols + (size_t)right_count;
+    DataFrame *out =
+        create_dataframe_with_layout(count ? count : 1, out_cols, DATAFRAME_LAYOUT_COLUMNS);
+    DataframeErrorCode err = DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (out && dataframe_enable_validity(out) == DATAFRAME_SUCCESS)
+        err = dataframe_gather_rows(out, 0, left, cols, left->cols, left_rows, count);
+    if (err == DATAFRAME_SUCCESS)
+        err = dataframe_gather_rows(
+            out, left->cols, right, right_cols, right_count, right_rows, count);
+
+    for (int c = 0; err == DATAFRAME_SUCCESS && c < (int)out_cols; c++) {
+        const bool from_left = c < left->cols;
+        const char *name =
+            from_left ? left->columns[c] : right->columns[right_cols[c - left->cols]];
+        char buffer[256];
+        if (!name)
+            name = "";
+        if (!from_left && dataframe_col_index(left, name) >= 0) {
+            snprintf(buffer, sizeof(buffer), "%s_right", name);
+            name = buffer;
+        }
+        out->columns[c] = strdup(name);
+        if (!out->columns[c])
+            err = DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    if (err == DATAFRAME_SUCCESS)
+        err = dataframe_index_columns(out);
+
+    free(cols);
+    if (err != DATAFRAME_SUCCESS) {
+        free_dataframe(out);
+        return err;
+    }
+    *out_df = out;
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode dataframe_hash_join(const DataFrame *left,
+                                       const int *left_keys,
+                                       const DataFrame *right,
+                                       const int *right_keys,
+                                       const int key_count,
+                                       const DataFrameJoinType type,
+                                       const int num_threads,
+                                       DataFrame **out_df)
+{
+    if (!out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+
+    int *left_rows = NULL;
+    int *right_rows = NULL;
+    size_t count = 0;
+    DataframeErrorCode err = dataframe_hash_join_indices(left,
+                                                         left_keys,
+                                                         right,
+                                                         right_keys,
+                                                         key_count,
+                                                         type,
+                                                         num_threads,
+                                                         &left_rows,
+                                                         &right_rows,
+                                                         &count);
+    if (err == DATAFRAME_SUCCESS)
+        err = build_joined_frame(
+            left, left_rows, right, right_rows, count, right_keys, key_count, out_df);
+
+    free(left_rows);
+    free(right_rows);
+    return err;
+}
+
+/**
+ * @brief Shared state of looking up the left rows of an as-of join.
+ */
+typedef struct {
+    const KeyIndex *index; /*!< The index of the right rows by their by columns. */
+    KeySide left;          /*!< The left by columns. */
+    int left_on;           /*!< The left time column. */
+    int right_on;          /*!< The right time column. */
+    bool numeric;          /*!< Whether the times are doubles rather than integers. */
+    int *out_right;        /*!< Receives the matching right row of each left row. */
+} AsofJob;
+
+/**
+ * @brief Checks whether the right time of a row is at or before a left time.
+ * @param job The as-of join state.
+ * @param row The right row.
+ * @param cell The left time.
+ * @return true if the right row's time is not later than the left time.
+ */
+static bool right_not_later(const AsofJob *job, const int row, const DataCell cell)
+{
+    const DataCell time = dataframe_get_cell(job->index->side.df, row, job->right_on);
+    return job->numeric ? time.v_num <= cell.v_num : time.v_int <= cell.v_int;
+}
+
+/**
+ * @brief Task matching one chunk of left rows of an as-of join.
+ * @param context The AsofJob.
+ * @param chunk The chunk index.
+ */
+static void asof_lookup_task(void *context, const size_t chunk)
+{
+    const AsofJob *job = context;
+    const DataFrame *left = job->left.df;
+    const uint64_t *time_validity = dataframe_column_validity(left, job->left_on, NULL);
+    const size_t rows = (size_t)left->rows;
+    const size_t begin = chunk * JOIN_CHUNK_ROWS;
+    const size_t end = rows - begin < JOIN_CHUNK_ROWS ? rows : begin + JOIN_CHUNK_ROWS;
+
+    for (size_t r = begin; r < end; r++) {
+        const int row = (int)r;
+        job->out_right[r] = -1;
+        const DataCell time = dataframe_get_cell(left, row, job->left_on);
+        if (cell_is_missing(left, time_validity, row, job->left_on) ||
+            (job->numeric && isnan(time.v_num)))
+            continue;
+        const int32_t group = index_find(job->index, &job->left, row);
+        if (group < 0)
+            continue;
+
+        /* The first entry of the group whose time is later than the left time */
+        int low = job->index->group_start[group];
+        int high = job->index->group_start[group + 1];
+        while (low < high) {
+            const int mid = low + (high - low) / 2;
+            if (right_not_later(job, job->index->group_rows[mid], time))
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        if (low > job->index->group_start[group])
+            job->out_right[r] = job->index->group_rows[low - 1];
+    }
+}
+
+/**
+ * @brief Checks that the right times of every by group are in ascending order.
+ * @param index The index of the right rows.
+ * @param col The right time column.
+ * @param numeric Whether the times are doubles.
+ * @return true if no group has a time earlier than its predecessor.
+ */
+static bool groups_are_sorted(const KeyIndex *index, const int col, const bool numeric)
+{
+    for (size_t g = 0; g < index->group_count; g++) {
+        for (int i = index->group_start[g] + 1; i < index->group_start[g + 1]; i++) {
+            const DataCell prev = dataframe_get_cell(index->side.df, index->group_rows[i - 1], col);
+            const DataCell next = dataframe_get_cell(index->side.df, index->group_rows[i], col);
+            if (numeric ? next.v_num < prev.v_num : next.v_int < prev.v_int)
+                return false;
+        }
+    }
+    return true;
+}
+
+DataframeErrorCode dataframe_asof_join_indices(const DataFrame *left,
+                                               const int left_on,
+                                               const DataFrame *right,
+                                               const int right_on,
+                                               const int *left_by,
+                                               const int *right_by,
+                                               const int by_count,
+                                               const int num_threads,
+                                               int *out_right_rows)
+{
+    if (!left || !right || !out_right_rows)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (by_count < 0 || (by_count > 0 && (!left_by || !right_by)) || left_on < 0 ||
+        left_on >= left->cols || right_on < 0 || right_on >= right->cols)
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+
+    const KeyKind time_kind = key_kind(left->col_types[left_on]);
+    if (time_kind == KEY_TEXT || time_kind != key_kind(right->col_types[right_on]))
+        return DATAFRAME_ERR_COLUMN_MISMATCH;
+
+    AsofJob job = {0};
+    KeyIndex index = {0};
+    job.left = (KeySide){left, left_by, by_count, NULL};
+    job.left_on = left_on;
+    job.right_on = right_on;
+    job.numeric = time_kind == KEY_NUMBER;
+    job.out_right = out_right_rows;
+    index.side = (KeySide){right, right_by, by_count, NULL};
+    index.time_col = right_on;
+
+    DataframeErrorCode err = prepare_keys(&job.left, &index.side);
+    if (err == DATAFRAME_SUCCESS)
+        err = index_build(&index, num_threads);
+    if (err == DATAFRAME_SUCCESS && !groups_are_sorted(&index, right_on, job.numeric))
+        err = DATAFRAME_ERR_INVALID_FORMAT;
+
+    if (err == DATAFRAME_SUCCESS) {
+        job.index = &index;
+        const size_t chunks = ((size_t)left->rows + JOIN_CHUNK_ROWS - 1) / JOIN_CHUNK_ROWS;
+        parallel_for(chunks, num_threads, asof_lookup_task, &job);
+    }
+
+    free((void *)job.left.validity);
+    index_release(&index);
+    return err;
+}
+
+DataframeErrorCode dataframe_asof_join(const DataFrame *left,
+                                       const int left_on,
+                                       const DataFrame *right,
+                                       const int right_on,
+                                       const int *left_by,
+                                       const int *right_by,
+                                       const int by_count,
+                                       const int num_threads,
+                                       DataFrame **out_df)
+{
+    if (!out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+    if (!left || !right)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    const size_t rows = left->rows > 0 ? (size_t)left->rows : 1;
+    int *left_rows = malloc(rows * sizeof(int));
+    int *right_rows = malloc(rows * sizeof(int));
+    int *skipped = malloc(((by_count > 0 ? (size_t)by_count : 0) + 1) * sizeof(int));
+    DataframeErrorCode err = DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (left_rows && right_rows && skipped)
+        err = dataframe_asof_join_indices(
+            left, left_on, right, right_on, left_by, right_by, by_count, num_threads, right_rows);
+
+    if (err == DATAFRAME_SUCCESS) {
+        for (int r = 0; r < left->rows; r++) {
+            left_rows[r] = r;
+        }
+        skipped[0] = right_on;
+        for (int k = 0; k < by_count; k++) {
+            skipped[k + 1] = right_by[k];
+        }
+        err = build_joined_frame(left,
+                                 left_rows,
+                                 right,
+                                 right_rows,
+                                 (size_t)left->rows,
+                                 skipped,
+                                 by_count + 1,
+                                 out_df);
+    }
+
+    free(left_rows);
+    free(right_rows);
+    free(skipped);
+    return err;
+}
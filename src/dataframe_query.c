@@ -0,0 +1,1219 @@
+#include "dataframe_query.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "statistics.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Number of bitmap words covering one morsel.
+ */
+#define QUERY_MORSEL_WORDS (QUERY_MORSEL_ROWS / 64)
+
+/**
+ * @brief Labels of the trading signals, in the order of the Signal codes.
+ */
+static const char *const SIGNAL_LABELS[] = {"HOLD", "BUY", "SELL"};
+
+/**
+ * @brief A trading signal, indexing SIGNAL_LABELS.
+ */
+typedef enum { SIGNAL_HOLD, SIGNAL_BUY, SIGNAL_SELL } Signal;
+
+/**
+ * @brief What a recorded step does.
+ */
+typedef enum {
+    QUERY_STEP_FILTER, /*!< Narrows the rows alive. */
+    QUERY_STEP_SMA,    /*!< Computes a Simple Moving Average. */
+    QUERY_STEP_EMA,    /*!< Computes an Exponential Moving Average. */
+    QUERY_STEP_SIGNALS /*!< Computes crossover signals. */
+} QueryStepKind;
+
+/**
+ * @brief A column read by a step: one of the scan or one computed by an earlier step.
+ */
+typedef struct {
+    bool computed; /*!< Whether index refers to the computed columns rather than the scan's. */
+    int index;     /*!< The column of the scan, or of the computed columns. */
+} QueryColumn;
+
+/**
+ * @brief One recorded step of a query.
+ */
+typedef struct {
+    QueryStepKind kind;          /*!< What the step does. */
+    FilterCondition *conditions; /*!< Filter: conditions on scanned columns, then on computed. */
+    size_t scan_count;           /*!< Filter: number of conditions on scanned columns. */
+    size_t computed_count;       /*!< Filter: number of conditions on computed columns. */
+    QueryColumn input;           /*!< The averaged column, or the price column of signals. */
+    QueryColumn average;         /*!< Signals: the moving average column. */
+    int period;                  /*!< Moving averages: the period. */
+    int output;                  /*!< The computed column written by the step. */
+} QueryStep;
+
+struct DataFrameQuery {
+    DataFrame *df;            /*!< Scanned frame (frame scans), holding a reference, else NULL. */
+    char *path;               /*!< Scanned file (CSV scans), else NULL. */
+    CsvReadOptions options;   /*!< Options of a CSV scan. */
+    CsvStream *schema_stream; /*!< Stream whose first batch describes a CSV scan's columns. */
+    const DataFrame *schema;  /*!< Frame giving the names and types of the scanned columns. */
+    QueryStep *steps;         /*!< The recorded steps, in execution order. */
+    size_t step_count;        /*!< Number of steps. */
+    size_t step_capacity;     /*!< Number of steps allocated. */
+    char **computed_names;    /*!< Names of the computed columns. */
+    DataType *computed_types; /*!< Types of the computed columns. */
+    int computed_count;       /*!< Number of computed columns. */
+    int computed_capacity;    /*!< Number of computed columns allocated. */
+    QueryColumn *selected;    /*!< Columns returned by dataframe_query_collect, or NULL for all. */
+    int selected_count;       /*!< Number of selected columns. */
+};
+
+/**
+ * @brief Execution state of one step, carried from one morsel to the next.
+ */
+typedef struct {
+    FilterTerm *scan_terms;     /*!< Filter: compiled conditions on scanned columns, or NULL. */
+    FilterTerm *computed_terms; /*!< Filter: compiled conditions on computed columns, or NULL. */
+    bool pushed;                /*!< Filter: whether the CSV reader checks the scanned ones. */
+    double *window;             /*!< SMA: the last period values, as a ring. */
+    uint8_t *window_valid;      /*!< SMA: whether each value of window is present. */
+    size_t position;            /*!< SMA: slot of window receiving the next value. */
+    size_t seen;                /*!< SMA: number of rows pushed so far. */
+    size_t null_count;          /*!< SMA: number of missing values in window. */
+    double sum;                 /*!< Running sum of the SMA window or of the EMA seed. */
+    size_t streak;              /*!< EMA: number of consecutive present values, up to period. */
+    double ema;                 /*!< EMA: the current average. */
+    double previous_price;      /*!< Signals: price of the previous row (NAN if missing). */
+    double previous_average;    /*!< Signals: average of the previous row (NAN if missing). */
+    int32_t codes[3];           /*!< Signals: dictionary code of each Signal in the morsel. */
+} QueryStepState;
+
+/**
+ * @brief State of one execution of a query.
+ */
+typedef struct {
+    const DataFrameQuery *query; /*!< The query executed. */
+    QueryStepState *states;      /*!< One state per step. */
+    DataFrame *morsel;           /*!< Computed columns of the current morsel (NULL without any). */
+} QueryRun;
+
+/**
+ * @brief Receives the rows of a morsel that survived every step.
+ * @param context The terminal operation's state.
+ * @param run The execution, whose morsel frame holds the computed columns.
+ * @param block The frame holding the scanned columns.
+ * @param first The row of block at morsel position 0.
+ * @param count The number of rows in the morsel.
+ * @param alive Bitmap of the surviving morsel positions.
+ * @return DATAFRAME_SUCCESS, or an error code that stops the execution.
+ */
+typedef DataframeErrorCode (*QueryConsumer)(void *context,
+                                            const QueryRun *run,
+                                            const DataFrame *block,
+                                            size_t first,
+                                            size_t count,
+                                            const uint64_t *alive);
+
+/**
+ * @brief Reads the values of one column over one morsel as doubles.
+ */
+typedef struct {
+    const DataFrame *df;      /*!< The scanned block or the morsel frame. */
+    int col;                  /*!< The column of df. */
+    size_t first;             /*!< Row of df at morsel position 0. */
+    const double *numbers;    /*!< Contiguous values of a columnar numeric column, else NULL. */
+    const uint64_t *validity; /*!< The column's validity bitmap, or NULL. */
+    bool tracked;             /*!< Whether df tracks validity (otherwise sentinels count). */
+    bool integer;             /*!< Whether the column is int64-backed. */
+} QueryReader;
+
+/**
+ * @brief Running aggregates of one column over the surviving rows.
+ */
+typedef struct {
+    RunningStatistics stats; /*!< Count, mean and M2 of the non-missing values. */
+    double sum;              /*!< Sum of the non-missing values. */
+    double min;              /*!< Smallest value (+INFINITY while there is none). */
+    double max;              /*!< Largest value (-INFINITY while there is none). */
+} QueryAccumulator;
+
+/**
+ * @brief State of dataframe_query_aggregate.
+ */
+typedef struct {
+    const QueryAggregate *aggregates; /*!< The output aggregates. */
+    const QueryColumn *columns;       /*!< The column of each aggregate. */
+    QueryAccumulator *accs;           /*!< The accumulator of each aggregate. */
+    int count;                        /*!< Number of aggregates. */
+} AggregateJob;
+
+/**
+ * @brief State of dataframe_query_collect.
+ */
+typedef struct {
+    DataFrame *out;  /*!< The result. */
+    DataFrame *part; /*!< Rows of the current morsel, moved to out once gathered. */
+    int *rows;       /*!< Row of the scanned block of each surviving row. */
+    int *positions;  /*!< Morsel position of each surviving row. */
+} CollectJob;
+
+/**
+ * @brief Returns the index of the lowest set bit of a non-zero 64-bit value.
+ * @param bits The value to inspect (must not be zero).
+ * @return The zero-based position of the least significant set bit.
+ */
+static inline unsigned trailing_zeros64(const uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(bits);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (unsigned)index;
+#else
+    unsigned index = 0;
+    while (!((bits >> index) & 1u))
+        index++;
+    return index;
+#endif
+}
+
+/**
+ * @brief Looks up a scanned or computed column by name.
+ * @param query The query.
+ * @param name The column name.
+ * @param out_column Receives the column.
+ * @return true if the column exists.
+ */
+static bool resolve_column(const DataFrameQuery *query, const char *name, QueryColumn *out_column)
+{
+    if (!name)
+        return false;
+    for (int c = 0; c < query->computed_count; c++) {
+        if (strcmp(query->computed_names[c], name) == 0) {
+            out_column->computed = true;
+            out_column->index = c;
+            return true;
+        }
+    }
+    const int col = dataframe_col_index(query->schema, name);
+    out_column->computed = false;
+    out_column->index = col;
+    return col >= 0;
+}
+
+/**
+ * @brief Returns the type of a scanned or computed column.
+ * @param query The query.
+ * @param column The column.
+ * @return The column's type.
+ */
+static DataType column_type(const DataFrameQuery *query, const QueryColumn column)
+{
+    return column.computed ? query->computed_types[column.index]
+                           : query->schema->col_types[column.index];
+}
+
+/**
+ * @brief Looks up a column that must hold numbers.
+ * @param query The query.
+ * @param name The column name.
+ * @param out_column Receives the column.
+ * @return true if the column exists and is TYPE_NUMERIC or int64-backed.
+ */
+static bool resolve_numeric(const DataFrameQuery *query, const char *name, QueryColumn *out_column)
+{
+    if (!resolve_column(query, name, out_column))
+        return false;
+    const DataType type = column_type(query, *out_column);
+    return type == TYPE_NUMERIC || dataframe_type_is_int64(type);
+}
+
+/**
+ * @brief Appends a step to the plan.
+ * @param query The query.
+ * @param step The step (its conditions pass to the query).
+ * @return true on success, false on allocation failure.
+ */
+static bool append_step(DataFrameQuery *query, const QueryStep *step)
+{
+    if (query->step_count == query->step_capacity) {
+        const size_t capacity = query->step_capacity ? query->step_capacity * 2 : 8;
+        QueryStep *steps = realloc(query->steps, capacity * sizeof(QueryStep));
+        if (!steps)
+            return false;
+        query->steps = steps;
+        query->step_capacity = capacity;
+    }
+    query->steps[query->step_count++] = *step;
+    return true;
+}
+
+/**
+ * @brief Declares a new computed column and appends the step computing it.
+ * @param query The query.
+ * @param step The step, whose output is set to the new column.
+ * @param name The name of the column.
+ * @param type The type of the column.
+ * @return DATAFRAME_SUCCESS, DATAFRAME_ERR_COLUMN_MISMATCH if the name is taken, or
+ * DATAFRAME_ERR_ALLOCATION_FAILED (the plan is then unchanged).
+ */
+static DataframeErrorCode
+add_computed(DataFrameQuery *query, QueryStep *step, const char *name, const DataType type)
+{
+    QueryColumn existing;
+    if (resolve_column(query, name, &existing))
+        return DATAFRAME_ERR_COLUMN_MISMATCH;
+
+    if (query->computed_count == query->computed_capacity) {
+        const int capacity = query->computed_capacity ? query->computed_capacity * 2 : 8;
+        char **names = realloc(query->computed_names, (size_t)capacity * sizeof(char *));
+        if (!names)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        query->computed_names = names;
+        DataType *types = realloc(query->computed_types, (size_t)capacity * sizeof(DataType));
+        if (!types)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+        query->computed_types = types;
+        query->computed_capacity = capacity;
+    }
+
+    char *copy = strdup(name);
+    step->output = query->computed_count;
+    if (!copy || !append_step(query, step)) {
+        free(copy);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    query->computed_names[query->computed_count] = copy;
+    query->computed_types[query->computed_count] = type;
+    query->computed_count++;
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Records a moving average step.
+ * @param query The query.
+ * @param kind QUERY_STEP_SMA or QUERY_STEP_EMA.
+ * @param column The averaged column.
+ * @param period The period.
+ * @param name The output name, or NULL for the default.
+ * @param suffix The default name's suffix ("sma" or "ema").
+ * @return The codes of dataframe_query_sma.
+ */
+static DataframeErrorCode record_average(DataFrameQuery *query,
+                                         const QueryStepKind kind,
+                                         const char *column,
+                                         const int period,
+                                         const char *name,
+                                         const char *suffix)
+{
+    if (!query)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (period <= 0)
+        return DATAFRAME_ERR_INVALID_FORMAT;
+
+    QueryStep step = {.kind = kind, .period = period};
+    if (!resolve_numeric(query, column, &step.input))
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+
+    char default_name[256];
+    if (!name) {
+        snprintf(default_name, sizeof(default_name), "%s_%s%d", column, suffix, period);
+        name = default_name;
+    }
+    return add_computed(query, &step, name, TYPE_NUMERIC);
+}
+
+DataframeErrorCode dataframe_query_scan(DataFrame *df, DataFrameQuery **out_query)
+{
+    if (!df || !out_query)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_query = NULL;
+
+    DataFrameQuery *query = calloc(1, sizeof(DataFrameQuery));
+    if (!query)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    query->df = dataframe_retain(df);
+    query->schema = df;
+    *out_query = query;
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode dataframe_query_scan_csv(const char *path,
+                                            const CsvReadOptions *options,
+                                            DataFrameQuery **out_query)
+{
+    if (!path || !out_query)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_query = NULL;
+
+    DataFrameQuery *query = calloc(1, sizeof(DataFrameQuery));
+    if (!query)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    query->options = options ? *options : csv_default_read_options();
+    query->path = strdup(path);
+    if (!query->path) {
+        dataframe_query_free(query);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    /* Executions read the same batch size, so their types are inferred from the same sample */
+    DataFrame *batch = NULL;
+    DataframeErrorCode err = csv_stream_open(path, &query->options, &query->schema_stream);
+    if (err == DATAFRAME_SUCCESS)
+        err = csv_stream_next_batch(query->schema_stream, QUERY_MORSEL_ROWS, &batch);
+    if (err == DATAFRAME_SUCCESS && !batch)
+        err = DATAFRAME_ERR_EMPTY_FILE;
+    if (err != DATAFRAME_SUCCESS) {
+        dataframe_query_free(query);
+        return err;
+    }
+
+    query->schema = batch;
+    *out_query = query;
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode dataframe_query_filter(DataFrameQuery *query, const FilterPredicate *predicate)
+{
+    if (!query || !predicate || (predicate->count && !predicate->conditions))
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (predicate->count == 0)
+        return DATAFRAME_SUCCESS;
+
+    QueryStep step = {.kind = QUERY_STEP_FILTER};
+    step.conditions = malloc(predicate->count * sizeof(FilterCondition));
+    if (!step.conditions)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    /* Conditions on scanned columns go first: they can be checked before anything is computed */
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t i = 0; i < predicate->count; i++) {
+            QueryColumn column;
+            if (!resolve_column(query, predicate->conditions[i].column, &column)) {
+                free(step.conditions);
+                return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+            }
+            if (column.computed != (pass == 1))
+                continue;
+            step.conditions[step.scan_count + step.computed_count] = predicate->conditions[i];
+            if (column.computed)
+                step.computed_count++;
+            else
+                step.scan_count++;
+        }
+    }
+
+    if (!append_step(query, &step)) {
+        free(step.conditions);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode dataframe_query_sma(DataFrameQuery *query,
+                                       const char *column,
+                                       const int period,
+                                       const char *name)
+{
+    return record_average(query, QUERY_STEP_SMA, column, period, name, "sma");
+}
+
+DataframeErrorCode dataframe_query_ema(DataFrameQuery *query,
+                                       const char *column,
+                                       const int period,
+                                       const char *name)
+{
+    return record_average(query, QUERY_STEP_EMA, column, period, name, "ema");
+}
+
+DataframeErrorCode dataframe_query_signals(DataFrameQuery *query,
+                                           const char *price_column,
+                                           const char *average_column,
+                                           const char *name)
+{
+    if (!query)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    QueryStep step = {.kind = QUERY_STEP_SIGNALS};
+    if (!resolve_numeric(query, price_column, &step.input) ||
+        !resolve_numeric(query, average_column, &step.average))
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+    return add_computed(query, &step, name ? name : "signal", TYPE_CATEGORY);
+}
+
+DataframeErrorCode
+dataframe_query_select(DataFrameQuery *query, const char **columns, const int count)
+{
+    if (!query || !columns || count <= 0)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    QueryColumn *selected = malloc((size_t)count * sizeof(QueryColumn));
+    if (!selected)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    for (int c = 0; c < count; c++) {
+        if (!resolve_column(query, columns[c], &selected[c])) {
+            free(selected);
+            return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+        }
+    }
+
+    free(query->selected);
+    query->selected = selected;
+    query->selected_count = count;
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Binds a reader to a column for the current morsel.
+ * @param reader The reader.
+ * @param run The execution.
+ * @param column The column read.
+ * @param block The frame holding the scanned columns.
+ * @param first The row of block at morsel position 0.
+ */
+static void reader_bind(QueryReader *reader,
+                        const QueryRun *run,
+                        const QueryColumn column,
+                        const DataFrame *block,
+                        const size_t first)
+{
+    reader->df = column.computed ? run->morsel : block;
+    reader->col = column.index;
+    reader->first = column.computed ? 0 : first;
+    reader->numbers = dataframe_numeric_column(reader->df, reader->col);
+    reader->validity = dataframe_column_validity(reader->df, reader->col, NULL);
+    reader->tracked = reader->df->validity != NULL;
+    reader->integer = dataframe_type_is_int64(reader->df->col_types[reader->col]);
+}
+
+/**
+ * @brief Reads the value at one morsel position.
+ * @param reader The bound reader.
+ * @param i The morsel position.
+ * @param out_value Receives the value (left alone when missing).
+ * @return true if the value is present.
+ */
+static bool reader_value(const QueryReader *reader, const size_t i, double *out_value)
+{
+    const size_t row = reader->first + i;
+    if (reader->validity && !(reader->validity[row / 64] >> (row % 64) & 1u))
+        return false;
+
+    if (reader->numbers) {
+        if (!reader->tracked && isnan(reader->numbers[row]))
+            return false;
+        *out_value = reader->numbers[row];
+        return true;
+    }
+
+    if (!reader->tracked && dataframe_cell_is_null(reader->df, (int)row, reader->col))
+        return false;
+    const DataCell cell = dataframe_get_cell(reader->df, (int)row, reader->col);
+    *out_value = reader->integer ? (double)cell.v_int : cell.v_num;
+    return true;
+}
+
+/**
+ * @brief Advances a Simple Moving Average by one row, as calculate_sma_masked does.
+ * @param state The step state.
+ * @param period The period.
+ * @param valid Whether the row's value is present.
+ * @param value The row's value.
+ * @return The average of the last period rows, or NAN if fewer were seen or one is missing.
+ */
+static double
+sma_push(QueryStepState *state, const int period, const bool valid, const double value)
+{
+    const size_t u_period = (size_t)period;
+    if (valid)
+        state->sum += value;
+    else
+        state->null_count++;
+
+    if (state->seen >= u_period) {
+        if (state->window_valid[state->position])
+            state->sum -= state->window[state->position];
+        else
+            state->null_count--;
+    }
+    state->window[state->position] = valid ? value : 0.0;
+    state->window_valid[state->position] = valid;
+    state->position = state->position + 1 == u_period ? 0 : state->position + 1;
+    state->seen++;
+
+    if (state->seen < u_period || state->null_count > 0)
+        return NAN;
+
+    /* A NaN or infinite value poisons the running sum even after leaving the window */
+    if (!isfinite(state->sum)) {
+        state->sum = 0.0;
+        for (size_t k = 0; k < u_period; k++) {
+            const size_t slot = state->position + k;
+            state->sum += state->window[slot < u_period ? slot : slot - u_period];
+        }
+    }
+    return state->sum / (double)period;
+}
+
+/**
+ * @brief Advances an Exponential Moving Average by one row, as calculate_ema_masked does.
+ * @param state The step state.
+ * @param period The period.
+ * @param valid Whether the row's value is present.
+ * @param value The row's value.
+ * @return The average, or NAN while it is being seeded after a missing value.
+ */
+static double
+ema_push(QueryStepState *state, const int period, const bool valid, const double value)
+{
+    if (!valid) {
+        state->streak = 0;
+        state->sum = 0.0;
+        return NAN;
+    }
+    if (state->streak < (size_t)period) {
+        state->sum += value;
+        state->streak++;
+        if (state->streak < (size_t)period)
+            return NAN;
+        state->ema = state->sum / (double)period;
+        return state->ema;
+    }
+
+    const double multiplier = 2.0 / ((double)period + 1.0);
+    state->ema = (value - state->ema) * multiplier + state->ema;
+    return state->ema;
+}
+
+/**
+ * @brief Derives the signal of one row, as generate_trading_signals does.
+ * @param state The step state, holding the previous row.
+ * @param price The row's price (NAN if missing).
+ * @param average The row's average (NAN if missing).
+ * @return The signal.
+ */
+static Signal signal_push(QueryStepState *state, const double price, const double average)
+{
+    Signal signal = SIGNAL_HOLD;
+    if (!isnan(price) && !isnan(average) && !isnan(state->previous_price) &&
+        !isnan(state->previous_average)) {
+        if (state->previous_price <= state->previous_average && price > average)
+            signal = SIGNAL_BUY;
+        else if (state->previous_price >= state->previous_average && price < average)
+            signal = SIGNAL_SELL;
+    }
+    state->previous_price = price;
+    state->previous_average = average;
+    return signal;
+}
+
+/**
+ * @brief Computes the output of a moving average or signals step for the surviving rows.
+ * @param run The execution.
+ * @param s The step index.
+ * @param block The frame holding the scanned columns.
+ * @param first The row of block at morsel position 0.
+ * @param count The number of rows in the morsel.
+ * @param alive Bitmap of the surviving morsel positions.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode compute_step(const QueryRun *run,
+                                       const size_t s,
+                                       const DataFrame *block,
+                                       const size_t first,
+                                       const size_t count,
+                                       const uint64_t *alive)
+{
+    const QueryStep *step = &run->query->steps[s];
+    QueryStepState *state = &run->states[s];
+    DataCell *out = run->morsel->col_data[step->output];
+
+    QueryReader input;
+    QueryReader average;
+    reader_bind(&input, run, step->input, block, first);
+    if (step->kind == QUERY_STEP_SIGNALS)
+        reader_bind(&average, run, step->average, block, first);
+
+    for (size_t w = 0; w * 64 < count; w++) {
+        uint64_t bits = alive[w];
+        while (bits) {
+            const size_t i = w * 64 + trailing_zeros64(bits);
+            bits &= bits - 1;
+
+            double value = NAN;
+            const bool valid = reader_value(&input, i, &value);
+            if (step->kind == QUERY_STEP_SIGNALS) {
+                double mean = NAN;
+                reader_value(&average, i, &mean);
+                out[i].v_code = state->codes[signal_push(state, value, mean)];
+                continue;
+            }
+
+            out[i].v_num = step->kind == QUERY_STEP_SMA
+                               ? sma_push(state, step->period, valid, value)
+                               : ema_push(state, step->period, valid, value);
+            if (isnan(out[i].v_num) &&
+                !dataframe_set_valid(run->morsel, (int)i, step->output, false))
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Checks whether any bit of a bitmap is set.
+ * @param bits The bitmap.
+ * @param words The number of words.
+ * @return true if a bit is set.
+ */
+static bool any_alive(const uint64_t *bits, const size_t words)
+{
+    for (size_t w = 0; w < words; w++) {
+        if (bits[w])
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Passes one morsel through every step and hands its surviving rows to the consumer.
+ * @param run The execution.
+ * @param block The frame holding the scanned columns.
+ * @param first The row of block at morsel position 0.
+ * @param count The number of rows in the morsel (at most QUERY_MORSEL_ROWS).
+ * @param consume The terminal operation.
+ * @param context The terminal operation's state.
+ * @return DATAFRAME_SUCCESS, or the error of a step or of the consumer.
+ */
+static DataframeErrorCode process_morsel(const QueryRun *run,
+                                         const DataFrame *block,
+                                         const size_t first,
+                                         const size_t count,
+                                         const QueryConsumer consume,
+                                         void *context)
+{
+    uint64_t alive[QUERY_MORSEL_WORDS];
+    const size_t words = (count + 63) / 64;
+    for (size_t w = 0; w < words; w++) {
+        const size_t remaining = count - w * 64;
+        alive[w] = remaining < 64 ? ((uint64_t)1 << remaining) - 1 : ~(uint64_t)0;
+    }
+
+    /* The computed columns only ever hold one morsel */
+    if (run->morsel) {
+        dataframe_clear_rows(run->morsel);
+        run->morsel->rows = (int)count;
+    }
+
+    const DataFrameQuery *query = run->query;
+    for (size_t s = 0; s < query->step_count; s++) {
+        if (!any_alive(alive, words))
+            return DATAFRAME_SUCCESS;
+
+        const QueryStep *step = &query->steps[s];
+        const QueryStepState *state = &run->states[s];
+        if (step->kind != QUERY_STEP_FILTER) {
+            const DataframeErrorCode err = compute_step(run, s, block, first, count, alive);
+            if (err != DATAFRAME_SUCCESS)
+                return err;
+            continue;
+        }
+        if (state->scan_terms)
+            dataframe_filter_and_range(
+                block, state->scan_terms, step->scan_count, first, count, alive);
+        if (state->computed_terms)
+            dataframe_filter_and_range(
+                run->morsel, state->computed_terms, step->computed_count, 0, count, alive);
+    }
+
+    if (!any_alive(alive, words))
+        return DATAFRAME_SUCCESS;
+    return consume(context, run, block, first, count, alive);
+}
+
+/**
+ * @brief Compiles the filter conditions of every step that the reader does not check.
+ * @param run The execution (its morsel frame must exist).
+ * @param block The frame the scanned conditions are compiled against.
+ * @return The codes of dataframe_predicate_compile.
+ */
+static DataframeErrorCode compile_filters(const QueryRun *run, const DataFrame *block)
+{
+    const DataFrameQuery *query = run->query;
+    for (size_t s = 0; s < query->step_count; s++) {
+        const QueryStep *step = &query->steps[s];
+        QueryStepState *state = &run->states[s];
+        if (step->kind != QUERY_STEP_FILTER)
+            continue;
+
+        DataframeErrorCode err = DATAFRAME_SUCCESS;
+        if (step->scan_count && !state->pushed) {
+            const FilterPredicate predicate = {step->conditions, step->scan_count, NULL};
+            err = dataframe_predicate_compile(block, &predicate, &state->scan_terms);
+        }
+        if (err == DATAFRAME_SUCCESS && step->computed_count) {
+            const FilterPredicate predicate = {
+                step->conditions + step->scan_count, step->computed_count, NULL};
+            err = dataframe_predicate_compile(run->morsel, &predicate, &state->computed_terms);
+        }
+        if (err != DATAFRAME_SUCCESS)
+            return err;
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Releases the state of an execution.
+ * @param run The execution.
+ */
+static void run_close(QueryRun *run)
+{
+    for (size_t s = 0; run->states && s < run->query->step_count; s++) {
+        free(run->states[s].scan_terms);
+        free(run->states[s].computed_terms);
+        free(run->states[s].window);
+        free(run->states[s].window_valid);
+    }
+    free(run->states);
+    free_dataframe(run->morsel);
+}
+
+/**
+ * @brief Prepares the step states and the morsel frame of an execution.
+ * @param run The execution, to be released with run_close.
+ * @param query The query.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode run_open(QueryRun *run, const DataFrameQuery *query)
+{
+    run->query = query;
+    run->states = calloc(query->step_count ? query->step_count : 1, sizeof(QueryStepState));
+    if (!run->states)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    for (size_t s = 0; s < query->step_count; s++) {
+        QueryStepState *state = &run->states[s];
+        state->ema = NAN;
+        state->previous_price = NAN;
+        state->previous_average = NAN;
+        if (query->steps[s].kind != QUERY_STEP_SMA)
+            continue;
+        state->window = malloc((size_t)query->steps[s].period * sizeof(double));
+        state->window_valid = malloc((size_t)query->steps[s].period);
+        if (!state->window || !state->window_valid)
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    if (query->computed_count == 0)
+        return DATAFRAME_SUCCESS;
+
+    /* Named, so that filters on computed columns compile against it like any frame */
+    DataFrame *morsel = create_dataframe_with_layout(
+        QUERY_MORSEL_ROWS, (size_t)query->computed_count, DATAFRAME_LAYOUT_COLUMNS);
+    run->morsel = morsel;
+    if (!morsel || dataframe_enable_validity(morsel) != DATAFRAME_SUCCESS)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    for (int c = 0; c < morsel->cols; c++) {
+        morsel->col_types[c] = query->computed_types[c];
+        morsel->columns[c] = strdup(query->computed_names[c]);
+        if (!morsel->columns[c])
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    if (dataframe_index_columns(morsel) != DATAFRAME_SUCCESS)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    for (size_t s = 0; s < query->step_count; s++) {
+        const QueryStep *step = &query->steps[s];
+        for (int k = 0; step->kind == QUERY_STEP_SIGNALS && k < 3; k++) {
+            const char *label = SIGNAL_LABELS[k];
+            run->states[s].codes[k] =
+                dataframe_intern_string(morsel, step->output, label, strlen(label));
+            if (run->states[s].codes[k] < 0)
+                return DATAFRAME_ERR_ALLOCATION_FAILED;
+        }
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Streams a CSV scan through the steps, one batch per morsel.
+ *
+ * The scanned conditions of the filters preceding the first computed column
+ * are handed to the reader, together with the caller's own filter.
+ *
+ * @param run The execution.
+ * @param consume The terminal operation.
+ * @param context The terminal operation's state.
+ * @return DATAFRAME_SUCCESS, or the error of the reader, a step or the consumer.
+ */
+static DataframeErrorCode
+execute_csv(const QueryRun *run, const QueryConsumer consume, void *context)
+{
+    const DataFrameQuery *query = run->query;
+    const FilterPredicate *own = query->options.filter;
+    size_t pushed_count = own ? own->count : 0;
+    for (size_t s = 0; s < query->step_count && query->steps[s].kind == QUERY_STEP_FILTER; s++) {
+        pushed_count += query->steps[s].scan_count;
+    }
+
+    FilterCondition *pushed = malloc((pushed_count ? pushed_count : 1) * sizeof(FilterCondition));
+    if (!pushed)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    size_t n = 0;
+    for (size_t i = 0; own && i < own->count; i++) {
+        pushed[n++] = own->conditions[i];
+    }
+    for (size_t s = 0; s < query->step_count && query->steps[s].kind == QUERY_STEP_FILTER; s++) {
+        const QueryStep *step = &query->steps[s];
+        memcpy(pushed + n, step->conditions, step->scan_count * sizeof(FilterCondition));
+        n += step->scan_count;
+        run->states[s].pushed = true;
+    }
+
+    const FilterPredicate predicate = {pushed, pushed_count, NULL};
+    CsvReadOptions options = query->options;
+    options.filter = pushed_count ? &predicate : NULL;
+
+    CsvStream *stream = NULL;
+    DataframeErrorCode err = csv_stream_open(query->path, &options, &stream);
+    bool compiled = false;
+    while (err == DATAFRAME_SUCCESS) {
+        DataFrame *batch = NULL;
+        err = csv_stream_next_batch(stream, QUERY_MORSEL_ROWS, &batch);
+        if (err != DATAFRAME_SUCCESS || !batch)
+            break;
+
+        /* Codes of category constants are resolved against this stream's own dictionaries */
+        if (!compiled) {
+            err = compile_filters(run, batch);
+            compiled = true;
+        }
+        if (err == DATAFRAME_SUCCESS)
+            err = process_morsel(run, batch, 0, (size_t)batch->rows, consume, context);
+    }
+
+    csv_stream_close(stream);
+    free(pushed);
+    return err;
+}
+
+/**
+ * @brief Executes a query, handing the surviving rows of every morsel to a consumer.
+ * @param query The query.
+ * @param consume The terminal operation.
+ * @param context The terminal operation's state.
+ * @return DATAFRAME_SUCCESS, or the error of the scan, a step or the consumer.
+ */
+static DataframeErrorCode
+execute(const DataFrameQuery *query, const QueryConsumer consume, void *context)
+{
+    QueryRun run = {0};
+    DataframeErrorCode err = run_open(&run, query);
+
+    if (err == DATAFRAME_SUCCESS && query->path) {
+        err = execute_csv(&run, consume, context);
+    } else if (err == DATAFRAME_SUCCESS) {
+        const DataFrame *df = query->df;
+        err = compile_filters(&run, df);
+        for (size_t first = 0; err == DATAFRAME_SUCCESS && first < (size_t)df->rows;
+             first += QUERY_MORSEL_ROWS) {
+            const size_t remaining = (size_t)df->rows - first;
+            const size_t count = remaining < QUERY_MORSEL_ROWS ? remaining : QUERY_MORSEL_ROWS;
+            err = process_morsel(&run, df, first, count, consume, context);
+        }
+    }
+
+    run_close(&run);
+    return err;
+}
+
+/**
+ * @brief Returns the column behind an output column of dataframe_query_collect.
+ * @param query The query.
+ * @param c The output column.
+ * @return The column.
+ */
+static QueryColumn output_column(const DataFrameQuery *query, const int c)
+{
+    if (query->selected)
+        return query->selected[c];
+    const QueryColumn column = {c >= query->schema->cols,
+                                c < query->schema->cols ? c : c - query->schema->cols};
+    return column;
+}
+
+/**
+ * @brief Appends the surviving rows of a morsel to the collected result.
+ *
+ * Implements QueryConsumer for dataframe_query_collect.
+ */
+static DataframeErrorCode collect_morsel(void *context,
+                                         const QueryRun *run,
+                                         const DataFrame *block,
+                                         const size_t first,
+                                         const size_t count,
+                                         const uint64_t *alive)
+{
+    CollectJob *job = context;
+    size_t selected = 0;
+    for (size_t w = 0; w * 64 < count; w++) {
+        uint64_t bits = alive[w];
+        while (bits) {
+            const size_t i = w * 64 + trailing_zeros64(bits);
+            bits &= bits - 1;
+            job->rows[selected] = (int)(first + i);
+            job->positions[selected] = (int)i;
+            selected++;
+        }
+    }
+
+    for (int c = 0; c < job->part->cols; c++) {
+        const QueryColumn column = output_column(run->query, c);
+        const DataFrame *src = column.computed ? run->morsel : block;
+        const int *rows = column.computed ? job->positions : job->rows;
+        const DataframeErrorCode err =
+            dataframe_gather_rows(job->part, c, src, &column.index, 1, rows, selected);
+        if (err != DATAFRAME_SUCCESS)
+            return err;
+    }
+
+    /* dataframe_move_rows reserves exactly what it needs, so grow geometrically here */
+    DataFrame *out = job->out;
+    const size_t needed = (size_t)out->rows + selected;
+    if (needed > (size_t)out->row_capacity) {
+        const size_t doubled = (size_t)out->row_capacity * 2;
+        if (!dataframe_reserve_rows(out, needed > doubled ? needed : doubled))
+            return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    return dataframe_move_rows(out, job->part);
+}
+
+DataframeErrorCode dataframe_query_collect(DataFrameQuery *query, DataFrame **out_df)
+{
+    if (!query || !out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+
+    const int cols =
+        query->selected ? query->selected_count : query->schema->cols + query->computed_count;
+    CollectJob job = {0};
+    job.out =
+        create_dataframe_with_layout(QUERY_MORSEL_ROWS, (size_t)cols, DATAFRAME_LAYOUT_COLUMNS);
+    job.part =
+        create_dataframe_with_layout(QUERY_MORSEL_ROWS, (size_t)cols, DATAFRAME_LAYOUT_COLUMNS);
+    job.rows = malloc(QUERY_MORSEL_ROWS * sizeof(int));
+    job.positions = malloc(QUERY_MORSEL_ROWS * sizeof(int));
+
+    bool ok = job.out && job.part && job.rows && job.positions &&
+              dataframe_enable_validity(job.out) == DATAFRAME_SUCCESS &&
+              dataframe_enable_validity(job.part) == DATAFRAME_SUCCESS;
+    for (int c = 0; c < cols && ok; c++) {
+        const QueryColumn column = output_column(query, c);
+        const char *name = column.computed ? query->computed_names[column.index]
+                                           : query->schema->columns[column.index];
+        job.out->col_types[c] = column_type(query, column);
+        job.part->col_types[c] = job.out->col_types[c];
+        job.out->columns[c] = strdup(name ? name : "");
+        ok = job.out->columns[c] != NULL;
+    }
+
+    DataframeErrorCode err = ok ? execute(query, collect_morsel, &job)
+                                : DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (err == DATAFRAME_SUCCESS && dataframe_index_columns(job.out) != DATAFRAME_SUCCESS)
+        err = DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    free(job.rows);
+    free(job.positions);
+    free_dataframe(job.part);
+    if (err != DATAFRAME_SUCCESS) {
+        free_dataframe(job.out);
+        return err;
+    }
+    *out_df = job.out;
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Adds the surviving rows of a morsel to the aggregates.
+ *
+ * Implements QueryConsumer for dataframe_query_aggregate.
+ */
+static DataframeErrorCode aggregate_morsel(void *context,
+                                           const QueryRun *run,
+                                           const DataFrame *block,
+                                           const size_t first,
+                                           const size_t count,
+                                           const uint64_t *alive)
+{
+    const AggregateJob *job = context;
+    for (int a = 0; a < job->count; a++) {
+        QueryReader reader;
+        reader_bind(&reader, run, job->columns[a], block, first);
+        QueryAccumulator *acc = &job->accs[a];
+        const bool numeric = job->aggregates[a].aggregation != GROUPBY_COUNT;
+
+        for (size_t w = 0; w * 64 < count; w++) {
+            uint64_t bits = alive[w];
+            while (bits) {
+                const size_t i = w * 64 + trailing_zeros64(bits);
+                bits &= bits - 1;
+
+                double x = NAN;
+                if (!reader_value(&reader, i, &x))
+                    continue;
+                if (!numeric) {
+                    acc->stats.count++;
+                    continue;
+                }
+                running_statistics_add(&acc->stats, x);
+                acc->sum += x;
+                if (x < acc->min)
+                    acc->min = x;
+                if (x > acc->max)
+                    acc->max = x;
+            }
+        }
+    }
+    return DATAFRAME_SUCCESS;
+}
+
+/**
+ * @brief Builds the one-row result of dataframe_query_aggregate.
+ * @param job The filled aggregates.
+ * @param out_df Receives the result.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode build_aggregates(const AggregateJob *job, DataFrame **out_df)
+{
+    DataFrame *out = create_dataframe_with_layout(1, (size_t)job->count, DATAFRAME_LAYOUT_COLUMNS);
+    bool ok = out && dataframe_enable_validity(out) == DATAFRAME_SUCCESS &&
+              dataframe_push_row(out) == 0;
+
+    for (int a = 0; a < job->count && ok; a++) {
+        const QueryAggregate *agg = &job->aggregates[a];
+        const QueryAccumulator *acc = &job->accs[a];
+        const size_t n = acc->stats.count;
+        char name[256];
+        if (agg->name)
+            snprintf(name, sizeof(name), "%s", agg->name);
+        else
+            snprintf(name,
+                     sizeof(name),
+                     "%s_%s",
+                     agg->column,
+                     dataframe_groupby_suffix(agg->aggregation));
+        out->columns[a] = strdup(name);
+        out->col_types[a] = agg->aggregation == GROUPBY_COUNT ? TYPE_INT64 : TYPE_NUMERIC;
+        ok = out->columns[a] != NULL;
+
+        DataCell cell = {0};
+        bool valid = n > 0;
+        switch (agg->aggregation) {
+        case GROUPBY_COUNT:
+            cell.v_int = (int64_t)n;
+            valid = true;
+            break;
+        case GROUPBY_SUM:
+            cell.v_num = acc->sum;
+            break;
+        case GROUPBY_MEAN:
+            cell.v_num = acc->stats.mean;
+            break;
+        case GROUPBY_VARIANCE:
+            cell.v_num = n > 1 ? acc->stats.m2 / (double)(n - 1) : NAN;
+            valid = n > 1;
+            break;
+        case GROUPBY_MIN:
+            cell.v_num = acc->min;
+            break;
+        default:
+            cell.v_num = acc->max;
+            break;
+        }
+        dataframe_set_cell(out, 0, a, cell);
+        if (ok && !valid)
+            ok = dataframe_set_valid(out, 0, a, false);
+    }
+
+    if (!ok || dataframe_index_columns(out) != DATAFRAME_SUCCESS) {
+        free_dataframe(out);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+    *out_df = out;
+    return DATAFRAME_SUCCESS;
+}
+
+DataframeErrorCode dataframe_query_aggregate(DataFrameQuery *query,
+                                             const QueryAggregate *aggregates,
+                                             const int aggregate_count,
+                                             DataFrame **out_df)
+{
+    if (!query || !aggregates || aggregate_count <= 0 || !out_df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_df = NULL;
+
+    AggregateJob job = {aggregates, NULL, NULL, aggregate_count};
+    QueryColumn *columns = malloc((size_t)aggregate_count * sizeof(QueryColumn));
+    job.accs = malloc((size_t)aggregate_count * sizeof(QueryAccumulator));
+    job.columns = columns;
+    if (!columns || !job.accs) {
+        free(columns);
+        free(job.accs);
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    }
+
+    DataframeErrorCode err = DATAFRAME_SUCCESS;
+    for (int a = 0; a < aggregate_count && err == DATAFRAME_SUCCESS; a++) {
+        const GroupByAggregation aggregation = aggregates[a].aggregation;
+        const bool found = aggregation == GROUPBY_COUNT
+                               ? resolve_column(query, aggregates[a].column, &columns[a])
+                               : resolve_numeric(query, aggregates[a].column, &columns[a]);
+        if (!found || aggregation < GROUPBY_COUNT || aggregation > GROUPBY_MAX)
+            err = DATAFRAME_ERR_COLUMN_NOT_FOUND;
+
+        running_statistics_reset(&job.accs[a].stats);
+        job.accs[a].sum = 0.0;
+        job.accs[a].min = INFINITY;
+        job.accs[a].max = -INFINITY;
+    }
+
+    if (err == DATAFRAME_SUCCESS)
+        err = execute(query, aggregate_morsel, &job);
+    if (err == DATAFRAME_SUCCESS)
+        err = build_aggregates(&job, out_df);
+
+    free(columns);
+    free(job.accs);
+    return err;
+}
+
+void dataframe_query_free(DataFrameQuery *query)
+{
+    if (!query)
+        return;
+
+    for (size_t s = 0; s < query->step_count; s++) {
+        free(query->steps[s].conditions);
+    }
+    for (int c = 0; c < query->computed_count; c++) {
+        free(query->computed_names[c]);
+    }
+    free(query->steps);
+    free(query->computed_names);
+    free(query->computed_types);
+    free(query->selected);
+    free(query->path);
+    csv_stream_close(query->schema_stream);
+    free_dataframe(query->df);
+    free(query);
+}
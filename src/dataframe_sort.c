@@ -0,0 +1,632 @@
+#include "dataframe_sort.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parallel.h"
+
+/**
+ * @brief Number of key bits consumed by one radix pass.
+ */
+#define SORT_RADIX_BITS 8
+
+/**
+ * @brief Number of buckets of one radix pass.
+ */
+#define SORT_RADIX_BUCKETS (1u << SORT_RADIX_BITS)
+
+/**
+ * @brief Minimum number of rows handled by one task; smaller inputs use fewer threads.
+ */
+#define SORT_CHUNK_ROWS 65536
+
+/**
+ * @brief Length of the runs sorted by insertion before merging starts.
+ */
+#define SORT_INSERTION_RUN 32
+
+/**
+ * @brief A string key and the row it belongs to.
+ */
+typedef struct {
+    const char *text; /*!< The key (never NULL; missing values are partitioned out first). */
+    int row;          /*!< The row of the DataFrame holding the key. */
+} SortEntry;
+
+/**
+ * @brief Buffers and state shared by the passes of one dataframe_sort_order call.
+ */
+typedef struct {
+    const DataFrame *df;        /*!< The frame being sorted. */
+    int col;                    /*!< The key column of the current pass. */
+    bool ascending;             /*!< The direction of the current key. */
+    const uint64_t *validity;   /*!< Validity bitmap of the current key column, or NULL. */
+    bool check_sentinels;       /*!< Whether missing values are only marked by sentinels. */
+    const uint32_t *ranks;      /*!< Sort rank of each category code of the current key, or NULL. */
+    int *order;                 /*!< The permutation, refined key by key. */
+    int *order_scratch;         /*!< Second permutation buffer. */
+    uint64_t *keys;             /*!< Encoded keys of the current pass (radix keys only). */
+    uint64_t *keys_scratch;     /*!< Second key buffer (radix keys only). */
+    SortEntry *entries;         /*!< String keys of the current pass (string keys only). */
+    SortEntry *entries_scratch; /*!< Second entry buffer (string keys only). */
+    bool *missing;              /*!< Whether the key at each position is missing. */
+    size_t count;               /*!< Number of positions covered by the current task split. */
+    size_t chunk_rows;          /*!< Number of positions handled by one task. */
+} SortJob;
+
+/**
+ * @brief State of one radix pass over the valid keys.
+ */
+typedef struct {
+    const uint64_t *keys_in; /*!< Keys in their current order. */
+    const int *rows_in;      /*!< Rows in their current order. */
+    uint64_t *keys_out;      /*!< Receives the keys ordered by the pass's digit. */
+    int *rows_out;           /*!< Receives the rows ordered by the pass's digit. */
+    size_t count;            /*!< Number of keys. */
+    size_t chunk_rows;       /*!< Number of keys handled by one task. */
+    unsigned shift;          /*!< Position of the pass's digit. */
+    size_t *counts;          /*!< Per-task histograms, turned into per-task scatter offsets. */
+} RadixPass;
+
+/**
+ * @brief State of one level of the parallel merge sort.
+ */
+typedef struct {
+    const SortEntry *src; /*!< Entries made of sorted runs of width entries. */
+    SortEntry *dst;       /*!< Receives the merged runs. */
+    size_t count;         /*!< Number of entries. */
+    size_t width;         /*!< Length of the sorted runs of src. */
+    bool ascending;       /*!< The sort direction. */
+} MergeLevel;
+
+/**
+ * @brief Chooses how many tasks a number of positions is split into.
+ * @param count The number of positions.
+ * @param out_chunk_rows Receives the number of positions per task.
+ * @return The number of tasks (at least 1).
+ */
+static size_t split_tasks(const size_t count, size_t *out_chunk_rows)
+{
+    size_t tasks = (count + SORT_CHUNK_ROWS - 1) / SORT_CHUNK_ROWS;
+    const size_t threads = (size_t)parallel_hardware_threads();
+    if (tasks > threads)
+        tasks = threads;
+    if (tasks == 0)
+        tasks = 1;
+    *out_chunk_rows = (count + tasks - 1) / tasks;
+    if (*out_chunk_rows == 0)
+        *out_chunk_rows = 1;
+    return tasks;
+}
+
+/**
+ * @brief Returns the positions handled by one task.
+ * @param count The number of positions.
+ * @param chunk_rows The number of positions per task.
+ * @param chunk The task index.
+ * @param out_end Receives the end of the task's range (exclusive).
+ * @return The start of the task's range.
+ */
+static size_t
+chunk_range(const size_t count, const size_t chunk_rows, const size_t chunk, size_t *out_end)
+{
+    const size_t begin = chunk * chunk_rows < count ? chunk * chunk_rows : count;
+    *out_end = count - begin < chunk_rows ? count : begin + chunk_rows;
+    return begin;
+}
+
+/**
+ * @brief Encodes a double as an unsigned integer with the same order.
+ *
+ * Negative zero is folded into zero and every NaN into one value that sorts
+ * after positive infinity.
+ *
+ * @param value The number.
+ * @return The encoded key.
+ */
+static uint64_t encode_double(double value)
+{
+    if (value == 0.0)
+        value = 0.0;
+    if (isnan(value))
+        value = NAN;
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits >> 63 ? ~bits : bits | (uint64_t)1 << 63;
+}
+
+/**
+ * @brief Checks whether the key of a row is missing, given its cell.
+ * @param job The sort state.
+ * @param type The type of the key column.
+ * @param row The row.
+ * @param cell The row's key cell.
+ * @return true if the key is missing.
+ */
+static bool
+key_is_missing(const SortJob *job, const DataType type, const int row, const DataCell cell)
+{
+    /* Codes without a dictionary value cannot be ranked, whatever the bitmap says */
+    if (type == TYPE_CATEGORY && cell.v_code < 0)
+        return true;
+    if (job->validity)
+        return !(job->validity[row / 64] >> (row % 64) & 1u);
+    if (!job->check_sentinels)
+        return false;
+
+    switch (type) {
+    case TYPE_NUMERIC:
+        return isnan(cell.v_num);
+    case TYPE_STRING:
+        return cell.v_str == NULL;
+    case TYPE_CATEGORY:
+        return false;
+    default:
+        return cell.v_int == DATAFRAME_NULL_INT64;
+    }
+}
+
+/**
+ * @brief Task encoding the keys of one range of positions and flagging missing ones.
+ * @param context The SortJob.
+ * @param chunk The task index.
+ */
+static void encode_keys_task(void *context, const size_t chunk)
+{
+    const SortJob *job = context;
+    const DataFrame *df = job->df;
+    const DataType type = df->col_types[job->col];
+    size_t end;
+
+    for (size_t i = chunk_range(job->count, job->chunk_rows, chunk, &end); i < end; i++) {
+        const int row = job->order[i];
+        const DataCell cell = dataframe_get_cell(df, row, job->col);
+        job->missing[i] = key_is_missing(job, type, row, cell);
+        if (job->missing[i])
+            continue;
+
+        if (type == TYPE_STRING) {
+            job->entries[i].text = cell.v_str;
+            job->entries[i].row = row;
+            continue;
+        }
+
+        uint64_t key;
+        if (type == TYPE_NUMERIC)
+            key = encode_double(cell.v_num);
+        else if (type == TYPE_CATEGORY)
+            key = job->ranks[cell.v_code];
+        else
+            key = (uint64_t)cell.v_int ^ (uint64_t)1 << 63;
+        job->keys[i] = job->ascending ? key : ~key;
+    }
+}
+
+/**
+ * @brief Radix task counting the digits of one range of keys.
+ * @param context The RadixPass.
+ * @param chunk The task index.
+ */
+static void radix_count_task(void *context, const size_t chunk)
+{
+    const RadixPass *pass = context;
+    size_t *counts = pass->counts + chunk * SORT_RADIX_BUCKETS;
+    size_t end;
+
+    memset(counts, 0, SORT_RADIX_BUCKETS * sizeof(size_t));
+    for (size_t i = chunk_range(pass->count, pass->chunk_rows, chunk, &end); i < end; i++) {
+        counts[pass->keys_in[i] >> pass->shift & (SORT_RADIX_BUCKETS - 1)]++;
+    }
+}
+
+/**
+ * @brief Radix task moving one range of keys and rows to their places for the pass's digit.
+ * @param context The RadixPass.
+ * @param chunk The task index.
+ */
+static void radix_scatter_task(void *context, const size_t chunk)
+{
+    const RadixPass *pass = context;
+    size_t *offsets = pass->counts + chunk * SORT_RADIX_BUCKETS;
+    size_t end;
+
+    for (size_t i = chunk_range(pass->count, pass->chunk_rows, chunk, &end); i < end; i++) {
+        const uint64_t key = pass->keys_in[i];
+        const size_t slot = offsets[key >> pass->shift & (SORT_RADIX_BUCKETS - 1)]++;
+        pass->keys_out[slot] = key;
+        pass->rows_out[slot] = pass->rows_in[i];
+    }
+}
+
+/**
+ * @brief Stably sorts the first count positions of the permutation by their encoded keys.
+ *
+ * Only the digits in which some keys differ are sorted on. Each pass counts
+ * digits per task, turns the counts into per-task offsets (tasks cover
+ * consecutive ranges, so the order within a bucket is preserved) and
+ * scatters in parallel.
+ *
+ * @param job The sort state (keys and order hold the valid keys).
+ * @param count The number of valid keys.
+ * @return true on success, false if the histograms could not be allocated.
+ */
+static bool radix_sort(SortJob *job, const size_t count)
+{
+    uint64_t differing = 0;
+    for (size_t i = 1; i < count; i++) {
+        differing |= job->keys[i] ^ job->keys[0];
+    }
+    if (!differing)
+        return true;
+
+    RadixPass pass = {0};
+    pass.count = count;
+    const size_t tasks = split_tasks(count, &pass.chunk_rows);
+    pass.counts = malloc(tasks * SORT_RADIX_BUCKETS * sizeof(size_t));
+    if (!pass.counts)
+        return false;
+
+    uint64_t *keys = job->keys;
+    uint64_t *keys_other = job->keys_scratch;
+    int *rows = job->order;
+    int *rows_other = job->order_scratch;
+
+    for (unsigned shift = 0; shift < 64; shift += SORT_RADIX_BITS) {
+        if (!(differing >> shift & (SORT_RADIX_BUCKETS - 1)))
+            continue;
+
+        pass.keys_in = keys;
+        pass.rows_in = rows;
+        pass.keys_out = keys_other;
+        pass.rows_out = rows_other;
+        pass.shift = shift;
+        parallel_for(tasks, 0, radix_count_task, &pass);
+
+        size_t total = 0;
+        for (size_t bucket = 0; bucket < SORT_RADIX_BUCKETS; bucket++) {
+            for (size_t t = 0; t < tasks; t++) {
+                const size_t n = pass.counts[t * SORT_RADIX_BUCKETS + bucket];
+                pass.counts[t * SORT_RADIX_BUCKETS + bucket] = total;
+                total += n;
+            }
+        }
+        parallel_for(tasks, 0, radix_scatter_task, &pass);
+
+        keys_other = keys;
+        keys = pass.keys_out;
+        rows_other = rows;
+        rows = pass.rows_out;
+    }
+
+    if (rows != job->order)
+        memcpy(job->order, rows, count * sizeof(int));
+    free(pass.counts);
+    return true;
+}
+
+/**
+ * @brief Compares two string keys in the requested direction.
+ * @param a The first entry.
+ * @param b The second entry.
+ * @param ascending The sort direction.
+ * @return A negative value if a sorts before b, 0 if they are equal, a positive value otherwise.
+ */
+static int compare_entries(const SortEntry *a, const SortEntry *b, const bool ascending)
+{
+    const int cmp = strcmp(a->text, b->text);
+    return ascending ? cmp : -cmp;
+}
+
+/**
+ * @brief Merges the sorted runs src[begin, middle) and src[middle, end) into dst.
+ *
+ * Ties are taken from the first run, which keeps the merge stable.
+ *
+ * @param src The entries holding both runs.
+ * @param dst Receives the merged run at the same positions.
+ * @param begin Start of the first run.
+ * @param middle End of the first run and start of the second.
+ * @param end End of the second run.
+ * @param ascending The sort direction.
+ */
+static void merge_runs(const SortEntry *src,
+                       SortEntry *dst,
+                       const size_t begin,
+                       const size_t middle,
+                       const size_t end,
+                       const bool ascending)
+{
+    size_t i = begin;
+    size_t j = middle;
+    size_t k = begin;
+
+    while (i < middle && j < end) {
+        dst[k++] = compare_entries(&src[j], &src[i], ascending) < 0 ? src[j++] : src[i++];
+    }
+    while (i < middle) {
+        dst[k++] = src[i++];
+    }
+    while (j < end) {
+        dst[k++] = src[j++];
+    }
+}
+
+/**
+ * @brief Stably sorts entries[begin, end) on one thread.
+ *
+ * Short runs are sorted by insertion, then merged bottom-up through the
+ * matching range of scratch. The result is left in entries.
+ *
+ * @param entries The entries.
+ * @param scratch A buffer as large as entries.
+ * @param begin Start of the range.
+ * @param end End of the range.
+ * @param ascending The sort direction.
+ */
+static void sort_entries_serial(SortEntry *entries,
+                                SortEntry *scratch,
+                                const size_t begin,
+                                const size_t end,
+                                const bool ascending)
+{
+    for (size_t run = begin; run < end; run += SORT_INSERTION_RUN) {
+        const size_t run_end = end - run < SORT_INSERTION_RUN ? end : run + SORT_INSERTION_RUN;
+        for (size_t i = run + 1; i < run_end; i++) {
+            const SortEntry entry = entries[i];
+            size_t j = i;
+            for (; j > run && compare_entries(&entry, &entries[j - 1], ascending) < 0; j--) {
+                entries[j] = entries[j - 1];
+            }
+            entries[j] = entry;
+        }
+    }
+
+    SortEntry *src = entries;
+    SortEntry *dst = scratch;
+    for (size_t width = SORT_INSERTION_RUN; width < end - begin; width *= 2) {
+        for (size_t lo = begin; lo < end; lo += 2 * width) {
+            const size_t middle = end - lo < width ? end : lo + width;
+            const size_t hi = end - lo < 2 * width ? end : lo + 2 * width;
+            merge_runs(src, dst, lo, middle, hi, ascending);
+        }
+        SortEntry *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != entries)
+        memcpy(entries + begin, src + begin, (end - begin) * sizeof(SortEntry));
+}
+
+/**
+ * @brief Merge sort task sorting one range of string keys.
+ * @param context The SortJob.
+ * @param chunk The task index.
+ */
+static void sort_chunk_task(void *context, const size_t chunk)
+{
+    const SortJob *job = context;
+    size_t end;
+    const size_t begin = chunk_range(job->count, job->chunk_rows, chunk, &end);
+    sort_entries_serial(job->entries, job->entries_scratch, begin, end, job->ascending);
+}
+
+/**
+ * @brief Merge sort task merging one pair of neighbouring runs.
+ * @param context The MergeLevel.
+ * @param pair The index of the pair.
+ */
+static void merge_pair_task(void *context, const size_t pair)
+{
+    const MergeLevel *level = context;
+    const size_t lo = pair * 2 * level->width;
+    const size_t middle = level->count - lo < level->width ? level->count : lo + level->width;
+    const size_t hi = level->count - lo < 2 * level->width ? level->count : lo + 2 * level->width;
+    merge_runs(level->src, level->dst, lo, middle, hi, level->ascending);
+}
+
+/**
+ * @brief Stably sorts the first count string keys and writes their rows to the permutation.
+ *
+ * Every task sorts a range on its own; neighbouring ranges are then merged
+ * pairwise, one level at a time, with the merges of a level running in
+ * parallel.
+ *
+ * @param job The sort state (entries hold the valid keys).
+ * @param count The number of valid keys.
+ */
+static void merge_sort(SortJob *job, const size_t count)
+{
+    job->count = count;
+    const size_t tasks = split_tasks(count, &job->chunk_rows);
+    parallel_for(tasks, 0, sort_chunk_task, job);
+
+    MergeLevel level;
+    level.src = job->entries;
+    level.dst = job->entries_scratch;
+    level.count = count;
+    level.ascending = job->ascending;
+    for (level.width = job->chunk_rows; level.width < count; level.width *= 2) {
+        const size_t pairs = (count + 2 * level.width - 1) / (2 * level.width);
+        parallel_for(pairs, 0, merge_pair_task, &level);
+
+        SortEntry *merged = level.dst;
+        level.dst = (SortEntry *)level.src;
+        level.src = merged;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        job->order[i] = level.src[i].row;
+    }
+}
+
+/**
+ * @brief Ranks the dictionary values of a category column in lexicographic order.
+ * @param df Pointer to the DataFrame.
+ * @param col The category column.
+ * @param out_ranks Receives an array giving the rank of each code (free with free()).
+ * @return true on success, false on allocation failure.
+ */
+static bool rank_categories(const DataFrame *df, const int col, uint32_t **out_ranks)
+{
+    const StringDictionary *dict = df->dictionaries ? df->dictionaries[col] : NULL;
+    const size_t count = dict ? (size_t)dict->count : 0;
+
+    *out_ranks = malloc((count ? count : 1) * sizeof(uint32_t));
+    SortEntry *entries = malloc((count ? count : 1) * sizeof(SortEntry));
+    SortEntry *scratch = malloc((count ? count : 1) * sizeof(SortEntry));
+    if (!*out_ranks || !entries || !scratch) {
+        free(*out_ranks);
+        free(entries);
+        free(scratch);
+        *out_ranks = NULL;
+        return false;
+    }
+
+    for (size_t code = 0; code < count; code++) {
+        entries[code].text = dict->values[code];
+        entries[code].row = (int)code;
+    }
+    sort_entries_serial(entries, scratch, 0, count, true);
+    for (size_t rank = 0; rank < count; rank++) {
+        (*out_ranks)[entries[rank].row] = (uint32_t)rank;
+    }
+
+    free(entries);
+    free(scratch);
+    return true;
+}
+
+/**
+ * @brief Stably sorts the permutation by one key column, missing values last.
+ * @param job The sort state; col and ascending select the key.
+ * @param rows The number of rows.
+ * @return DATAFRAME_SUCCESS or DATAFRAME_ERR_ALLOCATION_FAILED.
+ */
+static DataframeErrorCode sort_by_key(SortJob *job, const size_t rows)
+{
+    const DataFrame *df = job->df;
+    const DataType type = df->col_types[job->col];
+    uint32_t *ranks = NULL;
+
+    if (type == TYPE_CATEGORY && !rank_categories(df, job->col, &ranks))
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    job->ranks = ranks;
+    job->validity = dataframe_column_validity(df, job->col, NULL);
+    job->check_sentinels = !df->validity;
+
+    job->count = rows;
+    const size_t tasks = split_tasks(rows, &job->chunk_rows);
+    parallel_for(tasks, 0, encode_keys_task, job);
+
+    /* Stable partition: valid keys keep their order at the front, missing rows go last */
+    size_t valid = 0;
+    size_t missing = 0;
+    for (size_t i = 0; i < rows; i++) {
+        if (job->missing[i]) {
+            job->order_scratch[missing++] = job->order[i];
+            continue;
+        }
+        if (type == TYPE_STRING)
+            job->entries[valid] = job->entries[i];
+        else
+            job->keys[valid] = job->keys[i];
+        job->order[valid++] = job->order[i];
+    }
+    memcpy(job->order + valid, job->order_scratch, missing * sizeof(int));
+
+    bool sorted = true;
+    if (type == TYPE_STRING)
+        merge_sort(job, valid);
+    else
+        sorted = radix_sort(job, valid);
+
+    free(ranks);
+    job->ranks = NULL;
+    return sorted ? DATAFRAME_SUCCESS : DATAFRAME_ERR_ALLOCATION_FAILED;
+}
+
+DataframeErrorCode dataframe_sort_order(const DataFrame *df,
+                                        const int *keys,
+                                        const bool *ascending,
+                                        const int key_count,
+                                        int *out_order)
+{
+    if (!df || !out_order)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    if (!keys || key_count <= 0)
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+
+    bool has_strings = false;
+    bool has_radix = false;
+    for (int k = 0; k < key_count; k++) {
+        if (keys[k] < 0 || keys[k] >= df->cols)
+            return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+        if (df->col_types[keys[k]] == TYPE_STRING)
+            has_strings = true;
+        else
+            has_radix = true;
+    }
+
+    const size_t rows = (size_t)df->rows;
+    for (size_t i = 0; i < rows; i++) {
+        out_order[i] = (int)i;
+    }
+    if (rows < 2)
+        return DATAFRAME_SUCCESS;
+
+    SortJob job = {0};
+    job.df = df;
+    job.order = out_order;
+    job.order_scratch = malloc(rows * sizeof(int));
+    job.missing = malloc(rows * sizeof(bool));
+    if (has_radix) {
+        job.keys = malloc(rows * sizeof(uint64_t));
+        job.keys_scratch = malloc(rows * sizeof(uint64_t));
+    }
+    if (has_strings) {
+        job.entries = malloc(rows * sizeof(SortEntry));
+        job.entries_scratch = malloc(rows * sizeof(SortEntry));
+    }
+
+    DataframeErrorCode err = DATAFRAME_SUCCESS;
+    if (!job.order_scratch || !job.missing || (has_radix && (!job.keys || !job.keys_scratch)) ||
+        (has_strings && (!job.entries || !job.entries_scratch)))
+        err = DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    /* Least significant key first: each stable pass keeps the order of the keys after it */
+    for (int k = key_count - 1; k >= 0 && err == DATAFRAME_SUCCESS; k--) {
+        job.col = keys[k];
+        job.ascending = ascending ? ascending[k] : true;
+        err = sort_by_key(&job, rows);
+    }
+
+    free(job.order_scratch);
+    free(job.missing);
+    free(job.keys);
+    free(job.keys_scratch);
+    free(job.entries);
+    free(job.entries_scratch);
+    return err;
+}
+
+DataframeErrorCode
+dataframe_sort(DataFrame *df, const int *keys, const bool *ascending, const int key_count)
+{
+    if (!df)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    int *order = malloc((df->rows ? (size_t)df->rows : 1) * sizeof(int));
+    if (!order)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+
+    DataframeErrorCode err = dataframe_sort_order(df, keys, ascending, key_count, order);
+    if (err == DATAFRAME_SUCCESS)
+        err = dataframe_permute_rows(df, order);
+
+    free(order);
+    return err;
+}
@@ -0,0 +1,278 @@
+#include "dataframe_view.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Number of rows covered by one validity word.
+ */
+#define VIEW_WORD_BITS 64
+
+/**
+ * @brief Allocates a view of a parent frame and takes a reference to it.
+ * @param df The parent frame.
+ * @param cols The number of view columns.
+ * @param mapped Whether the view needs its own column map.
+ * @return The view with every other field zeroed, or NULL on allocation failure.
+ */
+static DataFrameView *allocate_view(DataFrame *df, const int cols, const bool mapped)
+{
+    DataFrameView *view = calloc(1, sizeof(DataFrameView));
+    if (!view)
+        return NULL;
+
+    if (mapped) {
+        view->col_map = malloc((size_t)cols * sizeof(int));
+        if (!view->col_map) {
+            free(view);
+            return NULL;
+        }
+    }
+
+    view->frame = dataframe_retain(df);
+    view->cols = cols;
+    return view;
+}
+
+DataFrameView *dataframe_view_create(DataFrame *df)
+{
+    if (!df)
+        return NULL;
+
+    DataFrameView *view = allocate_view(df, df->cols, false);
+    if (!view)
+        return NULL;
+
+    view->first_row = 0;
+    view->row_step = 1;
+    view->rows = df->rows;
+    return view;
+}
+
+DataFrameView *
+dataframe_view_slice(const DataFrameView *view, const int first_row, const int rows, const int step)
+{
+    if (!view || first_row < 0 || rows < 0 || step < 1)
+        return NULL;
+    /* The last selected row must exist; computed in 64 bits so large steps cannot overflow */
+    if (rows > 0 && (int64_t)first_row + (int64_t)(rows - 1) * step >= view->rows)
+        return NULL;
+    if (rows == 0 && first_row > view->rows)
+        return NULL;
+
+    DataFrameView *slice = allocate_view(view->frame, view->cols, view->col_map != NULL);
+    if (!slice)
+        return NULL;
+
+    if (view->col_map)
+        memcpy(slice->col_map, view->col_map, (size_t)view->cols * sizeof(int));
+
+    /* Offsets and strides compose, so the slice still addresses the parent directly */
+    slice->first_row = view->first_row + first_row * view->row_step;
+    slice->row_step = rows > 1 ? view->row_step * step : view->row_step;
+    slice->rows = rows;
+    return slice;
+}
+
+DataFrameView *dataframe_view_select(const DataFrameView *view, const int *cols, const int count)
+{
+    if (!view || !cols || count <= 0)
+        return NULL;
+
+    for (int c = 0; c < count; c++) {
+        if (cols[c] < 0 || cols[c] >= view->cols)
+            return NULL;
+    }
+
+    DataFrameView *selection = allocate_view(view->frame, count, true);
+    if (!selection)
+        return NULL;
+
+    for (int c = 0; c < count; c++) {
+        selection->col_map[c] = dataframe_view_parent_col(view, cols[c]);
+    }
+    selection->first_row = view->first_row;
+    selection->row_step = view->row_step;
+    selection->rows = view->rows;
+    return selection;
+}
+
+DataFrameView *
+dataframe_view_select_names(const DataFrameView *view, const char *const *names, const int count)
+{
+    if (!view || !names || count <= 0)
+        return NULL;
+
+    int *cols = malloc((size_t)count * sizeof(int));
+    if (!cols)
+        return NULL;
+
+    for (int c = 0; c < count; c++) {
+        const int parent_col = dataframe_col_index(view->frame, names[c]);
+        cols[c] = -1;
+        if (!view->col_map) {
+            cols[c] = parent_col;
+            continue;
+        }
+        for (int vc = 0; parent_col >= 0 && vc < view->cols; vc++) {
+            if (view->col_map[vc] == parent_col) {
+                cols[c] = vc;
+                break;
+            }
+        }
+    }
+
+    DataFrameView *selection = dataframe_view_select(view, cols, count);
+    free(cols);
+    return selection;
+}
+
+void dataframe_view_free(DataFrameView *view)
+{
+    if (!view)
+        return;
+
+    free_dataframe(view->frame);
+    free(view->col_map);
+    free(view);
+}
+
+int dataframe_view_parent_col(const DataFrameView *view, const int col)
+{
+    return view->col_map ? view->col_map[col] : col;
+}
+
+int dataframe_view_parent_row(const DataFrameView *view, const int row)
+{
+    return view->first_row + row * view->row_step;
+}
+
+DataCell dataframe_view_get_cell(const DataFrameView *view, const int row, const int col)
+{
+    return dataframe_get_cell(view->frame,
+                              dataframe_view_parent_row(view, row),
+                              dataframe_view_parent_col(view, col));
+}
+
+bool dataframe_view_cell_is_null(const DataFrameView *view, const int row, const int col)
+{
+    return dataframe_cell_is_null(view->frame,
+                                  dataframe_view_parent_row(view, row),
+                                  dataframe_view_parent_col(view, col));
+}
+
+const char *dataframe_view_get_string(const DataFrameView *view, const int row, const int col)
+{
+    return dataframe_get_string(view->frame,
+                                dataframe_view_parent_row(view, row),
+                                dataframe_view_parent_col(view, col));
+}
+
+const DataCell *dataframe_view_column(const DataFrameView *view, const int col)
+{
+    if (!view || col < 0 || col >= view->cols || view->rows == 0 ||
+        view->frame->layout != DATAFRAME_LAYOUT_COLUMNS)
+        return NULL;
+
+    /* String cells still holding heap offsets are only readable through get_cell */
+    const int parent = dataframe_view_parent_col(view, col);
+    if (view->frame->string_heaps && view->frame->string_heaps[parent].data)
+        return NULL;
+
+    return &view->frame->col_data[parent][view->first_row];
+}
+
+const double *dataframe_view_numeric_column(const DataFrameView *view, const int col)
+{
+    if (!view || col < 0 || col >= view->cols || view->row_step != 1)
+        return NULL;
+
+    const double *values =
+        dataframe_numeric_column(view->frame, dataframe_view_parent_col(view, col));
+    return values ? values + view->first_row : NULL;
+}
+
+const int64_t *dataframe_view_int64_column(const DataFrameView *view, const int col)
+{
+    if (!view || col < 0 || col >= view->cols || view->row_step != 1)
+        return NULL;
+
+    const int64_t *values =
+        dataframe_int64_column(view->frame, dataframe_view_parent_col(view, col));
+    return values ? values + view->first_row : NULL;
+}
+
+/**
+ * @brief Counts the rows of a bitmap whose bit is clear.
+ * @param bits The bitmap.
+ * @param rows The number of rows it covers; bits past them are ignored.
+ * @return The number of missing rows.
+ */
+static size_t count_missing(const uint64_t *bits, const size_t rows)
+{
+    size_t missing = 0;
+    for (size_t start = 0; start < rows; start += VIEW_WORD_BITS) {
+        const size_t n = rows - start;
+        const uint64_t range = n >= VIEW_WORD_BITS ? ~(uint64_t)0 : ((uint64_t)1 << n) - 1;
+        for (uint64_t clear = ~bits[start / VIEW_WORD_BITS] & range; clear; clear &= clear - 1) {
+            missing++;
+        }
+    }
+    return missing;
+}
+
+DataframeErrorCode dataframe_view_column_validity(const DataFrameView *view,
+                                                  const int col,
+                                                  uint64_t *scratch,
+                                                  const uint64_t **out_bits,
+                                                  size_t *out_null_count)
+{
+    if (out_bits)
+        *out_bits = NULL;
+    if (out_null_count)
+        *out_null_count = 0;
+    if (!view || !out_bits || col < 0 || col >= view->cols)
+        return DATAFRAME_ERR_COLUMN_NOT_FOUND;
+    if (view->rows == 0)
+        return DATAFRAME_SUCCESS;
+
+    const DataFrame *df = view->frame;
+    const int parent_col = dataframe_view_parent_col(view, col);
+    const size_t rows = (size_t)view->rows;
+
+    if (df->validity) {
+        const uint64_t *bits = dataframe_column_validity(df, parent_col, NULL);
+        if (!bits)
+            return DATAFRAME_SUCCESS;
+
+        /* A contiguous range starting on a word boundary lines up with the parent's bitmap */
+        if (view->row_step == 1 && view->first_row % VIEW_WORD_BITS == 0) {
+            const uint64_t *in_place = bits + view->first_row / VIEW_WORD_BITS;
+            const size_t missing = count_missing(in_place, rows);
+            if (out_null_count)
+                *out_null_count = missing;
+            *out_bits = missing > 0 ? in_place : NULL;
+            return DATAFRAME_SUCCESS;
+        }
+    }
+
+    size_t missing = 0;
+    if (scratch)
+        memset(scratch, 0, (rows + VIEW_WORD_BITS - 1) / VIEW_WORD_BITS * sizeof(uint64_t));
+    for (size_t r = 0; r < rows; r++) {
+        if (dataframe_view_cell_is_null(view, (int)r, col))
+            missing++;
+        else if (scratch)
+            scratch[r / VIEW_WORD_BITS] |= (uint64_t)1 << (r % VIEW_WORD_BITS);
+    }
+
+    if (out_null_count)
+        *out_null_count = missing;
+    if (missing == 0)
+        return DATAFRAME_SUCCESS;
+    /* Without scratch the missing rows cannot be reported, which must not read as all-valid */
+    if (!scratch)
+        return DATAFRAME_ERR_ALLOCATION_FAILED;
+    *out_bits = scratch;
+    return DATAFRAME_SUCCESS;
+}
@@ -0,0 +1,232 @@
+#include "date_parser.h"
+
+#include <string.h>
+
+/**
+ * @brief Length of a YYYY-MM-DD date.
+ */
+#define ISO_DATE_LENGTH 10
+
+/**
+ * @brief Length of a YYYY-MM-DDTHH:MM:SS timestamp without fraction or zone.
+ */
+#define ISO_TIMESTAMP_LENGTH 19
+
+/**
+ * @brief Nanoseconds per second.
+ */
+#define NANOS_PER_SECOND INT64_C(1000000000)
+
+/**
+ * @brief Nanoseconds per day.
+ */
+#define NANOS_PER_DAY (INT64_C(86400) * NANOS_PER_SECOND)
+
+/*
+ * Fixed-width fields are checked eight bytes at a time (SWAR): a word is
+ * loaded in little-endian order so byte i of the text sits in bits 8i..8i+7,
+ * then the separator bytes are compared against a template and all digit
+ * bytes are range-checked with a few masked additions. A 10-byte date is too
+ * short for a 16-byte vector load that stays inside the field, and 64-bit
+ * words need no intrinsics, so the same code runs on every compiler.
+ */
+
+/** @brief Digit positions of "YYYY-MM-" (bytes 0-3, 5, 6). */
+#define SWAR_DATE_HEAD_DIGITS UINT64_C(0x00FFFF00FFFFFFFF)
+/** @brief Separators of "YYYY-MM-" ('-' at bytes 4 and 7). */
+#define SWAR_DATE_HEAD_SEPARATORS UINT64_C(0x2D00002D00000000)
+/** @brief Digit positions of "YY-MM-DD" and "HH:MM:SS" (bytes 0, 1, 3, 4, 6, 7). */
+#define SWAR_PAIR_DIGITS UINT64_C(0xFFFF00FFFF00FFFF)
+/** @brief Separators of "YY-MM-DD" ('-' at bytes 2 and 5). */
+#define SWAR_DATE_TAIL_SEPARATORS UINT64_C(0x00002D00002D0000)
+/** @brief Separators of "HH:MM:SS" (':' at bytes 2 and 5). */
+#define SWAR_TIME_SEPARATORS UINT64_C(0x00003A00003A0000)
+
+/**
+ * @brief Loads eight bytes as a little-endian word.
+ * @param str The first byte.
+ * @return The word with str[0] in the least significant byte.
+ */
+static inline uint64_t load_le64(const char *str)
+{
+    uint64_t word;
+    memcpy(&word, str, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+/**
+ * @brief Checks a word against a fixed layout of digits and separators.
+ * @param word The little-endian word.
+ * @param digits Mask with 0xFF in every byte that must be an ASCII digit.
+ * @param separators The exact value of every other byte.
+ * @return true if the word matches the layout.
+ */
+static inline bool
+swar_matches(const uint64_t word, const uint64_t digits, const uint64_t separators)
+{
+    const uint64_t high_nibbles = UINT64_C(0xF0F0F0F0F0F0F0F0) & digits;
+    const uint64_t zeros = UINT64_C(0x3030303030303030) & digits;
+
+    if ((word & ~digits) != separators || (word & high_nibbles) != zeros)
+        return false;
+    /* Digit bytes are now 0x30-0x3F, so adding 6 cannot carry and leaves 0x3_ only for 0-9 */
+    return ((word + (UINT64_C(0x0606060606060606) & digits)) & high_nibbles) == zeros;
+}
+
+/**
+ * @brief Reads the two-digit number at a byte position of a validated word.
+ * @param word The little-endian word.
+ * @param byte The position of the tens digit.
+ * @return The value, 0 to 99.
+ */
+static inline int swar_pair(const uint64_t word, const int byte)
+{
+    const int tens = (int)((word >> (8 * byte)) & 0x0F);
+    const int ones = (int)((word >> (8 * (byte + 1))) & 0x0F);
+    return tens * 10 + ones;
+}
+
+/**
+ * @brief Checks whether a year is a leap year in the Gregorian calendar.
+ * @param year The year.
+ * @return true for leap years.
+ */
+static bool is_leap_year(const int64_t year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+/**
+ * @brief Returns the number of days in a month.
+ * @param year The year (matters for February).
+ * @param month The month, 1 to 12.
+ * @return The number of days.
+ */
+static int days_in_month(const int64_t year, const int month)
+{
+    static const int DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && is_leap_year(year) ? 29 : DAYS[month - 1];
+}
+
+/**
+ * @brief Converts the first ten bytes of a field, which must form YYYY-MM-DD, to a day count.
+ * @param str The first character of the date (at least ten readable bytes).
+ * @param out_days Receives the number of days since 1970-01-01.
+ * @return true if the bytes form a valid calendar date.
+ */
+static bool parse_fixed_date(const char *str, int64_t *out_days)
+{
+    const uint64_t head = load_le64(str);
+    const uint64_t tail = load_le64(str + 2);
+
+    if (!swar_matches(head, SWAR_DATE_HEAD_DIGITS, SWAR_DATE_HEAD_SEPARATORS) ||
+        !swar_matches(tail, SWAR_PAIR_DIGITS, SWAR_DATE_TAIL_SEPARATORS))
+        return false;
+
+    const int year = swar_pair(head, 0) * 100 + swar_pair(head, 2);
+    const int month = swar_pair(head, 5);
+    const int day = swar_pair(tail, 6);
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month))
+        return false;
+
+    *out_days = date_from_civil(year, month, day);
+    return true;
+}
+
+bool parse_date_span(const char *begin, const char *end, int64_t *out_days)
+{
+    if (!begin || !end || end - begin != ISO_DATE_LENGTH || !out_days)
+        return false;
+
+    return parse_fixed_date(begin, out_days);
+}
+
+bool parse_timestamp_span(const char *begin, const char *end, int64_t *out_nanos)
+{
+    if (!begin || !end || end - begin < ISO_DATE_LENGTH || !out_nanos)
+        return false;
+
+    int64_t days;
+    if (!parse_fixed_date(begin, &days))
+        return false;
+
+    /* Nanosecond timestamps cover roughly the years 1677 to 2262 */
+    if (days < INT64_MIN / NANOS_PER_DAY || days > INT64_MAX / NANOS_PER_DAY)
+        return false;
+
+    int64_t nanos = 0;
+    const char *cur = begin + ISO_DATE_LENGTH;
+
+    if (cur != end) {
+        if (end - begin < ISO_TIMESTAMP_LENGTH || (*cur != 'T' && *cur != ' '))
+            return false;
+
+        const uint64_t time = load_le64(begin + ISO_TIMESTAMP_LENGTH - 8);
+        if (!swar_matches(time, SWAR_PAIR_DIGITS, SWAR_TIME_SEPARATORS))
+            return false;
+
+        const int hour = swar_pair(time, 0);
+        const int minute = swar_pair(time, 3);
+        const int second = swar_pair(time, 6);
+        if (hour > 23 || minute > 59 || second > 59)
+            return false;
+        nanos = ((int64_t)hour * 3600 + minute * 60 + second) * NANOS_PER_SECOND;
+        cur = begin + ISO_TIMESTAMP_LENGTH;
+
+        if (cur != end && *cur == '.') {
+            int64_t scale = NANOS_PER_SECOND;
+            const char *digits = ++cur;
+            while (cur != end && *cur >= '0' && *cur <= '9' && cur - digits < 9) {
+                scale /= 10;
+                nanos += (*cur - '0') * scale;
+                cur++;
+            }
+            if (cur == digits)
+                return false;
+        }
+        if (cur != end && *cur == 'Z')
+            cur++;
+        if (cur != end)
+            return false;
+    }
+
+    /* The time of day can still push the last representable day past INT64_MAX */
+    const int64_t day_start = days * NANOS_PER_DAY;
+    if (day_start > INT64_MAX - nanos)
+        return false;
+
+    *out_nanos = day_start + nanos;
+    return true;
+}
+
+int64_t date_from_civil(int64_t year, const int month, const int day)
+{
+    /* Counts from 0000-03-01 in 400-year eras so leap days fall at the end of each year */
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t year_of_era = year - era * 400;
+    const int64_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int64_t day_of_era =
+        year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+void date_to_civil(int64_t days, int64_t *out_year, int *out_month, int *out_day)
+{
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t day_of_era = days - era * 146097;
+    const int64_t year_of_era =
+        (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const int64_t day_of_year =
+        day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const int64_t shifted_month = (5 * day_of_year + 2) / 153;
+    const int month = (int)(shifted_month < 10 ? shifted_month + 3 : shifted_month - 9);
+
+    *out_day = (int)(day_of_year - (153 * shifted_month + 2) / 5 + 1);
+    *out_month = month;
+    *out_year = year_of_era + era * 400 + (month <= 2);
+}
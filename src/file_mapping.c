@@ -0,0 +1,222 @@
+#include "file_mapping.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Reads a stream until EOF into a geometrically growing heap buffer.
+ *
+ * Used for inputs that cannot be memory-mapped. The buffer is always
+ * null-terminated so callers may treat it as a C string if needed.
+ *
+ * @param file The stream to drain. It is not closed by this function.
+ * @param out_mapping Mapping structure that receives the buffer and its size.
+ * @return FILE_MAPPING_SUCCESS or an error code on read/allocation failure.
+ */
+static FileMappingErrorCode read_stream_fully(FILE *file, FileMapping *out_mapping)
+{
+    size_t capacity = 64 * 1024;
+    size_t length = 0;
+    char *buffer = malloc(capacity + 1);
+    if (!buffer)
+        return FILE_MAPPING_ERR_ALLOCATION_FAILED;
+
+    for (;;) {
+        if (length == capacity) {
+            const size_t new_cap = capacity * 2;
+            char *tmp = realloc(buffer, new_cap + 1);
+            if (!tmp) {
+                free(buffer);
+                return FILE_MAPPING_ERR_ALLOCATION_FAILED;
+            }
+            buffer = tmp;
+            capacity = new_cap;
+        }
+
+        const size_t got = fread(buffer + length, 1, capacity - length, file);
+        length += got;
+
+        if (got == 0) {
+            if (ferror(file)) {
+                free(buffer);
+                return FILE_MAPPING_ERR_READ_FAILED;
+            }
+            break;
+        }
+    }
+
+    buffer[length] = '\0';
+    out_mapping->data = buffer;
+    out_mapping->size = length;
+    out_mapping->is_mapped = false;
+    return FILE_MAPPING_SUCCESS;
+}
+
+#if defined(_WIN32)
+
+/**
+ * @brief Maps a file read-only or copy-on-write, falling back to a heap buffer.
+ * @param path The path of the file to open.
+ * @param copy_on_write Whether pages of the mapping may be written privately.
+ * @param out_mapping Pointer to the structure that receives the mapping.
+ * @return FILE_MAPPING_SUCCESS on success, or an appropriate FileMappingErrorCode.
+ */
+static FileMappingErrorCode
+open_mapping(const char *path, const bool copy_on_write, FileMapping *out_mapping)
+{
+    if (!path || !out_mapping)
+        return FILE_MAPPING_ERR_OPEN_FAILED;
+    memset(out_mapping, 0, sizeof(*out_mapping));
+
+    HANDLE file = CreateFileA(path,
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              NULL,
+                              OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN,
+                              NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return FILE_MAPPING_ERR_OPEN_FAILED;
+
+    LARGE_INTEGER size;
+    if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &size)) {
+        if (size.QuadPart == 0) {
+            CloseHandle(file);
+            return FILE_MAPPING_SUCCESS;
+        }
+
+        HANDLE mapping = CreateFileMappingA(
+            file, NULL, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            const void *view =
+                MapViewOfFile(mapping, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+            if (view) {
+                out_mapping->data = view;
+                out_mapping->size = (size_t)size.QuadPart;
+                out_mapping->is_mapped = true;
+                out_mapping->os_file = file;
+                out_mapping->os_mapping = mapping;
+                return FILE_MAPPING_SUCCESS;
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+
+    /* Mapping is not possible (pipe, device, ...): fall back to sequential reads */
+    FILE *stream = fopen(path, "rb");
+    if (!stream)
+        return FILE_MAPPING_ERR_OPEN_FAILED;
+
+    const FileMappingErrorCode err = read_stream_fully(stream, out_mapping);
+    fclose(stream);
+    return err;
+}
+
+void file_mapping_close(FileMapping *mapping)
+{
+    if (!mapping)
+        return;
+
+    if (mapping->is_mapped) {
+        UnmapViewOfFile(mapping->data);
+        CloseHandle((HANDLE)mapping->os_mapping);
+        CloseHandle((HANDLE)mapping->os_file);
+    } else {
+        free((void *)mapping->data);
+    }
+
+    memset(mapping, 0, sizeof(*mapping));
+}
+
+#else
+
+/**
+ * @brief Maps a file read-only or copy-on-write, falling back to a heap buffer.
+ * @param path The path of the file to open.
+ * @param copy_on_write Whether pages of the mapping may be written privately.
+ * @param out_mapping Pointer to the structure that receives the mapping.
+ * @return FILE_MAPPING_SUCCESS on success, or an appropriate FileMappingErrorCode.
+ */
+static FileMappingErrorCode
+open_mapping(const char *path, const bool copy_on_write, FileMapping *out_mapping)
+{
+    if (!path || !out_mapping)
+        return FILE_MAPPING_ERR_OPEN_FAILED;
+    memset(out_mapping, 0, sizeof(*out_mapping));
+
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return FILE_MAPPING_ERR_OPEN_FAILED;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        if (st.st_size == 0) {
+            close(fd);
+            return FILE_MAPPING_SUCCESS;
+        }
+
+        const int protection = copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+        void *view = mmap(NULL, (size_t)st.st_size, protection, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+#if defined(MADV_SEQUENTIAL)
+            /* Copy-on-write mappings hold binary data that is accessed column by column */
+            if (!copy_on_write)
+                madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+            /* The mapping stays valid after the descriptor is closed */
+            close(fd);
+            out_mapping->data = view;
+            out_mapping->size = (size_t)st.st_size;
+            out_mapping->is_mapped = true;
+            return FILE_MAPPING_SUCCESS;
+        }
+    }
+
+    /* Mapping is not possible (pipe, device, ...): fall back to sequential reads */
+    FILE *stream = fdopen(fd, "rb");
+    if (!stream) {
+        close(fd);
+        return FILE_MAPPING_ERR_OPEN_FAILED;
+    }
+
+    const FileMappingErrorCode err = read_stream_fully(stream, out_mapping);
+    fclose(stream);
+    return err;
+}
+
+void file_mapping_close(FileMapping *mapping)
+{
+    if (!mapping)
+        return;
+
+    if (mapping->is_mapped) {
+        munmap((void *)mapping->data, mapping->size);
+    } else {
+        free((void *)mapping->data);
+    }
+
+    memset(mapping, 0, sizeof(*mapping));
+}
+
+#endif
+
+FileMappingErrorCode file_mapping_open(const char *path, FileMapping *out_mapping)
+{
+    return open_mapping(path, false, out_mapping);
+}
+
+FileMappingErrorCode file_mapping_open_copy_on_write(const char *path, FileMapping *out_mapping)
+{
+    return open_mapping(path, true, out_mapping);
+}
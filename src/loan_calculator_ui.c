@@ -48,8 +48,12 @@ apply_custom_payment_schedule(const char *filepath, const int term_months, Money
         return;
     }
 
+    /* Schedules are reused across many simulations; later loads map the parsed sidecar */
+    CsvReadOptions options = csv_default_read_options();
+    options.use_cache = true;
+
     DataFrame *df = NULL;
-    const DataframeErrorCode err = read_csv(filepath, true, ",", &df);
+    const DataframeErrorCode err = read_csv_with_options(filepath, &options, &df);
 
     if (err != DATAFRAME_SUCCESS || !df) {
         printf("Warning: Could not load custom payment schedule from %s. Proceeding with standard "
@@ -1,5 +1,6 @@
 #include "memory_utils.h"
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,6 +9,31 @@
 #include <malloc.h>
 #endif
 
+/**
+ * @brief Size of the first block allocated by an arena.
+ */
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+/**
+ * @brief Upper bound for the geometric growth of arena blocks.
+ */
+#define ARENA_MAX_BLOCK_SIZE (4 * 1024 * 1024)
+
+/**
+ * @brief Alignment of the memory returned by arena_alloc, suitable for any object type.
+ */
+#define ARENA_ALIGNMENT _Alignof(max_align_t)
+
+/**
+ * @brief Header of an arena block; the usable bytes follow it directly.
+ */
+struct MemoryArenaBlock {
+    MemoryArenaBlock *next;            /*!< The next older block. */
+    size_t capacity;                   /*!< Number of usable bytes in the block. */
+    size_t used;                       /*!< Number of bytes already handed out. */
+    _Alignas(max_align_t) char data[]; /*!< The block's storage, aligned for any type. */
+};
+
 void *aligned_calloc(const size_t num, const size_t size, size_t alignment)
 {
     /* Validate input sizes to prevent zero-byte allocations */
@@ -75,3 +101,148 @@ void aligned_free(void *ptr)
     free(ptr);
 #endif
 }
+
+/**
+ * @brief Allocates a new arena block with at least the given capacity.
+ * @param capacity The number of usable bytes required.
+ * @return The new block, or NULL on allocation failure or overflow.
+ */
+static MemoryArenaBlock *arena_new_block(const size_t capacity)
+{
+    if (capacity > SIZE_MAX - sizeof(MemoryArenaBlock))
+        return NULL;
+
+    MemoryArenaBlock *block = malloc(sizeof(MemoryArenaBlock) + capacity);
+    if (!block)
+        return NULL;
+
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+    return block;
+}
+
+/**
+ * @brief Allocates memory from the arena at the given alignment.
+ *
+ * Every block starts at ARENA_ALIGNMENT, so only the offset into the head
+ * block needs rounding up.
+ *
+ * @param arena The arena to allocate from.
+ * @param size The number of bytes to allocate.
+ * @param alignment The byte boundary of the allocation (a power of 2 up to ARENA_ALIGNMENT).
+ * @return A pointer valid until the arena is reset or released, or NULL if allocation fails.
+ */
+static void *arena_alloc_aligned(MemoryArena *arena, const size_t size, const size_t alignment)
+{
+    if (!arena)
+        return NULL;
+
+    MemoryArenaBlock *head = arena->head;
+    if (head) {
+        const size_t offset = (head->used + alignment - 1) & ~(alignment - 1);
+        if (offset <= head->capacity && head->capacity - offset >= size) {
+            head->used = offset + size;
+            return head->data + offset;
+        }
+    }
+
+    if (arena->block_size == 0)
+        arena->block_size = ARENA_DEFAULT_BLOCK_SIZE;
+
+    if (head && size > arena->block_size / 4) {
+        /* Oversized requests get their own block behind the head, keeping its free space */
+        MemoryArenaBlock *block = arena_new_block(size);
+        if (!block)
+            return NULL;
+        block->used = size;
+        block->next = head->next;
+        head->next = block;
+        return block->data;
+    }
+
+    MemoryArenaBlock *block =
+        arena_new_block(size > arena->block_size ? size : arena->block_size);
+    if (!block)
+        return NULL;
+
+    if (arena->block_size < ARENA_MAX_BLOCK_SIZE)
+        arena->block_size *= 2;
+
+    block->next = head;
+    block->used = size;
+    arena->head = block;
+    return block->data;
+}
+
+void *arena_alloc(MemoryArena *arena, const size_t size)
+{
+    return arena_alloc_aligned(arena, size, ARENA_ALIGNMENT);
+}
+
+char *arena_strndup(MemoryArena *arena, const char *str, const size_t len)
+{
+    if (!str || len == SIZE_MAX)
+        return NULL;
+
+    /* Strings need no alignment, so they stay packed */
+    char *copy = arena_alloc_aligned(arena, len + 1, 1);
+    if (!copy)
+        return NULL;
+
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+void arena_reset(MemoryArena *arena)
+{
+    if (!arena || !arena->head)
+        return;
+
+    MemoryArenaBlock *block = arena->head->next;
+    while (block) {
+        MemoryArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    arena->head->next = NULL;
+    arena->head->used = 0;
+}
+
+void arena_adopt(MemoryArena *dst, MemoryArena *src)
+{
+    if (!dst || !src || dst == src || !src->head)
+        return;
+
+    if (!dst->head) {
+        dst->head = src->head;
+        if (dst->block_size < src->block_size)
+            dst->block_size = src->block_size;
+    } else {
+        /* Splice the adopted chain behind dst's head so allocation continues there */
+        MemoryArenaBlock *tail = src->head;
+        while (tail->next)
+            tail = tail->next;
+        tail->next = dst->head->next;
+        dst->head->next = src->head;
+    }
+
+    src->head = NULL;
+}
+
+void arena_release(MemoryArena *arena)
+{
+    if (!arena)
+        return;
+
+    MemoryArenaBlock *block = arena->head;
+    while (block) {
+        MemoryArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    arena->head = NULL;
+}
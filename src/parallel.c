@@ -0,0 +1,397 @@
+#include "parallel.h"
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief A background thread and the function it runs.
+ */
+struct ParallelThread {
+    ParallelThreadEntry entry; /*!< The function run by the thread. */
+    void *context;             /*!< Pointer handed to entry. */
+#if defined(_WIN32)
+    HANDLE handle; /*!< Win32 thread handle. */
+#else
+    pthread_t handle; /*!< POSIX thread handle. */
+#endif
+};
+
+/**
+ * @brief A bounded ring buffer of pointers guarded by a lock and two condition variables.
+ */
+struct ParallelQueue {
+    void **items;    /*!< Ring buffer of capacity slots. */
+    size_t capacity; /*!< Number of slots in items. */
+    size_t head;     /*!< Slot of the oldest item. */
+    size_t count;    /*!< Number of queued items. */
+    bool closed;     /*!< Whether parallel_queue_close has been called. */
+#if defined(_WIN32)
+    SRWLOCK lock;                 /*!< Guards every field above. */
+    CONDITION_VARIABLE not_empty; /*!< Signalled when an item is pushed or the queue closes. */
+    CONDITION_VARIABLE not_full;  /*!< Signalled when an item is popped or the queue closes. */
+#else
+    pthread_mutex_t lock;     /*!< Guards every field above. */
+    pthread_cond_t not_empty; /*!< Signalled when an item is pushed or the queue closes. */
+    pthread_cond_t not_full;  /*!< Signalled when an item is popped or the queue closes. */
+#endif
+};
+
+/**
+ * @brief The share of a parallel_for executed by one thread.
+ */
+typedef struct {
+    ParallelTask task;  /*!< The function executed for each task index. */
+    void *context;      /*!< Shared context handed to the task. */
+    size_t first;       /*!< First task index handled by this worker. */
+    size_t stride;      /*!< Distance between consecutive task indices of this worker. */
+    size_t task_count;  /*!< Total number of tasks. */
+} ParallelWorker;
+
+/**
+ * @brief Runs every task index assigned to a worker.
+ * @param worker The worker description.
+ */
+static void run_worker(const ParallelWorker *worker)
+{
+    for (size_t i = worker->first; i < worker->task_count; i += worker->stride) {
+        worker->task(worker->context, i);
+    }
+}
+
+#if defined(_WIN32)
+
+/**
+ * @brief Win32 thread entry point adapting run_worker.
+ */
+static DWORD WINAPI worker_entry(LPVOID arg)
+{
+    run_worker((const ParallelWorker *)arg);
+    return 0;
+}
+
+/**
+ * @brief Win32 thread entry point of a background thread.
+ */
+static DWORD WINAPI thread_entry(LPVOID arg)
+{
+    const ParallelThread *thread = arg;
+    thread->entry(thread->context);
+    return 0;
+}
+
+/** @brief Acquires the queue lock. */
+static void queue_lock(ParallelQueue *queue)
+{
+    AcquireSRWLockExclusive(&queue->lock);
+}
+
+/** @brief Releases the queue lock. */
+static void queue_unlock(ParallelQueue *queue)
+{
+    ReleaseSRWLockExclusive(&queue->lock);
+}
+
+/** @brief Releases the queue lock while waiting for a condition, then reacquires it. */
+static void queue_wait(ParallelQueue *queue, CONDITION_VARIABLE *condition)
+{
+    SleepConditionVariableSRW(condition, &queue->lock, INFINITE, 0);
+}
+
+/** @brief Wakes every thread waiting for a condition. */
+static void queue_wake_all(CONDITION_VARIABLE *condition)
+{
+    WakeAllConditionVariable(condition);
+}
+
+#else
+
+/**
+ * @brief POSIX thread entry point adapting run_worker.
+ */
+static void *worker_entry(void *arg)
+{
+    run_worker((const ParallelWorker *)arg);
+    return NULL;
+}
+
+/**
+ * @brief POSIX thread entry point of a background thread.
+ */
+static void *thread_entry(void *arg)
+{
+    const ParallelThread *thread = arg;
+    thread->entry(thread->context);
+    return NULL;
+}
+
+/** @brief Acquires the queue lock. */
+static void queue_lock(ParallelQueue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+}
+
+/** @brief Releases the queue lock. */
+static void queue_unlock(ParallelQueue *queue)
+{
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/** @brief Releases the queue lock while waiting for a condition, then reacquires it. */
+static void queue_wait(ParallelQueue *queue, pthread_cond_t *condition)
+{
+    pthread_cond_wait(condition, &queue->lock);
+}
+
+/** @brief Wakes every thread waiting for a condition. */
+static void queue_wake_all(pthread_cond_t *condition)
+{
+    pthread_cond_broadcast(condition);
+}
+
+#endif
+
+int parallel_hardware_threads(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    const long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return online > 0 ? (int)online : 1;
+#endif
+}
+
+bool parallel_for(const size_t task_count,
+                  int thread_count,
+                  const ParallelTask task,
+                  void *context)
+{
+    if (!task || task_count == 0)
+        return false;
+
+    if (thread_count <= 0)
+        thread_count = parallel_hardware_threads();
+    if ((size_t)thread_count > task_count)
+        thread_count = (int)task_count;
+
+    ParallelWorker *workers = NULL;
+    if (thread_count > 1)
+        workers = malloc((size_t)thread_count * sizeof(ParallelWorker));
+
+    if (!workers) {
+        const ParallelWorker serial = {task, context, 0, 1, task_count};
+        run_worker(&serial);
+        return false;
+    }
+
+#if defined(_WIN32)
+    HANDLE *threads = calloc((size_t)thread_count, sizeof(HANDLE));
+#else
+    pthread_t *threads = calloc((size_t)thread_count, sizeof(pthread_t));
+#endif
+    bool *started = calloc((size_t)thread_count, sizeof(bool));
+
+    for (int t = 0; t < thread_count; t++) {
+        workers[t].task = task;
+        workers[t].context = context;
+        workers[t].first = (size_t)t;
+        workers[t].stride = (size_t)thread_count;
+        workers[t].task_count = task_count;
+    }
+
+    /* Worker 0 runs on the calling thread; the others get their own threads if possible */
+    int spawned = 0;
+    if (threads && started) {
+        for (int t = 1; t < thread_count; t++) {
+#if defined(_WIN32)
+            threads[t] = CreateThread(NULL, 0, worker_entry, &workers[t], 0, NULL);
+            started[t] = threads[t] != NULL;
+#else
+            started[t] = pthread_create(&threads[t], NULL, worker_entry, &workers[t]) == 0;
+#endif
+            if (started[t])
+                spawned++;
+        }
+    }
+
+    run_worker(&workers[0]);
+
+    for (int t = 1; t < thread_count; t++) {
+        if (started && started[t]) {
+#if defined(_WIN32)
+            WaitForSingleObject(threads[t], INFINITE);
+            CloseHandle(threads[t]);
+#else
+            pthread_join(threads[t], NULL);
+#endif
+        } else {
+            run_worker(&workers[t]);
+        }
+    }
+
+    free(started);
+    free(threads);
+    free(workers);
+    return spawned > 0;
+}
+
+ParallelThread *parallel_thread_start(const ParallelThreadEntry entry, void *context)
+{
+    if (!entry)
+        return NULL;
+
+    ParallelThread *thread = malloc(sizeof(ParallelThread));
+    if (!thread)
+        return NULL;
+    thread->entry = entry;
+    thread->context = context;
+
+#if defined(_WIN32)
+    thread->handle = CreateThread(NULL, 0, thread_entry, thread, 0, NULL);
+    const bool started = thread->handle != NULL;
+#else
+    const bool started = pthread_create(&thread->handle, NULL, thread_entry, thread) == 0;
+#endif
+    if (!started) {
+        free(thread);
+        return NULL;
+    }
+    return thread;
+}
+
+void parallel_thread_join(ParallelThread *thread)
+{
+    if (!thread)
+        return;
+
+#if defined(_WIN32)
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+    free(thread);
+}
+
+ParallelQueue *parallel_queue_create(const size_t capacity)
+{
+    ParallelQueue *queue = calloc(1, sizeof(ParallelQueue));
+    if (!queue)
+        return NULL;
+
+    queue->capacity = capacity > 0 ? capacity : 1;
+    queue->items = malloc(queue->capacity * sizeof(void *));
+    if (!queue->items) {
+        free(queue);
+        return NULL;
+    }
+
+#if defined(_WIN32)
+    InitializeSRWLock(&queue->lock);
+    InitializeConditionVariable(&queue->not_empty);
+    InitializeConditionVariable(&queue->not_full);
+#else
+    if (pthread_mutex_init(&queue->lock, NULL) != 0) {
+        free(queue->items);
+        free(queue);
+        return NULL;
+    }
+    if (pthread_cond_init(&queue->not_empty, NULL) != 0) {
+        pthread_mutex_destroy(&queue->lock);
+        free(queue->items);
+        free(queue);
+        return NULL;
+    }
+    if (pthread_cond_init(&queue->not_full, NULL) != 0) {
+        pthread_cond_destroy(&queue->not_empty);
+        pthread_mutex_destroy(&queue->lock);
+        free(queue->items);
+        free(queue);
+        return NULL;
+    }
+#endif
+    return queue;
+}
+
+bool parallel_queue_push(ParallelQueue *queue, void *item)
+{
+    if (!queue || !item)
+        return false;
+
+    queue_lock(queue);
+    while (queue->count == queue->capacity && !queue->closed) {
+        queue_wait(queue, &queue->not_full);
+    }
+
+    const bool accepted = !queue->closed;
+    if (accepted) {
+        queue->items[(queue->head + queue->count) % queue->capacity] = item;
+        queue->count++;
+        queue_wake_all(&queue->not_empty);
+    }
+    queue_unlock(queue);
+    return accepted;
+}
+
+void *parallel_queue_pop(ParallelQueue *queue)
+{
+    if (!queue)
+        return NULL;
+
+    queue_lock(queue);
+    while (queue->count == 0 && !queue->closed) {
+        queue_wait(queue, &queue->not_empty);
+    }
+
+    void *item = NULL;
+    if (queue->count > 0) {
+        item = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        queue_wake_all(&queue->not_full);
+    }
+    queue_unlock(queue);
+    return item;
+}
+
+void parallel_queue_close(ParallelQueue *queue)
+{
+    if (!queue)
+        return;
+
+    queue_lock(queue);
+    queue->closed = true;
+    queue_wake_all(&queue->not_empty);
+    queue_wake_all(&queue->not_full);
+    queue_unlock(queue);
+}
+
+void parallel_queue_free(ParallelQueue *queue)
+{
+    if (!queue)
+        return;
+
+#if !defined(_WIN32)
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->lock);
+#endif
+    free(queue->items);
+    free(queue);
+}
+
+long parallel_atomic_add(volatile long *counter, const long delta)
+{
+#if defined(_WIN32)
+    return InterlockedExchangeAdd(counter, delta) + delta;
+#else
+    return __atomic_add_fetch(counter, delta, __ATOMIC_SEQ_CST);
+#endif
+}
@@ -1,6 +1,12 @@
 #include "statistics.h"
 
 #include <math.h>
+#include <stdbool.h>
+
+/**
+ * @brief Number of elements covered by one word of a validity bitmap.
+ */
+#define VALIDITY_WORD_BITS 64
 
 /**
  * @brief Internal helper using Welford's online algorithm for computing variance.
@@ -51,6 +57,259 @@ static StatisticsErrorCode calculate_welford_stats(const double *restrict data,
     return STATS_SUCCESS;
 }
 
+/**
+ * @brief Returns the bits of a validity word that belong to existing elements.
+ * @param length Total number of elements in the series.
+ * @param start Index of the first element covered by the word.
+ * @return All ones for a full word, only the low (length - start) bits for the last one.
+ */
+static uint64_t word_range(const size_t length, const size_t start)
+{
+    const size_t n = length - start;
+    return n >= VALIDITY_WORD_BITS ? ~(uint64_t)0 : ((uint64_t)1 << n) - 1;
+}
+
+/**
+ * @brief Returns the validity of the elements covered by one bitmap word.
+ * @param validity The validity bitmap, or NULL if every element is valid.
+ * @param length Total number of elements in the series.
+ * @param start Index of the first element covered by the word (a multiple of 64).
+ * @return The word, restricted to existing elements.
+ */
+static uint64_t validity_word(const uint64_t *validity, const size_t length, const size_t start)
+{
+    const uint64_t range = word_range(length, start);
+    return validity ? validity[start / VALIDITY_WORD_BITS] & range : range;
+}
+
+/**
+ * @brief Checks the validity bit of one element.
+ * @param validity The validity bitmap, or NULL if every element is valid.
+ * @param index The element index.
+ * @return true if the element holds a value.
+ */
+static inline bool element_is_valid(const uint64_t *validity, const size_t index)
+{
+    return !validity || (validity[index / VALIDITY_WORD_BITS] >> (index % VALIDITY_WORD_BITS) & 1u);
+}
+
+/**
+ * @brief Checks whether a validity bitmap reports no missing element at all.
+ * @param validity The validity bitmap, or NULL.
+ * @param length Total number of elements in the series.
+ * @return true if every element is valid.
+ */
+static bool validity_is_full(const uint64_t *validity, const size_t length)
+{
+    for (size_t start = 0; validity && start < length; start += VALIDITY_WORD_BITS) {
+        if (validity_word(validity, length, start) != word_range(length, start))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Counts the set bits of a word.
+ * @param bits The word.
+ * @return The number of set bits.
+ */
+static size_t count_bits(uint64_t bits)
+{
+    bits = bits - (bits >> 1 & 0x5555555555555555ULL);
+    bits = (bits & 0x3333333333333333ULL) + (bits >> 2 & 0x3333333333333333ULL);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (size_t)(bits * 0x0101010101010101ULL >> 56);
+}
+
+/**
+ * @brief Summarizes the valid elements of a block of at most 64 values.
+ *
+ * Two passes over the block compute the mean and then the squared deviations
+ * from it. A full block is summed with four independent accumulators and no
+ * per-element test, so both loops vectorize; a partial block selects its
+ * elements with the mask instead.
+ *
+ * @param data The block's values.
+ * @param mask Validity of the block's elements (must not be zero).
+ * @param n Number of elements in the block.
+ * @param out Receives the block's count, mean and M2.
+ */
+static void block_statistics(const double *restrict data,
+                             const uint64_t mask,
+                             const size_t n,
+                             RunningStatistics *restrict out)
+{
+    const size_t count = count_bits(mask);
+    double sum[4] = {0.0, 0.0, 0.0, 0.0};
+    double sum_sq_diff[4] = {0.0, 0.0, 0.0, 0.0};
+
+    if (count == n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            for (size_t lane = 0; lane < 4; lane++) {
+                sum[lane] += data[i + lane];
+            }
+        }
+        for (; i < n; i++) {
+            sum[0] += data[i];
+        }
+        const double mean = (sum[0] + sum[1] + sum[2] + sum[3]) / (double)n;
+
+        for (i = 0; i + 4 <= n; i += 4) {
+            for (size_t lane = 0; lane < 4; lane++) {
+                const double delta = data[i + lane] - mean;
+                sum_sq_diff[lane] += delta * delta;
+            }
+        }
+        for (; i < n; i++) {
+            sum_sq_diff[0] += (data[i] - mean) * (data[i] - mean);
+        }
+        out->mean = mean;
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            sum[0] += mask >> i & 1u ? data[i] : 0.0;
+        }
+        const double mean = sum[0] / (double)count;
+
+        for (size_t i = 0; i < n; i++) {
+            const double delta = mask >> i & 1u ? data[i] - mean : 0.0;
+            sum_sq_diff[0] += delta * delta;
+        }
+        out->mean = mean;
+    }
+
+    out->count = count;
+    out->m2 = sum_sq_diff[0] + sum_sq_diff[1] + sum_sq_diff[2] + sum_sq_diff[3];
+}
+
+/**
+ * @brief Mergeable accumulator of the co-moments of two series.
+ */
+typedef struct {
+    size_t count;  /*!< Number of pairs accumulated. */
+    double mean_x; /*!< Mean of the x values. */
+    double mean_y; /*!< Mean of the y values. */
+    double m2_x;   /*!< Sum of squared differences of x from its mean. */
+    double m2_y;   /*!< Sum of squared differences of y from its mean. */
+    double c_xy;   /*!< Sum of products of the differences of x and y from their means. */
+} PairStatistics;
+
+/**
+ * @brief Summarizes the pairs of a block of at most 64 values valid in both series.
+ * @param data_x The block's x values.
+ * @param data_y The block's y values.
+ * @param mask Validity of the block's pairs (must not be zero).
+ * @param n Number of elements in the block.
+ * @param out Receives the block's co-moments.
+ */
+static void block_pair_statistics(const double *restrict data_x,
+                                  const double *restrict data_y,
+                                  const uint64_t mask,
+                                  const size_t n,
+                                  PairStatistics *restrict out)
+{
+    const size_t count = count_bits(mask);
+    const bool full = count == n;
+    double sum_x = 0.0;
+    double sum_y = 0.0;
+
+    /* Without a mask test the loops vectorize; partial blocks select pair by pair */
+    if (full) {
+        for (size_t i = 0; i < n; i++) {
+            sum_x += data_x[i];
+            sum_y += data_y[i];
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            const bool valid = mask >> i & 1u;
+            sum_x += valid ? data_x[i] : 0.0;
+            sum_y += valid ? data_y[i] : 0.0;
+        }
+    }
+    const double mean_x = sum_x / (double)count;
+    const double mean_y = sum_y / (double)count;
+
+    double m2_x = 0.0;
+    double m2_y = 0.0;
+    double c_xy = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const bool valid = full || (mask >> i & 1u);
+        const double delta_x = valid ? data_x[i] - mean_x : 0.0;
+        const double delta_y = valid ? data_y[i] - mean_y : 0.0;
+        m2_x += delta_x * delta_x;
+        m2_y += delta_y * delta_y;
+        c_xy += delta_x * delta_y;
+    }
+
+    out->count = count;
+    out->mean_x = mean_x;
+    out->mean_y = mean_y;
+    out->m2_x = m2_x;
+    out->m2_y = m2_y;
+    out->c_xy = c_xy;
+}
+
+/**
+ * @brief Combines two pair accumulators (the bivariate form of Chan et al.'s update).
+ * @param acc The accumulator receiving the combined result.
+ * @param other The accumulator to fold into acc.
+ */
+static void pair_statistics_merge(PairStatistics *restrict acc,
+                                  const PairStatistics *restrict other)
+{
+    if (other->count == 0)
+        return;
+    if (acc->count == 0) {
+        *acc = *other;
+        return;
+    }
+
+    const double n_a = (double)acc->count;
+    const double n_b = (double)other->count;
+    const double total = n_a + n_b;
+    const double delta_x = other->mean_x - acc->mean_x;
+    const double delta_y = other->mean_y - acc->mean_y;
+    const double weight = n_a * n_b / total;
+
+    acc->mean_x += delta_x * n_b / total;
+    acc->mean_y += delta_y * n_b / total;
+    acc->m2_x += other->m2_x + delta_x * delta_x * weight;
+    acc->m2_y += other->m2_y + delta_y * delta_y * weight;
+    acc->c_xy += other->c_xy + delta_x * delta_y * weight;
+    acc->count += other->count;
+}
+
+/**
+ * @brief Accumulates the co-moments of the pairs valid in both validity bitmaps.
+ * @param data_x First array of input values.
+ * @param validity_x Validity bitmap of data_x, or NULL.
+ * @param data_y Second array of input values.
+ * @param validity_y Validity bitmap of data_y, or NULL.
+ * @param length Number of elements in both arrays.
+ * @param out Receives the co-moments.
+ */
+static void accumulate_pairs(const double *restrict data_x,
+                             const uint64_t *restrict validity_x,
+                             const double *restrict data_y,
+                             const uint64_t *restrict validity_y,
+                             const size_t length,
+                             PairStatistics *restrict out)
+{
+    *out = (PairStatistics){0};
+
+    for (size_t start = 0; start < length; start += VALIDITY_WORD_BITS) {
+        const uint64_t mask = validity_word(validity_x, length, start) &
+                              validity_word(validity_y, length, start);
+        if (!mask)
+            continue;
+
+        const size_t n = length - start < VALIDITY_WORD_BITS ? length - start : VALIDITY_WORD_BITS;
+        PairStatistics block;
+        block_pair_statistics(data_x + start, data_y + start, mask, n, &block);
+        pair_statistics_merge(out, &block);
+    }
+}
+
 StatisticsErrorCode calculate_series_statistics(const double *restrict data,
                                                 const size_t length,
                                                 SeriesStatistics *restrict out_stats)
@@ -79,6 +338,130 @@ StatisticsErrorCode calculate_series_statistics(const double *restrict data,
     return STATS_SUCCESS;
 }
 
+StatisticsErrorCode calculate_series_statistics_masked(const double *restrict data,
+                                                       const uint64_t *restrict validity,
+                                                       const size_t length,
+                                                       SeriesStatistics *restrict out_stats)
+{
+    if (!out_stats)
+        return STATS_ERR_NULL_POINTER;
+
+    RunningStatistics acc;
+    running_statistics_reset(&acc);
+
+    const StatisticsErrorCode err = running_statistics_update_masked(&acc, data, validity, length);
+    if (err != STATS_SUCCESS)
+        return err;
+    return running_statistics_finalize(&acc, out_stats);
+}
+
+void running_statistics_reset(RunningStatistics *acc)
+{
+    if (!acc)
+        return;
+    acc->count = 0;
+    acc->mean = 0.0;
+    acc->m2 = 0.0;
+}
+
+void running_statistics_add(RunningStatistics *acc, const double value)
+{
+    if (!acc)
+        return;
+
+    acc->count++;
+    const double delta = value - acc->mean;
+    acc->mean += delta / (double)acc->count;
+    acc->m2 += delta * (value - acc->mean);
+}
+
+void running_statistics_merge(RunningStatistics *restrict acc,
+                              const RunningStatistics *restrict other)
+{
+    if (!acc || !other || other->count == 0)
+        return;
+
+    if (acc->count == 0) {
+        *acc = *other;
+        return;
+    }
+
+    const double n_a = (double)acc->count;
+    const double n_b = (double)other->count;
+    const double total = n_a + n_b;
+    const double delta = other->mean - acc->mean;
+
+    acc->mean += delta * n_b / total;
+    acc->m2 += other->m2 + delta * delta * n_a * n_b / total;
+    acc->count += other->count;
+}
+
+StatisticsErrorCode running_statistics_update(RunningStatistics *restrict acc,
+                                              const double *restrict data,
+                                              const size_t length)
+{
+    if (!acc)
+        return STATS_ERR_NULL_POINTER;
+
+    RunningStatistics batch;
+    const StatisticsErrorCode err =
+        calculate_welford_stats(data, length, &batch.mean, &batch.m2, &batch.count);
+
+    /* A batch without valid values leaves the accumulator untouched */
+    if (err == STATS_ERR_INSUFFICIENT_DATA)
+        return STATS_SUCCESS;
+    if (err != STATS_SUCCESS)
+        return err;
+
+    running_statistics_merge(acc, &batch);
+    return STATS_SUCCESS;
+}
+
+StatisticsErrorCode running_statistics_update_masked(RunningStatistics *restrict acc,
+                                                     const double *restrict data,
+                                                     const uint64_t *restrict validity,
+                                                     const size_t length)
+{
+    if (!acc || !data)
+        return STATS_ERR_NULL_POINTER;
+    if (length == 0)
+        return STATS_ERR_INVALID_LENGTH;
+
+    /* Each bitmap word selects a block, which is summarized on its own and merged */
+    for (size_t start = 0; start < length; start += VALIDITY_WORD_BITS) {
+        const uint64_t mask = validity_word(validity, length, start);
+        if (!mask)
+            continue;
+
+        const size_t n = length - start < VALIDITY_WORD_BITS ? length - start : VALIDITY_WORD_BITS;
+        RunningStatistics block;
+        block_statistics(data + start, mask, n, &block);
+        running_statistics_merge(acc, &block);
+    }
+    return STATS_SUCCESS;
+}
+
+StatisticsErrorCode running_statistics_finalize(const RunningStatistics *restrict acc,
+                                                SeriesStatistics *restrict out_stats)
+{
+    if (!acc || !out_stats)
+        return STATS_ERR_NULL_POINTER;
+    if (acc->count == 0)
+        return STATS_ERR_INSUFFICIENT_DATA;
+
+    out_stats->mean = acc->mean;
+
+    if (acc->count > 1) {
+        out_stats->variance = acc->m2 / (double)(acc->count - 1);
+        out_stats->standard_deviation = sqrt(out_stats->variance);
+    } else {
+        out_stats->variance = NAN;
+        out_stats->standard_deviation = NAN;
+    }
+
+    return STATS_SUCCESS;
+}
+
 StatisticsErrorCode calculate_sma(const double *restrict data,
                                   const size_t length,
                                   const int period,
@@ -118,6 +501,67 @@ StatisticsErrorCode calculate_sma(const double *restrict data,
     return STATS_SUCCESS;
 }
 
+/**
+ * @brief Sums the values of one window.
+ * @param data The first value of the window.
+ * @param period The number of values in the window.
+ * @return The sum.
+ */
+static double window_sum(const double *restrict data, const size_t period)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < period; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+StatisticsErrorCode calculate_sma_masked(const double *restrict data,
+                                         const uint64_t *restrict validity,
+                                         const size_t length,
+                                         const int period,
+                                         double *restrict out_sma)
+{
+    if (!data || !out_sma)
+        return STATS_ERR_NULL_POINTER;
+    if (length == 0)
+        return STATS_ERR_INVALID_LENGTH;
+    if (period <= 0)
+        return STATS_ERR_INVALID_PERIOD;
+    if (length < (size_t)period)
+        return STATS_ERR_INSUFFICIENT_DATA;
+
+    const size_t u_period = (size_t)period;
+    const bool all_valid = validity_is_full(validity, length);
+    double sum = 0.0;
+    size_t null_count = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        if (all_valid || element_is_valid(validity, i))
+            sum += data[i];
+        else
+            null_count++;
+
+        if (i >= u_period) {
+            if (all_valid || element_is_valid(validity, i - u_period))
+                sum -= data[i - u_period];
+            else
+                null_count--;
+        }
+
+        if (i < u_period - 1 || null_count > 0) {
+            out_sma[i] = NAN;
+            continue;
+        }
+
+        /* A NaN or infinite value poisons the running sum even after leaving the window */
+        if (!isfinite(sum))
+            sum = window_sum(data + i + 1 - u_period, u_period);
+        out_sma[i] = sum / (double)period;
+    }
+    return STATS_SUCCESS;
+}
+
 StatisticsErrorCode calculate_ema(const double *restrict data,
                                   const size_t length,
                                   const int period,
@@ -167,6 +611,67 @@ StatisticsErrorCode calculate_ema(const double *restrict data,
     return STATS_SUCCESS;
 }
 
+StatisticsErrorCode calculate_ema_masked(const double *restrict data,
+                                         const uint64_t *restrict validity,
+                                         const size_t length,
+                                         const int period,
+                                         double *restrict out_ema)
+{
+    if (!data || !out_ema)
+        return STATS_ERR_NULL_POINTER;
+    if (period <= 0)
+        return STATS_ERR_INVALID_PERIOD;
+    if (length == 0 || length < (size_t)period)
+        return STATS_ERR_INSUFFICIENT_DATA;
+
+    const double multiplier = 2.0 / ((double)period + 1.0);
+    const size_t u_period = (size_t)period;
+
+    if (validity_is_full(validity, length)) {
+        /* One seed over the first window, then the recurrence without any test */
+        for (size_t i = 0; i < u_period - 1; i++) {
+            out_ema[i] = NAN;
+        }
+        double current_ema = window_sum(data, u_period) / (double)period;
+        out_ema[u_period - 1] = current_ema;
+        for (size_t i = u_period; i < length; i++) {
+            current_ema = (data[i] - current_ema) * multiplier + current_ema;
+            out_ema[i] = current_ema;
+        }
+        return STATS_SUCCESS;
+    }
+
+    size_t valid_streak = 0;
+    double current_sum = 0.0;
+    double current_ema = NAN;
+    int has_valid_output = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        if (!element_is_valid(validity, i)) {
+            out_ema[i] = NAN;
+            valid_streak = 0;
+            current_sum = 0.0;
+        } else if (valid_streak < u_period) {
+            current_sum += data[i];
+            valid_streak++;
+            if (valid_streak == u_period) {
+                current_ema = current_sum / (double)period;
+                out_ema[i] = current_ema;
+                has_valid_output = 1;
+            } else {
+                out_ema[i] = NAN;
+            }
+        } else {
+            current_ema = (data[i] - current_ema) * multiplier + current_ema;
+            out_ema[i] = current_ema;
+        }
+    }
+
+    if (!has_valid_output)
+        return STATS_ERR_INSUFFICIENT_DATA;
+    return STATS_SUCCESS;
+}
+
 StatisticsErrorCode generate_trading_signals(const double *restrict prices,
                                              const double *restrict sma,
                                              const size_t length,
@@ -238,6 +743,59 @@ StatisticsErrorCode calculate_rolling_std(const double *restrict data,
     return STATS_SUCCESS;
 }
 
+StatisticsErrorCode calculate_rolling_std_masked(const double *restrict data,
+                                                 const uint64_t *restrict validity,
+                                                 const size_t length,
+                                                 const int period,
+                                                 double *restrict out_std)
+{
+    if (!data || !out_std)
+        return STATS_ERR_NULL_POINTER;
+    if (length == 0)
+        return STATS_ERR_INVALID_LENGTH;
+    if (period <= 1)
+        return STATS_ERR_INVALID_PERIOD;
+    if (length < (size_t)period)
+        return STATS_ERR_INSUFFICIENT_DATA;
+
+    const size_t u_period = (size_t)period;
+    const bool all_valid = validity_is_full(validity, length);
+
+    for (size_t i = 0; i < length; i++) {
+        if (i < u_period - 1) {
+            out_std[i] = NAN;
+            continue;
+        }
+
+        const size_t first = i + 1 - u_period;
+        if (all_valid) {
+            /* Two passes over the window, neither with a per-element test */
+            const double mean = window_sum(data + first, u_period) / (double)period;
+            double sum_sq_diff = 0.0;
+            for (size_t j = first; j <= i; j++) {
+                sum_sq_diff += (data[j] - mean) * (data[j] - mean);
+            }
+            out_std[i] = sqrt(sum_sq_diff / (double)(period - 1));
+            continue;
+        }
+
+        double mean = 0.0;
+        double sum_sq_diff = 0.0;
+        size_t count = 0;
+        for (size_t j = first; j <= i; j++) {
+            if (element_is_valid(validity, j)) {
+                count++;
+                const double delta = data[j] - mean;
+                mean += delta / (double)count;
+                sum_sq_diff += delta * (data[j] - mean);
+            }
+        }
+        out_std[i] = count > 1 ? sqrt(sum_sq_diff / (double)(count - 1)) : NAN;
+    }
+
+    return STATS_SUCCESS;
+}
+
 StatisticsErrorCode calculate_bollinger_bands(const double *restrict sma,
                                               const double *restrict rolling_std,
                                               const size_t length,
@@ -296,6 +854,27 @@ StatisticsErrorCode calculate_covariance(const double *restrict data_x,
     return STATS_SUCCESS;
 }
 
+StatisticsErrorCode calculate_covariance_masked(const double *restrict data_x,
+                                                const uint64_t *restrict validity_x,
+                                                const double *restrict data_y,
+                                                const uint64_t *restrict validity_y,
+                                                const size_t length,
+                                                double *restrict out_covariance)
+{
+    if (!data_x || !data_y || !out_covariance)
+        return STATS_ERR_NULL_POINTER;
+    if (length == 0)
+        return STATS_ERR_INVALID_LENGTH;
+
+    PairStatistics pairs;
+    accumulate_pairs(data_x, validity_x, data_y, validity_y, length, &pairs);
+    if (pairs.count < 2)
+        return STATS_ERR_INSUFFICIENT_DATA;
+
+    *out_covariance = pairs.c_xy / (double)(pairs.count - 1);
+    return STATS_SUCCESS;
+}
+
 StatisticsErrorCode calculate_correlation(const double *restrict data_x,
                                           const double *restrict data_y,
                                           const size_t length,
@@ -339,3 +918,29 @@ StatisticsErrorCode calculate_correlation(const double *restrict data_x,
 
     return STATS_SUCCESS;
 }
+
+StatisticsErrorCode calculate_correlation_masked(const double *restrict data_x,
+                                                 const uint64_t *restrict validity_x,
+                                                 const double *restrict data_y,
+                                                 const uint64_t *restrict validity_y,
+                                                 const size_t length,
+                                                 double *restrict out_correlation)
+{
+    if (!data_x || !data_y || !out_correlation)
+        return STATS_ERR_NULL_POINTER;
+    if (length == 0)
+        return STATS_ERR_INVALID_LENGTH;
+
+    PairStatistics pairs;
+    accumulate_pairs(data_x, validity_x, data_y, validity_y, length, &pairs);
+    if (pairs.count < 2)
+        return STATS_ERR_INSUFFICIENT_DATA;
+
+    if (pairs.m2_x == 0.0 || pairs.m2_y == 0.0) {
+        *out_correlation = NAN;
+    } else {
+        *out_correlation = pairs.c_xy / sqrt(pairs.m2_x * pairs.m2_y);
+    }
+
+    return STATS_SUCCESS;
+}
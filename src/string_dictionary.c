@@ -0,0 +1,193 @@
+#include "string_dictionary.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Number of distinct values and hash slots reserved by a new dictionary.
+ */
+#define INITIAL_DICTIONARY_CAPACITY 16
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a byte range.
+ * @param str The bytes to hash.
+ * @param len The number of bytes.
+ * @return The hash value.
+ */
+static uint64_t hash_bytes(const char *str, const size_t len)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Finds the slot holding a string, or the empty slot where it would be inserted.
+ * @param dict The dictionary.
+ * @param str The characters of the string.
+ * @param len The number of characters.
+ * @param hash The string's hash.
+ * @return The slot index.
+ */
+static size_t
+find_slot(const StringDictionary *dict, const char *str, const size_t len, const uint64_t hash)
+{
+    const size_t mask = dict->slot_count - 1;
+    size_t slot = (size_t)hash & mask;
+
+    for (;;) {
+        const int32_t code = dict->slots[slot];
+        if (code < 0)
+            return slot;
+        if (dict->hashes[code] == hash && dict->lengths[code] == len &&
+            memcmp(dict->values[code], str, len) == 0)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+}
+
+/**
+ * @brief Doubles the hash table and reinserts every code using the stored hashes.
+ * @param dict The dictionary.
+ * @return true on success, false if allocation fails (the dictionary is left unchanged).
+ */
+static bool grow_slots(StringDictionary *dict)
+{
+    const size_t slot_count = dict->slot_count * 2;
+    int32_t *slots = malloc(slot_count * sizeof(int32_t));
+    if (!slots)
+        return false;
+    memset(slots, 0xFF, slot_count * sizeof(int32_t));
+
+    const size_t mask = slot_count - 1;
+    for (int32_t code = 0; code < dict->count; code++) {
+        size_t slot = (size_t)dict->hashes[code] & mask;
+        while (slots[slot] >= 0)
+            slot = (slot + 1) & mask;
+        slots[slot] = code;
+    }
+
+    free(dict->slots);
+    dict->slots = slots;
+    dict->slot_count = slot_count;
+    return true;
+}
+
+/**
+ * @brief Grows the per-value arrays so one more value fits.
+ * @param dict The dictionary.
+ * @return true on success, false if allocation fails.
+ */
+static bool grow_values(StringDictionary *dict)
+{
+    if (dict->capacity > INT32_MAX / 2)
+        return false;
+    const int32_t capacity = dict->capacity * 2;
+
+    char **values = realloc(dict->values, (size_t)capacity * sizeof(char *));
+    if (!values)
+        return false;
+    dict->values = values;
+
+    size_t *lengths = realloc(dict->lengths, (size_t)capacity * sizeof(size_t));
+    if (!lengths)
+        return false;
+    dict->lengths = lengths;
+
+    uint64_t *hashes = realloc(dict->hashes, (size_t)capacity * sizeof(uint64_t));
+    if (!hashes)
+        return false;
+    dict->hashes = hashes;
+
+    dict->capacity = capacity;
+    return true;
+}
+
+StringDictionary *string_dictionary_create(void)
+{
+    StringDictionary *dict = calloc(1, sizeof(StringDictionary));
+    if (!dict)
+        return NULL;
+
+    dict->capacity = INITIAL_DICTIONARY_CAPACITY;
+    dict->slot_count = 2 * INITIAL_DICTIONARY_CAPACITY;
+    dict->values = malloc((size_t)dict->capacity * sizeof(char *));
+    dict->lengths = malloc((size_t)dict->capacity * sizeof(size_t));
+    dict->hashes = malloc((size_t)dict->capacity * sizeof(uint64_t));
+    dict->slots = malloc(dict->slot_count * sizeof(int32_t));
+
+    if (!dict->values || !dict->lengths || !dict->hashes || !dict->slots) {
+        string_dictionary_free(dict);
+        return NULL;
+    }
+
+    memset(dict->slots, 0xFF, dict->slot_count * sizeof(int32_t));
+    return dict;
+}
+
+int32_t string_dictionary_intern(StringDictionary *dict, const char *str, const size_t len)
+{
+    if (!dict || (!str && len > 0))
+        return -1;
+    if (!str)
+        str = "";
+
+    const uint64_t hash = hash_bytes(str, len);
+    size_t slot = find_slot(dict, str, len, hash);
+    if (dict->slots[slot] >= 0)
+        return dict->slots[slot];
+
+    /* Keep the load factor at or below one half so probe sequences stay short */
+    if ((size_t)(dict->count + 1) * 2 > dict->slot_count) {
+        if (!grow_slots(dict))
+            return -1;
+        slot = find_slot(dict, str, len, hash);
+    }
+    if (dict->count == dict->capacity && !grow_values(dict))
+        return -1;
+
+    char *copy = arena_strndup(&dict->storage, str, len);
+    if (!copy)
+        return -1;
+
+    const int32_t code = dict->count++;
+    dict->values[code] = copy;
+    dict->lengths[code] = len;
+    dict->hashes[code] = hash;
+    dict->slots[slot] = code;
+    return code;
+}
+
+int32_t string_dictionary_find(const StringDictionary *dict, const char *str, const size_t len)
+{
+    if (!dict || (!str && len > 0))
+        return -1;
+    if (!str)
+        str = "";
+
+    return dict->slots[find_slot(dict, str, len, hash_bytes(str, len))];
+}
+
+const char *string_dictionary_value(const StringDictionary *dict, const int32_t code)
+{
+    if (!dict || code < 0 || code >= dict->count)
+        return NULL;
+    return dict->values[code];
+}
+
+void string_dictionary_free(StringDictionary *dict)
+{
+    if (!dict)
+        return;
+
+    free(dict->values);
+    free(dict->lengths);
+    free(dict->hashes);
+    free(dict->slots);
+    arena_release(&dict->storage);
+    free(dict);
+}
@@ -20,8 +20,15 @@ static void process_time_series_file(void)
         return;
     }
 
+    /* Columnar storage lets the analysis run directly on the selected column */
+    CsvReadOptions options = csv_default_read_options();
+    options.layout = DATAFRAME_LAYOUT_COLUMNS;
+    options.infer_dates = true;
+    /* The same files are analyzed repeatedly; later runs map the parsed columns */
+    options.use_cache = true;
+
     DataFrame *df = NULL;
-    const DataframeErrorCode err = read_csv(filepath, true, ",", &df);
+    const DataframeErrorCode err = read_csv_with_options(filepath, &options, &df);
 
     if (err != DATAFRAME_SUCCESS || !df) {
         printf("Failed to load or parse the CSV file. Please check the file path and format.\n");
@@ -65,14 +72,15 @@ static void process_time_series_file(void)
     }
 
     const size_t length = (size_t)df->rows;
-    double *data = aligned_calloc(length, sizeof(double), CACHE_LINE_SIZE);
+    const double *data = dataframe_numeric_column(df, target_col);
+    /* NULL when nothing is missing, which puts the kernels on their all-valid path */
+    const uint64_t *validity = dataframe_column_validity(df, target_col, NULL);
     double *sma = aligned_calloc(length, sizeof(double), CACHE_LINE_SIZE);
     double *ema = aligned_calloc(length, sizeof(double), CACHE_LINE_SIZE);
     const char **signals = aligned_calloc(length, sizeof(char *), CACHE_LINE_SIZE);
 
     if (!data || !sma || !ema || !signals) {
         printf("Error: Memory allocation failed.\n");
-        aligned_free(data);
         aligned_free(sma);
         aligned_free(ema);
         aligned_free(signals);
@@ -80,13 +88,9 @@ static void process_time_series_file(void)
         return;
     }
 
-    for (size_t i = 0; i < length; i++) {
-        data[i] = df->data[i][target_col].v_num;
-    }
-
     SeriesStatistics stats = {0};
 
-    if (calculate_series_statistics(data, length, &stats) == STATS_SUCCESS) {
+    if (calculate_series_statistics_masked(data, validity, length, &stats) == STATS_SUCCESS) {
         printf("\n--- STATISTICAL ANALYSIS N(m, 𝜎) ---\n");
         printf("Mean (m):                 %.4f\n", stats.mean);
         printf("Standard Deviation (𝜎):   %.4f\n", stats.standard_deviation);
@@ -94,8 +98,8 @@ static void process_time_series_file(void)
     } else {
         printf("\nWarning: Insufficient valid data to calculate N(m, 𝜎).\n");
     }
-    const StatisticsErrorCode sma_err = calculate_sma(data, length, period, sma);
-    const StatisticsErrorCode ema_err = calculate_ema(data, length, period, ema);
+    const StatisticsErrorCode sma_err = calculate_sma_masked(data, validity, length, period, sma);
+    const StatisticsErrorCode ema_err = calculate_ema_masked(data, validity, length, period, ema);
 
     if (sma_err == STATS_ERR_INSUFFICIENT_DATA || ema_err == STATS_ERR_INSUFFICIENT_DATA) {
         printf("\nWarning: The chosen period (%d) exceeds the dataset length (%zu). Moving "
@@ -137,7 +141,6 @@ static void process_time_series_file(void)
     }
     printf("----------------------------------------------------------------------\n");
 
-    aligned_free(data);
     aligned_free(sma);
     aligned_free(ema);
     aligned_free(signals);
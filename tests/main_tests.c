@@ -12,8 +12,24 @@ extern void run_money_tests(void);
 extern void run_loan_math_tests(void);
 extern void run_loan_simulation_tests(void);
 extern void run_dataframe_tests(void);
+extern void run_dataframe_view_tests(void);
+extern void run_dataframe_sort_tests(void);
+extern void run_dataframe_groupby_tests(void);
+extern void run_dataframe_join_tests(void);
+extern void run_dataframe_filter_tests(void);
+extern void run_dataframe_query_tests(void);
+extern void run_dataframe_binary_tests(void);
+extern void run_arrow_ipc_tests(void);
 extern void run_statistics_tests(void);
 extern void run_memory_utils_tests(void);
+extern void run_csv_reader_tests(void);
+extern void run_csv_cache_tests(void);
+extern void run_csv_scanner_tests(void);
+extern void run_compressed_input_tests(void);
+extern void run_parallel_tests(void);
+extern void run_number_parser_tests(void);
+extern void run_string_dictionary_tests(void);
+extern void run_date_parser_tests(void);
 
 /**
  * @brief Unity required function executed before each test.
@@ -36,7 +52,24 @@ int main(void) {
   run_loan_math_tests();
   run_loan_simulation_tests();
   run_dataframe_tests();
+  run_dataframe_view_tests();
+  run_dataframe_sort_tests();
+  run_dataframe_groupby_tests();
+  run_dataframe_join_tests();
+  run_dataframe_filter_tests();
+  run_dataframe_query_tests();
+  run_dataframe_binary_tests();
+  run_arrow_ipc_tests();
   run_statistics_tests();
+  run_csv_reader_tests();
+  run_csv_cache_tests();
+  run_csv_scanner_tests();
+  run_compressed_input_tests();
+  run_parallel_tests();
+  run_number_parser_tests();
+  run_string_dictionary_tests();
+  run_date_parser_tests();
+  run_memory_utils_tests();
 
   return UNITY_END();
 }
\ No newline at end of file
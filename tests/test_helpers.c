@@ -0,0 +1,104 @@
+#include "test_helpers.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+DataFrame *test_make_quotes(const TestQuote *quotes, const int count, const bool with_volume)
+{
+    const int cols = with_volume ? 5 : 4;
+    DataFrame *df = create_dataframe_with_layout(8, cols, DATAFRAME_LAYOUT_ROWS);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(df));
+
+    const char *names[] = {"Ticker", "Day", "Price", "Volume", "Note"};
+    const DataType types[] = {TYPE_CATEGORY, TYPE_DATE, TYPE_NUMERIC, TYPE_INT64, TYPE_STRING};
+    for (int c = 0; c < cols; c++) {
+        const int src = with_volume || c < 3 ? c : c + 1;
+        df->columns[c] = strdup(names[src]);
+        df->col_types[c] = types[src];
+    }
+
+    const int note_col = cols - 1;
+    for (int r = 0; r < count; r++) {
+        const TestQuote *quote = &quotes[r];
+        TEST_ASSERT_TRUE(dataframe_push_row(df) == r);
+
+        DataCell cell = {0};
+        cell.v_code = quote->ticker
+                          ? dataframe_intern_string(df, 0, quote->ticker, strlen(quote->ticker))
+                          : -1;
+        dataframe_set_cell(df, r, 0, cell);
+        cell.v_int = quote->day;
+        dataframe_set_cell(df, r, 1, cell);
+        cell.v_num = quote->price;
+        dataframe_set_cell(df, r, 2, cell);
+        if (with_volume) {
+            cell.v_int = quote->volume;
+            dataframe_set_cell(df, r, 3, cell);
+        }
+        cell.v_str =
+            quote->note ? dataframe_store_string(df, quote->note, strlen(quote->note)) : NULL;
+        dataframe_set_cell(df, r, note_col, cell);
+
+        if (!quote->ticker)
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 0, false));
+        if (isnan(quote->price))
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 2, false));
+        if (with_volume && quote->volume == DATAFRAME_NULL_INT64)
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 3, false));
+        if (!quote->note)
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, note_col, false));
+    }
+    return df;
+}
+
+DataFrame *test_make_typed_frame(const DataFrameLayout layout, const bool with_time)
+{
+    const int cols = with_time ? 6 : 5;
+    DataFrame *df = create_dataframe_with_layout(4, cols, layout);
+    TEST_ASSERT_NOT_NULL(df);
+
+    const char *names[] = {"Price", "Qty", "Day", "Time", "Note", "Ticker"};
+    const DataType types[] = {TYPE_NUMERIC,   TYPE_INT64,  TYPE_DATE,
+                              TYPE_TIMESTAMP, TYPE_STRING, TYPE_CATEGORY};
+    for (int c = 0; c < cols; c++) {
+        const int src = with_time || c < 3 ? c : c + 1;
+        df->columns[c] = strdup(names[src]);
+        df->col_types[c] = types[src];
+    }
+
+    const int note_col = cols - 2;
+    const int ticker_col = cols - 1;
+    const char *tickers[] = {"AAPL", "MSFT", "AAPL", "IBM", "MSFT", "AAPL", "IBM", "IBM", "AAPL"};
+    for (int r = 0; r < 9; r++) {
+        TEST_ASSERT_TRUE(dataframe_push_row(df) == r);
+
+        DataCell cell = {0};
+        cell.v_num = r == 4 ? NAN : r * 1.5;
+        dataframe_set_cell(df, r, 0, cell);
+        cell.v_int = r == 8 ? DATAFRAME_NULL_INT64 : (int64_t)r * 1000000000000LL;
+        dataframe_set_cell(df, r, 1, cell);
+        cell.v_int = r == 0 ? DATAFRAME_NULL_INT64 : -3 + r;
+        dataframe_set_cell(df, r, 2, cell);
+        if (with_time) {
+            cell.v_int = r == 1 ? DATAFRAME_NULL_INT64 : 1700000000123456789LL + r;
+            dataframe_set_cell(df, r, 3, cell);
+        }
+
+        char note[16];
+        snprintf(note, sizeof(note), "note %d", r);
+        cell.v_str = r == 3 ? NULL : dataframe_store_string(df, note, strlen(note));
+        dataframe_set_cell(df, r, note_col, cell);
+
+        cell.v_int = 0;
+        cell.v_code = r == 5 ? -1
+                             : dataframe_intern_string(df, ticker_col, tickers[r],
+                                                       strlen(tickers[r]));
+        dataframe_set_cell(df, r, ticker_col, cell);
+    }
+    return df;
+}
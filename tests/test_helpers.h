@@ -0,0 +1,56 @@
+#ifndef STATISTICALDATAPROCESSOR_TEST_HELPERS_H
+#define STATISTICALDATAPROCESSOR_TEST_HELPERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "dataframe.h"
+
+/**
+ * @file test_helpers.h
+ * @brief Frame builders shared by the unit test suites.
+ *
+ * Each builder fails the running test through Unity assertions instead of
+ * returning errors.
+ */
+
+/**
+ * @brief One row of a quotes frame built by test_make_quotes.
+ */
+typedef struct {
+    const char *ticker; /*!< Ticker symbol, or NULL when missing. */
+    int64_t day;        /*!< Day as days since the epoch. */
+    double price;       /*!< Price, or NAN when missing. */
+    int64_t volume;     /*!< Volume, or DATAFRAME_NULL_INT64 when missing. */
+    const char *note;   /*!< Free-text note, or NULL when missing. */
+} TestQuote;
+
+/**
+ * @brief Builds a small row-layout frame of quotes.
+ *
+ * Columns: Ticker (category), Day (date), Price (numeric), Volume (int64) when
+ * requested, and Note (string). Missing tickers, prices, volumes and notes are
+ * marked invalid.
+ *
+ * @param quotes The rows, in order.
+ * @param count The number of rows.
+ * @param with_volume Whether to include the Volume column.
+ * @return The new DataFrame, with validity tracking enabled.
+ */
+DataFrame *test_make_quotes(const TestQuote *quotes, int count, bool with_volume);
+
+/**
+ * @brief Builds a nine-row frame with one column of every type, each with one missing value.
+ *
+ * Columns: Price (numeric, NAN in row 4), Qty (int64, missing in row 8), Day
+ * (date, missing in row 0), Time (timestamp, missing in row 1) when requested,
+ * Note (string, NULL in row 3) and Ticker (category, missing in row 5). Missing
+ * values are marked by sentinels only.
+ *
+ * @param layout The storage layout of the frame.
+ * @param with_time Whether to include the Time column.
+ * @return The new DataFrame.
+ */
+DataFrame *test_make_typed_frame(DataFrameLayout layout, bool with_time);
+
+#endif // STATISTICALDATAPROCESSOR_TEST_HELPERS_H
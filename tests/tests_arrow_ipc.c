@@ -0,0 +1,430 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arrow_ipc.h"
+#include "dataframe.h"
+#include "test_helpers.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_arrow_ipc.c
+ * @brief Unit tests for the Arrow IPC export and import.
+ *
+ * Verifies round trips of every column type through both framings, that
+ * single-batch files are used in place, the decoding of types and layouts
+ * written by other Arrow implementations, and the rejection of damaged input.
+ */
+
+#define TEST_ARROW_FILE "test_data.tmp.arrow"
+
+/**
+ * @brief Asserts that an imported frame holds the values written by test_make_typed_frame.
+ * @param df The imported DataFrame.
+ */
+static void assert_frame_contents(const DataFrame *df)
+{
+    TEST_ASSERT_EQUAL_INT(9, df->rows);
+    TEST_ASSERT_EQUAL_INT(6, df->cols);
+    TEST_ASSERT_EQUAL_INT(DATAFRAME_LAYOUT_COLUMNS, df->layout);
+    TEST_ASSERT_EQUAL_STRING("Time", df->columns[3]);
+    TEST_ASSERT_EQUAL_INT(TYPE_DATE, df->col_types[2]);
+    TEST_ASSERT_EQUAL_INT(TYPE_TIMESTAMP, df->col_types[3]);
+    TEST_ASSERT_EQUAL_INT(TYPE_CATEGORY, df->col_types[5]);
+
+    for (int r = 0; r < 9; r++) {
+        if (r == 4)
+            TEST_ASSERT_TRUE(isnan(dataframe_get_cell(df, r, 0).v_num));
+        else
+            TEST_ASSERT_EQUAL_DOUBLE(r * 1.5, dataframe_get_cell(df, r, 0).v_num);
+        TEST_ASSERT_EQUAL_INT64(r == 8 ? DATAFRAME_NULL_INT64 : (int64_t)r * 1000000000000LL,
+                                dataframe_get_cell(df, r, 1).v_int);
+        TEST_ASSERT_EQUAL_INT64(r == 0 ? DATAFRAME_NULL_INT64 : -3 + r,
+                                dataframe_get_cell(df, r, 2).v_int);
+        TEST_ASSERT_EQUAL_INT64(r == 1 ? DATAFRAME_NULL_INT64 : 1700000000123456789LL + r,
+                                dataframe_get_cell(df, r, 3).v_int);
+    }
+    TEST_ASSERT_NULL(dataframe_get_string(df, 3, 4));
+    TEST_ASSERT_EQUAL_STRING("note 7", dataframe_get_string(df, 7, 4));
+    TEST_ASSERT_EQUAL_STRING("IBM", dataframe_get_string(df, 6, 5));
+    TEST_ASSERT_NULL(dataframe_get_string(df, 5, 5));
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(df, 5, 5));
+    TEST_ASSERT_EQUAL_INT(3, df->dictionaries[5]->count);
+}
+
+/**
+ * @brief Reads a whole file into a heap buffer.
+ * @param out_size Receives the number of bytes.
+ * @return The contents.
+ */
+static unsigned char *read_file(size_t *out_size)
+{
+    FILE *f = fopen(TEST_ARROW_FILE, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, 0, SEEK_END);
+    const long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    unsigned char *bytes = malloc((size_t)size + 1);
+    TEST_ASSERT_NOT_NULL(bytes);
+    TEST_ASSERT_EQUAL_size_t((size_t)size, fread(bytes, 1, (size_t)size, f));
+    fclose(f);
+    *out_size = (size_t)size;
+    return bytes;
+}
+
+/**
+ * @brief Tests exporting frames of both layouts in both framings and importing them again.
+ * Expected result: Values, types, names, nulls and dictionaries survive; files carry the
+ * ARROW1 magic at both ends, and loaded fixed-width columns are the mapped buffers themselves.
+ */
+void test_ArrowIpc_RoundTrip(void)
+{
+    DataFrame *rows = test_make_typed_frame(DATAFRAME_LAYOUT_ROWS, true);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_save_arrow(rows, TEST_ARROW_FILE, ARROW_IPC_FILE));
+    free_dataframe(rows);
+
+    size_t size;
+    unsigned char *bytes = read_file(&size);
+    TEST_ASSERT_EQUAL_MEMORY("ARROW1\0\0", bytes, 8);
+    TEST_ASSERT_EQUAL_MEMORY("ARROW1", bytes + size - 6, 6);
+    free(bytes);
+
+    DataFrame *df = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_load_arrow(TEST_ARROW_FILE, &df));
+    assert_frame_contents(df);
+
+    /* Float64 and Int64 data are used in place, with nulls patched into private pages */
+    const char *prices = (const char *)dataframe_numeric_column(df, 0);
+    const char *quantities = (const char *)dataframe_int64_column(df, 1);
+    TEST_ASSERT_TRUE(prices >= df->mapping->data && prices < df->mapping->data + df->mapping->size);
+    TEST_ASSERT_TRUE(quantities >= df->mapping->data &&
+                     quantities < df->mapping->data + df->mapping->size);
+    TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)prices % CACHE_LINE_SIZE);
+    TEST_ASSERT_TRUE(dataframe_push_row(df) == 9);
+    TEST_ASSERT_EQUAL_DOUBLE(12.0, dataframe_get_cell(df, 8, 0).v_num);
+    free_dataframe(df);
+
+    DataFrame *columnar = test_make_typed_frame(DATAFRAME_LAYOUT_COLUMNS, true);
+    FILE *f = fopen(TEST_ARROW_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_write_arrow(columnar, f, ARROW_IPC_STREAM));
+    fclose(f);
+    free_dataframe(columnar);
+
+    /* The stream ends with the end-of-stream marker */
+    bytes = read_file(&size);
+    TEST_ASSERT_EQUAL_MEMORY("\xFF\xFF\xFF\xFF\0\0\0\0", bytes + size - 8, 8);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_read_arrow(bytes, size, &df));
+    free(bytes);
+    assert_frame_contents(df);
+    TEST_ASSERT_NULL(df->mapping);
+    free_dataframe(df);
+
+    remove(TEST_ARROW_FILE);
+}
+
+/**
+ * @brief An IPC stream written by pyarrow 26.0 with two record batches and a delta dictionary.
+ *
+ * Columns (int8, uint32, float32, bool, date64, timestamp[ms], large_string,
+ * dictionary<int8, string>), generated with emit_dictionary_deltas=True from:
+ *   batch 1: [-5, null], [4000000000, 7], [0.5, null], [true, false],
+ *            [-86400000, null], [1700000000123, null], ["x", null], dictionary ["lo", "hi"]
+ *            with indices [1, null]
+ *   batch 2: [127], [null], [-2.25], [null], [259200005], [-1], ["large"], delta ["mid"]
+ *            with indices [2]
+ */
+static const unsigned char ARROW_FIXTURE[] = {
+    0xff, 0xff, 0xff, 0xff, 0xe0, 0x01, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00, 0x06, 0x00, 0x05, 0x00, 0x08, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x00, 0x01, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0xa0, 0xff, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x80, 0x01, 0x00, 0x00, 0x3c, 0x01, 0x00, 0x00, 0x08, 0x01, 0x00, 0x00,
+    0xd8, 0x00, 0x00, 0x00, 0xb0, 0x00, 0x00, 0x00, 0x84, 0x00, 0x00, 0x00,
+    0x5c, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x10, 0x00, 0x18, 0x00,
+    0x08, 0x00, 0x06, 0x00, 0x07, 0x00, 0x0c, 0x00, 0x10, 0x00, 0x14, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x05, 0x14, 0x00, 0x00, 0x00,
+    0x34, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x63, 0x61, 0x74, 0x00,
+    0x08, 0x00, 0x08, 0x00, 0x00, 0x00, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0xc4, 0xfe, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01,
+    0x08, 0x00, 0x00, 0x00, 0x68, 0xff, 0xff, 0xff, 0x04, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x01, 0x14, 0x10, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x62, 0x69, 0x67, 0x00, 0x8c, 0xff, 0xff, 0xff, 0x28, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x01, 0x0a, 0x10, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x6d, 0x73, 0x00, 0x00, 0x86, 0xff, 0xff, 0xff, 0x00, 0x00, 0x01, 0x00,
+    0x50, 0xff, 0xff, 0xff, 0x00, 0x00, 0x01, 0x08, 0x10, 0x00, 0x00, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x64, 0x36, 0x34, 0x00, 0xd8, 0xff, 0xff, 0xff,
+    0x74, 0xff, 0xff, 0xff, 0x00, 0x00, 0x01, 0x06, 0x10, 0x00, 0x00, 0x00,
+    0x1c, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x66, 0x6c, 0x61, 0x67, 0x00, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0xa0, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x01, 0x03, 0x10, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x66, 0x33, 0x32, 0x00, 0x00, 0x00, 0x06, 0x00, 0x08, 0x00, 0x06, 0x00,
+    0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0xd0, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x01, 0x02, 0x10, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x75, 0x33, 0x32, 0x00, 0x00, 0x00, 0x06, 0x00, 0x08, 0x00, 0x04, 0x00,
+    0x06, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x10, 0x00, 0x14, 0x00,
+    0x08, 0x00, 0x06, 0x00, 0x07, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x10, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x10, 0x00, 0x00, 0x00,
+    0x1c, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x69, 0x38, 0x00, 0x00, 0x08, 0x00, 0x0c, 0x00,
+    0x08, 0x00, 0x07, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+    0xa8, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x14, 0x00, 0x06, 0x00, 0x05, 0x00, 0x08, 0x00, 0x0c, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0x00, 0x02, 0x04, 0x00, 0x14, 0x00, 0x00, 0x00,
+    0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x0a, 0x00,
+    0x00, 0x00, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0a, 0x00, 0x18, 0x00, 0x0c, 0x00, 0x04, 0x00, 0x08, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x4c, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6c, 0x6f, 0x68, 0x69,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xe8, 0x01, 0x00, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x16, 0x00,
+    0x06, 0x00, 0x05, 0x00, 0x08, 0x00, 0x0c, 0x00, 0x0c, 0x00, 0x00, 0x00,
+    0x00, 0x03, 0x04, 0x00, 0x18, 0x00, 0x00, 0x00, 0x98, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x18, 0x00, 0x0c, 0x00,
+    0x04, 0x00, 0x08, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x2c, 0x01, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x68, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x28, 0x6b, 0xee, 0x07, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xa4, 0xd9, 0xfa, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x7b, 0x68, 0xe5, 0xcf, 0x8b, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xb0, 0x00, 0x00, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x16, 0x00,
+    0x06, 0x00, 0x05, 0x00, 0x08, 0x00, 0x0c, 0x00, 0x0c, 0x00, 0x00, 0x00,
+    0x00, 0x02, 0x04, 0x00, 0x18, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x0e, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x07, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x18, 0x00, 0x0c, 0x00,
+    0x04, 0x00, 0x08, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x4c, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x6d, 0x69, 0x64, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xff, 0xff, 0xff, 0xe8, 0x01, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x16, 0x00, 0x06, 0x00, 0x05, 0x00,
+    0x08, 0x00, 0x0c, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x03, 0x04, 0x00,
+    0x18, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0a, 0x00, 0x18, 0x00, 0x0c, 0x00, 0x04, 0x00, 0x08, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x2c, 0x01, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x58, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x58, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0xc0, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x05, 0x14, 0x73, 0x0f, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x6c, 0x61, 0x72, 0x67, 0x65, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+};
+
+/**
+ * @brief Tests importing data written by another Arrow implementation.
+ * Expected result: Narrow and unsigned integers, Float32, Bool, Date64, millisecond timestamps,
+ * LargeUtf8 and dictionaries with Int8 indices are converted, nulls become missing values, and
+ * rows of both batches are concatenated with the delta dictionary applied.
+ */
+void test_ArrowIpc_ReadsForeignData(void)
+{
+    DataFrame *df = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_read_arrow(ARROW_FIXTURE, sizeof(ARROW_FIXTURE), &df));
+    TEST_ASSERT_EQUAL_INT(8, df->cols);
+    TEST_ASSERT_EQUAL_INT(3, df->rows);
+    TEST_ASSERT_EQUAL_STRING("flag", df->columns[3]);
+
+    const DataType types[] = {TYPE_INT64, TYPE_INT64,     TYPE_NUMERIC, TYPE_NUMERIC,
+                              TYPE_DATE,  TYPE_TIMESTAMP, TYPE_STRING,  TYPE_CATEGORY};
+    for (int c = 0; c < 8; c++) {
+        TEST_ASSERT_EQUAL_INT(types[c], df->col_types[c]);
+    }
+
+    const int64_t i8[] = {-5, DATAFRAME_NULL_INT64, 127};
+    const int64_t u32[] = {4000000000LL, 7, DATAFRAME_NULL_INT64};
+    const int64_t days[] = {-1, DATAFRAME_NULL_INT64, 3};
+    const int64_t nanos[] = {1700000000123000000LL, DATAFRAME_NULL_INT64, -1000000};
+    for (int r = 0; r < 3; r++) {
+        TEST_ASSERT_EQUAL_INT64(i8[r], dataframe_get_cell(df, r, 0).v_int);
+        TEST_ASSERT_EQUAL_INT64(u32[r], dataframe_get_cell(df, r, 1).v_int);
+        TEST_ASSERT_EQUAL_INT64(days[r], dataframe_get_cell(df, r, 4).v_int);
+        TEST_ASSERT_EQUAL_INT64(nanos[r], dataframe_get_cell(df, r, 5).v_int);
+    }
+
+    TEST_ASSERT_EQUAL_DOUBLE(0.5, dataframe_get_cell(df, 0, 2).v_num);
+    TEST_ASSERT_TRUE(isnan(dataframe_get_cell(df, 1, 2).v_num));
+    TEST_ASSERT_EQUAL_DOUBLE(-2.25, dataframe_get_cell(df, 2, 2).v_num);
+    TEST_ASSERT_EQUAL_DOUBLE(1.0, dataframe_get_cell(df, 0, 3).v_num);
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, dataframe_get_cell(df, 1, 3).v_num);
+    TEST_ASSERT_TRUE(isnan(dataframe_get_cell(df, 2, 3).v_num));
+
+    TEST_ASSERT_EQUAL_STRING("x", dataframe_get_string(df, 0, 6));
+    TEST_ASSERT_NULL(dataframe_get_string(df, 1, 6));
+    TEST_ASSERT_EQUAL_STRING("large", dataframe_get_string(df, 2, 6));
+    TEST_ASSERT_EQUAL_STRING("hi", dataframe_get_string(df, 0, 7));
+    TEST_ASSERT_NULL(dataframe_get_string(df, 1, 7));
+    TEST_ASSERT_EQUAL_STRING("mid", dataframe_get_string(df, 2, 7));
+    TEST_ASSERT_EQUAL_INT(3, df->dictionaries[7]->count);
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests input that must be rejected, and frames without rows.
+ * Expected result: Missing files, empty input, truncated data and a damaged footer are reported;
+ * a frame without rows round-trips and can grow afterwards.
+ */
+void test_ArrowIpc_RejectsInvalid(void)
+{
+    DataFrame *df = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_FILE_NOT_FOUND, dataframe_load_arrow(TEST_ARROW_FILE, &df));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_EMPTY_FILE, dataframe_read_arrow("", 0, &df));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT, dataframe_read_arrow("garbage!", 8, &df));
+    TEST_ASSERT_NULL(df);
+
+    DataFrame *source = test_make_typed_frame(DATAFRAME_LAYOUT_COLUMNS, true);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_save_arrow(source, TEST_ARROW_FILE, ARROW_IPC_STREAM));
+
+    size_t size;
+    unsigned char *bytes = read_file(&size);
+
+    /* Every truncation of the stream is either a valid prefix or rejected, never read past */
+    for (size_t cut = 0; cut < size; cut += 7) {
+        const DataframeErrorCode err = dataframe_read_arrow(bytes, cut, &df);
+        if (err == DATAFRAME_SUCCESS)
+            free_dataframe(df);
+        else
+            TEST_ASSERT_NULL(df);
+    }
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT, dataframe_read_arrow(bytes, 100, &df));
+    free(bytes);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_save_arrow(source, TEST_ARROW_FILE, ARROW_IPC_FILE));
+    bytes = read_file(&size);
+    bytes[size - 1] = 'X';
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT, dataframe_read_arrow(bytes, size, &df));
+    free(bytes);
+
+    dataframe_clear_rows(source);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_save_arrow(source, TEST_ARROW_FILE, ARROW_IPC_FILE));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_load_arrow(TEST_ARROW_FILE, &df));
+    TEST_ASSERT_EQUAL_INT(0, df->rows);
+    TEST_ASSERT_EQUAL_INT(6, df->cols);
+    TEST_ASSERT_EQUAL_INT(TYPE_CATEGORY, df->col_types[5]);
+    TEST_ASSERT_TRUE(dataframe_push_row(df) == 0);
+    free_dataframe(df);
+    free_dataframe(source);
+
+    remove(TEST_ARROW_FILE);
+}
+
+/**
+ * @brief Test runner for the Arrow IPC module.
+ */
+void run_arrow_ipc_tests(void)
+{
+    RUN_TEST(test_ArrowIpc_RoundTrip);
+    RUN_TEST(test_ArrowIpc_ReadsForeignData);
+    RUN_TEST(test_ArrowIpc_RejectsInvalid);
+}
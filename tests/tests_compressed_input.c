@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compressed_input.h"
+#include "unity/unity.h"
+
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+/**
+ * @file tests_compressed_input.c
+ * @brief Unit tests for format detection and pipelined decompression.
+ *
+ * Verifies magic-byte detection, round trips through gzip (including
+ * concatenated members) and zstd spanning several decoded blocks, and the
+ * reporting of truncated streams. Round trips only run for the formats the
+ * build was configured with.
+ */
+
+#define TEST_COMPRESSED_FILE "test_data.tmp.cmp"
+
+/**
+ * @brief Number of bytes in the generated payload (several decoded blocks).
+ */
+#define TEST_PAYLOAD_SIZE (1500 * 1000)
+
+#if defined(HAVE_ZLIB) || defined(HAVE_ZSTD)
+
+/**
+ * @brief Builds a CSV-like payload that compresses well but is not trivially repetitive.
+ * @return A heap buffer of TEST_PAYLOAD_SIZE bytes.
+ */
+static char *make_payload(void)
+{
+    char *payload = malloc(TEST_PAYLOAD_SIZE);
+    TEST_ASSERT_NOT_NULL(payload);
+
+    size_t pos = 0;
+    for (unsigned i = 0; pos < TEST_PAYLOAD_SIZE; i++) {
+        char line[64];
+        const int len = snprintf(line, sizeof(line), "%u,%u.%02u,row%u\n", i, i * 7919u % 1000u,
+                                 i % 100u, i % 37u);
+        for (int k = 0; k < len && pos < TEST_PAYLOAD_SIZE; k++) {
+            payload[pos++] = line[k];
+        }
+    }
+    return payload;
+}
+
+/**
+ * @brief Decompresses the test file completely through the pipelined reader.
+ * @param format The format of the file.
+ * @param out_size Receives the number of decompressed bytes.
+ * @param out_err Receives the status of the last read.
+ * @return A heap buffer with the decompressed bytes.
+ */
+static char *
+read_all(const CompressionFormat format, size_t *out_size, CompressedInputErrorCode *out_err)
+{
+    FILE *file = fopen(TEST_COMPRESSED_FILE, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    CompressedInput *input = NULL;
+    TEST_ASSERT_EQUAL(COMPRESSED_INPUT_SUCCESS,
+                      compressed_input_open(file, format, NULL, 0, &input));
+
+    char *result = malloc(TEST_PAYLOAD_SIZE + 1);
+    TEST_ASSERT_NOT_NULL(result);
+
+    size_t total = 0;
+    size_t got;
+    do {
+        /* Odd read sizes make the reads straddle the decoded block boundaries */
+        size_t want = 70001;
+        if (want > TEST_PAYLOAD_SIZE + 1 - total)
+            want = TEST_PAYLOAD_SIZE + 1 - total;
+        *out_err = compressed_input_read(input, result + total, want, &got);
+        total += got;
+    } while (*out_err == COMPRESSED_INPUT_SUCCESS && got > 0 && total <= TEST_PAYLOAD_SIZE);
+
+    compressed_input_close(input);
+    fclose(file);
+    remove(TEST_COMPRESSED_FILE);
+
+    *out_size = total;
+    return result;
+}
+
+#endif
+
+/**
+ * @brief Tests recognizing formats from their leading bytes.
+ * Expected result: gzip and zstd signatures are detected, plain text and short inputs are not.
+ */
+void test_CompressionDetect_MagicBytes(void)
+{
+    const unsigned char gzip[] = {0x1F, 0x8B, 0x08, 0x00};
+    const unsigned char zstd[] = {0x28, 0xB5, 0x2F, 0xFD};
+
+    TEST_ASSERT_EQUAL_INT(COMPRESSION_GZIP, compression_detect(gzip, sizeof(gzip)));
+    TEST_ASSERT_EQUAL_INT(COMPRESSION_ZSTD, compression_detect(zstd, sizeof(zstd)));
+    TEST_ASSERT_EQUAL_INT(COMPRESSION_NONE, compression_detect(zstd, 3));
+    TEST_ASSERT_EQUAL_INT(COMPRESSION_NONE, compression_detect("Date,Price", 10));
+    TEST_ASSERT_EQUAL_INT(COMPRESSION_NONE, compression_detect(NULL, 4));
+}
+
+/**
+ * @brief Tests decoding a gzip file made of two members, and a truncated one.
+ * Expected result: The payload is restored exactly; a cut-off stream reports corruption.
+ * Without zlib, opening a gzip stream reports the format as unsupported.
+ */
+void test_CompressedInput_GzipRoundTrip(void)
+{
+#if defined(HAVE_ZLIB)
+    char *payload = make_payload();
+    const size_t half = TEST_PAYLOAD_SIZE / 2;
+
+    gzFile gz = gzopen(TEST_COMPRESSED_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(gz);
+    TEST_ASSERT_EQUAL_INT((int)half, gzwrite(gz, payload, (unsigned)half));
+    gzclose(gz);
+    gz = gzopen(TEST_COMPRESSED_FILE, "ab");
+    TEST_ASSERT_NOT_NULL(gz);
+    TEST_ASSERT_EQUAL_INT((int)(TEST_PAYLOAD_SIZE - half),
+                          gzwrite(gz, payload + half, (unsigned)(TEST_PAYLOAD_SIZE - half)));
+    gzclose(gz);
+
+    size_t size;
+    CompressedInputErrorCode err;
+    char *decoded = read_all(COMPRESSION_GZIP, &size, &err);
+    TEST_ASSERT_EQUAL(COMPRESSED_INPUT_SUCCESS, err);
+    TEST_ASSERT_EQUAL_size_t(TEST_PAYLOAD_SIZE, size);
+    TEST_ASSERT_EQUAL_MEMORY(payload, decoded, TEST_PAYLOAD_SIZE);
+    free(decoded);
+
+    /* Keep only the first half of a single-member file */
+    gz = gzopen(TEST_COMPRESSED_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(gz);
+    gzwrite(gz, payload, (unsigned)half);
+    gzclose(gz);
+
+    FILE *file = fopen(TEST_COMPRESSED_FILE, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    char *compressed = malloc(TEST_PAYLOAD_SIZE);
+    TEST_ASSERT_NOT_NULL(compressed);
+    const size_t compressed_size = fread(compressed, 1, TEST_PAYLOAD_SIZE, file);
+    fclose(file);
+
+    file = fopen(TEST_COMPRESSED_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    fwrite(compressed, 1, compressed_size / 2, file);
+    fclose(file);
+    free(compressed);
+
+    decoded = read_all(COMPRESSION_GZIP, &size, &err);
+    TEST_ASSERT_EQUAL(COMPRESSED_INPUT_ERR_CORRUPT, err);
+    TEST_ASSERT_TRUE(size < half);
+    free(decoded);
+    free(payload);
+#else
+    FILE *file = tmpfile();
+    TEST_ASSERT_NOT_NULL(file);
+    CompressedInput *input = NULL;
+    TEST_ASSERT_FALSE(compression_supported(COMPRESSION_GZIP));
+    TEST_ASSERT_EQUAL(COMPRESSED_INPUT_ERR_UNSUPPORTED,
+                      compressed_input_open(file, COMPRESSION_GZIP, NULL, 0, &input));
+    TEST_ASSERT_NULL(input);
+    fclose(file);
+#endif
+}
+
+/**
+ * @brief Tests decoding a file made of two zstd frames.
+ * Expected result: The payload is restored exactly (skipped without zstd).
+ */
+void test_CompressedInput_ZstdRoundTrip(void)
+{
+#if defined(HAVE_ZSTD)
+    char *payload = make_payload();
+    const size_t half = TEST_PAYLOAD_SIZE / 2;
+    const size_t bound = ZSTD_compressBound(TEST_PAYLOAD_SIZE);
+    char *compressed = malloc(bound);
+    TEST_ASSERT_NOT_NULL(compressed);
+
+    const size_t first = ZSTD_compress(compressed, bound, payload, half, 3);
+    TEST_ASSERT_FALSE(ZSTD_isError(first));
+    const size_t second = ZSTD_compress(
+        compressed + first, bound - first, payload + half, TEST_PAYLOAD_SIZE - half, 3);
+    TEST_ASSERT_FALSE(ZSTD_isError(second));
+
+    FILE *file = fopen(TEST_COMPRESSED_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    fwrite(compressed, 1, first + second, file);
+    fclose(file);
+    free(compressed);
+
+    size_t size;
+    CompressedInputErrorCode err;
+    char *decoded = read_all(COMPRESSION_ZSTD, &size, &err);
+    TEST_ASSERT_EQUAL(COMPRESSED_INPUT_SUCCESS, err);
+    TEST_ASSERT_EQUAL_size_t(TEST_PAYLOAD_SIZE, size);
+    TEST_ASSERT_EQUAL_MEMORY(payload, decoded, TEST_PAYLOAD_SIZE);
+    free(decoded);
+    free(payload);
+#else
+    TEST_ASSERT_FALSE(compression_supported(COMPRESSION_ZSTD));
+#endif
+}
+
+/**
+ * @brief Test runner for the compressed input module.
+ */
+void run_compressed_input_tests(void)
+{
+    RUN_TEST(test_CompressionDetect_MagicBytes);
+    RUN_TEST(test_CompressedInput_GzipRoundTrip);
+    RUN_TEST(test_CompressedInput_ZstdRoundTrip);
+}
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "csv_cache.h"
+#include "csv_reader.h"
+#include "dataframe.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_csv_cache.c
+ * @brief Unit tests for the binary sidecar cache of parsed CSV files.
+ *
+ * Verifies that warm loads reproduce the parsed frame in both layouts, that
+ * mapped frames stay modifiable without touching the sidecar, and that a
+ * changed source, changed options or a damaged sidecar fall back to parsing.
+ */
+
+#define TEST_CACHE_CSV "test_data.tmp.cache.csv"
+#define TEST_CACHE_SIDECAR TEST_CACHE_CSV CSV_CACHE_SUFFIX
+
+/**
+ * @brief Writes the CSV file used by the cache tests.
+ * @param content The file contents.
+ */
+static void write_source(const char *content)
+{
+    FILE *f = fopen(TEST_CACHE_CSV, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs(content, f);
+    fclose(f);
+}
+
+/**
+ * @brief Deletes the CSV file and its sidecar.
+ */
+static void remove_files(void)
+{
+    remove(TEST_CACHE_CSV);
+    remove(TEST_CACHE_SIDECAR);
+}
+
+/**
+ * @brief Asserts that two frames hold the same columns and values.
+ * @param expected The frame parsed from CSV.
+ * @param actual The frame loaded from the sidecar.
+ */
+static void assert_frames_equal(const DataFrame *expected, const DataFrame *actual)
+{
+    TEST_ASSERT_EQUAL_INT(expected->rows, actual->rows);
+    TEST_ASSERT_EQUAL_INT(expected->cols, actual->cols);
+
+    for (int c = 0; c < expected->cols; c++) {
+        TEST_ASSERT_EQUAL_STRING(expected->columns[c], actual->columns[c]);
+        TEST_ASSERT_EQUAL_INT(expected->col_types[c], actual->col_types[c]);
+
+        for (int r = 0; r < expected->rows; r++) {
+            const DataType type = expected->col_types[c];
+            if (type == TYPE_STRING || type == TYPE_CATEGORY) {
+                TEST_ASSERT_EQUAL_STRING(dataframe_get_string(expected, r, c),
+                                         dataframe_get_string(actual, r, c));
+            } else if (type == TYPE_NUMERIC) {
+                TEST_ASSERT_EQUAL_DOUBLE(dataframe_get_cell(expected, r, c).v_num,
+                                         dataframe_get_cell(actual, r, c).v_num);
+            } else {
+                TEST_ASSERT_EQUAL_INT64(dataframe_get_cell(expected, r, c).v_int,
+                                        dataframe_get_cell(actual, r, c).v_int);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Tests loading a file a second time through its sidecar.
+ * Expected result: The first load parses and writes the sidecar, later loads come from the
+ * mapping in either layout and match the parsed frame, numeric columns are exposed in place,
+ * and modifying or growing a mapped frame leaves the sidecar unchanged.
+ */
+void test_CsvCache_WarmLoadMatchesParse(void)
+{
+    write_source("Date,Ticker,Price,Qty,Note\n"
+                 "2024-01-02,AAPL,150.5,100,first\n"
+                 "2024-01-03,MSFT,,200,\n"
+                 "2024-01-04,AAPL,152.25,300,third\n");
+
+    CsvReadOptions options = csv_default_read_options();
+    options.use_cache = true;
+    options.infer_dates = true;
+    options.infer_integers = true;
+    options.layout = DATAFRAME_LAYOUT_COLUMNS;
+
+    DataFrame *cold = NULL;
+    DataFrame *warm = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CACHE_CSV, &options, &cold));
+    TEST_ASSERT_NULL(cold->mapping);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CACHE_CSV, &options, &warm));
+    TEST_ASSERT_NOT_NULL(warm->mapping);
+    TEST_ASSERT_EQUAL_INT(TYPE_DATE, warm->col_types[0]);
+    TEST_ASSERT_EQUAL_INT(TYPE_INT64, warm->col_types[3]);
+    assert_frames_equal(cold, warm);
+
+    const double *prices = dataframe_numeric_column(warm, 2);
+    TEST_ASSERT_NOT_NULL(prices);
+    TEST_ASSERT_EQUAL_DOUBLE(152.25, prices[2]);
+
+    /* Writes go to private copies of the mapped pages, and growing moves columns to the heap */
+    DataCell cell = {0};
+    cell.v_num = -1.0;
+    dataframe_set_cell(warm, 0, 2, cell);
+    TEST_ASSERT_TRUE(dataframe_push_row(warm) == 3);
+    TEST_ASSERT_EQUAL_DOUBLE(-1.0, dataframe_get_cell(warm, 0, 2).v_num);
+    TEST_ASSERT_EQUAL_STRING("third", dataframe_get_string(warm, 2, 4));
+    free_dataframe(warm);
+
+    options.layout = DATAFRAME_LAYOUT_ROWS;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CACHE_CSV, &options, &warm));
+    TEST_ASSERT_NOT_NULL(warm->mapping);
+    TEST_ASSERT_NOT_NULL(warm->data);
+    TEST_ASSERT_EQUAL_DOUBLE(150.5, warm->data[0][2].v_num);
+    assert_frames_equal(cold, warm);
+    free_dataframe(warm);
+    free_dataframe(cold);
+
+    /* Different result-affecting options miss the cache and replace the sidecar */
+    options.dictionary_encode = true;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CACHE_CSV, &options, &cold));
+    TEST_ASSERT_NULL(cold->mapping);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CACHE_CSV, &options, &warm));
+    TEST_ASSERT_NOT_NULL(warm->mapping);
+    TEST_ASSERT_EQUAL_INT(TYPE_CATEGORY, warm->col_types[1]);
+    assert_frames_equal(cold, warm);
+    free_dataframe(warm);
+    free_dataframe(cold);
+
+    remove_files();
+}
+
+/**
+ * @brief Tests that stale or damaged sidecars are never used.
+ * Expected result: A changed source or an overwritten sidecar is parsed again (and the sidecar
+ * rewritten), a missing sidecar is reported, and the bad-row log survives the round trip.
+ */
+void test_CsvCache_InvalidatedBySourceChange(void)
+{
+    write_source("A,B\n1,x\n2,y\n");
+
+    CsvReadOptions options = csv_default_read_options();
+    options.use_cache = true;
+    options.bad_rows = CSV_BAD_ROWS_SKIP;
+
+    uint64_t key;
+    DataFrame *df = NULL;
+    TEST_ASSERT_TRUE(csv_cache_key(TEST_CACHE_CSV, &options, &key));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_FILE_NOT_FOUND,
+                      csv_cache_load(TEST_CACHE_CSV, key, DATAFRAME_LAYOUT_ROWS, &df));
+    TEST_ASSERT_NULL(df);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CACHE_CSV, &options, &df));
+    free_dataframe(df);
+
+    write_source("A,B\n1,x\n2,y,extra\n3,z\n");
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CACHE_CSV, &options, &df));
+    TEST_ASSERT_NULL(df->mapping);
+    TEST_ASSERT_EQUAL_INT(2, df->rows);
+    free_dataframe(df);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CACHE_CSV, &options, &df));
+    TEST_ASSERT_NOT_NULL(df->mapping);
+    TEST_ASSERT_EQUAL_INT(2, df->rows);
+    TEST_ASSERT_EQUAL_STRING("z", df->data[1][1].v_str);
+    TEST_ASSERT_EQUAL_size_t(1, df->bad_rows.count);
+    TEST_ASSERT_EQUAL_size_t(1, df->bad_rows.total);
+    TEST_ASSERT_EQUAL_UINT64(3, df->bad_rows.entries[0].line);
+    free_dataframe(df);
+
+    FILE *f = fopen(TEST_CACHE_SIDECAR, "r+b");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("garbage", f);
+    fclose(f);
+
+    TEST_ASSERT_TRUE(csv_cache_key(TEST_CACHE_CSV, &options, &key));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT,
+                      csv_cache_load(TEST_CACHE_CSV, key, DATAFRAME_LAYOUT_ROWS, &df));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CACHE_CSV, &options, &df));
+    TEST_ASSERT_NULL(df->mapping);
+    TEST_ASSERT_EQUAL_INT(2, df->rows);
+    free_dataframe(df);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      csv_cache_load(TEST_CACHE_CSV, key, DATAFRAME_LAYOUT_COLUMNS, &df));
+    TEST_ASSERT_EQUAL_STRING("z", dataframe_get_string(df, 1, 1));
+    free_dataframe(df);
+
+    remove_files();
+}
+
+/**
+ * @brief Test runner for the CSV cache module.
+ */
+void run_csv_cache_tests(void)
+{
+    RUN_TEST(test_CsvCache_WarmLoadMatchesParse);
+    RUN_TEST(test_CsvCache_InvalidatedBySourceChange);
+}
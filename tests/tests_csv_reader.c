@@ -2,9 +2,14 @@
 #include "dataframe.h"
 #include "csv_reader.h"
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
 #define TEST_CSV_FILE "test_data.tmp.csv"
 
 /**
@@ -53,6 +58,8 @@ void test_LoadCsv_WithHeader(void) {
 
     TEST_ASSERT_EQUAL_STRING("Cena", df->columns[0]);
     TEST_ASSERT_EQUAL_STRING("Ilosc", df->columns[1]);
+    TEST_ASSERT_NOT_NULL(df->name_index);
+    TEST_ASSERT_EQUAL_INT(1, dataframe_col_index(df, "Ilosc"));
 
     TEST_ASSERT_EQUAL_DOUBLE(10.5, df->data[0][0].v_num);
     TEST_ASSERT_EQUAL_DOUBLE(5.0,  df->data[0][1].v_num);
@@ -184,6 +191,753 @@ void test_LoadCsv_MixedTypes(void) {
     free_dataframe(df);
 }
 
+/**
+ * @brief Tests the memory-mapped loader on a file with a header row.
+ * Expected result: Identical shape, names and values to read_csv.
+ */
+void test_LoadCsvMmap_WithHeader(void) {
+    create_temp_csv("Cena;Ilosc\n10.5;5\n20.0;2\n");
+
+    DataFrame *df = NULL;
+    const DataframeErrorCode err = read_csv_mmap(TEST_CSV_FILE, true, ";", &df);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, err);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL_INT(2, df->rows);
+    TEST_ASSERT_EQUAL_INT(2, df->cols);
+
+    TEST_ASSERT_EQUAL_STRING("Cena", df->columns[0]);
+    TEST_ASSERT_EQUAL_STRING("Ilosc", df->columns[1]);
+
+    TEST_ASSERT_EQUAL_DOUBLE(10.5, df->data[0][0].v_num);
+    TEST_ASSERT_EQUAL_DOUBLE(2.0,  df->data[1][1].v_num);
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests quoted fields containing delimiters and line breaks, CRLF endings
+ * and a final record without a trailing newline.
+ * Expected result: Quoted content stays inside a single field and every row is kept.
+ */
+void test_LoadCsvMmap_QuotedFieldsAndCrlf(void) {
+    create_temp_csv("Name,Price\r\n\"Acme, Inc.\",1.5\r\n\"Multi\nLine\",2.5\r\n\r\nLast,3");
+
+    DataFrame *df = NULL;
+    const DataframeErrorCode err = read_csv_mmap(TEST_CSV_FILE, true, ",", &df);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, err);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL_INT(3, df->rows);
+
+    TEST_ASSERT_EQUAL_STRING("Price", df->columns[1]);
+    TEST_ASSERT_EQUAL_STRING("Acme, Inc.", df->data[0][0].v_str);
+    TEST_ASSERT_EQUAL_STRING("Multi\nLine", df->data[1][0].v_str);
+    TEST_ASSERT_EQUAL_STRING("Last", df->data[2][0].v_str);
+    TEST_ASSERT_EQUAL_DOUBLE(3.0, df->data[2][1].v_num);
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests error reporting of the memory-mapped loader.
+ * Expected result: Missing, empty and ragged files map to the same codes as read_csv.
+ */
+void test_LoadCsvMmap_Errors(void) {
+    DataFrame *df = NULL;
+
+    remove(TEST_CSV_FILE);
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_FILE_NOT_FOUND, read_csv_mmap(TEST_CSV_FILE, true, ";", &df));
+    TEST_ASSERT_NULL(df);
+
+    create_temp_csv("");
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_EMPTY_FILE, read_csv_mmap(TEST_CSV_FILE, true, ";", &df));
+    TEST_ASSERT_NULL(df);
+
+    create_temp_csv("10.5;5\n20.0;2;1\n");
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_MISMATCH, read_csv_mmap(TEST_CSV_FILE, false, ";", &df));
+    TEST_ASSERT_NULL(df);
+
+    clean_temp_file();
+}
+
+/**
+ * @brief Tests a file larger than one read block, so records straddle block boundaries.
+ * Expected result: Every row is loaded exactly once with the correct values.
+ */
+void test_LoadCsv_SpansMultipleBlocks(void) {
+    FILE *f = fopen(TEST_CSV_FILE, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("Id,Label,Value\n", f);
+    for (int i = 0; i < 40000; i++) {
+        fprintf(f, "%d,\"item %d\",%d.25\n", i, i, i);
+    }
+    fclose(f);
+
+    DataFrame *df = NULL;
+    const DataframeErrorCode err = read_csv(TEST_CSV_FILE, true, ",", &df);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, err);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL_INT(40000, df->rows);
+    TEST_ASSERT_EQUAL_INT(TYPE_STRING, df->col_types[1]);
+
+    for (int i = 0; i < df->rows; i += 997) {
+        TEST_ASSERT_EQUAL_DOUBLE((double)i, df->data[i][0].v_num);
+        TEST_ASSERT_EQUAL_DOUBLE(i + 0.25, df->data[i][2].v_num);
+    }
+    TEST_ASSERT_EQUAL_STRING("item 39999", df->data[39999][1].v_str);
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests loading with an explicit row capacity hint.
+ * Expected result: The row table is reserved up front and no extra rows are reported.
+ */
+void test_LoadCsv_RowCapacityHint(void) {
+    create_temp_csv("A;B\n1;2\n3;4\n5;6\n");
+
+    CsvReadOptions options = csv_default_read_options();
+    options.delim = ";";
+    options.row_capacity_hint = 1000;
+
+    DataFrame *df = NULL;
+    const DataframeErrorCode err = read_csv_with_options(TEST_CSV_FILE, &options, &df);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, err);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL_INT(3, df->rows);
+    TEST_ASSERT_EQUAL_INT(1000, df->row_capacity);
+    TEST_ASSERT_EQUAL_DOUBLE(6.0, df->data[2][1].v_num);
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests the row table reserved for a mapped file whose header is much narrower than its
+ * rows.
+ * Expected result: The reservation follows the width of the data records, not the header's.
+ */
+void test_LoadCsv_RowCapacityFromData(void) {
+    FILE *f = fopen(TEST_CSV_FILE, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("A,B\n", f);
+    for (int i = 0; i < 1000; i++) {
+        fprintf(f, "%d.25,%d.5\n", 1000000 + i, 2000000 + i);
+    }
+    fclose(f);
+
+    CsvReadOptions options = csv_default_read_options();
+    options.layout = DATAFRAME_LAYOUT_COLUMNS;
+    options.memory_map = true;
+
+    DataFrame *df = NULL;
+    const DataframeErrorCode err = read_csv_with_options(TEST_CSV_FILE, &options, &df);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, err);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL_INT(1000, df->rows);
+    TEST_ASSERT_TRUE(df->row_capacity >= 1000 && df->row_capacity <= 1010);
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests the multi-threaded loader on a multi-megabyte file whose quoted fields
+ * contain delimiters and line breaks, so chunk splits land inside quoted sections.
+ * Expected result: The parallel result matches the serial result row for row.
+ */
+void test_LoadCsv_ParallelMatchesSerial(void) {
+    FILE *f = fopen(TEST_CSV_FILE, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("Id,Note,Value\n", f);
+    for (int i = 0; i < 60000; i++) {
+        fprintf(f, "%d,\"line one, %d\nline two ......................\",%d.5\n", i, i, i);
+    }
+    fclose(f);
+
+    CsvReadOptions options = csv_default_read_options();
+    DataFrame *serial = NULL;
+    DataFrame *parallel = NULL;
+
+    const DataframeErrorCode serial_err = read_csv_with_options(TEST_CSV_FILE, &options, &serial);
+    options.num_threads = 4;
+    const DataframeErrorCode parallel_err =
+        read_csv_with_options(TEST_CSV_FILE, &options, &parallel);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, serial_err);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, parallel_err);
+    TEST_ASSERT_EQUAL_INT(60000, serial->rows);
+    TEST_ASSERT_EQUAL_INT(serial->rows, parallel->rows);
+    TEST_ASSERT_EQUAL_STRING("Note", parallel->columns[1]);
+
+    for (int r = 0; r < serial->rows; r++) {
+        TEST_ASSERT_EQUAL_DOUBLE(serial->data[r][0].v_num, parallel->data[r][0].v_num);
+        TEST_ASSERT_EQUAL_STRING(serial->data[r][1].v_str, parallel->data[r][1].v_str);
+        TEST_ASSERT_EQUAL_DOUBLE(serial->data[r][2].v_num, parallel->data[r][2].v_num);
+    }
+
+    free_dataframe(serial);
+    free_dataframe(parallel);
+}
+
+/**
+ * @brief Tests the tolerant bad-row policies and the bad-row log.
+ * Expected result: Short and long records are skipped or padded/truncated, each is logged with
+ * its physical line (counting line breaks inside quotes) and byte offset, the log stops at its
+ * limit while the total keeps counting, and the default policy still rejects the file.
+ */
+void test_LoadCsv_BadRowsTolerated(void) {
+    const char *content = "A,B,C\n1,2,3\n4,5\n\"x\ny\",7,8\n9,10,11,12\n13,14,15\n";
+    create_temp_csv(content);
+
+    CsvReadOptions options = csv_default_read_options();
+    DataFrame *df = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_MISMATCH,
+                      read_csv_with_options(TEST_CSV_FILE, &options, &df));
+    TEST_ASSERT_NULL(df);
+
+    options.bad_rows = CSV_BAD_ROWS_SKIP;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CSV_FILE, &options, &df));
+    TEST_ASSERT_EQUAL_INT(3, df->rows);
+    TEST_ASSERT_EQUAL_STRING("x\ny", df->data[1][0].v_str);
+    TEST_ASSERT_EQUAL_STRING("13", df->data[2][0].v_str);
+    TEST_ASSERT_EQUAL_size_t(2, df->bad_rows.count);
+    TEST_ASSERT_EQUAL_UINT64(2, df->bad_rows.total);
+    TEST_ASSERT_EQUAL_UINT64(3, df->bad_rows.entries[0].line);
+    TEST_ASSERT_EQUAL_UINT64(12, df->bad_rows.entries[0].offset);
+    TEST_ASSERT_EQUAL_UINT32(2, df->bad_rows.entries[0].fields);
+    TEST_ASSERT_EQUAL_UINT64(6, df->bad_rows.entries[1].line);
+    TEST_ASSERT_EQUAL_UINT64(26, df->bad_rows.entries[1].offset);
+    TEST_ASSERT_EQUAL_UINT32(4, df->bad_rows.entries[1].fields);
+    free_dataframe(df);
+
+    options.bad_rows = CSV_BAD_ROWS_PAD;
+    options.bad_row_log_limit = 1;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CSV_FILE, &options, &df));
+    TEST_ASSERT_EQUAL_INT(5, df->rows);
+    TEST_ASSERT_EQUAL_STRING("4", df->data[1][0].v_str);
+    TEST_ASSERT_TRUE(isnan(df->data[1][2].v_num));
+    TEST_ASSERT_EQUAL_STRING("9", df->data[3][0].v_str);
+    TEST_ASSERT_EQUAL_DOUBLE(11.0, df->data[3][2].v_num);
+    TEST_ASSERT_EQUAL_size_t(1, df->bad_rows.count);
+    TEST_ASSERT_EQUAL_UINT64(2, df->bad_rows.total);
+    free_dataframe(df);
+
+    clean_temp_file();
+}
+
+/**
+ * @brief Tests the tolerant mode of the multi-threaded loader, whose chunks each see only part
+ * of the file.
+ * Expected result: The parallel bad-row log matches the serial one entry for entry, also when
+ * only a late chunk holds bad rows.
+ */
+void test_LoadCsv_BadRowsParallel(void) {
+    FILE *f = fopen(TEST_CSV_FILE, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("Id,Note,Value\n", f);
+    for (int i = 0; i < 60000; i++) {
+        if (i % 997 == 0)
+            fprintf(f, "%d,\"broken\nrecord\"\n", i);
+        else
+            fprintf(f, "%d,\"line one, %d\nline two ......................\",%d.5\n", i, i, i);
+    }
+    fclose(f);
+
+    CsvReadOptions options = csv_default_read_options();
+    options.bad_rows = CSV_BAD_ROWS_SKIP;
+    options.bad_row_log_limit = 50;
+    DataFrame *serial = NULL;
+    DataFrame *parallel = NULL;
+
+    const DataframeErrorCode serial_err = read_csv_with_options(TEST_CSV_FILE, &options, &serial);
+    options.num_threads = 4;
+    const DataframeErrorCode parallel_err =
+        read_csv_with_options(TEST_CSV_FILE, &options, &parallel);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, serial_err);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, parallel_err);
+    TEST_ASSERT_EQUAL_INT(60000 - 61, serial->rows);
+    TEST_ASSERT_EQUAL_INT(serial->rows, parallel->rows);
+    TEST_ASSERT_EQUAL_UINT64(61, serial->bad_rows.total);
+    TEST_ASSERT_EQUAL_UINT64(61, parallel->bad_rows.total);
+    TEST_ASSERT_EQUAL_size_t(50, parallel->bad_rows.count);
+    TEST_ASSERT_EQUAL_UINT64(2, serial->bad_rows.entries[0].line);
+
+    for (size_t i = 0; i < serial->bad_rows.count; i++) {
+        TEST_ASSERT_EQUAL_UINT64(serial->bad_rows.entries[i].line,
+                                 parallel->bad_rows.entries[i].line);
+        TEST_ASSERT_EQUAL_UINT64(serial->bad_rows.entries[i].offset,
+                                 parallel->bad_rows.entries[i].offset);
+    }
+
+    free_dataframe(serial);
+    free_dataframe(parallel);
+
+    /* Bad rows only in the last chunk: the clean chunks before it must still count their lines */
+    f = fopen(TEST_CSV_FILE, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("Id,Note,Value\n", f);
+    for (int i = 0; i < 200000; i++) {
+        if (i == 190000 || i == 195000)
+            fprintf(f, "%d,broken\n", i);
+        else
+            fprintf(f, "%d,note %d,%d.5\n", i, i, i);
+    }
+    fclose(f);
+
+    options.num_threads = 1;
+    const DataframeErrorCode late_serial_err =
+        read_csv_with_options(TEST_CSV_FILE, &options, &serial);
+    options.num_threads = 4;
+    const DataframeErrorCode late_parallel_err =
+        read_csv_with_options(TEST_CSV_FILE, &options, &parallel);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, late_serial_err);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, late_parallel_err);
+    TEST_ASSERT_EQUAL_size_t(2, serial->bad_rows.count);
+    TEST_ASSERT_EQUAL_size_t(2, parallel->bad_rows.count);
+    TEST_ASSERT_EQUAL_UINT64(190002, serial->bad_rows.entries[0].line);
+    for (size_t i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL_UINT64(serial->bad_rows.entries[i].line,
+                                 parallel->bad_rows.entries[i].line);
+        TEST_ASSERT_EQUAL_UINT64(serial->bad_rows.entries[i].offset,
+                                 parallel->bad_rows.entries[i].offset);
+    }
+
+    free_dataframe(serial);
+    free_dataframe(parallel);
+}
+
+/**
+ * @brief Tests loading into the columnar layout, serially and with several threads.
+ * Expected result: Both match the row-layout result and numeric columns are exposed as
+ * cache-line aligned double arrays.
+ */
+void test_LoadCsv_ColumnarLayout(void) {
+    FILE *f = fopen(TEST_CSV_FILE, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("Id,Ticker,Price\n", f);
+    for (int i = 0; i < 100000; i++) {
+        fprintf(f, "%d,T%d,%d.25\n", i, i % 7, i);
+    }
+    fclose(f);
+
+    CsvReadOptions options = csv_default_read_options();
+    DataFrame *rows = NULL;
+    DataFrame *serial = NULL;
+    DataFrame *parallel = NULL;
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CSV_FILE, &options, &rows));
+    options.layout = DATAFRAME_LAYOUT_COLUMNS;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CSV_FILE, &options, &serial));
+    options.num_threads = 4;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      read_csv_with_options(TEST_CSV_FILE, &options, &parallel));
+
+    clean_temp_file();
+
+    TEST_ASSERT_NULL(dataframe_numeric_column(rows, 2));
+    TEST_ASSERT_NULL(dataframe_numeric_column(serial, 1));
+
+    const DataFrame *columnar[] = {serial, parallel};
+    for (int k = 0; k < 2; k++) {
+        const DataFrame *df = columnar[k];
+        TEST_ASSERT_EQUAL_INT(DATAFRAME_LAYOUT_COLUMNS, df->layout);
+        TEST_ASSERT_EQUAL_INT(rows->rows, df->rows);
+
+        const double *prices = dataframe_numeric_column(df, 2);
+        TEST_ASSERT_NOT_NULL(prices);
+        TEST_ASSERT_EQUAL_UINT(0, (uintptr_t)prices % CACHE_LINE_SIZE);
+
+        for (int r = 0; r < rows->rows; r++) {
+            TEST_ASSERT_EQUAL_DOUBLE(rows->data[r][2].v_num, prices[r]);
+            TEST_ASSERT_EQUAL_STRING(rows->data[r][1].v_str, dataframe_get_cell(df, r, 1).v_str);
+        }
+    }
+
+    free_dataframe(rows);
+    free_dataframe(serial);
+    free_dataframe(parallel);
+}
+
+/**
+ * @brief Tests dictionary-encoding text columns, serially and with several threads.
+ * Expected result: Cells hold codes into one shared dictionary per column and decode to
+ * the original strings; the parallel result translates every chunk's codes.
+ */
+void test_LoadCsv_DictionaryEncode(void) {
+    FILE *f = fopen(TEST_CSV_FILE, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("Ticker,Price\n", f);
+    for (int i = 0; i < 200000; i++) {
+        fprintf(f, "T%d,%d\n", (i * 7919) % 13, i);
+    }
+    fclose(f);
+
+    CsvReadOptions options = csv_default_read_options();
+    options.dictionary_encode = true;
+    DataFrame *serial = NULL;
+    DataFrame *parallel = NULL;
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CSV_FILE, &options, &serial));
+    options.num_threads = 4;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      read_csv_with_options(TEST_CSV_FILE, &options, &parallel));
+
+    clean_temp_file();
+
+    const DataFrame *frames[] = {serial, parallel};
+    for (int k = 0; k < 2; k++) {
+        const DataFrame *df = frames[k];
+        TEST_ASSERT_EQUAL_INT(200000, df->rows);
+        TEST_ASSERT_EQUAL_INT(TYPE_CATEGORY, df->col_types[0]);
+        TEST_ASSERT_EQUAL_INT(TYPE_NUMERIC, df->col_types[1]);
+        TEST_ASSERT_EQUAL_INT32(13, df->dictionaries[0]->count);
+
+        const int32_t t5 = string_dictionary_find(df->dictionaries[0], "T5", 2);
+        char expected[16];
+        for (int r = 0; r < df->rows; r++) {
+            snprintf(expected, sizeof(expected), "T%d", (r * 7919) % 13);
+            TEST_ASSERT_EQUAL_STRING(expected, dataframe_get_string(df, r, 0));
+            TEST_ASSERT_EQUAL((r * 7919) % 13 == 5, df->data[r][0].v_code == t5);
+        }
+    }
+
+    free_dataframe(serial);
+    free_dataframe(parallel);
+}
+
+/**
+ * @brief Tests type inference over a sample of rows with integer and date detection.
+ * Expected result: Placeholders for missing values in the first row no longer turn
+ * columns into text; integers and dates get their own types, missing values are NULL.
+ */
+void test_LoadCsv_SampledTypeInference(void) {
+    create_temp_csv("Date,Volume,Price,Note\n"
+                    "2024-01-02,N/A,,x\n"
+                    "2024-01-03,100,1.5,y\n"
+                    "2024-01-04,-200,2,z\n");
+
+    CsvReadOptions options = csv_default_read_options();
+    DataFrame *df = NULL;
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CSV_FILE, &options, &df));
+    TEST_ASSERT_EQUAL_INT(TYPE_STRING, df->col_types[0]);
+    TEST_ASSERT_EQUAL_INT(TYPE_NUMERIC, df->col_types[1]);
+    TEST_ASSERT_TRUE(isnan(df->data[0][1].v_num));
+    TEST_ASSERT_EQUAL_DOUBLE(100.0, df->data[1][1].v_num);
+    free_dataframe(df);
+
+    options.infer_integers = true;
+    options.infer_dates = true;
+    options.layout = DATAFRAME_LAYOUT_COLUMNS;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CSV_FILE, &options, &df));
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL_INT(3, df->rows);
+    TEST_ASSERT_EQUAL_INT(TYPE_DATE, df->col_types[0]);
+    TEST_ASSERT_EQUAL_INT(TYPE_INT64, df->col_types[1]);
+    TEST_ASSERT_EQUAL_INT(TYPE_NUMERIC, df->col_types[2]);
+    TEST_ASSERT_EQUAL_INT(TYPE_STRING, df->col_types[3]);
+
+    const int64_t *dates = dataframe_int64_column(df, 0);
+    const int64_t *volumes = dataframe_int64_column(df, 1);
+    TEST_ASSERT_NOT_NULL(dates);
+    TEST_ASSERT_NOT_NULL(volumes);
+    TEST_ASSERT_EQUAL_INT64(19725, dates[1]);
+    TEST_ASSERT_EQUAL_INT64(DATAFRAME_NULL_INT64, volumes[0]);
+    TEST_ASSERT_EQUAL_INT64(-200, volumes[2]);
+    TEST_ASSERT_TRUE(isnan(dataframe_numeric_column(df, 2)[0]));
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests converting date and timestamp columns while reading.
+ * Expected result: Date-only columns hold day counts, columns with times hold nanoseconds,
+ * and a value that does not parse after the sample is missing.
+ */
+void test_LoadCsv_DateTimeColumns(void) {
+    create_temp_csv("Date,Time,Price\n"
+                    "2026-01-01,2026-01-01T09:30:00,150.5\n"
+                    "2026-01-02,2026-01-02 09:30:00.250,152\n"
+                    "2026-01-03,bad,151.75\n");
+
+    CsvReadOptions options = csv_default_read_options();
+    options.infer_dates = true;
+    options.inference_rows = 2;
+
+    DataFrame *df = NULL;
+    const DataframeErrorCode err = read_csv_with_options(TEST_CSV_FILE, &options, &df);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, err);
+    TEST_ASSERT_EQUAL_INT(TYPE_DATE, df->col_types[0]);
+    TEST_ASSERT_EQUAL_INT(TYPE_TIMESTAMP, df->col_types[1]);
+    TEST_ASSERT_EQUAL_INT(TYPE_NUMERIC, df->col_types[2]);
+
+    const int64_t second = INT64_C(1000000000);
+    TEST_ASSERT_EQUAL_INT64(20454, df->data[0][0].v_int);
+    TEST_ASSERT_EQUAL_INT64(20455 * 86400 * second + 34200 * second + 250000000,
+                            df->data[1][1].v_int);
+    TEST_ASSERT_EQUAL_INT64(DATAFRAME_NULL_INT64, df->data[2][1].v_int);
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests reading a gzip-compressed file without a temporary copy.
+ * Expected result: The rows match the plain file, also when threads or batches are requested.
+ * Without zlib, the load fails with DATAFRAME_ERR_UNSUPPORTED_FORMAT.
+ */
+void test_LoadCsv_GzipInput(void) {
+    CsvReadOptions options = csv_default_read_options();
+    options.num_threads = 4;
+    DataFrame *df = NULL;
+
+#if defined(HAVE_ZLIB)
+    gzFile gz = gzopen(TEST_CSV_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(gz);
+    gzputs(gz, "Id,Value\n");
+    for (int i = 0; i < 50000; i++) {
+        gzprintf(gz, "%d,%d.5\n", i, i % 100);
+    }
+    gzclose(gz);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CSV_FILE, &options, &df));
+    TEST_ASSERT_EQUAL_INT(50000, df->rows);
+    TEST_ASSERT_EQUAL_STRING("Value", df->columns[1]);
+    TEST_ASSERT_EQUAL_DOUBLE(49999.0, df->data[49999][0].v_num);
+    TEST_ASSERT_EQUAL_DOUBLE(99.5, df->data[49999][1].v_num);
+    free_dataframe(df);
+
+    CsvStream *stream = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, csv_stream_open(TEST_CSV_FILE, &options, &stream));
+    size_t total = 0;
+    DataFrame *batch = NULL;
+    while (csv_stream_next_batch(stream, 7000, &batch) == DATAFRAME_SUCCESS && batch) {
+        TEST_ASSERT_EQUAL_DOUBLE((double)total, batch->data[0][0].v_num);
+        total += (size_t)batch->rows;
+    }
+    csv_stream_close(stream);
+    TEST_ASSERT_EQUAL_size_t(50000, total);
+#else
+    FILE *f = fopen(TEST_CSV_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    fwrite("\x1f\x8b\x08\x00\x00\x00\x00\x00", 1, 8, f);
+    fclose(f);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_UNSUPPORTED_FORMAT,
+                      read_csv_with_options(TEST_CSV_FILE, &options, &df));
+    TEST_ASSERT_NULL(df);
+#endif
+
+    clean_temp_file();
+}
+
+/**
+ * @brief Tests reading a file as a sequence of fixed-size batches.
+ * Expected result: Batches hold at most the requested rows, continue where the previous
+ * one stopped, reuse the same buffer and end with a NULL batch.
+ */
+void test_CsvStream_Batches(void) {
+    create_temp_csv("Ticker,Price\nA,1\nB,2\nC,3\nD,4\nE,5\n");
+
+    CsvReadOptions options = csv_default_read_options();
+    CsvStream *stream = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, csv_stream_open(TEST_CSV_FILE, &options, &stream));
+
+    DataFrame *batch = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, csv_stream_next_batch(stream, 2, &batch));
+    TEST_ASSERT_NOT_NULL(batch);
+    DataFrame *first = batch;
+    TEST_ASSERT_EQUAL_INT(2, batch->rows);
+    TEST_ASSERT_EQUAL_STRING("Price", batch->columns[1]);
+    TEST_ASSERT_EQUAL_STRING("A", batch->data[0][0].v_str);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, csv_stream_next_batch(stream, 2, &batch));
+    TEST_ASSERT_EQUAL_PTR(first, batch);
+    TEST_ASSERT_EQUAL_INT(2, batch->rows);
+    TEST_ASSERT_EQUAL_STRING("C", batch->data[0][0].v_str);
+    TEST_ASSERT_EQUAL_DOUBLE(4.0, batch->data[1][1].v_num);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, csv_stream_next_batch(stream, 2, &batch));
+    TEST_ASSERT_EQUAL_INT(1, batch->rows);
+    TEST_ASSERT_EQUAL_STRING("E", batch->data[0][0].v_str);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, csv_stream_next_batch(stream, 2, &batch));
+    TEST_ASSERT_NULL(batch);
+
+    csv_stream_close(stream);
+    clean_temp_file();
+}
+
+/**
+ * @brief Tests keeping a subset of columns selected by name.
+ * Expected result: Only the requested columns are loaded, in file order.
+ */
+void test_LoadCsv_UseColsByName(void) {
+    create_temp_csv("Date,Ticker,Price,Volume\n2023-01-01,AAPL,150.5,100\n2023-01-02,MSFT,250.0,200\n");
+
+    const char *keep[] = {"Volume", "Ticker"};
+    CsvReadOptions options = csv_default_read_options();
+    options.usecols = keep;
+    options.usecols_count = 2;
+
+    DataFrame *df = NULL;
+    const DataframeErrorCode err = read_csv_with_options(TEST_CSV_FILE, &options, &df);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, err);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL_INT(2, df->rows);
+    TEST_ASSERT_EQUAL_INT(2, df->cols);
+
+    TEST_ASSERT_EQUAL_STRING("Ticker", df->columns[0]);
+    TEST_ASSERT_EQUAL_STRING("Volume", df->columns[1]);
+    TEST_ASSERT_EQUAL_INT(TYPE_STRING, df->col_types[0]);
+    TEST_ASSERT_EQUAL_INT(TYPE_NUMERIC, df->col_types[1]);
+    TEST_ASSERT_EQUAL_STRING("MSFT", df->data[1][0].v_str);
+    TEST_ASSERT_EQUAL_DOUBLE(200.0, df->data[1][1].v_num);
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests keeping a subset of columns selected by index in a headerless file,
+ * and asking for a column that does not exist.
+ * Expected result: Indices select the right fields; unknown columns are reported.
+ */
+void test_LoadCsv_UseColsByIndex(void) {
+    create_temp_csv("1;x;3\n4;y;6\n");
+
+    const int keep[] = {2};
+    CsvReadOptions options = csv_default_read_options();
+    options.has_header = false;
+    options.delim = ";";
+    options.usecols_indices = keep;
+    options.usecols_count = 1;
+
+    DataFrame *df = NULL;
+    DataframeErrorCode err = read_csv_with_options(TEST_CSV_FILE, &options, &df);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, err);
+    TEST_ASSERT_EQUAL_INT(1, df->cols);
+    TEST_ASSERT_EQUAL_STRING("col_3", df->columns[0]);
+    TEST_ASSERT_EQUAL_DOUBLE(3.0, df->data[0][0].v_num);
+    TEST_ASSERT_EQUAL_DOUBLE(6.0, df->data[1][0].v_num);
+    free_dataframe(df);
+
+    const char *missing[] = {"Price"};
+    options.usecols = missing;
+    err = read_csv_with_options(TEST_CSV_FILE, &options, &df);
+
+    clean_temp_file();
+
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND, err);
+    TEST_ASSERT_NULL(df);
+}
+
+/**
+ * @brief Tests loading with a row filter, serially, in parallel and in batches.
+ * Expected result: Only the records satisfying every condition become rows, in file order,
+ * and a filter on a column that is not kept fails the load.
+ */
+void test_LoadCsv_FilterPushdown(void) {
+    const char *tickers[] = {"AAPL", "MSFT", "IBM"};
+    FILE *f = fopen(TEST_CSV_FILE, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("Ticker,Day,Price,Volume,Note\n", f);
+    int expected = 0;
+    for (int i = 0; i < 150000; i++) {
+        const int price = 100 + i * 37 % 101;
+        const int volume = i * 7919 % 5000;
+        fprintf(f, "%s,2024-01-%02d,%d.5,%d,\"note %d, x\"\n",
+                tickers[i % 3], 1 + i % 28, price, volume, i);
+        expected += i % 3 == 1 && price >= 190 && volume >= 1000 && 1 + i % 28 <= 20;
+    }
+    fclose(f);
+
+    FilterPredicate filter;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_predicate_parse(
+                          "Price > 190 AND Volume >= 1000 AND Ticker == MSFT AND Day <= 2024-01-20",
+                          &filter));
+    CsvReadOptions options = csv_default_read_options();
+    options.dictionary_encode = true;
+    options.infer_integers = true;
+    options.infer_dates = true;
+    options.filter = &filter;
+
+    for (int threads = 1; threads <= 2; threads++) {
+        options.num_threads = threads;
+        DataFrame *df = NULL;
+        TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(TEST_CSV_FILE, &options, &df));
+        TEST_ASSERT_EQUAL_INT(expected, df->rows);
+        TEST_ASSERT_EQUAL_INT(TYPE_CATEGORY, df->col_types[0]);
+        TEST_ASSERT_EQUAL_INT(TYPE_INT64, df->col_types[3]);
+
+        int row = 0;
+        for (int i = 0; i < 150000 && row < df->rows; i++) {
+            const int price = 100 + i * 37 % 101;
+            const int volume = i * 7919 % 5000;
+            if (i % 3 != 1 || price < 190 || volume < 1000 || 1 + i % 28 > 20)
+                continue;
+            TEST_ASSERT_EQUAL_STRING("MSFT", dataframe_get_string(df, row, 0));
+            TEST_ASSERT_EQUAL_DOUBLE(price + 0.5, dataframe_get_cell(df, row, 2).v_num);
+            TEST_ASSERT_EQUAL_INT64(volume, dataframe_get_cell(df, row, 3).v_int);
+            row++;
+        }
+        TEST_ASSERT_EQUAL_INT(expected, row);
+        free_dataframe(df);
+    }
+
+    CsvStream *stream = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, csv_stream_open(TEST_CSV_FILE, &options, &stream));
+    int streamed = 0;
+    DataFrame *batch = NULL;
+    do {
+        TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, csv_stream_next_batch(stream, 1000, &batch));
+        streamed += batch ? batch->rows : 0;
+    } while (batch);
+    csv_stream_close(stream);
+    TEST_ASSERT_EQUAL_INT(expected, streamed);
+
+    const char *keep[] = {"Ticker", "Price"};
+    options.usecols = keep;
+    options.usecols_count = 2;
+    DataFrame *df = NULL;
+    const DataframeErrorCode err = read_csv_with_options(TEST_CSV_FILE, &options, &df);
+
+    clean_temp_file();
+    dataframe_predicate_free(&filter);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND, err);
+    TEST_ASSERT_NULL(df);
+}
+
 /**
  * @brief Test runner for the CSV reader module.
  */
@@ -195,4 +949,22 @@ void run_csv_reader_tests(void) {
     RUN_TEST(test_LoadCsv_ColumnMismatch);
     RUN_TEST(test_LoadCsv_MissingValues);
     RUN_TEST(test_LoadCsv_MixedTypes);
+    RUN_TEST(test_LoadCsvMmap_WithHeader);
+    RUN_TEST(test_LoadCsvMmap_QuotedFieldsAndCrlf);
+    RUN_TEST(test_LoadCsvMmap_Errors);
+    RUN_TEST(test_LoadCsv_SpansMultipleBlocks);
+    RUN_TEST(test_LoadCsv_RowCapacityHint);
+    RUN_TEST(test_LoadCsv_RowCapacityFromData);
+    RUN_TEST(test_LoadCsv_ParallelMatchesSerial);
+    RUN_TEST(test_LoadCsv_BadRowsTolerated);
+    RUN_TEST(test_LoadCsv_BadRowsParallel);
+    RUN_TEST(test_LoadCsv_ColumnarLayout);
+    RUN_TEST(test_LoadCsv_DictionaryEncode);
+    RUN_TEST(test_LoadCsv_SampledTypeInference);
+    RUN_TEST(test_LoadCsv_DateTimeColumns);
+    RUN_TEST(test_LoadCsv_GzipInput);
+    RUN_TEST(test_CsvStream_Batches);
+    RUN_TEST(test_LoadCsv_UseColsByName);
+    RUN_TEST(test_LoadCsv_UseColsByIndex);
+    RUN_TEST(test_LoadCsv_FilterPushdown);
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "csv_scanner.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_csv_scanner.c
+ * @brief Unit tests for the vectorized CSV structural scanner.
+ *
+ * Checks that delimiter and newline positions outside quotes are reported
+ * correctly, that quote state carries across calls, and that the dispatched
+ * SIMD backend agrees with the scalar reference on arbitrary input.
+ */
+
+/**
+ * @brief Tests a short record with a quoted delimiter.
+ * Expected result: Only the unquoted delimiters and the newline are reported.
+ */
+void test_ScanStructurals_SkipsQuotedDelimiters(void)
+{
+    const char *text = "a,\"b,c\",d\n";
+    uint32_t positions[16];
+    bool in_quotes = false;
+
+    const size_t count = csv_scan_structurals(text, strlen(text), ',', &in_quotes, positions);
+
+    TEST_ASSERT_EQUAL_UINT(3, count);
+    TEST_ASSERT_EQUAL_UINT32(1, positions[0]);
+    TEST_ASSERT_EQUAL_UINT32(7, positions[1]);
+    TEST_ASSERT_EQUAL_UINT32(9, positions[2]);
+    TEST_ASSERT_FALSE(in_quotes);
+}
+
+/**
+ * @brief Tests scanning a quoted section split across two calls at a 64-byte block edge.
+ * Expected result: The quote state is carried and the quoted newline is not reported.
+ */
+void test_ScanStructurals_CarriesQuoteState(void)
+{
+    char text[100];
+    memset(text, 'x', sizeof(text));
+    text[60] = '"';
+    text[70] = '\n';
+    text[80] = '"';
+    text[90] = ';';
+
+    uint32_t positions[100];
+    bool in_quotes = false;
+
+    size_t count = csv_scan_structurals(text, 64, ';', &in_quotes, positions);
+    TEST_ASSERT_EQUAL_UINT(0, count);
+    TEST_ASSERT_TRUE(in_quotes);
+
+    count = csv_scan_structurals(text + 64, sizeof(text) - 64, ';', &in_quotes, positions);
+    TEST_ASSERT_EQUAL_UINT(1, count);
+    TEST_ASSERT_EQUAL_UINT32(90 - 64, positions[0]);
+    TEST_ASSERT_FALSE(in_quotes);
+}
+
+/**
+ * @brief Tests the dispatched backend against the scalar reference on random CSV-like bytes.
+ * Expected result: Both produce identical offsets and final quote states for every length.
+ */
+void test_ScanStructurals_MatchesScalarReference(void)
+{
+    static const char alphabet[] = "ab1.,,\"\n\r ;";
+    char text[777];
+    uint32_t expected[sizeof(text)];
+    uint32_t actual[sizeof(text)];
+
+    srand(12345);
+    for (size_t i = 0; i < sizeof(text); i++) {
+        text[i] = alphabet[rand() % (int)(sizeof(alphabet) - 1)];
+    }
+
+    for (size_t len = 0; len <= sizeof(text); len += 37) {
+        bool q_expected = len % 2 == 0;
+        bool q_actual = q_expected;
+
+        const size_t n_expected =
+            csv_scan_structurals_scalar(text, len, ',', &q_expected, expected);
+        const size_t n_actual = csv_scan_structurals(text, len, ',', &q_actual, actual);
+
+        TEST_ASSERT_EQUAL_UINT(n_expected, n_actual);
+        TEST_ASSERT_EQUAL(q_expected, q_actual);
+        if (n_expected > 0)
+            TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, actual, n_expected);
+    }
+}
+
+/**
+ * @brief Test runner for the CSV scanner module.
+ */
+void run_csv_scanner_tests(void)
+{
+    RUN_TEST(test_ScanStructurals_SkipsQuotedDelimiters);
+    RUN_TEST(test_ScanStructurals_CarriesQuoteState);
+    RUN_TEST(test_ScanStructurals_MatchesScalarReference);
+}
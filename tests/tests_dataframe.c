@@ -1,4 +1,8 @@
+#include <math.h>
 #include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "dataframe.h"
 #include "unity/unity.h"
@@ -45,6 +49,217 @@ void test_CreateDataFrame_InvalidDimensions(void)
     TEST_ASSERT_NULL(df2);
 }
 
+/**
+ * @brief Tests growing an initially empty DataFrame past its reserved capacity.
+ * Expected result: Every appended row is zero-initialized and retains its values.
+ */
+void test_AppendRow_GrowsBeyondCapacity(void)
+{
+    DataFrame *df = create_dataframe_with_capacity((size_t)2, (size_t)2);
+
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL_INT(0, df->rows);
+
+    for (int i = 0; i < 100; i++) {
+        DataCell *row = dataframe_append_row(df);
+        TEST_ASSERT_NOT_NULL(row);
+        TEST_ASSERT_EQUAL_DOUBLE(0.0, row[1].v_num);
+        row[0].v_num = (double)i;
+    }
+
+    TEST_ASSERT_EQUAL_INT(100, df->rows);
+    TEST_ASSERT_TRUE(df->row_capacity >= 100);
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, df->data[0][0].v_num);
+    TEST_ASSERT_EQUAL_DOUBLE(99.0, df->data[99][0].v_num);
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests filling and growing a columnar DataFrame, then moving its rows.
+ * Expected result: Values survive reallocation and the move; accessors agree with the
+ * contiguous column view.
+ */
+void test_PushRow_ColumnarLayout(void)
+{
+    DataFrame *df = create_dataframe_with_layout((size_t)2, (size_t)2, DATAFRAME_LAYOUT_COLUMNS);
+    DataFrame *dst = create_dataframe_with_layout((size_t)0, (size_t)2, DATAFRAME_LAYOUT_ROWS);
+
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_NOT_NULL(dst);
+    TEST_ASSERT_NULL(dataframe_append_row(df));
+    df->col_types[1] = TYPE_STRING;
+
+    for (int i = 0; i < 100; i++) {
+        const int r = dataframe_push_row(df);
+        TEST_ASSERT_EQUAL_INT(i, r);
+        TEST_ASSERT_EQUAL_DOUBLE(0.0, dataframe_get_cell(df, r, 0).v_num);
+
+        DataCell cell = {.v_num = (double)i};
+        dataframe_set_cell(df, r, 0, cell);
+        cell.v_str = dataframe_store_string(df, "abc", (size_t)(i % 3));
+        dataframe_set_cell(df, r, 1, cell);
+    }
+
+    const double *values = dataframe_numeric_column(df, 0);
+    TEST_ASSERT_NOT_NULL(values);
+    TEST_ASSERT_NULL(dataframe_numeric_column(df, 1));
+    TEST_ASSERT_EQUAL_DOUBLE(57.0, values[57]);
+    TEST_ASSERT_EQUAL_STRING("ab", dataframe_get_cell(df, 98, 1).v_str);
+
+    dst->col_types[1] = TYPE_STRING;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_move_rows(dst, df));
+    TEST_ASSERT_EQUAL_INT(0, df->rows);
+    free_dataframe(df);
+
+    TEST_ASSERT_EQUAL_INT(100, dst->rows);
+    TEST_ASSERT_EQUAL_DOUBLE(99.0, dst->data[99][0].v_num);
+    TEST_ASSERT_EQUAL_STRING("a", dst->data[97][1].v_str);
+
+    free_dataframe(dst);
+}
+
+/**
+ * @brief Tests converting a string column into a dictionary-encoded column.
+ * Expected result: Repeated values share a code and still read back as strings.
+ */
+void test_DictionaryEncode_StringColumn(void)
+{
+    DataFrame *df = create_dataframe((size_t)4, (size_t)2);
+    TEST_ASSERT_NOT_NULL(df);
+
+    const char *tickers[] = {"AAPL", "MSFT", "AAPL", "AAPL"};
+    df->col_types[1] = TYPE_STRING;
+    for (int r = 0; r < 4; r++) {
+        df->data[r][1].v_str = dataframe_store_string(df, tickers[r], strlen(tickers[r]));
+    }
+
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND, dataframe_dictionary_encode(df, 0));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_dictionary_encode(df, 1));
+
+    TEST_ASSERT_EQUAL_INT(TYPE_CATEGORY, df->col_types[1]);
+    TEST_ASSERT_EQUAL_INT32(2, df->dictionaries[1]->count);
+    TEST_ASSERT_EQUAL_INT32(df->data[0][1].v_code, df->data[3][1].v_code);
+    TEST_ASSERT_EQUAL_STRING("MSFT", dataframe_get_string(df, 1, 1));
+    TEST_ASSERT_NULL(dataframe_get_string(df, 1, 0));
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests validity bitmaps through enabling, growth, row moves and clearing.
+ * Expected result: Bitmaps are derived from sentinels, a NaN marked valid is not null, null
+ * counts stay exact as the frame grows, and moved rows keep their nulls.
+ */
+void test_Validity_TracksNulls(void)
+{
+    DataFrame *df = create_dataframe_with_layout((size_t)2, (size_t)2, DATAFRAME_LAYOUT_COLUMNS);
+    DataFrame *dst = create_dataframe_with_layout((size_t)0, (size_t)2, DATAFRAME_LAYOUT_ROWS);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_NOT_NULL(dst);
+    df->col_types[1] = TYPE_INT64;
+    dst->col_types[1] = TYPE_INT64;
+
+    /* Sentinels written before tracking starts become nulls of the bitmap */
+    for (int i = 0; i < 3; i++) {
+        const int r = dataframe_push_row(df);
+        DataCell cell = {.v_num = i == 1 ? NAN : (double)i};
+        dataframe_set_cell(df, r, 0, cell);
+    }
+    size_t nulls = 99;
+    TEST_ASSERT_NULL(dataframe_column_validity(df, 0, &nulls));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(df));
+    TEST_ASSERT_NOT_NULL(dataframe_column_validity(df, 0, &nulls));
+    TEST_ASSERT_EQUAL_size_t(1, nulls);
+    TEST_ASSERT_NULL(dataframe_column_validity(df, 1, &nulls));
+    TEST_ASSERT_EQUAL_size_t(0, nulls);
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(df, 1, 0));
+
+    /* From now on the bitmap decides: a NaN written as a value is valid */
+    for (int i = 3; i < 200; i++) {
+        const int r = dataframe_push_row(df);
+        DataCell cell = {.v_num = i == 150 ? NAN : (double)i};
+        dataframe_set_cell(df, r, 0, cell);
+        if (i % 10 == 0)
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 1, false));
+    }
+    TEST_ASSERT_FALSE(dataframe_cell_is_null(df, 150, 0));
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(df, 190, 1));
+    TEST_ASSERT_EQUAL_INT64(DATAFRAME_NULL_INT64, dataframe_get_cell(df, 190, 1).v_int);
+    TEST_ASSERT_TRUE(dataframe_set_valid(df, 1, 0, true));
+    TEST_ASSERT_NULL(dataframe_column_validity(df, 0, &nulls));
+    const uint64_t *bits = dataframe_column_validity(df, 1, &nulls);
+    TEST_ASSERT_EQUAL_size_t(19, nulls);
+    TEST_ASSERT_EQUAL_HEX64(~(((uint64_t)1 << 10) | ((uint64_t)1 << 20) | ((uint64_t)1 << 30) |
+                              ((uint64_t)1 << 40) | ((uint64_t)1 << 50) | ((uint64_t)1 << 60)),
+                            bits[0]);
+
+    const uint8_t bitmap[] = {0xFE};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_set_validity_bitmap(df, 0, 4, bitmap, 8));
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(df, 4, 0));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND,
+                      dataframe_set_validity_bitmap(df, 0, 195, bitmap, 8));
+
+    /* Moved rows keep their nulls at their new positions */
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(dst));
+    TEST_ASSERT_EQUAL_INT(0, dataframe_push_row(dst));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_move_rows(dst, df));
+    TEST_ASSERT_EQUAL_INT(201, dst->rows);
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(dst, 5, 0));
+    TEST_ASSERT_FALSE(dataframe_cell_is_null(dst, 151, 0));
+    TEST_ASSERT_TRUE(isnan(dst->data[151][0].v_num));
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(dst, 191, 1));
+    dataframe_column_validity(dst, 1, &nulls);
+    TEST_ASSERT_EQUAL_size_t(19, nulls);
+    TEST_ASSERT_NULL(dataframe_column_validity(df, 1, &nulls));
+
+    dataframe_clear_rows(dst);
+    TEST_ASSERT_EQUAL_INT(0, dataframe_push_row(dst));
+    TEST_ASSERT_FALSE(dataframe_cell_is_null(dst, 0, 0));
+    TEST_ASSERT_NULL(dataframe_column_validity(dst, 0, &nulls));
+
+    free_dataframe(df);
+    free_dataframe(dst);
+}
+
+/**
+ * @brief Tests column lookup by name with and without the hash index.
+ * Expected result: Both paths find the first column carrying a name, report -1 for unknown
+ * names, and the index only reflects renames after it is rebuilt.
+ */
+void test_ColIndex_FindsColumns(void)
+{
+    DataFrame *df = create_dataframe_with_capacity(1, 40);
+    TEST_ASSERT_NOT_NULL(df);
+    for (int c = 0; c < df->cols; c++) {
+        char name[16];
+        snprintf(name, sizeof(name), "col_%d", c % 30);
+        df->columns[c] = strdup(name);
+    }
+
+    /* Unindexed frames are scanned */
+    TEST_ASSERT_NULL(df->name_index);
+    TEST_ASSERT_EQUAL_INT(7, dataframe_col_index(df, "col_7"));
+    TEST_ASSERT_EQUAL_INT(-1, dataframe_col_index(df, "col_30"));
+
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_index_columns(df));
+    TEST_ASSERT_EQUAL_INT(30, df->name_index->count);
+    for (int c = 0; c < df->cols; c++) {
+        TEST_ASSERT_EQUAL_INT(c % 30, dataframe_col_index(df, df->columns[c]));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, dataframe_col_index(df, "col_30"));
+    TEST_ASSERT_EQUAL_INT(-1, dataframe_col_index(df, "col_"));
+    TEST_ASSERT_EQUAL_INT(-1, dataframe_col_index(df, NULL));
+
+    free(df->columns[35]);
+    df->columns[35] = strdup("Close");
+    TEST_ASSERT_EQUAL_INT(-1, dataframe_col_index(df, "Close"));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_index_columns(df));
+    TEST_ASSERT_EQUAL_INT(35, dataframe_col_index(df, "Close"));
+
+    free_dataframe(df);
+}
+
 /**
  * @brief Test runner for the dataframe module.
  */
@@ -52,4 +267,9 @@ void run_dataframe_tests(void)
 {
     RUN_TEST(test_CreateDataFrame_Valid);
     RUN_TEST(test_CreateDataFrame_InvalidDimensions);
+    RUN_TEST(test_AppendRow_GrowsBeyondCapacity);
+    RUN_TEST(test_PushRow_ColumnarLayout);
+    RUN_TEST(test_DictionaryEncode_StringColumn);
+    RUN_TEST(test_Validity_TracksNulls);
+    RUN_TEST(test_ColIndex_FindsColumns);
 }
@@ -0,0 +1,310 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dataframe.h"
+#include "dataframe_binary.h"
+#include "test_helpers.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_dataframe_binary.c
+ * @brief Unit tests for the memory-mapped columnar DataFrame file format.
+ *
+ * Verifies round trips of every column type including missing values, that
+ * opened columns live in the file mapping, the written and reopened validity
+ * bitmaps, that opening a large file does no per-row work, and the rejection
+ * of truncated, foreign or mismatching files.
+ */
+
+#define TEST_BINARY_FILE "test_data.tmp.sdpframe"
+
+/**
+ * @brief Builds the shared typed frame without a Time column and with its missing day filled in.
+ *
+ * The Day column then has no missing value, so it is written without a validity bitmap.
+ *
+ * @param layout The storage layout of the frame.
+ * @return The new DataFrame.
+ */
+static DataFrame *make_frame(const DataFrameLayout layout)
+{
+    DataFrame *df = test_make_typed_frame(layout, false);
+    DataCell cell = {0};
+    cell.v_int = -3;
+    dataframe_set_cell(df, 0, 2, cell);
+    return df;
+}
+
+/**
+ * @brief Asserts that an opened frame holds the values written by make_frame.
+ * @param df The opened DataFrame.
+ */
+static void assert_frame_contents(const DataFrame *df)
+{
+    TEST_ASSERT_EQUAL_INT(9, df->rows);
+    TEST_ASSERT_EQUAL_INT(5, df->cols);
+    TEST_ASSERT_EQUAL_STRING("Ticker", df->columns[4]);
+    TEST_ASSERT_EQUAL_INT(TYPE_CATEGORY, df->col_types[4]);
+
+    for (int r = 0; r < 9; r++) {
+        if (r == 4)
+            TEST_ASSERT_TRUE(isnan(dataframe_get_cell(df, r, 0).v_num));
+        else
+            TEST_ASSERT_EQUAL_DOUBLE(r * 1.5, dataframe_get_cell(df, r, 0).v_num);
+        TEST_ASSERT_EQUAL_INT64(r == 8 ? DATAFRAME_NULL_INT64 : (int64_t)r * 1000000000000LL,
+                                dataframe_get_cell(df, r, 1).v_int);
+        TEST_ASSERT_EQUAL_INT64(-3 + r, dataframe_get_cell(df, r, 2).v_int);
+    }
+    TEST_ASSERT_NULL(dataframe_get_string(df, 3, 3));
+    TEST_ASSERT_EQUAL_STRING("note 7", dataframe_get_string(df, 7, 3));
+    TEST_ASSERT_EQUAL_STRING("IBM", dataframe_get_string(df, 6, 4));
+    TEST_ASSERT_NULL(dataframe_get_string(df, 5, 4));
+    TEST_ASSERT_EQUAL_INT(3, df->dictionaries[4]->count);
+}
+
+/**
+ * @brief Tests saving frames of both layouts and opening them again.
+ * Expected result: Values, types, names, dictionaries and the bad-row log survive, columnar
+ * opens use the mapped columns in place, and missing values are marked in validity bitmaps.
+ */
+void test_DataFrameBinary_RoundTrip(void)
+{
+    DataFrame *rows = make_frame(DATAFRAME_LAYOUT_ROWS);
+    const DataFrameBadRow bad = {12, 345, 7};
+    TEST_ASSERT_TRUE(dataframe_log_bad_row(rows, &bad, 10));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_save_binary(rows, TEST_BINARY_FILE, 42));
+    free_dataframe(rows);
+
+    DataFrame *df = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_open_mmap(TEST_BINARY_FILE, &df));
+    assert_frame_contents(df);
+    TEST_ASSERT_EQUAL_size_t(1, df->bad_rows.count);
+    TEST_ASSERT_EQUAL_UINT64(345, df->bad_rows.entries[0].offset);
+
+    /* The numeric column is the mapped file data itself, cache-line aligned */
+    const char *prices = (const char *)dataframe_numeric_column(df, 0);
+    TEST_ASSERT_TRUE(prices >= df->mapping->data && prices < df->mapping->data + df->mapping->size);
+    TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)prices % CACHE_LINE_SIZE);
+
+    /* Validity bitmaps: only columns with missing values have one, bit clear for the null */
+    const DataFrameBinaryHeader *header = (const DataFrameBinaryHeader *)df->mapping->data;
+    const DataFrameBinaryColumn *columns =
+        (const DataFrameBinaryColumn *)(df->mapping->data + sizeof(DataFrameBinaryHeader));
+    TEST_ASSERT_EQUAL_UINT32(DATAFRAME_BINARY_VERSION, header->version);
+    TEST_ASSERT_EQUAL_UINT64(42, header->tag);
+    TEST_ASSERT_EQUAL_UINT64(1, columns[0].null_count);
+    TEST_ASSERT_EQUAL_UINT64(0, columns[0].validity_offset % DATAFRAME_BINARY_ALIGNMENT);
+    const uint64_t *price_bits = (const uint64_t *)(df->mapping->data + columns[0].validity_offset);
+    TEST_ASSERT_EQUAL_HEX64(~((uint64_t)1 << 4), price_bits[0]);
+    TEST_ASSERT_EQUAL_PTR(price_bits, dataframe_column_validity(df, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT64(1, columns[1].null_count);
+    const uint64_t *qty_bits = (const uint64_t *)(df->mapping->data + columns[1].validity_offset);
+    TEST_ASSERT_EQUAL_HEX64(~((uint64_t)1 << 8), qty_bits[0]);
+    TEST_ASSERT_EQUAL_UINT64(0, columns[2].null_count);
+    TEST_ASSERT_EQUAL_UINT64(0, columns[2].validity_offset);
+    TEST_ASSERT_EQUAL_UINT64(1, columns[3].null_count);
+    free_dataframe(df);
+
+    DataFrame *columnar = make_frame(DATAFRAME_LAYOUT_COLUMNS);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_save_binary(columnar, TEST_BINARY_FILE, 0));
+    free_dataframe(columnar);
+
+    DataFrameBinaryOpenOptions options = dataframe_binary_default_open_options();
+    options.layout = DATAFRAME_LAYOUT_ROWS;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_open_mmap_with_options(TEST_BINARY_FILE, &options, &df));
+    TEST_ASSERT_NOT_NULL(df->data);
+    assert_frame_contents(df);
+    free_dataframe(df);
+
+    remove(TEST_BINARY_FILE);
+}
+
+/**
+ * @brief Tests files that must not be opened.
+ * Expected result: Missing files are reported as such; truncated files, other versions and
+ * tag mismatches are rejected as invalid; an empty frame round-trips.
+ */
+void test_DataFrameBinary_RejectsInvalid(void)
+{
+    DataFrame *df = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_FILE_NOT_FOUND, dataframe_open_mmap(TEST_BINARY_FILE, &df));
+
+    DataFrame *source = make_frame(DATAFRAME_LAYOUT_COLUMNS);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_save_binary(source, TEST_BINARY_FILE, 7));
+
+    DataFrameBinaryOpenOptions options = dataframe_binary_default_open_options();
+    options.check_tag = true;
+    options.tag = 8;
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT,
+                      dataframe_open_mmap_with_options(TEST_BINARY_FILE, &options, &df));
+    TEST_ASSERT_NULL(df);
+    options.tag = 7;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_open_mmap_with_options(TEST_BINARY_FILE, &options, &df));
+    free_dataframe(df);
+
+    /* Read the file back to damage copies of it */
+    FILE *f = fopen(TEST_BINARY_FILE, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    char bytes[4096];
+    const size_t size = fread(bytes, 1, sizeof(bytes), f);
+    fclose(f);
+    TEST_ASSERT_TRUE(size > sizeof(DataFrameBinaryHeader) && size < sizeof(bytes));
+
+    f = fopen(TEST_BINARY_FILE, "wb");
+    fwrite(bytes, 1, size - 1, f);
+    fclose(f);
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT, dataframe_open_mmap(TEST_BINARY_FILE, &df));
+
+    ((DataFrameBinaryHeader *)bytes)->version = DATAFRAME_BINARY_VERSION + 1;
+    f = fopen(TEST_BINARY_FILE, "wb");
+    fwrite(bytes, 1, size, f);
+    fclose(f);
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT, dataframe_open_mmap(TEST_BINARY_FILE, &df));
+    TEST_ASSERT_NULL(df);
+
+    dataframe_clear_rows(source);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_save_binary(source, TEST_BINARY_FILE, 0));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_open_mmap(TEST_BINARY_FILE, &df));
+    TEST_ASSERT_EQUAL_INT(0, df->rows);
+    TEST_ASSERT_EQUAL_INT(5, df->cols);
+    TEST_ASSERT_TRUE(dataframe_push_row(df) == 0);
+    free_dataframe(df);
+    free_dataframe(source);
+
+    remove(TEST_BINARY_FILE);
+}
+
+/**
+ * @brief Tests that validity bitmaps survive a save and open in both layouts.
+ * Expected result: A NaN marked valid stays a value and a NaN marked missing stays null.
+ */
+void test_DataFrameBinary_KeepsValidity(void)
+{
+    DataFrame *source = create_dataframe_with_layout(4, 1, DATAFRAME_LAYOUT_COLUMNS);
+    TEST_ASSERT_NOT_NULL(source);
+    source->columns[0] = strdup("Price");
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(source));
+    for (int r = 0; r < 3; r++) {
+        DataCell cell = {.v_num = r == 1 ? NAN : (double)r};
+        dataframe_set_cell(source, dataframe_push_row(source), 0, cell);
+    }
+    TEST_ASSERT_TRUE(dataframe_set_valid(source, 2, 0, false));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_save_binary(source, TEST_BINARY_FILE, 0));
+    free_dataframe(source);
+
+    const DataFrameLayout layouts[] = {DATAFRAME_LAYOUT_COLUMNS, DATAFRAME_LAYOUT_ROWS};
+    for (int i = 0; i < 2; i++) {
+        DataFrameBinaryOpenOptions options = dataframe_binary_default_open_options();
+        options.layout = layouts[i];
+        DataFrame *df = NULL;
+        TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                          dataframe_open_mmap_with_options(TEST_BINARY_FILE, &options, &df));
+        TEST_ASSERT_TRUE(isnan(dataframe_get_cell(df, 1, 0).v_num));
+        TEST_ASSERT_FALSE(dataframe_cell_is_null(df, 1, 0));
+        TEST_ASSERT_TRUE(dataframe_cell_is_null(df, 2, 0));
+
+        size_t nulls = 0;
+        TEST_ASSERT_NOT_NULL(dataframe_column_validity(df, 0, &nulls));
+        TEST_ASSERT_EQUAL_size_t(1, nulls);
+        free_dataframe(df);
+    }
+
+    remove(TEST_BINARY_FILE);
+}
+
+/**
+ * @brief Tests that opening a large columnar file leaves the whole mapping untouched.
+ *
+ * Expected result: After opening, the mapped bytes still equal the file, so no string cell was
+ * fixed up and no bitmap copied; strings, nulls and values read correctly through the mapping,
+ * and writing a string cell or adding a row afterwards keeps every value.
+ */
+void test_DataFrameBinary_OpensWithoutRowWork(void)
+{
+    const int rows = 200000;
+    DataFrame *source = create_dataframe_with_layout((size_t)rows, 3, DATAFRAME_LAYOUT_COLUMNS);
+    TEST_ASSERT_NOT_NULL(source);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(source));
+    const char *names[] = {"Price", "Note", "Qty"};
+    const DataType types[] = {TYPE_NUMERIC, TYPE_STRING, TYPE_INT64};
+    for (int c = 0; c < 3; c++) {
+        source->columns[c] = strdup(names[c]);
+        source->col_types[c] = types[c];
+    }
+    for (int r = 0; r < rows; r++) {
+        TEST_ASSERT_TRUE(dataframe_push_row(source) == r);
+
+        DataCell cell = {.v_num = r * 0.25};
+        dataframe_set_cell(source, r, 0, cell);
+        char note[16];
+        snprintf(note, sizeof(note), "n%d", r);
+        cell.v_str = r % 10 == 3 ? NULL : dataframe_store_string(source, note, strlen(note));
+        dataframe_set_cell(source, r, 1, cell);
+        cell.v_int = r;
+        dataframe_set_cell(source, r, 2, cell);
+        if (r % 1000 == 7)
+            TEST_ASSERT_TRUE(dataframe_set_valid(source, r, 0, false));
+    }
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_save_binary(source, TEST_BINARY_FILE, 0));
+    free_dataframe(source);
+
+    DataFrame *df = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_open_mmap(TEST_BINARY_FILE, &df));
+    TEST_ASSERT_EQUAL_INT(rows, df->rows);
+
+    /* The copy-on-write mapping still matches the file byte for byte */
+    FILE *f = fopen(TEST_BINARY_FILE, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    char *bytes = malloc(df->mapping->size);
+    TEST_ASSERT_NOT_NULL(bytes);
+    TEST_ASSERT_EQUAL_size_t(df->mapping->size, fread(bytes, 1, df->mapping->size, f));
+    fclose(f);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(bytes, df->mapping->data, df->mapping->size));
+    free(bytes);
+
+    /* Columns and the validity bitmap are used in place */
+    size_t nulls = 0;
+    const char *bits = (const char *)dataframe_column_validity(df, 0, &nulls);
+    TEST_ASSERT_TRUE(bits >= df->mapping->data && bits < df->mapping->data + df->mapping->size);
+    TEST_ASSERT_EQUAL_size_t(200, nulls);
+    TEST_ASSERT_NULL(dataframe_column_validity(df, 1, NULL));
+    const char *notes = (const char *)df->col_data[1];
+    TEST_ASSERT_TRUE(notes >= df->mapping->data && notes < df->mapping->data + df->mapping->size);
+
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(df, 1007, 0));
+    TEST_ASSERT_FALSE(dataframe_cell_is_null(df, 1008, 0));
+    TEST_ASSERT_EQUAL_STRING("n0", dataframe_get_string(df, 0, 1));
+    TEST_ASSERT_NULL(dataframe_get_string(df, 3, 1));
+    TEST_ASSERT_EQUAL_STRING("n199999", dataframe_get_string(df, rows - 1, 1));
+    TEST_ASSERT_EQUAL_INT64(123456, dataframe_get_cell(df, 123456, 2).v_int);
+
+    /* Writing one string cell, then adding a row, keeps the other strings and nulls */
+    DataCell cell = {.v_str = "first"};
+    dataframe_set_cell(df, 0, 1, cell);
+    TEST_ASSERT_EQUAL_STRING("first", dataframe_get_string(df, 0, 1));
+    TEST_ASSERT_EQUAL_STRING("n150001", dataframe_get_string(df, 150001, 1));
+    TEST_ASSERT_TRUE(dataframe_push_row(df) == rows);
+    TEST_ASSERT_NULL(dataframe_get_string(df, rows, 1));
+    TEST_ASSERT_FALSE(dataframe_cell_is_null(df, rows, 0));
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(df, 199007, 0));
+    TEST_ASSERT_NULL(dataframe_get_string(df, 13, 1));
+    TEST_ASSERT_EQUAL_STRING("n14", dataframe_get_string(df, 14, 1));
+    free_dataframe(df);
+
+    remove(TEST_BINARY_FILE);
+}
+
+/**
+ * @brief Test runner for the binary DataFrame format module.
+ */
+void run_dataframe_binary_tests(void)
+{
+    RUN_TEST(test_DataFrameBinary_RoundTrip);
+    RUN_TEST(test_DataFrameBinary_RejectsInvalid);
+    RUN_TEST(test_DataFrameBinary_KeepsValidity);
+    RUN_TEST(test_DataFrameBinary_OpensWithoutRowWork);
+}
@@ -0,0 +1,269 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dataframe.h"
+#include "dataframe_filter.h"
+#include "test_helpers.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_dataframe_filter.c
+ * @brief Unit tests for selecting DataFrame rows with comparison predicates.
+ *
+ * Verifies the predicate parser, the comparison of every column type with
+ * missing values, the frame built from the selected rows, and that the
+ * vectorized evaluation of large columnar frames matches a row-by-row check.
+ */
+
+/**
+ * @brief Builds a small frame of quotes with some missing values.
+ *
+ * Columns: Ticker (category), Day (date), Price (numeric), Volume (int64), Note (string).
+ *
+ * @return The new DataFrame, with validity tracking enabled.
+ */
+static DataFrame *make_quotes(void)
+{
+    const TestQuote quotes[] = {
+        {"AAPL", 19700, 140.0, 1200, "open"},
+        {"MSFT", 19700, 310.0, 800, "close"},
+        {"AAPL", 19701, 152.5, 1000, NULL},
+        {"IBM", 19701, NAN, 50, "halt"},
+        {"MSFT", 19702, 305.0, DATAFRAME_NULL_INT64, "close"},
+        {NULL, 19702, 160.0, 3000, "open"},
+        {"AAPL", 19703, 149.0, 5000, "close"},
+    };
+    return test_make_quotes(quotes, 7, true);
+}
+
+/**
+ * @brief Parses an expression and lists the rows of a frame that satisfy it.
+ * @param df The DataFrame.
+ * @param expression The predicate text (must parse).
+ * @param out_rows Receives the selected rows (to be freed with free).
+ * @param out_count Receives the number of selected rows.
+ * @return The result of dataframe_filter_rows.
+ */
+static DataframeErrorCode
+select_rows(const DataFrame *df, const char *expression, int **out_rows, size_t *out_count)
+{
+    FilterPredicate predicate;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_predicate_parse(expression, &predicate));
+    const DataframeErrorCode err = dataframe_filter_rows(df, &predicate, 1, out_rows, out_count);
+    dataframe_predicate_free(&predicate);
+    return err;
+}
+
+/**
+ * @brief Checks that an expression selects exactly the expected rows.
+ * @param df The DataFrame.
+ * @param expression The predicate text.
+ * @param expected The expected rows in ascending order.
+ * @param expected_count The number of expected rows.
+ */
+static void assert_selects(const DataFrame *df,
+                           const char *expression,
+                           const int *expected,
+                           const size_t expected_count)
+{
+    int *rows = NULL;
+    size_t count = 0;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, select_rows(df, expression, &rows, &count));
+    TEST_ASSERT_EQUAL_size_t(expected_count, count);
+    if (expected_count)
+        TEST_ASSERT_EQUAL_INT_ARRAY(expected, rows, expected_count);
+    free(rows);
+}
+
+/**
+ * @brief Tests the predicate parser and the comparison of every column type.
+ *
+ * Expected result: Conjunctions select the rows satisfying every condition, missing values
+ * satisfy nothing (not even "!="), malformed expressions, unknown columns and constants of the
+ * wrong type are rejected, and the filtered frame holds the selected rows.
+ */
+void test_Filter_ParseAndSelect(void)
+{
+    const char *expression = "Price > 150 and \"Trade Volume\"<>'1 000'&&Day<=2024-01-02";
+    FilterPredicate predicate;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_predicate_parse(expression, &predicate));
+    TEST_ASSERT_EQUAL_size_t(3, predicate.count);
+    TEST_ASSERT_EQUAL_STRING("Price", predicate.conditions[0].column);
+    TEST_ASSERT_EQUAL(FILTER_GREATER, predicate.conditions[0].op);
+    TEST_ASSERT_EQUAL_STRING("150", predicate.conditions[0].value);
+    TEST_ASSERT_EQUAL_STRING("Trade Volume", predicate.conditions[1].column);
+    TEST_ASSERT_EQUAL(FILTER_NOT_EQUAL, predicate.conditions[1].op);
+    TEST_ASSERT_EQUAL_STRING("1 000", predicate.conditions[1].value);
+    TEST_ASSERT_EQUAL(FILTER_LESS_EQUAL, predicate.conditions[2].op);
+    TEST_ASSERT_EQUAL_STRING("2024-01-02", predicate.conditions[2].value);
+    dataframe_predicate_free(&predicate);
+    TEST_ASSERT_NULL(predicate.conditions);
+
+    const char *malformed[] = {"", "Price", "Price >", "> 150", "Price > 150 AND", "Price ~ 1",
+                               "Price > 150 OR Volume > 1", "Note == 'open"};
+    for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+        TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT,
+                          dataframe_predicate_parse(malformed[i], &predicate));
+    }
+
+    DataFrame *df = make_quotes();
+    const int price_and_volume[] = {2, 5};
+    assert_selects(df, "Price > 150 AND Volume >= 1000", price_and_volume, 2);
+    const int not_aapl[] = {1, 3, 4};
+    assert_selects(df, "Ticker != AAPL", not_aapl, 3);
+    const int up_to_ibm[] = {0, 2, 3, 6};
+    assert_selects(df, "Ticker <= IBM", up_to_ibm, 4);
+    const int after_day[] = {4, 5, 6};
+    assert_selects(df, "Day > 2023-12-10", after_day, 3);
+    const int fractional[] = {0, 2, 5, 6};
+    assert_selects(df, "Volume > 999.5", fractional, 4);
+    const int not_close[] = {0, 3, 5};
+    assert_selects(df, "Note <> close", not_close, 3);
+    const int no_price[] = {0, 1, 2, 4, 5, 6};
+    assert_selects(df, "Price != 0", no_price, 6);
+    assert_selects(df, "Price == 1 && Ticker = AAPL", NULL, 0);
+
+    int *rows = NULL;
+    size_t count = 0;
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND, select_rows(df, "Bid > 1", &rows, &count));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT, select_rows(df, "Price > abc", &rows, &count));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT, select_rows(df, "Day > 19700", &rows, &count));
+    TEST_ASSERT_NULL(rows);
+
+    /* Conditions built by hand select the same rows as parsed ones */
+    const FilterCondition conditions[] = {{"Ticker", FILTER_EQUAL, "AAPL"},
+                                          {"Price", FILTER_LESS, "150"}};
+    const FilterPredicate by_hand = {conditions, 2, NULL};
+    DataFrame *out = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_filter(df, &by_hand, 0, &out));
+    TEST_ASSERT_EQUAL_INT(2, out->rows);
+    TEST_ASSERT_EQUAL_INT(5, out->cols);
+    TEST_ASSERT_EQUAL(DATAFRAME_LAYOUT_COLUMNS, out->layout);
+    TEST_ASSERT_EQUAL_INT(3, dataframe_col_index(out, "Volume"));
+    TEST_ASSERT_EQUAL_STRING("AAPL", dataframe_get_string(out, 1, 0));
+    TEST_ASSERT_EQUAL_INT64(19700, dataframe_get_cell(out, 0, 1).v_int);
+    TEST_ASSERT_EQUAL_DOUBLE(149.0, dataframe_get_cell(out, 1, 2).v_num);
+    TEST_ASSERT_EQUAL_INT64(5000, dataframe_get_cell(out, 1, 3).v_int);
+    TEST_ASSERT_EQUAL_STRING("close", dataframe_get_string(out, 1, 4));
+    free_dataframe(out);
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Checks a row of the large test frame against the conditions of the large test.
+ * @param prices The price column.
+ * @param volumes The volume column.
+ * @param row The row.
+ * @param expression Index of the expression being checked.
+ * @return Whether the row satisfies the expression.
+ */
+static bool large_row_matches(const double *prices,
+                              const int64_t *volumes,
+                              const int row,
+                              const int expression)
+{
+    const bool price_missing = row % 89 == 5;
+    const bool volume_missing = row % 67 == 11;
+    switch (expression) {
+    case 0:
+        return !price_missing && !volume_missing && prices[row] > 150.0 && volumes[row] >= 1000;
+    case 1:
+        return !price_missing && prices[row] <= 100.25;
+    case 2:
+        return !volume_missing && volumes[row] != 4242 && volumes[row] < 3000;
+    default:
+        return !price_missing && !volume_missing && prices[row] == 100.0 && volumes[row] > 10;
+    }
+}
+
+/**
+ * @brief Tests a columnar frame large enough to be evaluated in several chunks.
+ *
+ * Expected result: Every expression selects the same rows as a row-by-row check, whatever the
+ * thread count, and ranges starting inside a bitmap word are evaluated correctly.
+ */
+void test_Filter_LargeFrame(void)
+{
+    const int rows = 200003;
+    DataFrame *df = create_dataframe_with_layout((size_t)rows, 2, DATAFRAME_LAYOUT_COLUMNS);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(df));
+    df->columns[0] = strdup("Price");
+    df->columns[1] = strdup("Volume");
+    df->col_types[0] = TYPE_NUMERIC;
+    df->col_types[1] = TYPE_INT64;
+
+    for (int r = 0; r < rows; r++) {
+        TEST_ASSERT_TRUE(dataframe_push_row(df) == r);
+
+        DataCell cell = {0};
+        cell.v_num = 50.0 + (double)(r * 37 % 1201) * 0.25;
+        dataframe_set_cell(df, r, 0, cell);
+        cell.v_int = (int64_t)(r * 7919 % 5000);
+        dataframe_set_cell(df, r, 1, cell);
+        if (r % 89 == 5)
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 0, false));
+        if (r % 67 == 11)
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 1, false));
+    }
+    const double *prices = dataframe_numeric_column(df, 0);
+    const int64_t *volumes = dataframe_int64_column(df, 1);
+
+    const char *expressions[] = {"Price > 150 AND Volume >= 1000",
+                                 "Price <= 100.25",
+                                 "Volume != 4242 AND Volume < 3000",
+                                 "Price == 100 AND Volume > 10"};
+    for (int e = 0; e < 4; e++) {
+        for (int threads = 1; threads <= 4; threads += 3) {
+            FilterPredicate predicate;
+            TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                              dataframe_predicate_parse(expressions[e], &predicate));
+            int *selected = NULL;
+            size_t count = 0;
+            TEST_ASSERT_EQUAL(
+                DATAFRAME_SUCCESS,
+                dataframe_filter_rows(df, &predicate, threads, &selected, &count));
+
+            size_t next = 0;
+            for (int r = 0; r < rows; r++) {
+                if (!large_row_matches(prices, volumes, r, e))
+                    continue;
+                TEST_ASSERT_TRUE(next < count);
+                TEST_ASSERT_EQUAL_INT(r, selected[next]);
+                next++;
+            }
+            TEST_ASSERT_EQUAL_size_t(next, count);
+            free(selected);
+
+            /* A range that starts and ends inside bitmap words */
+            FilterTerm *terms = NULL;
+            TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                              dataframe_predicate_compile(df, &predicate, &terms));
+            uint64_t mask[(1000 + 63) / 64];
+            dataframe_filter_range(df, terms, predicate.count, 4133, 1000, mask);
+            for (int i = 0; i < 1024; i++) {
+                const bool bit = (mask[i / 64] >> (i % 64) & 1u) != 0;
+                if (i < 1000)
+                    TEST_ASSERT_EQUAL(large_row_matches(prices, volumes, 4133 + i, e), bit);
+                else
+                    TEST_ASSERT_FALSE(bit);
+            }
+            free(terms);
+            dataframe_predicate_free(&predicate);
+        }
+    }
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Test runner for the DataFrame filter module.
+ */
+void run_dataframe_filter_tests(void)
+{
+    RUN_TEST(test_Filter_ParseAndSelect);
+    RUN_TEST(test_Filter_LargeFrame);
+}
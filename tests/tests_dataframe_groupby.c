@@ -0,0 +1,219 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "dataframe.h"
+#include "dataframe_groupby.h"
+#include "test_helpers.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_dataframe_groupby.c
+ * @brief Unit tests for group-by aggregation of DataFrame rows.
+ *
+ * Verifies the aggregates of multi-column and string keys, the handling of
+ * missing keys and values, the output column names and types, and that large
+ * frames aggregated by several threads match a serial computation.
+ */
+
+/**
+ * @brief Builds a small frame of quotes with some missing values.
+ *
+ * Columns: Ticker (category), Day (date), Price (numeric), Volume (int64), Note (string).
+ *
+ * @return The new DataFrame, with validity tracking enabled.
+ */
+static DataFrame *make_quotes(void)
+{
+    const TestQuote quotes[] = {
+        {"AAPL", 19700, 10.0, 100, "x"},
+        {"MSFT", 19700, 20.0, 200, "y"},
+        {"AAPL", 19700, 12.0, DATAFRAME_NULL_INT64, "x"},
+        {"AAPL", 19701, NAN, 50, NULL},
+        {"MSFT", 19700, 26.0, 300, "y"},
+        {NULL, 19700, 5.0, 10, "x"},
+        {"AAPL", 19700, 14.0, 150, "z"},
+    };
+    return test_make_quotes(quotes, 7, true);
+}
+
+/**
+ * @brief Tests per-ticker and per-day aggregates, and grouping by a string column.
+ *
+ * Expected result: Groups appear in order of first appearance, rows with a missing ticker form
+ * their own group, missing values are skipped, and aggregates without enough values are missing.
+ */
+void test_GroupBy_MultiKey(void)
+{
+    DataFrame *df = make_quotes();
+    const int keys[] = {0, 1};
+    const GroupByAggregate aggregates[] = {
+        {2, GROUPBY_COUNT, NULL},
+        {2, GROUPBY_SUM, NULL},
+        {2, GROUPBY_MEAN, "Average"},
+        {2, GROUPBY_VARIANCE, NULL},
+        {2, GROUPBY_MIN, NULL},
+        {2, GROUPBY_MAX, NULL},
+        {3, GROUPBY_SUM, NULL},
+        {4, GROUPBY_COUNT, NULL},
+    };
+
+    DataFrame *out = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_groupby_agg(df, keys, 2, aggregates, 8, 0, &out));
+    TEST_ASSERT_EQUAL_INT(4, out->rows);
+    TEST_ASSERT_EQUAL_INT(10, out->cols);
+    TEST_ASSERT_EQUAL(TYPE_CATEGORY, out->col_types[0]);
+    TEST_ASSERT_EQUAL(TYPE_DATE, out->col_types[1]);
+    TEST_ASSERT_EQUAL(TYPE_INT64, out->col_types[2]);
+    TEST_ASSERT_EQUAL(TYPE_NUMERIC, out->col_types[3]);
+    TEST_ASSERT_EQUAL_INT(2, dataframe_col_index(out, "Price_count"));
+    TEST_ASSERT_EQUAL_INT(4, dataframe_col_index(out, "Average"));
+    TEST_ASSERT_EQUAL_INT(5, dataframe_col_index(out, "Price_variance"));
+    TEST_ASSERT_EQUAL_INT(9, dataframe_col_index(out, "Note_count"));
+
+    /* AAPL on day 19700: prices 10, 12 and 14, one volume missing */
+    TEST_ASSERT_EQUAL_STRING("AAPL", dataframe_get_string(out, 0, 0));
+    TEST_ASSERT_EQUAL_INT64(19700, dataframe_get_cell(out, 0, 1).v_int);
+    TEST_ASSERT_EQUAL_INT64(3, dataframe_get_cell(out, 0, 2).v_int);
+    TEST_ASSERT_EQUAL_DOUBLE(36.0, dataframe_get_cell(out, 0, 3).v_num);
+    TEST_ASSERT_EQUAL_DOUBLE(12.0, dataframe_get_cell(out, 0, 4).v_num);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 4.0, dataframe_get_cell(out, 0, 5).v_num);
+    TEST_ASSERT_EQUAL_DOUBLE(10.0, dataframe_get_cell(out, 0, 6).v_num);
+    TEST_ASSERT_EQUAL_DOUBLE(14.0, dataframe_get_cell(out, 0, 7).v_num);
+    TEST_ASSERT_EQUAL_DOUBLE(250.0, dataframe_get_cell(out, 0, 8).v_num);
+    TEST_ASSERT_EQUAL_INT64(3, dataframe_get_cell(out, 0, 9).v_int);
+
+    /* MSFT on day 19700: prices 20 and 26 */
+    TEST_ASSERT_EQUAL_STRING("MSFT", dataframe_get_string(out, 1, 0));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 23.0, dataframe_get_cell(out, 1, 4).v_num);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 18.0, dataframe_get_cell(out, 1, 5).v_num);
+
+    /* AAPL on day 19701: its only price is missing */
+    TEST_ASSERT_EQUAL_STRING("AAPL", dataframe_get_string(out, 2, 0));
+    TEST_ASSERT_EQUAL_INT64(19701, dataframe_get_cell(out, 2, 1).v_int);
+    TEST_ASSERT_EQUAL_INT64(0, dataframe_get_cell(out, 2, 2).v_int);
+    for (int c = 3; c < 8; c++) {
+        TEST_ASSERT_TRUE(dataframe_cell_is_null(out, 2, c));
+    }
+    TEST_ASSERT_EQUAL_INT64(0, dataframe_get_cell(out, 2, 9).v_int);
+
+    /* The missing ticker: a single price has no sample variance */
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(out, 3, 0));
+    TEST_ASSERT_FALSE(dataframe_cell_is_null(out, 3, 1));
+    TEST_ASSERT_EQUAL_DOUBLE(5.0, dataframe_get_cell(out, 3, 4).v_num);
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(out, 3, 5));
+    free_dataframe(out);
+
+    /* String keys: the missing note forms its own group */
+    const int note[] = {4};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_groupby_agg(df, note, 1, aggregates, 1, 1, &out));
+    TEST_ASSERT_EQUAL_INT(4, out->rows);
+    TEST_ASSERT_EQUAL_STRING("x", dataframe_get_string(out, 0, 0));
+    TEST_ASSERT_EQUAL_INT64(3, dataframe_get_cell(out, 0, 1).v_int);
+    TEST_ASSERT_EQUAL_STRING("y", dataframe_get_string(out, 1, 0));
+    TEST_ASSERT_EQUAL_INT64(2, dataframe_get_cell(out, 1, 1).v_int);
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(out, 2, 0));
+    TEST_ASSERT_EQUAL_INT64(0, dataframe_get_cell(out, 2, 1).v_int);
+    TEST_ASSERT_EQUAL_STRING("z", dataframe_get_string(out, 3, 0));
+    free_dataframe(out);
+
+    const GroupByAggregate text_mean[] = {{4, GROUPBY_MEAN, NULL}};
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND,
+                      dataframe_groupby_agg(df, keys, 2, text_mean, 1, 0, &out));
+    TEST_ASSERT_NULL(out);
+    const int bad_keys[] = {0, 5};
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND,
+                      dataframe_groupby_agg(df, bad_keys, 2, aggregates, 8, 0, &out));
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests a frame large enough to be aggregated by several threads.
+ *
+ * Expected result: Every group matches a serial computation of its count, sum, mean and
+ * variance, and the groups appear in order of first appearance.
+ */
+void test_GroupBy_LargeFrame(void)
+{
+    const int rows = 250000;
+    const int group_count = 1000;
+    DataFrame *df = create_dataframe_with_layout((size_t)rows, 2, DATAFRAME_LAYOUT_COLUMNS);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(df));
+    df->col_types[0] = TYPE_INT64;
+    df->col_types[1] = TYPE_NUMERIC;
+
+    double *sums = calloc((size_t)group_count, sizeof(double));
+    int64_t *counts = calloc((size_t)group_count, sizeof(int64_t));
+    TEST_ASSERT_NOT_NULL(sums);
+    TEST_ASSERT_NOT_NULL(counts);
+    for (int r = 0; r < rows; r++) {
+        TEST_ASSERT_TRUE(dataframe_push_row(df) == r);
+
+        DataCell cell = {0};
+        cell.v_int = (int64_t)r * 7919 % group_count;
+        dataframe_set_cell(df, r, 0, cell);
+        cell.v_num = 1e6 + (double)(r % 97) * 0.5;
+        dataframe_set_cell(df, r, 1, cell);
+        if (r % 101 == 3) {
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 1, false));
+        } else {
+            sums[r * 7919 % group_count] += cell.v_num;
+            counts[r * 7919 % group_count]++;
+        }
+    }
+
+    /* Second pass of the serial two-pass variance */
+    double *squares = calloc((size_t)group_count, sizeof(double));
+    TEST_ASSERT_NOT_NULL(squares);
+    const double *values = dataframe_numeric_column(df, 1);
+    for (int r = 0; r < rows; r++) {
+        const int g = r * 7919 % group_count;
+        if (!dataframe_cell_is_null(df, r, 1)) {
+            const double d = values[r] - sums[g] / (double)counts[g];
+            squares[g] += d * d;
+        }
+    }
+
+    const int keys[] = {0};
+    const GroupByAggregate aggregates[] = {
+        {1, GROUPBY_COUNT, NULL},
+        {1, GROUPBY_MEAN, NULL},
+        {1, GROUPBY_VARIANCE, NULL},
+        {1, GROUPBY_SUM, NULL},
+    };
+    DataFrame *out = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_groupby_agg(df, keys, 1, aggregates, 4, 4, &out));
+    TEST_ASSERT_EQUAL_INT(group_count, out->rows);
+
+    for (int i = 0; i < group_count; i++) {
+        /* Row i is the first row of key i * 7919 % group_count */
+        const int g = (int)((int64_t)i * 7919 % group_count);
+        TEST_ASSERT_EQUAL_INT64(g, dataframe_get_cell(out, i, 0).v_int);
+        TEST_ASSERT_EQUAL_INT64(counts[g], dataframe_get_cell(out, i, 1).v_int);
+        TEST_ASSERT_DOUBLE_WITHIN(
+            1e-6, sums[g] / (double)counts[g], dataframe_get_cell(out, i, 2).v_num);
+        TEST_ASSERT_DOUBLE_WITHIN(
+            1e-6, squares[g] / (double)(counts[g] - 1), dataframe_get_cell(out, i, 3).v_num);
+        TEST_ASSERT_DOUBLE_WITHIN(1e-3, sums[g], dataframe_get_cell(out, i, 4).v_num);
+    }
+
+    free(sums);
+    free(counts);
+    free(squares);
+    free_dataframe(out);
+    free_dataframe(df);
+}
+
+/**
+ * @brief Test runner for the DataFrame group-by module.
+ */
+void run_dataframe_groupby_tests(void)
+{
+    RUN_TEST(test_GroupBy_MultiKey);
+    RUN_TEST(test_GroupBy_LargeFrame);
+}
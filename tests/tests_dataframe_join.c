@@ -0,0 +1,324 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dataframe.h"
+#include "dataframe_join.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_dataframe_join.c
+ * @brief Unit tests for hash joins and as-of joins of DataFrames.
+ *
+ * Verifies the row pairs of inner and left joins on single and multiple keys,
+ * matching across key column types, the as-of lookup with and without by
+ * columns, the columns of the built frames, and large joins split across
+ * threads.
+ */
+
+/**
+ * @brief Creates an empty row-layout frame with validity tracking and named, typed columns.
+ * @param cols The number of columns.
+ * @param names The column names.
+ * @param types The column types.
+ * @return The new DataFrame.
+ */
+static DataFrame *make_frame(const int cols, const char *const *names, const DataType *types)
+{
+    DataFrame *df = create_dataframe_with_layout(8, (size_t)cols, DATAFRAME_LAYOUT_ROWS);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(df));
+    for (int c = 0; c < cols; c++) {
+        df->columns[c] = strdup(names[c]);
+        df->col_types[c] = types[c];
+    }
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_index_columns(df));
+    return df;
+}
+
+/**
+ * @brief Appends a row of a ticker (category or string), a day and a number.
+ * @param df The frame, whose first three columns are the ticker, the day and the number.
+ * @param ticker The ticker, or NULL for a missing one.
+ * @param day The day.
+ * @param value The number.
+ */
+static void add_row(DataFrame *df, const char *ticker, const int64_t day, const double value)
+{
+    const int r = dataframe_push_row(df);
+    TEST_ASSERT_TRUE(r >= 0);
+
+    DataCell cell = {0};
+    if (!ticker)
+        TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 0, false));
+    else if (df->col_types[0] == TYPE_CATEGORY)
+        cell.v_code = dataframe_intern_string(df, 0, ticker, strlen(ticker));
+    else
+        cell.v_str = dataframe_store_string(df, ticker, strlen(ticker));
+    if (ticker)
+        dataframe_set_cell(df, r, 0, cell);
+    cell.v_int = day;
+    dataframe_set_cell(df, r, 1, cell);
+    cell.v_num = value;
+    dataframe_set_cell(df, r, 2, cell);
+}
+
+/**
+ * @brief Tests inner and left joins of prices with reference data.
+ *
+ * Expected result: Category keys match string keys by text, duplicate right keys give one pair
+ * each in row order, missing keys match nothing, and the built frame holds the left columns
+ * followed by the right non-key columns with clashing names suffixed.
+ */
+void test_HashJoin_InnerAndLeft(void)
+{
+    const char *price_names[] = {"Ticker", "Day", "Price"};
+    const DataType price_types[] = {TYPE_CATEGORY, TYPE_DATE, TYPE_NUMERIC};
+    DataFrame *prices = make_frame(3, price_names, price_types);
+    add_row(prices, "AAPL", 19700, 190.0);
+    add_row(prices, "IBM", 19700, 140.0);
+    add_row(prices, NULL, 19700, 1.0);
+    add_row(prices, "MSFT", 19701, 310.0);
+    add_row(prices, "AAPL", 19701, 191.0);
+
+    const char *ref_names[] = {"Symbol", "Day", "Price"};
+    const DataType ref_types[] = {TYPE_STRING, TYPE_INT64, TYPE_NUMERIC};
+    DataFrame *ref = make_frame(3, ref_names, ref_types);
+    add_row(ref, "MSFT", 0, 1.5);
+    add_row(ref, "AAPL", 0, 2.5);
+    add_row(ref, "AAPL", 0, 3.5);
+    add_row(ref, NULL, 0, 4.5);
+    add_row(ref, "ORCL", 0, 5.5);
+
+    int *left_rows = NULL;
+    int *right_rows = NULL;
+    size_t count = 0;
+    const int ticker[] = {0};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_hash_join_indices(prices,
+                                                  ticker,
+                                                  ref,
+                                                  ticker,
+                                                  1,
+                                                  DATAFRAME_JOIN_INNER,
+                                                  0,
+                                                  &left_rows,
+                                                  &right_rows,
+                                                  &count));
+    const int inner_left[] = {0, 0, 3, 4, 4};
+    const int inner_right[] = {1, 2, 0, 1, 2};
+    TEST_ASSERT_EQUAL_size_t(5, count);
+    TEST_ASSERT_EQUAL_INT_ARRAY(inner_left, left_rows, 5);
+    TEST_ASSERT_EQUAL_INT_ARRAY(inner_right, right_rows, 5);
+    free(left_rows);
+    free(right_rows);
+
+    DataFrame *out = NULL;
+    TEST_ASSERT_EQUAL(
+        DATAFRAME_SUCCESS,
+        dataframe_hash_join(prices, ticker, ref, ticker, 1, DATAFRAME_JOIN_LEFT, 2, &out));
+    TEST_ASSERT_EQUAL_INT(7, out->rows);
+    TEST_ASSERT_EQUAL_INT(5, out->cols);
+    TEST_ASSERT_EQUAL_INT(3, dataframe_col_index(out, "Day_right"));
+    TEST_ASSERT_EQUAL_INT(4, dataframe_col_index(out, "Price_right"));
+    TEST_ASSERT_EQUAL(TYPE_CATEGORY, out->col_types[0]);
+    TEST_ASSERT_EQUAL(TYPE_INT64, out->col_types[3]);
+
+    /* Rows: AAPL x2, IBM (unmatched), missing ticker (unmatched), MSFT, AAPL x2 */
+    TEST_ASSERT_EQUAL_STRING("AAPL", dataframe_get_string(out, 1, 0));
+    TEST_ASSERT_EQUAL_DOUBLE(3.5, dataframe_get_cell(out, 1, 4).v_num);
+    TEST_ASSERT_EQUAL_STRING("IBM", dataframe_get_string(out, 2, 0));
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(out, 2, 4));
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(out, 3, 0));
+    TEST_ASSERT_EQUAL_DOUBLE(1.0, dataframe_get_cell(out, 3, 2).v_num);
+    TEST_ASSERT_EQUAL_STRING("MSFT", dataframe_get_string(out, 4, 0));
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, dataframe_get_cell(out, 4, 4).v_num);
+    TEST_ASSERT_EQUAL_INT64(19701, dataframe_get_cell(out, 6, 1).v_int);
+    free_dataframe(out);
+
+    /* Two keys: ticker and price, where -0.0 and 0.0 match */
+    add_row(prices, "ORCL", 19702, -0.0);
+    add_row(ref, "ORCL", 0, 0.0);
+    const int two_keys[] = {0, 2};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_hash_join_indices(prices,
+                                                  two_keys,
+                                                  ref,
+                                                  two_keys,
+                                                  2,
+                                                  DATAFRAME_JOIN_INNER,
+                                                  0,
+                                                  &left_rows,
+                                                  &right_rows,
+                                                  &count));
+    TEST_ASSERT_EQUAL_size_t(1, count);
+    TEST_ASSERT_EQUAL_INT(5, left_rows[0]);
+    TEST_ASSERT_EQUAL_INT(5, right_rows[0]);
+    free(left_rows);
+    free(right_rows);
+
+    const int mismatched[] = {1};
+    TEST_ASSERT_EQUAL(
+        DATAFRAME_ERR_COLUMN_MISMATCH,
+        dataframe_hash_join(prices, mismatched, ref, ticker, 1, DATAFRAME_JOIN_INNER, 0, &out));
+    TEST_ASSERT_NULL(out);
+    const int missing_col[] = {3};
+    TEST_ASSERT_EQUAL(
+        DATAFRAME_ERR_COLUMN_NOT_FOUND,
+        dataframe_hash_join(prices, ticker, ref, missing_col, 1, DATAFRAME_JOIN_INNER, 0, &out));
+
+    free_dataframe(prices);
+    free_dataframe(ref);
+}
+
+/**
+ * @brief Tests as-of joins of trades with the latest quote at or before each trade.
+ *
+ * Expected result: Each trade gets the last quote of its ticker not later than its day, ties go
+ * to the later quote, trades before the first quote and quotes without a day match nothing,
+ * and right times out of order within a ticker are rejected.
+ */
+void test_AsofJoin_LatestQuote(void)
+{
+    const char *trade_names[] = {"Ticker", "Day", "Size"};
+    const DataType trade_types[] = {TYPE_STRING, TYPE_DATE, TYPE_NUMERIC};
+    DataFrame *trades = make_frame(3, trade_names, trade_types);
+    add_row(trades, "AAPL", 19703, 10.0);
+    add_row(trades, "MSFT", 19701, 20.0);
+    add_row(trades, "AAPL", 19699, 30.0);
+    add_row(trades, "AAPL", 19701, 40.0);
+    add_row(trades, "IBM", 19705, 50.0);
+    add_row(trades, "MSFT", 19702, 60.0);
+    TEST_ASSERT_TRUE(dataframe_set_valid(trades, 5, 1, false));
+
+    /* Quotes sorted by ticker, then day */
+    const char *quote_names[] = {"Ticker", "Day", "Bid"};
+    const DataType quote_types[] = {TYPE_CATEGORY, TYPE_DATE, TYPE_NUMERIC};
+    DataFrame *quotes = make_frame(3, quote_names, quote_types);
+    add_row(quotes, "AAPL", 19700, 1.0);
+    add_row(quotes, "AAPL", 19701, 2.0);
+    add_row(quotes, "AAPL", 19701, 3.0);
+    add_row(quotes, "AAPL", 19702, 4.0);
+    add_row(quotes, "MSFT", 19699, 5.0);
+    add_row(quotes, "MSFT", 0, 6.0);
+    add_row(quotes, "MSFT", 19702, 7.0);
+    TEST_ASSERT_TRUE(dataframe_set_valid(quotes, 5, 1, false));
+
+    int matches[6];
+    const int ticker[] = {0};
+    TEST_ASSERT_EQUAL(
+        DATAFRAME_SUCCESS,
+        dataframe_asof_join_indices(trades, 1, quotes, 1, ticker, ticker, 1, 0, matches));
+    const int by_ticker[] = {3, 4, -1, 2, -1, -1};
+    TEST_ASSERT_EQUAL_INT_ARRAY(by_ticker, matches, 6);
+
+    /* Without by columns the quotes are no longer in time order */
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT,
+                      dataframe_asof_join_indices(trades, 1, quotes, 1, NULL, NULL, 0, 0, matches));
+    TEST_ASSERT_EQUAL(
+        DATAFRAME_ERR_COLUMN_MISMATCH,
+        dataframe_asof_join_indices(trades, 0, quotes, 0, NULL, NULL, 0, 0, matches));
+
+    DataFrame *out = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_asof_join(trades, 1, quotes, 1, ticker, ticker, 1, 0, &out));
+    TEST_ASSERT_EQUAL_INT(6, out->rows);
+    TEST_ASSERT_EQUAL_INT(4, out->cols);
+    TEST_ASSERT_EQUAL_INT(3, dataframe_col_index(out, "Bid"));
+    TEST_ASSERT_EQUAL_STRING("MSFT", dataframe_get_string(out, 1, 0));
+    TEST_ASSERT_EQUAL_DOUBLE(5.0, dataframe_get_cell(out, 1, 3).v_num);
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(out, 2, 3));
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(out, 5, 1));
+    TEST_ASSERT_EQUAL_DOUBLE(60.0, dataframe_get_cell(out, 5, 2).v_num);
+    free_dataframe(out);
+
+    free_dataframe(trades);
+    free_dataframe(quotes);
+}
+
+/**
+ * @brief Tests joins of frames large enough to be split across threads.
+ *
+ * Expected result: The inner join pairs every left row with each right row of its key in
+ * ascending order, and the as-of join finds the last right row at or before each time.
+ */
+void test_Join_LargeFrame(void)
+{
+    const int rows = 200000;
+    const int keys = 5000;
+    DataFrame *left = create_dataframe_with_layout((size_t)rows, 1, DATAFRAME_LAYOUT_COLUMNS);
+    DataFrame *right = create_dataframe_with_layout((size_t)rows, 2, DATAFRAME_LAYOUT_COLUMNS);
+    TEST_ASSERT_NOT_NULL(left);
+    TEST_ASSERT_NOT_NULL(right);
+    left->col_types[0] = TYPE_INT64;
+    right->col_types[0] = TYPE_INT64;
+    right->col_types[1] = TYPE_TIMESTAMP;
+
+    /* Right key r % keys appears rows / keys times; right times are 2 * r */
+    for (int r = 0; r < rows; r++) {
+        TEST_ASSERT_TRUE(dataframe_push_row(left) == r);
+        TEST_ASSERT_TRUE(dataframe_push_row(right) == r);
+        DataCell cell = {0};
+        cell.v_int = (int64_t)r * 7919 % (2 * keys);
+        dataframe_set_cell(left, r, 0, cell);
+        cell.v_int = r % keys;
+        dataframe_set_cell(right, r, 0, cell);
+        cell.v_int = 2 * (int64_t)r;
+        dataframe_set_cell(right, r, 1, cell);
+    }
+
+    int *left_rows = NULL;
+    int *right_rows = NULL;
+    size_t count = 0;
+    const int key[] = {0};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_hash_join_indices(left,
+                                                  key,
+                                                  right,
+                                                  key,
+                                                  1,
+                                                  DATAFRAME_JOIN_INNER,
+                                                  4,
+                                                  &left_rows,
+                                                  &right_rows,
+                                                  &count));
+
+    /* Half of the left keys exist on the right, each rows / keys times */
+    const int per_key = rows / keys;
+    TEST_ASSERT_EQUAL_size_t((size_t)rows / 2 * (size_t)per_key, count);
+    for (size_t i = 0; i < count; i++) {
+        const int64_t value = dataframe_get_cell(left, left_rows[i], 0).v_int;
+        TEST_ASSERT_EQUAL_INT64(value, dataframe_get_cell(right, right_rows[i], 0).v_int);
+        if (i > 0 && left_rows[i] == left_rows[i - 1])
+            TEST_ASSERT_TRUE(right_rows[i] == right_rows[i - 1] + keys);
+        else if (i > 0)
+            TEST_ASSERT_TRUE(left_rows[i] > left_rows[i - 1]);
+    }
+    free(left_rows);
+    free(right_rows);
+
+    /* As-of on the times: left value v finds right row floor(v / 2) */
+    int *matches = malloc((size_t)rows * sizeof(int));
+    TEST_ASSERT_NOT_NULL(matches);
+    left->col_types[0] = TYPE_TIMESTAMP;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_asof_join_indices(left, 0, right, 1, NULL, NULL, 0, 4, matches));
+    for (int r = 0; r < rows; r++) {
+        TEST_ASSERT_EQUAL_INT((int)(dataframe_get_cell(left, r, 0).v_int / 2), matches[r]);
+    }
+
+    free(matches);
+    free_dataframe(left);
+    free_dataframe(right);
+}
+
+/**
+ * @brief Test runner for the DataFrame join module.
+ */
+void run_dataframe_join_tests(void)
+{
+    RUN_TEST(test_HashJoin_InnerAndLeft);
+    RUN_TEST(test_AsofJoin_LatestQuote);
+    RUN_TEST(test_Join_LargeFrame);
+}
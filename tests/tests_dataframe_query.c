@@ -0,0 +1,407 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "csv_reader.h"
+#include "dataframe.h"
+#include "dataframe_filter.h"
+#include "dataframe_query.h"
+#include "statistics.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_dataframe_query.c
+ * @brief Unit tests for lazy query plans executed in fused morsels.
+ *
+ * Verifies that moving averages and signals computed morsel by morsel behind
+ * a filter match the statistics kernels run over the materialized filtered
+ * column, that filters and aggregates can use computed columns, that CSV
+ * scans agree with scans of the loaded frame, and that invalid steps are
+ * rejected when recorded.
+ */
+
+#define QUERY_CSV_FILE "test_query.tmp.csv"
+
+/**
+ * @brief Number of rows of the test frames: several morsels and a partial one.
+ */
+#define QUERY_TEST_ROWS (3 * QUERY_MORSEL_ROWS + 777)
+
+/**
+ * @brief Builds a columnar frame of prices with some missing values.
+ *
+ * Columns: Ticker (category), Close (numeric), Volume (int64).
+ *
+ * @return The new DataFrame, with validity tracking enabled.
+ */
+static DataFrame *make_prices(void)
+{
+    DataFrame *df = create_dataframe_with_layout(QUERY_TEST_ROWS, 3, DATAFRAME_LAYOUT_COLUMNS);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(df));
+    df->columns[0] = strdup("Ticker");
+    df->columns[1] = strdup("Close");
+    df->columns[2] = strdup("Volume");
+    df->col_types[0] = TYPE_CATEGORY;
+    df->col_types[1] = TYPE_NUMERIC;
+    df->col_types[2] = TYPE_INT64;
+
+    const char *tickers[] = {"AAPL", "MSFT", "IBM"};
+    for (int r = 0; r < QUERY_TEST_ROWS; r++) {
+        TEST_ASSERT_TRUE(dataframe_push_row(df) == r);
+
+        DataCell cell = {0};
+        cell.v_code = dataframe_intern_string(df, 0, tickers[r % 3], strlen(tickers[r % 3]));
+        dataframe_set_cell(df, r, 0, cell);
+        cell.v_num = 100.0 + 10.0 * sin((double)r / 37.0) + (double)(r % 11) * 0.125;
+        dataframe_set_cell(df, r, 1, cell);
+        cell.v_int = (int64_t)(r * 7919 % 5000);
+        dataframe_set_cell(df, r, 2, cell);
+        if (r % 997 == 13) {
+            cell.v_num = NAN;
+            dataframe_set_cell(df, r, 1, cell);
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 1, false));
+        }
+    }
+    return df;
+}
+
+/**
+ * @brief Checks a computed column against the values of a statistics kernel.
+ * @param out The collected frame.
+ * @param col The computed column.
+ * @param expected The kernel's values (NAN where the column must be missing).
+ */
+static void assert_computed(const DataFrame *out, const int col, const double *expected)
+{
+    for (int r = 0; r < out->rows; r++) {
+        if (isnan(expected[r])) {
+            TEST_ASSERT_TRUE(dataframe_cell_is_null(out, r, col));
+            continue;
+        }
+        TEST_ASSERT_FALSE(dataframe_cell_is_null(out, r, col));
+        TEST_ASSERT_TRUE(dataframe_get_cell(out, r, col).v_num == expected[r]);
+    }
+}
+
+/**
+ * @brief Tests a filter followed by SMA, EMA and signals over a frame of several morsels.
+ *
+ * Expected result: The collected rows are those of dataframe_filter, and the computed columns
+ * equal calculate_sma_masked, calculate_ema_masked and generate_trading_signals run over the
+ * filtered column, across morsel boundaries.
+ */
+void test_Query_FusedPipeline(void)
+{
+    DataFrame *df = make_prices();
+    FilterPredicate predicate;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_predicate_parse("Volume >= 1000", &predicate));
+
+    DataFrameQuery *query = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_scan(df, &query));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_filter(query, &predicate));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_sma(query, "Close", 20, NULL));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_ema(query, "Close", 10, NULL));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_query_signals(query, "Close", "Close_sma20", NULL));
+
+    DataFrame *out = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_collect(query, &out));
+    DataFrame *filtered = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_filter(df, &predicate, 1, &filtered));
+
+    TEST_ASSERT_EQUAL_INT(6, out->cols);
+    TEST_ASSERT_EQUAL_INT(filtered->rows, out->rows);
+    TEST_ASSERT_TRUE(filtered->rows > 2 * QUERY_MORSEL_ROWS);
+    TEST_ASSERT_EQUAL_INT(3, dataframe_col_index(out, "Close_sma20"));
+    TEST_ASSERT_EQUAL_INT(4, dataframe_col_index(out, "Close_ema10"));
+    TEST_ASSERT_EQUAL_INT(5, dataframe_col_index(out, "signal"));
+    TEST_ASSERT_EQUAL(TYPE_CATEGORY, out->col_types[5]);
+
+    const size_t n = (size_t)filtered->rows;
+    const double *close = dataframe_numeric_column(filtered, 1);
+    const uint64_t *validity = dataframe_column_validity(filtered, 1, NULL);
+    double *sma = malloc(n * sizeof(double));
+    double *ema = malloc(n * sizeof(double));
+    const char **signals = malloc(n * sizeof(char *));
+    TEST_ASSERT_TRUE(sma && ema && signals);
+    TEST_ASSERT_EQUAL(STATS_SUCCESS, calculate_sma_masked(close, validity, n, 20, sma));
+    TEST_ASSERT_EQUAL(STATS_SUCCESS, calculate_ema_masked(close, validity, n, 10, ema));
+    TEST_ASSERT_EQUAL(STATS_SUCCESS, generate_trading_signals(close, sma, n, signals));
+
+    for (int r = 0; r < out->rows; r++) {
+        TEST_ASSERT_EQUAL_STRING(dataframe_get_string(filtered, r, 0),
+                                 dataframe_get_string(out, r, 0));
+        TEST_ASSERT_EQUAL(dataframe_cell_is_null(filtered, r, 1),
+                          dataframe_cell_is_null(out, r, 1));
+        TEST_ASSERT_TRUE(dataframe_get_cell(filtered, r, 2).v_int ==
+                         dataframe_get_cell(out, r, 2).v_int);
+        TEST_ASSERT_EQUAL_STRING(signals[r], dataframe_get_string(out, r, 5));
+    }
+    assert_computed(out, 3, sma);
+    assert_computed(out, 4, ema);
+
+    /* A second execution starts from fresh window state */
+    DataFrame *again = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_collect(query, &again));
+    TEST_ASSERT_EQUAL_INT(out->rows, again->rows);
+    assert_computed(again, 3, sma);
+
+    free(sma);
+    free(ema);
+    free(signals);
+    free_dataframe(again);
+    free_dataframe(filtered);
+    free_dataframe(out);
+    dataframe_query_free(query);
+    dataframe_predicate_free(&predicate);
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests filters on computed columns, column selection and aggregation.
+ *
+ * Expected result: Filtering on the signal column keeps the BUY rows only, the selected
+ * columns come out in the requested order, and the aggregates match a serial computation.
+ */
+void test_Query_ComputedFilterAndAggregate(void)
+{
+    DataFrame *df = make_prices();
+    const FilterCondition buy = {"signal", FILTER_EQUAL, "BUY"};
+    const FilterPredicate only_buys = {&buy, 1, NULL};
+
+    DataFrameQuery *query = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_scan(df, &query));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_sma(query, "Close", 5, "fast"));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_signals(query, "Close", "fast", NULL));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_filter(query, &only_buys));
+    const char *columns[] = {"fast", "Ticker"};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_select(query, columns, 2));
+
+    const size_t n = (size_t)df->rows;
+    const double *close = dataframe_numeric_column(df, 1);
+    double *sma = malloc(n * sizeof(double));
+    const char **signals = malloc(n * sizeof(char *));
+    TEST_ASSERT_TRUE(sma && signals);
+    TEST_ASSERT_EQUAL(STATS_SUCCESS,
+                      calculate_sma_masked(
+                          close, dataframe_column_validity(df, 1, NULL), n, 5, sma));
+    TEST_ASSERT_EQUAL(STATS_SUCCESS, generate_trading_signals(close, sma, n, signals));
+
+    DataFrame *out = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_collect(query, &out));
+    TEST_ASSERT_EQUAL_INT(2, out->cols);
+    TEST_ASSERT_EQUAL_STRING("fast", out->columns[0]);
+    TEST_ASSERT_EQUAL_STRING("Ticker", out->columns[1]);
+
+    int buys = 0;
+    double close_sum = 0.0;
+    double fast_max = -INFINITY;
+    for (size_t r = 0; r < n; r++) {
+        if (strcmp(signals[r], "BUY") != 0)
+            continue;
+        TEST_ASSERT_TRUE(buys < out->rows);
+        TEST_ASSERT_TRUE(dataframe_get_cell(out, buys, 0).v_num == sma[r]);
+        TEST_ASSERT_EQUAL_STRING(dataframe_get_string(df, (int)r, 0),
+                                 dataframe_get_string(out, buys, 1));
+        close_sum += close[r];
+        if (sma[r] > fast_max)
+            fast_max = sma[r];
+        buys++;
+    }
+    TEST_ASSERT_TRUE(buys > 10);
+    TEST_ASSERT_EQUAL_INT(buys, out->rows);
+
+    const QueryAggregate aggregates[] = {{"signal", GROUPBY_COUNT, NULL},
+                                         {"Close", GROUPBY_MEAN, "mean_close"},
+                                         {"fast", GROUPBY_MAX, NULL},
+                                         {"Volume", GROUPBY_VARIANCE, NULL}};
+    DataFrame *summary = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_aggregate(query, aggregates, 4, &summary));
+    TEST_ASSERT_EQUAL_INT(1, summary->rows);
+    TEST_ASSERT_EQUAL_STRING("signal_count", summary->columns[0]);
+    TEST_ASSERT_EQUAL_STRING("mean_close", summary->columns[1]);
+    TEST_ASSERT_EQUAL_STRING("fast_max", summary->columns[2]);
+    TEST_ASSERT_EQUAL(TYPE_INT64, summary->col_types[0]);
+    TEST_ASSERT_TRUE(dataframe_get_cell(summary, 0, 0).v_int == buys);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, close_sum / buys, dataframe_get_cell(summary, 0, 1).v_num);
+    TEST_ASSERT_TRUE(dataframe_get_cell(summary, 0, 2).v_num == fast_max);
+    TEST_ASSERT_FALSE(dataframe_cell_is_null(summary, 0, 3));
+
+    /* Aggregates over no surviving row are missing, except the count */
+    const FilterCondition none = {"Volume", FILTER_LESS, "0"};
+    const FilterPredicate no_rows = {&none, 1, NULL};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_filter(query, &no_rows));
+    DataFrame *empty = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_aggregate(query, aggregates, 4, &empty));
+    TEST_ASSERT_TRUE(dataframe_get_cell(empty, 0, 0).v_int == 0);
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(empty, 0, 1));
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(empty, 0, 2));
+
+    free(sma);
+    free(signals);
+    free_dataframe(empty);
+    free_dataframe(summary);
+    free_dataframe(out);
+    dataframe_query_free(query);
+    free_dataframe(df);
+}
+
+/**
+ * @brief Runs the same pipeline over a query plan.
+ * @param query The scan.
+ * @param predicate The filter applied before the averages.
+ * @return The collected result.
+ */
+static DataFrame *run_pipeline(DataFrameQuery *query, const FilterPredicate *predicate)
+{
+    DataFrame *out = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_filter(query, predicate));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_sma(query, "Close", 15, "sma"));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_signals(query, "Close", "sma", NULL));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_collect(query, &out));
+    return out;
+}
+
+/**
+ * @brief Tests a query over a CSV file against the same query over the loaded frame.
+ *
+ * Expected result: The streamed scan, whose filter is checked by the reader, returns the same
+ * rows and computed values as the scan of the fully loaded file, also when executed twice.
+ */
+void test_Query_CsvScan(void)
+{
+    FILE *f = fopen(QUERY_CSV_FILE, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fprintf(f, "Ticker,Close,Volume\n");
+    for (int r = 0; r < QUERY_TEST_ROWS; r++) {
+        if (r % 501 == 7)
+            fprintf(f, "T%d,,%d\n", r % 4, r * 7919 % 5000);
+        else
+            fprintf(f,
+                    "T%d,%.3f,%d\n",
+                    r % 4,
+                    50.0 + (double)(r * 37 % 1201) * 0.25,
+                    r * 7919 % 5000);
+    }
+    fclose(f);
+
+    CsvReadOptions options = csv_default_read_options();
+    options.dictionary_encode = true;
+    FilterPredicate predicate;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_predicate_parse("Volume < 4000 AND Ticker != T2", &predicate));
+
+    DataFrame *df = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, read_csv_with_options(QUERY_CSV_FILE, &options, &df));
+    DataFrameQuery *loaded = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_scan(df, &loaded));
+    free_dataframe(df);
+    DataFrame *expected = run_pipeline(loaded, &predicate);
+
+    DataFrameQuery *streamed = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_query_scan_csv(QUERY_CSV_FILE, &options, &streamed));
+    DataFrame *out = run_pipeline(streamed, &predicate);
+    DataFrame *again = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_collect(streamed, &again));
+
+    TEST_ASSERT_TRUE(expected->rows > QUERY_MORSEL_ROWS);
+    TEST_ASSERT_EQUAL_INT(expected->cols, out->cols);
+    TEST_ASSERT_EQUAL_INT(expected->rows, out->rows);
+    TEST_ASSERT_EQUAL_INT(expected->rows, again->rows);
+    for (int r = 0; r < expected->rows; r++) {
+        TEST_ASSERT_EQUAL_STRING(dataframe_get_string(expected, r, 0),
+                                 dataframe_get_string(out, r, 0));
+        for (int c = 1; c < 4; c++) {
+            TEST_ASSERT_EQUAL(dataframe_cell_is_null(expected, r, c),
+                              dataframe_cell_is_null(out, r, c));
+            TEST_ASSERT_EQUAL(dataframe_cell_is_null(expected, r, c),
+                              dataframe_cell_is_null(again, r, c));
+        }
+        if (!dataframe_cell_is_null(expected, r, 3))
+            TEST_ASSERT_TRUE(dataframe_get_cell(expected, r, 3).v_num ==
+                             dataframe_get_cell(out, r, 3).v_num);
+        TEST_ASSERT_EQUAL_STRING(dataframe_get_string(expected, r, 4),
+                                 dataframe_get_string(again, r, 4));
+    }
+
+    free_dataframe(again);
+    free_dataframe(out);
+    free_dataframe(expected);
+    dataframe_query_free(streamed);
+    dataframe_query_free(loaded);
+    dataframe_predicate_free(&predicate);
+    remove(QUERY_CSV_FILE);
+}
+
+/**
+ * @brief Tests that invalid steps are rejected when recorded or executed.
+ *
+ * Expected result: Unknown and non-numeric columns, taken names and invalid periods fail
+ * without changing the plan; a constant that does not parse fails the execution.
+ */
+void test_Query_Errors(void)
+{
+    DataFrame *df = make_prices();
+    DataFrameQuery *query = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_scan(df, &query));
+    /* The query holds its own reference */
+    free_dataframe(df);
+
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND,
+                      dataframe_query_sma(query, "Open", 5, NULL));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND,
+                      dataframe_query_sma(query, "Ticker", 5, NULL));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT, dataframe_query_ema(query, "Close", 0, NULL));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_MISMATCH,
+                      dataframe_query_sma(query, "Close", 5, "Volume"));
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_sma(query, "Volume", 3, NULL));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_MISMATCH,
+                      dataframe_query_ema(query, "Close", 3, "Volume_sma3"));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND,
+                      dataframe_query_signals(query, "Close", "Close_sma3", NULL));
+
+    const FilterCondition unknown = {"signal", FILTER_EQUAL, "BUY"};
+    const FilterPredicate on_unknown = {&unknown, 1, NULL};
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND, dataframe_query_filter(query, &on_unknown));
+    const char *columns[] = {"Close", "Open"};
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND, dataframe_query_select(query, columns, 2));
+    const QueryAggregate mean_ticker = {"Ticker", GROUPBY_MEAN, NULL};
+    DataFrame *out = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND,
+                      dataframe_query_aggregate(query, &mean_ticker, 1, &out));
+
+    /* Only the successful step was recorded */
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_collect(query, &out));
+    TEST_ASSERT_EQUAL_INT(4, out->cols);
+    TEST_ASSERT_EQUAL_INT(QUERY_TEST_ROWS, out->rows);
+    free_dataframe(out);
+
+    const FilterCondition bad = {"Volume_sma3", FILTER_LESS, "abc"};
+    const FilterPredicate bad_constant = {&bad, 1, NULL};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_query_filter(query, &bad_constant));
+    out = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_INVALID_FORMAT, dataframe_query_collect(query, &out));
+    TEST_ASSERT_NULL(out);
+
+    dataframe_query_free(query);
+
+    DataFrameQuery *missing = NULL;
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_FILE_NOT_FOUND,
+                      dataframe_query_scan_csv("does_not_exist.tmp.csv", NULL, &missing));
+    TEST_ASSERT_NULL(missing);
+}
+
+/**
+ * @brief Test runner for the DataFrame query module.
+ */
+void run_dataframe_query_tests(void)
+{
+    RUN_TEST(test_Query_FusedPipeline);
+    RUN_TEST(test_Query_ComputedFilterAndAggregate);
+    RUN_TEST(test_Query_CsvScan);
+    RUN_TEST(test_Query_Errors);
+}
@@ -0,0 +1,199 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dataframe.h"
+#include "dataframe_sort.h"
+#include "test_helpers.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_dataframe_sort.c
+ * @brief Unit tests for sorting DataFrame rows.
+ *
+ * Verifies multi-key ordering across every key type and direction, the
+ * placement of missing values, the stability of the sort, and that large
+ * frames split across threads sort the same way.
+ */
+
+/**
+ * @brief Builds a small frame of quotes with some missing values.
+ *
+ * Columns: Ticker (category), Day (date), Price (numeric), Note (string).
+ *
+ * @return The new DataFrame, with validity tracking enabled.
+ */
+static DataFrame *make_quotes(void)
+{
+    const TestQuote quotes[] = {
+        {"MSFT", 19702, 310.5, 0, "b"},
+        {"AAPL", 19701, 190.0, 0, "a"},
+        {"MSFT", 19700, -0.0, 0, NULL},
+        {"IBM", 19700, 140.25, 0, "c"},
+        {"AAPL", 19703, NAN, 0, "a"},
+        {"IBM", 19701, 141.0, 0, ""},
+        {"AAPL", 19700, 0.0, 0, "b"},
+    };
+    return test_make_quotes(quotes, 7, false);
+}
+
+/**
+ * @brief Asserts that a computed order matches the expected one.
+ * @param expected The expected former rows.
+ * @param order The computed order.
+ * @param count The number of rows.
+ */
+static void assert_order(const int *expected, const int *order, const int count)
+{
+    TEST_ASSERT_EQUAL_INT_ARRAY(expected, order, count);
+}
+
+/**
+ * @brief Tests ordering by single and multiple keys of every type.
+ *
+ * Expected result: Categories sort by their text, earlier keys take precedence, descending
+ * keys reverse only their own order, ties keep the input order and missing values come last.
+ */
+void test_DataFrameSort_MultiKey(void)
+{
+    DataFrame *df = make_quotes();
+    int order[7];
+
+    /* Ticker ascending, then Day descending */
+    const int keys[] = {0, 1};
+    const bool ascending[] = {true, false};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_sort_order(df, keys, ascending, 2, order));
+    const int by_ticker_day[] = {4, 1, 6, 5, 3, 0, 2};
+    assert_order(by_ticker_day, order, 7);
+
+    /* Prices: -0.0 and 0.0 tie and keep their order, the missing price goes last */
+    const int price[] = {2};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_sort_order(df, price, NULL, 1, order));
+    const int by_price[] = {2, 6, 3, 5, 1, 0, 4};
+    assert_order(by_price, order, 7);
+    const bool descending[] = {false};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_sort_order(df, price, descending, 1, order));
+    const int by_price_desc[] = {0, 1, 5, 3, 2, 6, 4};
+    assert_order(by_price_desc, order, 7);
+
+    /* Strings: the empty string first, the missing note last, in either direction */
+    const int note[] = {3};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_sort_order(df, note, NULL, 1, order));
+    const int by_note[] = {5, 1, 4, 0, 6, 3, 2};
+    assert_order(by_note, order, 7);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_sort_order(df, note, descending, 1, order));
+    const int by_note_desc[] = {3, 0, 6, 1, 4, 5, 2};
+    assert_order(by_note_desc, order, 7);
+
+    const int bad_keys[] = {0, 4};
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND,
+                      dataframe_sort_order(df, bad_keys, NULL, 2, order));
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND,
+                      dataframe_sort_order(df, keys, NULL, 0, order));
+
+    /* Sorting in place moves whole rows, validity included */
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_sort(df, keys, ascending, 2));
+    TEST_ASSERT_EQUAL_STRING("AAPL", dataframe_get_string(df, 0, 0));
+    TEST_ASSERT_EQUAL_INT64(19703, dataframe_get_cell(df, 0, 1).v_int);
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(df, 0, 2));
+    TEST_ASSERT_FALSE(dataframe_cell_is_null(df, 4, 2));
+    TEST_ASSERT_TRUE(dataframe_cell_is_null(df, 6, 3));
+    TEST_ASSERT_EQUAL_STRING("c", dataframe_get_string(df, 4, 3));
+
+    free_dataframe(df);
+}
+
+/**
+ * @brief Returns the next value of a 64-bit linear congruential generator.
+ * @param state The generator state.
+ * @return The new state.
+ */
+static uint64_t next_random(uint64_t *state)
+{
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *state;
+}
+
+/**
+ * @brief Tests sorting frames large enough to be split across threads.
+ *
+ * Expected result: The columnar frame ends up ordered by both keys with ties in input order,
+ * every row is kept exactly once, and string keys agree with strcmp.
+ */
+void test_DataFrameSort_LargeFrame(void)
+{
+    const int rows = 300000;
+    DataFrame *df = create_dataframe_with_layout((size_t)rows, 4, DATAFRAME_LAYOUT_COLUMNS);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(df));
+    const DataType types[] = {TYPE_INT64, TYPE_NUMERIC, TYPE_INT64, TYPE_STRING};
+    memcpy(df->col_types, types, sizeof(types));
+
+    uint64_t state = 42;
+    for (int r = 0; r < rows; r++) {
+        TEST_ASSERT_TRUE(dataframe_push_row(df) == r);
+
+        DataCell cell = {0};
+        cell.v_int = (int64_t)(next_random(&state) >> 54) - 512;
+        dataframe_set_cell(df, r, 0, cell);
+        cell.v_num = (double)(int64_t)(next_random(&state) >> 40) / 1024.0 - 8e6;
+        dataframe_set_cell(df, r, 1, cell);
+        cell.v_int = r;
+        dataframe_set_cell(df, r, 2, cell);
+
+        char text[16];
+        snprintf(text, sizeof(text), "k%u", (unsigned)(next_random(&state) >> 48));
+        cell.v_str = dataframe_store_string(df, text, strlen(text));
+        dataframe_set_cell(df, r, 3, cell);
+        if (r % 1000 == 7)
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 1, false));
+    }
+
+    const int keys[] = {0, 1};
+    const bool ascending[] = {false, true};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_sort(df, keys, ascending, 2));
+
+    const int64_t *group = dataframe_int64_column(df, 0);
+    const double *value = dataframe_numeric_column(df, 1);
+    const int64_t *origin = dataframe_int64_column(df, 2);
+    int64_t checksum = origin[0];
+    for (int r = 1; r < rows; r++) {
+        checksum += origin[r];
+        TEST_ASSERT_TRUE(group[r - 1] >= group[r]);
+        if (group[r - 1] != group[r])
+            continue;
+
+        const bool prev_null = dataframe_cell_is_null(df, r - 1, 1);
+        const bool null = dataframe_cell_is_null(df, r, 1);
+        TEST_ASSERT_TRUE(!prev_null || null);
+        if (!null && !prev_null)
+            TEST_ASSERT_TRUE(value[r - 1] <= value[r]);
+        if (null == prev_null && (null || value[r - 1] == value[r]))
+            TEST_ASSERT_TRUE(origin[r - 1] < origin[r]);
+    }
+    TEST_ASSERT_EQUAL_INT64((int64_t)rows * (rows - 1) / 2, checksum);
+
+    int *order = malloc((size_t)rows * sizeof(int));
+    TEST_ASSERT_NOT_NULL(order);
+    const int text_key[] = {3};
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_sort_order(df, text_key, NULL, 1, order));
+    for (int r = 1; r < rows; r++) {
+        const int cmp = strcmp(dataframe_get_string(df, order[r - 1], 3),
+                               dataframe_get_string(df, order[r], 3));
+        TEST_ASSERT_TRUE(cmp < 0 || (cmp == 0 && order[r - 1] < order[r]));
+    }
+
+    free(order);
+    free_dataframe(df);
+}
+
+/**
+ * @brief Test runner for the DataFrame sort module.
+ */
+void run_dataframe_sort_tests(void)
+{
+    RUN_TEST(test_DataFrameSort_MultiKey);
+    RUN_TEST(test_DataFrameSort_LargeFrame);
+}
@@ -0,0 +1,207 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dataframe.h"
+#include "dataframe_view.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_dataframe_view.c
+ * @brief Unit tests for the zero-copy DataFrame views.
+ *
+ * Verifies that slices and column selections compose onto the parent without
+ * copying, that a view keeps its parent alive, and the validity reported for
+ * sliced and strided columns.
+ */
+
+/**
+ * @brief Builds a columnar frame whose cells encode their position.
+ *
+ * Column 0 ("Price") holds row * 1.0, column 1 ("Qty") holds row * 10 and
+ * column 2 ("Note") holds NULL strings. Every seventh price is missing.
+ *
+ * @param rows The number of rows.
+ * @return The new DataFrame, with validity tracking enabled.
+ */
+static DataFrame *make_frame(const int rows)
+{
+    DataFrame *df = create_dataframe_with_layout((size_t)rows, 3, DATAFRAME_LAYOUT_COLUMNS);
+    TEST_ASSERT_NOT_NULL(df);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS, dataframe_enable_validity(df));
+
+    const char *names[] = {"Price", "Qty", "Note"};
+    const DataType types[] = {TYPE_NUMERIC, TYPE_INT64, TYPE_STRING};
+    for (int c = 0; c < 3; c++) {
+        df->columns[c] = strdup(names[c]);
+        df->col_types[c] = types[c];
+    }
+
+    for (int r = 0; r < rows; r++) {
+        TEST_ASSERT_TRUE(dataframe_push_row(df) == r);
+
+        DataCell cell = {0};
+        cell.v_num = (double)r;
+        dataframe_set_cell(df, r, 0, cell);
+        if (r % 7 == 0)
+            TEST_ASSERT_TRUE(dataframe_set_valid(df, r, 0, false));
+        cell.v_int = (int64_t)r * 10;
+        dataframe_set_cell(df, r, 1, cell);
+    }
+    return df;
+}
+
+/**
+ * @brief Tests slicing, strided slicing and column selection of views.
+ *
+ * Expected result: Nested views address the right parent cells, and contiguous numeric
+ * columns point into the parent's storage instead of a copy.
+ */
+void test_DataFrameView_SliceAndSelect(void)
+{
+    DataFrame *df = make_frame(1000);
+    DataFrameView *all = dataframe_view_create(df);
+    TEST_ASSERT_NOT_NULL(all);
+    TEST_ASSERT_EQUAL_INT(1000, all->rows);
+    TEST_ASSERT_EQUAL_INT(3, all->cols);
+
+    DataFrameView *window = dataframe_view_slice(all, 100, 250, 1);
+    TEST_ASSERT_NOT_NULL(window);
+    TEST_ASSERT_EQUAL_INT(250, window->rows);
+    TEST_ASSERT_EQUAL_DOUBLE(101.0, dataframe_view_get_cell(window, 1, 0).v_num);
+    TEST_ASSERT_EQUAL_PTR(dataframe_numeric_column(df, 0) + 100,
+                          dataframe_view_numeric_column(window, 0));
+    TEST_ASSERT_EQUAL_PTR(dataframe_int64_column(df, 1) + 100,
+                          dataframe_view_int64_column(window, 1));
+
+    /* Every third row of the window, from its 5th: parent rows 105, 108, ... */
+    DataFrameView *strided = dataframe_view_slice(window, 5, 10, 3);
+    TEST_ASSERT_NOT_NULL(strided);
+    TEST_ASSERT_EQUAL_INT(105, strided->first_row);
+    TEST_ASSERT_EQUAL_INT(3, strided->row_step);
+    TEST_ASSERT_EQUAL_INT64(1320, dataframe_view_get_cell(strided, 9, 1).v_int);
+    TEST_ASSERT_NULL(dataframe_view_numeric_column(strided, 0));
+    const DataCell *cells = dataframe_view_column(strided, 0);
+    TEST_ASSERT_NOT_NULL(cells);
+    TEST_ASSERT_EQUAL_DOUBLE(111.0, cells[2 * strided->row_step].v_num);
+
+    const char *names[] = {"Qty", "Price"};
+    DataFrameView *selected = dataframe_view_select_names(strided, names, 2);
+    TEST_ASSERT_NOT_NULL(selected);
+    TEST_ASSERT_EQUAL_INT(2, selected->cols);
+    TEST_ASSERT_EQUAL_INT(1, dataframe_view_parent_col(selected, 0));
+    TEST_ASSERT_EQUAL_INT(108, dataframe_view_parent_row(selected, 1));
+    TEST_ASSERT_EQUAL_DOUBLE(108.0, dataframe_view_get_cell(selected, 1, 1).v_num);
+    TEST_ASSERT_TRUE(dataframe_view_cell_is_null(selected, 0, 1));
+    TEST_ASSERT_NULL(dataframe_view_get_string(all, 0, 2));
+
+    /* Selections and slices that leave the view are rejected */
+    const char *missing[] = {"Note"};
+    TEST_ASSERT_NULL(dataframe_view_select_names(selected, missing, 1));
+    const int bad_cols[] = {0, 2};
+    TEST_ASSERT_NULL(dataframe_view_select(selected, bad_cols, 2));
+    TEST_ASSERT_NULL(dataframe_view_slice(window, 240, 11, 1));
+    TEST_ASSERT_NULL(dataframe_view_slice(window, 0, 2, 0));
+    DataFrameView *empty = dataframe_view_slice(window, 250, 0, 1);
+    TEST_ASSERT_NOT_NULL(empty);
+    TEST_ASSERT_NULL(dataframe_view_column(empty, 0));
+
+    dataframe_view_free(empty);
+    dataframe_view_free(selected);
+    dataframe_view_free(strided);
+    dataframe_view_free(window);
+    dataframe_view_free(all);
+    free_dataframe(df);
+}
+
+/**
+ * @brief Tests that a view keeps its parent frame alive.
+ *
+ * Expected result: The view still reads the parent's cells after the owner frees the frame,
+ * and freeing the last view releases it (checked by the sanitizer builds).
+ */
+void test_DataFrameView_KeepsParentAlive(void)
+{
+    DataFrame *df = make_frame(50);
+    DataFrameView *all = dataframe_view_create(df);
+    DataFrameView *tail = dataframe_view_slice(all, 40, 10, 1);
+    TEST_ASSERT_NOT_NULL(tail);
+    TEST_ASSERT_EQUAL(3, df->references);
+
+    free_dataframe(df);
+    dataframe_view_free(all);
+    TEST_ASSERT_EQUAL(1, tail->frame->references);
+    TEST_ASSERT_EQUAL_INT64(490, dataframe_view_get_cell(tail, 9, 1).v_int);
+    TEST_ASSERT_EQUAL_STRING("Qty", tail->frame->columns[dataframe_view_parent_col(tail, 1)]);
+
+    dataframe_view_free(tail);
+}
+
+/**
+ * @brief Tests the validity bitmaps of sliced and strided view columns.
+ *
+ * Expected result: Aligned contiguous slices reuse the parent's bitmap, other views gather
+ * their bits, columns of views without missing values report none, and a strided view over
+ * missing values without scratch space fails instead of reporting the column as all valid.
+ */
+void test_DataFrameView_Validity(void)
+{
+    DataFrame *df = make_frame(300);
+    DataFrameView *all = dataframe_view_create(df);
+    uint64_t scratch[5];
+    const uint64_t *bits = NULL;
+    size_t nulls = 0;
+
+    /* Rows 128..255 contain the multiples of 7 from 133 to 252 */
+    DataFrameView *aligned = dataframe_view_slice(all, 128, 128, 1);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_view_column_validity(aligned, 0, scratch, &bits, &nulls));
+    TEST_ASSERT_EQUAL_PTR(dataframe_column_validity(df, 0, NULL) + 2, bits);
+    TEST_ASSERT_EQUAL_size_t(18, nulls);
+
+    /* Parent rows 1, 3, 5, ...: missing at the odd multiples of 7 */
+    DataFrameView *odd = dataframe_view_slice(all, 1, 150, 2);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_view_column_validity(odd, 0, scratch, &bits, &nulls));
+    TEST_ASSERT_EQUAL_PTR(scratch, bits);
+    TEST_ASSERT_EQUAL_size_t(21, nulls);
+    TEST_ASSERT_FALSE(bits[0] >> 3 & 1u);
+    TEST_ASSERT_TRUE(bits[0] >> 4 & 1u);
+    for (int r = 0; r < odd->rows; r++) {
+        const bool valid = bits[r / 64] >> (r % 64) & 1u;
+        TEST_ASSERT_EQUAL(!dataframe_view_cell_is_null(odd, r, 0), valid);
+    }
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_ALLOCATION_FAILED,
+                      dataframe_view_column_validity(odd, 0, NULL, &bits, &nulls));
+    TEST_ASSERT_NULL(bits);
+    TEST_ASSERT_EQUAL_size_t(21, nulls);
+
+    /* Rows 1..6 hold no missing price; the quantity column has none at all */
+    DataFrameView *clean = dataframe_view_slice(all, 1, 6, 1);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_view_column_validity(clean, 0, scratch, &bits, &nulls));
+    TEST_ASSERT_NULL(bits);
+    TEST_ASSERT_EQUAL_size_t(0, nulls);
+    TEST_ASSERT_EQUAL(DATAFRAME_SUCCESS,
+                      dataframe_view_column_validity(odd, 1, NULL, &bits, &nulls));
+    TEST_ASSERT_NULL(bits);
+    TEST_ASSERT_EQUAL_size_t(0, nulls);
+    TEST_ASSERT_EQUAL(DATAFRAME_ERR_COLUMN_NOT_FOUND,
+                      dataframe_view_column_validity(odd, 3, scratch, &bits, &nulls));
+
+    dataframe_view_free(clean);
+    dataframe_view_free(odd);
+    dataframe_view_free(aligned);
+    dataframe_view_free(all);
+    free_dataframe(df);
+}
+
+/**
+ * @brief Test runner for the DataFrame view module.
+ */
+void run_dataframe_view_tests(void)
+{
+    RUN_TEST(test_DataFrameView_SliceAndSelect);
+    RUN_TEST(test_DataFrameView_KeepsParentAlive);
+    RUN_TEST(test_DataFrameView_Validity);
+}
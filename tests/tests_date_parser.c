@@ -0,0 +1,128 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "date_parser.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_date_parser.c
+ * @brief Unit tests for ISO-8601 date and timestamp parsing and day-count conversion.
+ *
+ * Verifies known day counts around the epoch and leap years, nanosecond
+ * timestamps with fractions and at the int64 limit, the rejection of
+ * malformed or impossible values, and the round trip through the calendar.
+ */
+
+/**
+ * @brief Tests parsing well-formed dates.
+ * Expected result: Day counts match known values, including dates before 1970.
+ */
+void test_ParseDate_KnownValues(void)
+{
+    int64_t days = 0;
+
+    TEST_ASSERT_TRUE(parse_date_span("1970-01-01", "1970-01-01" + 10, &days));
+    TEST_ASSERT_EQUAL_INT64(0, days);
+    TEST_ASSERT_TRUE(parse_date_span("2000-03-01", "2000-03-01" + 10, &days));
+    TEST_ASSERT_EQUAL_INT64(11017, days);
+    TEST_ASSERT_TRUE(parse_date_span("2024-02-29", "2024-02-29" + 10, &days));
+    TEST_ASSERT_EQUAL_INT64(19782, days);
+    TEST_ASSERT_TRUE(parse_date_span("1969-12-31", "1969-12-31" + 10, &days));
+    TEST_ASSERT_EQUAL_INT64(-1, days);
+}
+
+/**
+ * @brief Tests fields that are not valid dates.
+ * Expected result: Every field is rejected.
+ */
+void test_ParseDate_RejectsInvalid(void)
+{
+    const char *inputs[] = {
+        "2023-02-29", "2023-13-01", "2023-00-10", "2023-04-31", "2023/01/01", "2023-1-01",
+        "20230101", "2023-01-01T", "abcd-ef-gh", ""};
+    int64_t days;
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        TEST_ASSERT_FALSE_MESSAGE(
+            parse_date_span(inputs[i], inputs[i] + strlen(inputs[i]), &days), inputs[i]);
+    }
+}
+
+/**
+ * @brief Tests parsing dates with times into nanoseconds since the epoch.
+ * Expected result: Fractions, separators and the 'Z' suffix are handled, values before 1970
+ * are negative, and the last representable nanosecond is accepted.
+ */
+void test_ParseTimestamp_KnownValues(void)
+{
+    const int64_t second = INT64_C(1000000000);
+    const int64_t day = 86400 * second;
+    int64_t nanos = 0;
+
+    const char *inputs[] = {"1970-01-01T00:00:01.5Z",
+                            "2024-02-29 12:34:56.789",
+                            "2024-02-29",
+                            "1969-12-31T23:59:59.999999999",
+                            "2262-04-11T23:47:16.854775807"};
+    const int64_t expected[] = {second + second / 2,
+                                19782 * day + (12 * 3600 + 34 * 60 + 56) * second + 789000000,
+                                19782 * day,
+                                -1,
+                                INT64_MAX};
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        TEST_ASSERT_TRUE_MESSAGE(
+            parse_timestamp_span(inputs[i], inputs[i] + strlen(inputs[i]), &nanos), inputs[i]);
+        TEST_ASSERT_EQUAL_INT64_MESSAGE(expected[i], nanos, inputs[i]);
+    }
+}
+
+/**
+ * @brief Tests fields that are not valid timestamps.
+ * Expected result: Every field is rejected, including values just past the int64 range.
+ */
+void test_ParseTimestamp_RejectsInvalid(void)
+{
+    const char *inputs[] = {"2024-01-01T24:00:00",
+                            "2024-01-01T12:60:00",
+                            "2024-01-01T12:00",
+                            "2024-01-01T12:00:00.",
+                            "2024-01-01T12:00:00.1234567890",
+                            "2024-01-01T12:00:00+01:00",
+                            "2024-01-01X12:00:00",
+                            "2024-02-30T00:00:00",
+                            "2262-04-11T23:47:16.854775808",
+                            "1600-01-01"};
+    int64_t nanos;
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        TEST_ASSERT_FALSE_MESSAGE(
+            parse_timestamp_span(inputs[i], inputs[i] + strlen(inputs[i]), &nanos), inputs[i]);
+    }
+}
+
+/**
+ * @brief Tests converting day counts back to calendar dates over several centuries.
+ * Expected result: date_to_civil inverts date_from_civil for every day.
+ */
+void test_DateCivil_RoundTrip(void)
+{
+    for (int64_t days = -200000; days <= 200000; days += 7) {
+        int64_t year;
+        int month, day;
+        date_to_civil(days, &year, &month, &day);
+        TEST_ASSERT_EQUAL_INT64(days, date_from_civil(year, month, day));
+    }
+}
+
+/**
+ * @brief Test runner for the date parser module.
+ */
+void run_date_parser_tests(void)
+{
+    RUN_TEST(test_ParseDate_KnownValues);
+    RUN_TEST(test_ParseDate_RejectsInvalid);
+    RUN_TEST(test_ParseTimestamp_KnownValues);
+    RUN_TEST(test_ParseTimestamp_RejectsInvalid);
+    RUN_TEST(test_DateCivil_RoundTrip);
+}
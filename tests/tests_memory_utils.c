@@ -1,3 +1,8 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
 #include "memory_utils.h"
 #include "unity/unity.h"
 
@@ -6,7 +11,8 @@
  * @brief Unit tests for memory management utilities.
  *
  * Validates cache-line aligned allocations and protections against
- * boundary cases such as integer overflow and invalid alignment requests.
+ * boundary cases such as integer overflow and invalid alignment requests,
+ * as well as the bump-pointer arena.
  */
 
 /**
@@ -64,6 +70,64 @@ void test_AlignedCalloc_OverflowMultiplication(void)
     TEST_ASSERT_NULL(ptr);
 }
 
+/**
+ * @brief Tests many small and a few oversized arena allocations.
+ * Expected result: Every string keeps its contents until the arena is released, and odd-length
+ * strings do not misalign later allocations.
+ */
+void test_Arena_StringsStayValid(void)
+{
+    MemoryArena arena = {0};
+    char *copies[5000];
+    char expected[32];
+
+    for (int i = 0; i < 5000; i++) {
+        snprintf(expected, sizeof(expected), "value %d", i);
+        copies[i] = arena_strndup(&arena, expected, strlen(expected));
+        TEST_ASSERT_NOT_NULL(copies[i]);
+    }
+
+    double *values = arena_alloc(&arena, 3 * sizeof(double));
+    TEST_ASSERT_NOT_NULL(values);
+    TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)values % _Alignof(max_align_t));
+
+    char *large = arena_alloc(&arena, 1024 * 1024);
+    TEST_ASSERT_NOT_NULL(large);
+    memset(large, 'x', 1024 * 1024);
+
+    for (int i = 0; i < 5000; i++) {
+        snprintf(expected, sizeof(expected), "value %d", i);
+        TEST_ASSERT_EQUAL_STRING(expected, copies[i]);
+    }
+
+    arena_release(&arena);
+    TEST_ASSERT_NULL(arena.head);
+}
+
+/**
+ * @brief Tests moving blocks between arenas and resetting an arena.
+ * Expected result: Adopted strings survive the source; reset keeps the arena usable.
+ */
+void test_Arena_AdoptAndReset(void)
+{
+    MemoryArena dst = {0};
+    MemoryArena src = {0};
+
+    const char *kept = arena_strndup(&dst, "dst", 3);
+    const char *moved = arena_strndup(&src, "src-abc", 3);
+    arena_adopt(&dst, &src);
+
+    TEST_ASSERT_NULL(src.head);
+    TEST_ASSERT_EQUAL_STRING("dst", kept);
+    TEST_ASSERT_EQUAL_STRING("src", moved);
+
+    arena_reset(&dst);
+    TEST_ASSERT_EQUAL_STRING("again", arena_strndup(&dst, "again", 5));
+
+    arena_release(&dst);
+    arena_release(&src);
+}
+
 /**
  * @brief Test runner for the memory utilities module.
  */
@@ -73,4 +137,6 @@ void run_memory_utils_tests(void)
     RUN_TEST(test_AlignedCalloc_ZeroSize);
     RUN_TEST(test_AlignedCalloc_InvalidAlignment);
     RUN_TEST(test_AlignedCalloc_OverflowMultiplication);
+    RUN_TEST(test_Arena_StringsStayValid);
+    RUN_TEST(test_Arena_AdoptAndReset);
 }
\ No newline at end of file
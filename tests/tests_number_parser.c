@@ -0,0 +1,143 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "number_parser.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_number_parser.c
+ * @brief Unit tests for the span-based floating-point parser.
+ *
+ * Verifies that parse_double_span produces bit-identical results to strtod,
+ * including hard rounding cases, and honours span boundaries.
+ */
+
+/**
+ * @brief Parses a null-terminated string with both parse_double_span and strtod.
+ * @param text The text to parse.
+ * Expected result: Same value (bit for bit) and same number of consumed characters.
+ */
+static void assert_matches_strtod(const char *text)
+{
+    char *endptr;
+    const double expected = strtod(text, &endptr);
+    const size_t expected_len = (size_t)(endptr - text);
+
+    double actual = 0.0;
+    const size_t len = parse_double_span(text, text + strlen(text), &actual);
+
+    TEST_ASSERT_EQUAL_size_t_MESSAGE(expected_len, len, text);
+    if (expected_len > 0) {
+        if (isnan(expected)) {
+            TEST_ASSERT_TRUE_MESSAGE(isnan(actual), text);
+        } else {
+            TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&expected, &actual, sizeof(double), text);
+        }
+    }
+}
+
+/**
+ * @brief Tests typical CSV values and edge-case inputs against strtod.
+ * Expected result: Every input converts exactly like strtod.
+ */
+void test_ParseDouble_MatchesStrtod(void)
+{
+    const char *inputs[] = {
+        "0", "-0", "+1", "150.25", "-42.125", "1e10", "1E-5", "3.14159265358979323846",
+        ".5", "5.", "1e", "1e+", "12abc", "0.1", "0.3", "1.7976931348623157e308",
+        "1.7976931348623159e308", "2.2250738585072014e-308", "4.9406564584124654e-324",
+        "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400", "1e400",
+        "9007199254740993", "9007199254740992.5", "123456789012345678901234567890",
+        "0.000000000000000000000000000123456789012345678901", "7.038531e-26",
+        "4.35679e-10", "1e23", "8.41e21", "5e-324", "inf", "-Infinity", "nan", "0x1p4",
+        " 12", "abc", "-", "+.", "00000000000000000000000000001.5",
+        "2.22507385850720113605740979670913197593481954635164564e-308",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126"};
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        assert_matches_strtod(inputs[i]);
+    }
+}
+
+/**
+ * @brief Tests randomly generated decimal strings across the whole exponent range.
+ * Expected result: Every generated input converts exactly like strtod.
+ */
+void test_ParseDouble_RandomInputsMatchStrtod(void)
+{
+    srand(12345);
+    char text[64];
+
+    for (int i = 0; i < 50000; i++) {
+        const int digits = 1 + rand() % 24;
+        const int point = rand() % (digits + 1);
+        size_t pos = 0;
+
+        if (rand() % 2)
+            text[pos++] = '-';
+        for (int d = 0; d < digits; d++) {
+            if (d == point)
+                text[pos++] = '.';
+            text[pos++] = (char)('0' + rand() % 10);
+        }
+        if (rand() % 2)
+            pos += (size_t)snprintf(text + pos, sizeof(text) - pos, "e%d", rand() % 700 - 350);
+        text[pos] = '\0';
+
+        assert_matches_strtod(text);
+    }
+}
+
+/**
+ * @brief Tests that parsing stops at the end of the span even without a terminator.
+ * Expected result: Only the characters inside the span are consumed.
+ */
+void test_ParseDouble_StopsAtSpanEnd(void)
+{
+    const char text[] = "123.456789";
+    double value = 0.0;
+
+    TEST_ASSERT_EQUAL_size_t(5, parse_double_span(text, text + 5, &value));
+    TEST_ASSERT_EQUAL_DOUBLE(123.4, value);
+
+    TEST_ASSERT_EQUAL_size_t(0, parse_double_span(text, text, &value));
+}
+
+/**
+ * @brief Tests integer parsing, including both ends of the int64_t range.
+ * Expected result: Valid integers are exact; overflow and missing digits consume nothing.
+ */
+void test_ParseInt64_RangeAndErrors(void)
+{
+    int64_t value = 0;
+    const char *max = "9223372036854775807";
+    const char *min = "-9223372036854775808";
+    const char *over = "9223372036854775808";
+
+    TEST_ASSERT_EQUAL_size_t(19, parse_int64_span(max, max + strlen(max), &value));
+    TEST_ASSERT_EQUAL_INT64(INT64_MAX, value);
+    TEST_ASSERT_EQUAL_size_t(20, parse_int64_span(min, min + strlen(min), &value));
+    TEST_ASSERT_EQUAL_INT64(INT64_MIN, value);
+    TEST_ASSERT_EQUAL_size_t(0, parse_int64_span(over, over + strlen(over), &value));
+
+    const char *partial = "+42.5";
+    TEST_ASSERT_EQUAL_size_t(3, parse_int64_span(partial, partial + 5, &value));
+    TEST_ASSERT_EQUAL_INT64(42, value);
+    TEST_ASSERT_EQUAL_size_t(0, parse_int64_span("-", "-" + 1, &value));
+}
+
+/**
+ * @brief Test runner for the number parser module.
+ */
+void run_number_parser_tests(void)
+{
+    RUN_TEST(test_ParseDouble_MatchesStrtod);
+    RUN_TEST(test_ParseDouble_RandomInputsMatchStrtod);
+    RUN_TEST(test_ParseDouble_StopsAtSpanEnd);
+    RUN_TEST(test_ParseInt64_RangeAndErrors);
+}
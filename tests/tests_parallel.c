@@ -0,0 +1,105 @@
+#include <stddef.h>
+
+#include "parallel.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_parallel.c
+ * @brief Unit tests for the portable fork-join helpers.
+ *
+ * Verifies that parallel_for executes every task exactly once regardless of
+ * the requested thread count, and that a background thread and a small
+ * queue hand items over in order.
+ */
+
+#define PARALLEL_TEST_TASKS 1000
+
+/**
+ * @brief Task used by the tests: records the index it was invoked with.
+ * @param context Array of per-task hit counters.
+ * @param task_index The index of the task.
+ */
+static void mark_task(void *context, const size_t task_index)
+{
+    int *hits = context;
+    hits[task_index]++;
+}
+
+/**
+ * @brief Tests parallel_for with several thread counts, including "all hardware threads".
+ * Expected result: Every task index is executed exactly once.
+ */
+void test_ParallelFor_RunsEveryTaskOnce(void)
+{
+    const int thread_counts[] = {0, 1, 3, 16};
+
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        int hits[PARALLEL_TEST_TASKS] = {0};
+
+        parallel_for(PARALLEL_TEST_TASKS, thread_counts[t], mark_task, hits);
+
+        for (int i = 0; i < PARALLEL_TEST_TASKS; i++) {
+            TEST_ASSERT_EQUAL_INT(1, hits[i]);
+        }
+    }
+}
+
+/**
+ * @brief Tests the hardware thread query.
+ * Expected result: At least one thread is always reported.
+ */
+void test_ParallelHardwareThreads_Positive(void)
+{
+    TEST_ASSERT_TRUE(parallel_hardware_threads() >= 1);
+}
+
+/**
+ * @brief Producer used by the queue test: pushes the addresses of an array's elements in order.
+ * @param context The queue shared with the consumer.
+ */
+static void produce_items(void *context)
+{
+    static int items[PARALLEL_TEST_TASKS];
+    ParallelQueue *queue = context;
+
+    for (int i = 0; i < PARALLEL_TEST_TASKS; i++) {
+        items[i] = i;
+        if (!parallel_queue_push(queue, &items[i]))
+            return;
+    }
+    parallel_queue_close(queue);
+}
+
+/**
+ * @brief Tests passing items from a background thread through a queue smaller than the workload.
+ * Expected result: Every item arrives once and in order, and pops return NULL after closing.
+ */
+void test_ParallelQueue_ProducerConsumer(void)
+{
+    ParallelQueue *queue = parallel_queue_create(4);
+    TEST_ASSERT_NOT_NULL(queue);
+
+    ParallelThread *producer = parallel_thread_start(produce_items, queue);
+    TEST_ASSERT_NOT_NULL(producer);
+
+    for (int i = 0; i < PARALLEL_TEST_TASKS; i++) {
+        const int *item = parallel_queue_pop(queue);
+        TEST_ASSERT_NOT_NULL(item);
+        TEST_ASSERT_EQUAL_INT(i, *item);
+    }
+    TEST_ASSERT_NULL(parallel_queue_pop(queue));
+
+    parallel_thread_join(producer);
+    TEST_ASSERT_FALSE(parallel_queue_push(queue, queue));
+    parallel_queue_free(queue);
+}
+
+/**
+ * @brief Test runner for the parallel helpers module.
+ */
+void run_parallel_tests(void)
+{
+    RUN_TEST(test_ParallelFor_RunsEveryTaskOnce);
+    RUN_TEST(test_ParallelQueue_ProducerConsumer);
+    RUN_TEST(test_ParallelHardwareThreads_Positive);
+}
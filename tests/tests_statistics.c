@@ -1,4 +1,6 @@
 #include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "statistics.h"
@@ -11,6 +13,7 @@
  * This file verifies the correctness of mathematical and statistical algorithms,
  * including parameters of the normal distribution N(m, 𝜎) (mean and standard deviation),
  * moving averages, Bollinger Bands, covariance, correlation, and trading signals generation.
+ * The validity-bitmap variants are checked against the NaN-skipping kernels.
  */
 
 /**
@@ -257,6 +260,182 @@ void test_CalculateCorrelation_ZeroVariance(void)
     TEST_ASSERT_TRUE(isnan(correlation));
 }
 
+/**
+ * @brief Tests accumulating statistics over several batches, including an all-NaN batch.
+ * Expected result: The result equals calculate_series_statistics over the whole series.
+ */
+void test_RunningStatistics_MatchesSinglePass(void)
+{
+    double data[] = {2.0, 4.0, NAN, 4.0, 4.0, 5.0, NAN, 5.0, 7.0, 9.0};
+    SeriesStatistics expected;
+    SeriesStatistics actual;
+    RunningStatistics acc;
+
+    calculate_series_statistics(data, 10, &expected);
+
+    running_statistics_reset(&acc);
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS, running_statistics_update(&acc, data, 3));
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS, running_statistics_update(&acc, data + 3, 3));
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS, running_statistics_update(&acc, data + 6, 1));
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS, running_statistics_update(&acc, data + 7, 3));
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS, running_statistics_finalize(&acc, &actual));
+
+    TEST_ASSERT_EQUAL_UINT(8, acc.count);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, expected.mean, actual.mean);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, expected.variance, actual.variance);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, expected.standard_deviation, actual.standard_deviation);
+}
+
+/**
+ * @brief Tests finalizing an accumulator that never saw a valid value.
+ * Expected result: STATS_ERR_INSUFFICIENT_DATA is returned.
+ */
+void test_RunningStatistics_Empty(void)
+{
+    RunningStatistics acc;
+    SeriesStatistics stats;
+
+    running_statistics_reset(&acc);
+    TEST_ASSERT_EQUAL_INT(STATS_ERR_INSUFFICIENT_DATA, running_statistics_finalize(&acc, &stats));
+}
+
+/**
+ * @brief Number of elements of the series used by the masked kernel tests (three bitmap words).
+ */
+#define MASKED_LENGTH 150
+
+/**
+ * @brief Builds a series with missing values, both as NaN sentinels and as a validity bitmap.
+ *
+ * Elements 70..133 (a whole bitmap word's worth, straddling two words) and a
+ * few scattered ones are missing; the series data holds NaN there.
+ *
+ * @param data Receives MASKED_LENGTH values.
+ * @param validity Receives the bitmap (three words).
+ */
+static void make_masked_series(double *data, uint64_t *validity)
+{
+    validity[0] = validity[1] = validity[2] = 0;
+    for (size_t i = 0; i < MASKED_LENGTH; i++) {
+        const bool missing = (i >= 70 && i < 134) || i == 5 || i == 140;
+        data[i] = missing ? NAN : sin((double)i) * 10.0 + (double)(i % 7);
+        if (!missing)
+            validity[i / 64] |= (uint64_t)1 << (i % 64);
+    }
+}
+
+/**
+ * @brief Tests the bitmap-aware kernels on a series whose missing values are also NaN.
+ * Expected result: Every masked kernel matches its NaN-skipping counterpart, and a NULL
+ * bitmap over a complete series matches the plain kernels too.
+ */
+void test_MaskedKernels_MatchNaNKernels(void)
+{
+    double data[MASKED_LENGTH], other[MASKED_LENGTH];
+    uint64_t validity[3];
+    make_masked_series(data, validity);
+    for (size_t i = 0; i < MASKED_LENGTH; i++) {
+        other[i] = cos((double)i) * 3.0 + (double)i / 10.0;
+    }
+
+    SeriesStatistics expected, actual;
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS, calculate_series_statistics(data, MASKED_LENGTH, &expected));
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS,
+                          calculate_series_statistics_masked(data, validity, MASKED_LENGTH, &actual));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, expected.mean, actual.mean);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-10, expected.variance, actual.variance);
+
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS, calculate_series_statistics(other, MASKED_LENGTH, &expected));
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS,
+                          calculate_series_statistics_masked(other, NULL, MASKED_LENGTH, &actual));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, expected.mean, actual.mean);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-10, expected.variance, actual.variance);
+
+    double plain[MASKED_LENGTH], masked[MASKED_LENGTH];
+    calculate_sma(data, MASKED_LENGTH, 4, plain);
+    calculate_sma_masked(data, validity, MASKED_LENGTH, 4, masked);
+    for (size_t i = 0; i < MASKED_LENGTH; i++) {
+        TEST_ASSERT_EQUAL(isnan(plain[i]), isnan(masked[i]));
+        if (!isnan(plain[i]))
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, plain[i], masked[i]);
+    }
+
+    calculate_ema(data, MASKED_LENGTH, 4, plain);
+    calculate_ema_masked(data, validity, MASKED_LENGTH, 4, masked);
+    for (size_t i = 0; i < MASKED_LENGTH; i++) {
+        TEST_ASSERT_EQUAL(isnan(plain[i]), isnan(masked[i]));
+        if (!isnan(plain[i]))
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, plain[i], masked[i]);
+    }
+
+    calculate_rolling_std(other, MASKED_LENGTH, 5, plain);
+    calculate_rolling_std_masked(other, NULL, MASKED_LENGTH, 5, masked);
+    for (size_t i = 4; i < MASKED_LENGTH; i++) {
+        TEST_ASSERT_DOUBLE_WITHIN(1e-9, plain[i], masked[i]);
+    }
+    calculate_rolling_std(data, MASKED_LENGTH, 5, plain);
+    calculate_rolling_std_masked(data, validity, MASKED_LENGTH, 5, masked);
+    for (size_t i = 0; i < MASKED_LENGTH; i++) {
+        TEST_ASSERT_EQUAL(isnan(plain[i]), isnan(masked[i]));
+        if (!isnan(plain[i]))
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, plain[i], masked[i]);
+    }
+
+    double plain_value, masked_value;
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS,
+                          calculate_covariance(data, other, MASKED_LENGTH, &plain_value));
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS,
+                          calculate_covariance_masked(
+                              data, validity, other, NULL, MASKED_LENGTH, &masked_value));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-10, plain_value, masked_value);
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS,
+                          calculate_correlation(data, other, MASKED_LENGTH, &plain_value));
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS,
+                          calculate_correlation_masked(
+                              other, NULL, data, validity, MASKED_LENGTH, &masked_value));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, plain_value, masked_value);
+}
+
+/**
+ * @brief Tests that a NaN marked valid in the bitmap is treated as a value, not as missing.
+ * Expected result: Statistics over it are NaN, SMA windows are NaN only while they contain it,
+ * a series without valid elements is reported as insufficient, and bad arguments are rejected.
+ */
+void test_MaskedKernels_ValidNaN(void)
+{
+    double data[] = {1.0, 2.0, NAN, 4.0, 5.0, 6.0, 7.0};
+    const uint64_t all_valid = 0x7F;
+    const uint64_t none_valid = 0;
+    SeriesStatistics stats;
+
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS,
+                          calculate_series_statistics_masked(data, &all_valid, 7, &stats));
+    TEST_ASSERT_TRUE(isnan(stats.mean));
+
+    /* Missing in the bitmap: the NaN no longer takes part */
+    const uint64_t without_nan = 0x7B;
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS,
+                          calculate_series_statistics_masked(data, &without_nan, 7, &stats));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 25.0 / 6.0, stats.mean);
+
+    double sma[7];
+    TEST_ASSERT_EQUAL_INT(STATS_SUCCESS, calculate_sma_masked(data, NULL, 7, 2, sma));
+    TEST_ASSERT_TRUE(isnan(sma[0]));
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, sma[1]);
+    TEST_ASSERT_TRUE(isnan(sma[2]));
+    TEST_ASSERT_TRUE(isnan(sma[3]));
+    TEST_ASSERT_EQUAL_DOUBLE(4.5, sma[4]);
+    TEST_ASSERT_EQUAL_DOUBLE(6.5, sma[6]);
+
+    TEST_ASSERT_EQUAL_INT(STATS_ERR_INSUFFICIENT_DATA,
+                          calculate_series_statistics_masked(data, &none_valid, 7, &stats));
+    TEST_ASSERT_EQUAL_INT(STATS_ERR_NULL_POINTER,
+                          calculate_series_statistics_masked(NULL, NULL, 7, &stats));
+    TEST_ASSERT_EQUAL_INT(STATS_ERR_INVALID_LENGTH,
+                          calculate_series_statistics_masked(data, NULL, 0, &stats));
+    TEST_ASSERT_EQUAL_INT(STATS_ERR_INVALID_PERIOD, calculate_sma_masked(data, NULL, 7, 0, sma));
+}
+
 /**
  * @brief Test runner function that registers and executes all statistical module tests.
  */
@@ -266,6 +445,8 @@ void run_statistics_tests(void)
     RUN_TEST(test_CalculateSeriesStatistics_WithNaN);
     RUN_TEST(test_CalculateSeriesStatistics_NullOrEmpty);
     RUN_TEST(test_CalculateSeriesStatistics_SinglePoint);
+    RUN_TEST(test_RunningStatistics_MatchesSinglePass);
+    RUN_TEST(test_RunningStatistics_Empty);
 
     RUN_TEST(test_CalculateSMA);
     RUN_TEST(test_CalculateSMA_Negative);
@@ -278,4 +459,7 @@ void run_statistics_tests(void)
     RUN_TEST(test_CalculateCovariance);
     RUN_TEST(test_CalculateCorrelation);
     RUN_TEST(test_CalculateCorrelation_ZeroVariance);
+
+    RUN_TEST(test_MaskedKernels_MatchNaNKernels);
+    RUN_TEST(test_MaskedKernels_ValidNaN);
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "string_dictionary.h"
+#include "unity/unity.h"
+
+/**
+ * @file tests_string_dictionary.c
+ * @brief Unit tests for the string interning dictionary.
+ *
+ * Verifies that equal strings share one code, that codes are dense and stable
+ * while the hash table grows, and that lookups never modify the dictionary.
+ */
+
+/**
+ * @brief Tests interning repeated values from non-terminated spans.
+ * Expected result: Equal strings receive the same code, codes follow first appearance.
+ */
+void test_StringDictionary_InternDeduplicates(void)
+{
+    StringDictionary *dict = string_dictionary_create();
+    TEST_ASSERT_NOT_NULL(dict);
+
+    const char text[] = "AAPLMSFTAAPL";
+    TEST_ASSERT_EQUAL_INT32(0, string_dictionary_intern(dict, text, 4));
+    TEST_ASSERT_EQUAL_INT32(1, string_dictionary_intern(dict, text + 4, 4));
+    TEST_ASSERT_EQUAL_INT32(0, string_dictionary_intern(dict, text + 8, 4));
+    TEST_ASSERT_EQUAL_INT32(2, string_dictionary_intern(dict, "", 0));
+
+    TEST_ASSERT_EQUAL_INT32(3, dict->count);
+    TEST_ASSERT_EQUAL_STRING("MSFT", string_dictionary_value(dict, 1));
+    TEST_ASSERT_EQUAL_STRING("", string_dictionary_value(dict, 2));
+    TEST_ASSERT_NULL(string_dictionary_value(dict, 3));
+
+    TEST_ASSERT_EQUAL_INT32(1, string_dictionary_find(dict, "MSFT", 4));
+    TEST_ASSERT_EQUAL_INT32(-1, string_dictionary_find(dict, "MSF", 3));
+    TEST_ASSERT_EQUAL_INT32(3, dict->count);
+
+    string_dictionary_free(dict);
+}
+
+/**
+ * @brief Tests a dictionary growing well past its initial capacity.
+ * Expected result: Every value keeps its code and can be found again.
+ */
+void test_StringDictionary_GrowsAndKeepsCodes(void)
+{
+    StringDictionary *dict = string_dictionary_create();
+    TEST_ASSERT_NOT_NULL(dict);
+
+    char value[32];
+    for (int i = 0; i < 10000; i++) {
+        snprintf(value, sizeof(value), "key-%d", i);
+        TEST_ASSERT_EQUAL_INT32(i, string_dictionary_intern(dict, value, strlen(value)));
+    }
+
+    for (int i = 0; i < 10000; i++) {
+        snprintf(value, sizeof(value), "key-%d", i);
+        TEST_ASSERT_EQUAL_INT32(i, string_dictionary_find(dict, value, strlen(value)));
+        TEST_ASSERT_EQUAL_STRING(value, string_dictionary_value(dict, i));
+    }
+
+    string_dictionary_free(dict);
+}
+
+/**
+ * @brief Test runner for the string dictionary module.
+ */
+void run_string_dictionary_tests(void)
+{
+    RUN_TEST(test_StringDictionary_InternDeduplicates);
+    RUN_TEST(test_StringDictionary_GrowsAndKeepsCodes);
+}